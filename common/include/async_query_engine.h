@@ -0,0 +1,154 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <chrono>
+#include <shared_mutex>
+#include <mysql/mysql.h>
+
+namespace scheduler
+{
+
+  // 异步语句的执行结果
+  struct AsyncQueryResult
+  {
+    bool success = false;
+    uint64_t affected_rows = 0;
+    uint64_t insert_id = 0;
+    std::string error;
+  };
+
+  using AsyncQueryCallback = std::function<void(const AsyncQueryResult &)>;
+
+  /**
+   * @brief 异步执行的语句
+   *
+   * 客户端库的非阻塞接口只支持文本协议，参数在发送前按所在连接的字符集转义后代入占位符。
+   * 绑定接口与PreparedStatement一致，参数下标从0开始。只用于不返回结果集的写语句。
+   */
+  class AsyncStatement
+  {
+  public:
+    explicit AsyncStatement(std::string sql);
+
+    const std::string &sql() const { return sql_; }
+
+    void bindString(size_t index, const std::string &value);
+    // 按十六进制字面量代入，不做字符集转换
+    void bindBlob(size_t index, const std::string &value);
+    void bindInt(size_t index, int64_t value);
+    void bindUInt(size_t index, uint64_t value);
+    void bindTime(size_t index, const std::chrono::system_clock::time_point &value);
+    void bindNull(size_t index);
+
+    // 空字符串绑定为NULL
+    void bindOptionalString(size_t index, const std::string &value);
+
+    // 代入参数后的SQL，参数个数与占位符个数不一致时返回空串
+    std::string render(MYSQL *mysql) const;
+
+  private:
+    enum class ParamKind
+    {
+      Null,
+      String,
+      Blob,
+      Literal // 数字和时间，已是合法的SQL字面量
+    };
+
+    struct Param
+    {
+      ParamKind kind = ParamKind::Null;
+      std::string value;
+    };
+
+    Param &param(size_t index);
+
+    std::string sql_;
+    std::vector<Param> params_;
+  };
+
+  // 异步执行引擎状态
+  struct AsyncQueryStats
+  {
+    bool running = false;
+    bool non_blocking = false; // 客户端库是否提供非阻塞接口
+    size_t threads = 0;
+    size_t connections = 0; // 已建立的连接数
+    size_t queued = 0;      // 等待空闲连接的语句数
+    size_t in_flight = 0;   // 正在执行的语句数
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+  };
+
+  /**
+   * @brief 异步数据库执行引擎
+   *
+   * 少量事件循环线程（db.async.threads）各自持有若干连接（db.async.connections_per_thread），
+   * 通过客户端库的非阻塞接口同时发出多条语句，在poll上等待任意连接的应答，
+   * 不需要每条语句占用一个线程。调用方通过回调或future取得结果。
+   * 支持MariaDB的mysql_*_start/_cont和MySQL 8.0.16起的mysql_*_nonblocking；
+   * 都不支持时每个事件循环线程依次阻塞执行，调用方仍然不阻塞。
+   * 不同语句可能在不同连接上执行，彼此之间不保证顺序。
+   */
+  class AsyncQueryEngine
+  {
+  public:
+    static AsyncQueryEngine &getInstance();
+
+    // 按配置启动，db.async.threads为0时不启动
+    bool initialize();
+    bool initialize(size_t threads, size_t connectionsPerThread);
+
+    // 执行完已提交的语句后停止
+    void shutdown();
+
+    bool isRunning() const { return running_; }
+
+    static bool nonBlockingSupported();
+
+    // 提交语句，回调在事件循环线程中执行，不应阻塞；
+    // 引擎未启动时立即以失败结果回调并返回false
+    bool submit(AsyncStatement statement, AsyncQueryCallback callback);
+    std::future<AsyncQueryResult> submit(AsyncStatement statement);
+
+    AsyncQueryStats getStats() const;
+
+  private:
+    AsyncQueryEngine() = default;
+    ~AsyncQueryEngine();
+
+    AsyncQueryEngine(const AsyncQueryEngine &) = delete;
+    AsyncQueryEngine &operator=(const AsyncQueryEngine &) = delete;
+
+    struct Loop;
+
+    // 事件循环：把排队的语句分给空闲连接，等待并推进执行中的语句
+    void run(Loop &loop);
+
+    std::string host_;
+    std::string user_;
+    std::string password_;
+    std::string database_;
+    unsigned int port_ = 3306;
+    std::chrono::milliseconds queryTimeout_{30000};
+
+    // 保护loops_的创建和running_的切换
+    mutable std::shared_mutex lifecycleMutex_;
+    std::vector<std::unique_ptr<Loop>> loops_;
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> nextLoop_{0};
+
+    std::atomic<size_t> connections_{0};
+    std::atomic<size_t> inFlight_{0};
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> failed_{0};
+  };
+
+} // namespace scheduler
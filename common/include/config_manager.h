@@ -53,6 +53,13 @@ namespace scheduler
      */
     bool getBool(const std::string &key, bool defaultValue = false) const;
 
+    /**
+     * @brief 获取指定前缀的全部配置
+     * @param prefix 键前缀，例如"kafka.producer."
+     * @return 去掉前缀后的键到配置值的映射
+     */
+    std::map<std::string, std::string> getWithPrefix(const std::string &prefix) const;
+
     /**
      * @brief 设置配置值
      * @param key 配置键
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <set>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <utility>
+
+namespace scheduler
+{
+
+  // 消息所在的主题和分区
+  using TopicPartitionKey = std::pair<std::string, int32_t>;
+
+  /**
+   * @brief 消费消息的工作线程池
+   *
+   * 按消息键分配工作线程，同一键的消息由同一线程按到达顺序处理；无键的消息按主题和分区分配。
+   * 某个线程的队列达到容量时通过onPause暂停该消息所在的分区，所有队列回落到容量一半以下后
+   * 由resumePaused()通过onResume恢复。submit()、resumePaused()和clearPaused()只在消费线程中调用，
+   * 暂停和恢复的回调也在消费线程中执行。
+   */
+  class ConsumerWorkerPool
+  {
+  public:
+    using PartitionCallback = std::function<void(const std::vector<TopicPartitionKey> &)>;
+
+    ConsumerWorkerPool(size_t workers, size_t queueCapacity, PartitionCallback onPause, PartitionCallback onResume);
+    ~ConsumerWorkerPool();
+
+    ConsumerWorkerPool(const ConsumerWorkerPool &) = delete;
+    ConsumerWorkerPool &operator=(const ConsumerWorkerPool &) = delete;
+
+    // 分发一条消息的处理
+    void submit(const std::string &key, const std::string &topic, int32_t partition, std::function<void()> task);
+
+    // 所有队列回落后恢复暂停的分区
+    void resumePaused();
+
+    // 分区收回后丢弃暂停记录，重新分配的分区不处于暂停状态
+    void clearPaused();
+
+    bool hasPaused() const { return !paused_.empty(); }
+
+    // 等待已分发的消息全部处理完
+    void waitIdle();
+
+    // 已分发未处理完的消息数
+    size_t pending() const;
+
+    // 处理完队列中的消息后停止工作线程
+    void stop();
+
+    size_t workerCount() const { return workers_.size(); }
+
+    // 消息分配到的工作线程序号
+    static size_t workerIndex(const std::string &key, const std::string &topic, int32_t partition, size_t workers);
+
+  private:
+    struct Worker
+    {
+      std::deque<std::function<void()>> queue;
+      std::mutex mutex;
+      std::condition_variable condition;
+      bool stopping = false;
+      std::thread thread;
+    };
+
+    void run(Worker *worker);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    size_t queueCapacity_;
+    PartitionCallback onPause_;
+    PartitionCallback onResume_;
+
+    // 已暂停的分区，只在消费线程中访问
+    std::set<TopicPartitionKey> paused_;
+
+    // 已分发未处理完的消息数，降为0时唤醒waitIdle()
+    size_t pending_ = 0;
+    mutable std::mutex pendingMutex_;
+    std::condition_variable idle_;
+  };
+
+} // namespace scheduler
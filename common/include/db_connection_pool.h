@@ -1,11 +1,15 @@
 #pragma once
 
 #include <string>
-#include <queue>
+#include <deque>
 #include <mutex>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <memory>
+#include <unordered_map>
 #include <mysql/mysql.h>
+#include "prepared_statement.h"
 
 namespace scheduler
 {
@@ -23,9 +27,16 @@ namespace scheduler
     bool connect();
     void disconnect();
     bool reconnect();
+    // 通过ping检查连接，会产生一次网络往返
     bool isConnected() const;
 
-    // 执行SQL查询
+    // 上次执行因连接问题失败，需在下次借出前检查
+    bool needsValidation() const;
+
+    // 检查连接，失效时重连，由连接池在借出前按需调用
+    bool validate();
+
+    // 执行SQL查询，不预先检查连接，失败后由连接池在下次借出前检查
     bool executeQuery(const std::string &query);
 
     // 执行SQL更新（插入、更新、删除）
@@ -43,7 +54,15 @@ namespace scheduler
     // 获取原始MYSQL连接
     MYSQL *getRawConnection() { return mysql_; }
 
+    // 获取预处理语句，同一连接上相同SQL的语句只准备一次，失败返回nullptr
+    std::shared_ptr<PreparedStatement> prepare(const std::string &sql);
+
   private:
+    friend class DBConnectionPool;
+
+    // 关闭缓存的预处理语句，需在关闭连接之前调用
+    void clearStatements();
+
     std::string host_;
     std::string user_;
     std::string password_;
@@ -51,8 +70,82 @@ namespace scheduler
     unsigned int port_;
     MYSQL *mysql_;
     bool connected_;
+    bool failed_; // 最近一次执行因连接问题失败
+
+    // 建立连接和最近一次归还的时间，由连接池用于空闲检查和最长存活时间
+    std::chrono::steady_clock::time_point createdAt_;
+    std::chrono::steady_clock::time_point lastUsed_;
+
+    // 预处理语句缓存，自动重连后服务端的语句句柄失效，按连接线程ID判断
+    std::unordered_map<std::string, std::shared_ptr<PreparedStatement>> statements_;
+    unsigned long statementThreadId_;
+    size_t statementCacheSize_;
   };
 
+  class DBConnectionPool;
+
+  // 连接池状态
+  struct ConnectionPoolStats
+  {
+    size_t total = 0;               // 已建立的连接数
+    size_t in_use = 0;              // 已借出的连接数
+    size_t idle = 0;                // 空闲连接数
+    size_t max_size = 0;            // 最大连接数
+    uint64_t acquisitions = 0;      // 累计借出次数
+    uint64_t timeouts = 0;          // 等待连接超时次数
+    uint64_t wait_time_total_us = 0; // 借出连接的累计等待时间（微秒）
+    uint64_t wait_time_max_us = 0;   // 借出连接的最长等待时间（微秒）
+    uint64_t validations = 0;       // 借出前检查连接的次数
+    uint64_t recycled = 0;          // 超过最长存活时间后关闭的连接数
+
+    uint64_t getAvgWaitTime() const
+    {
+      return acquisitions > 0 ? wait_time_total_us / acquisitions : 0;
+    }
+
+    // 已借出的连接占最大连接数的比例
+    double getUtilization() const
+    {
+      return max_size > 0 ? static_cast<double>(in_use) / max_size : 0.0;
+    }
+  };
+
+  /**
+   * @brief 借出的数据库连接，析构时自动归还
+   *
+   * 只能移动，不能复制。提前返回时也会归还连接。
+   */
+  class ConnectionLease
+  {
+  public:
+    ConnectionLease() = default;
+    ConnectionLease(DBConnectionPool *pool, std::shared_ptr<DBConnection> conn);
+    ~ConnectionLease();
+
+    ConnectionLease(ConnectionLease &&other) noexcept;
+    ConnectionLease &operator=(ConnectionLease &&other) noexcept;
+    ConnectionLease(const ConnectionLease &) = delete;
+    ConnectionLease &operator=(const ConnectionLease &) = delete;
+
+    explicit operator bool() const { return conn_ != nullptr; }
+    DBConnection *operator->() const { return conn_.get(); }
+    DBConnection &operator*() const { return *conn_; }
+
+    // 提前归还连接
+    void release();
+
+  private:
+    DBConnectionPool *pool_ = nullptr;
+    std::shared_ptr<DBConnection> conn_;
+  };
+
+  /**
+   * @brief 数据库连接池
+   *
+   * 借出时不再每次ping：只有空闲超过db.pool.validate_idle_ms或上次执行出错的连接才检查。
+   * 同一线程优先拿回自己上次使用的连接，其次取最近归还的连接；
+   * 超过db.pool.max_lifetime_s的连接在归还时关闭，之后按需新建。
+   */
   class DBConnectionPool
   {
   public:
@@ -70,11 +163,8 @@ namespace scheduler
                     size_t initialSize = 5,
                     size_t maxSize = 20);
 
-    // 获取连接
-    std::shared_ptr<DBConnection> getConnection(unsigned int timeoutMs = 5000);
-
-    // 释放连接
-    void releaseConnection(std::shared_ptr<DBConnection> conn);
+    // 获取连接，超时或连接池已关闭时返回空租约
+    ConnectionLease getConnection(unsigned int timeoutMs = 5000);
 
     // 关闭连接池
     void shutdown();
@@ -82,8 +172,17 @@ namespace scheduler
     // 获取连接池状态
     size_t getActiveConnections() const;
     size_t getIdleConnections() const;
+    ConnectionPoolStats getStats() const;
 
   private:
+    friend class ConnectionLease;
+
+    // 归还连接，由ConnectionLease调用
+    void releaseConnection(std::shared_ptr<DBConnection> conn);
+
+    // 取出一个空闲连接，优先取当前线程上次使用的连接，调用方需持有mutex_
+    std::shared_ptr<DBConnection> takeIdle();
+
     DBConnectionPool() = default;
     ~DBConnectionPool();
 
@@ -100,14 +199,26 @@ namespace scheduler
     std::string database_;
     unsigned int port_;
 
-    size_t initialSize_;
-    size_t maxSize_;
-    size_t activeConnections_;
+    size_t initialSize_ = 0;
+    size_t maxSize_ = 0;
+    size_t activeConnections_ = 0; // 已借出的连接数
+    size_t totalConnections_ = 0;  // 已建立和正在建立的连接数
+
+    // 空闲检查阈值和最长存活时间，0表示不限制
+    std::chrono::milliseconds validateIdle_{30000};
+    std::chrono::seconds maxLifetime_{1800};
 
-    std::queue<std::shared_ptr<DBConnection>> connectionPool_;
+    std::deque<std::shared_ptr<DBConnection>> idle_;
     mutable std::mutex mutex_;
     std::condition_variable condition_;
-    bool shutdown_;
+    bool shutdown_ = false;
+
+    std::atomic<uint64_t> acquisitions_{0};
+    std::atomic<uint64_t> timeouts_{0};
+    std::atomic<uint64_t> waitTimeTotalUs_{0};
+    std::atomic<uint64_t> waitTimeMaxUs_{0};
+    std::atomic<uint64_t> validations_{0};
+    std::atomic<uint64_t> recycled_{0};
   };
 
 } // namespace scheduler
\ No newline at end of file
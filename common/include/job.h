@@ -13,6 +13,12 @@ namespace scheduler
     PERIODIC // 周期性任务
   };
 
+  enum class JobExecType
+  {
+    SHELL,         // shell命令
+    SHARED_LIBRARY // 共享库中的函数（进程内执行）
+  };
+
   enum class JobStatus
   {
     WAITING, // 等待执行
@@ -22,6 +28,13 @@ namespace scheduler
     TIMEOUT  // 执行超时
   };
 
+  enum class PayloadCodec
+  {
+    NONE, // 未压缩
+    LZ4,  // LZ4
+    ZSTD  // Zstandard
+  };
+
   struct JobInfo
   {
     std::string job_id;          // 任务ID
@@ -33,6 +46,13 @@ namespace scheduler
     int timeout;                 // 超时时间（秒）
     int retry_count;             // 重试次数
     int retry_interval;          // 重试间隔（秒）
+    int cpu_weight = 0;          // cgroup CPU权重（1-10000，0表示不限制）
+    int64_t memory_limit_mb = 0; // cgroup内存上限（MB，0表示不限制）
+    bool use_warm_pool = false;  // 是否在预热工作进程中执行（适用于短任务）
+    JobExecType exec_type = JobExecType::SHELL; // 执行方式
+    std::string library_path;                   // 共享库路径（SHARED_LIBRARY）
+    std::string entry_symbol;                   // 入口函数名（SHARED_LIBRARY），command作为参数
+    uint64_t execution_id = 0;                  // 派发时创建的执行记录ID，结果按此ID回写
 
     // 序列化为JSON
     nlohmann::json to_json() const;
@@ -44,12 +64,20 @@ namespace scheduler
   {
     std::string job_id;
     uint64_t execution_id = 0; // 执行ID
+    std::string executor_id;   // 执行该任务的执行器ID
     JobStatus status;
     std::string output; // 执行输出
     std::string error;  // 错误信息
+    PayloadCodec payload_codec = PayloadCodec::NONE; // output和error的压缩格式
     std::chrono::system_clock::time_point start_time;
     std::chrono::system_clock::time_point end_time;
 
+    // 资源使用统计（来自cgroup或wait4 rusage）
+    uint64_t cpu_time_ms = 0;    // CPU时间（毫秒，用户态+内核态）
+    uint64_t peak_rss_kb = 0;    // 峰值内存（KB）
+    uint64_t io_read_bytes = 0;  // 读取字节数
+    uint64_t io_write_bytes = 0; // 写入字节数
+
     nlohmann::json to_json() const;
     static JobResult from_json(const nlohmann::json &j);
   };
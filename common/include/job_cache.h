@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <optional>
+#include <chrono>
+#include "job.h"
+
+namespace scheduler
+{
+
+  // 任务定义缓存状态
+  struct JobCacheStats
+  {
+    size_t size = 0;            // 当前缓存的任务数
+    size_t capacity = 0;        // 最大缓存的任务数
+    size_t shards = 0;          // 分片数
+    uint64_t hits = 0;          // 命中次数
+    uint64_t misses = 0;        // 未命中次数（含已过期）
+    uint64_t evictions = 0;     // 容量已满时淘汰的条目数
+    uint64_t invalidations = 0; // 任务修改或删除时失效的条目数
+
+    double getHitRate() const
+    {
+      uint64_t lookups = hits + misses;
+      return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+    }
+  };
+
+  /**
+   * @brief 任务定义的分片LRU缓存
+   *
+   * 按job_id的哈希分片，每个分片一把锁，容量平均分给各分片，分片满时淘汰最久未访问的条目。
+   * 条目超过ttl后视为未命中，用于限制其他节点修改任务后本节点读到旧定义的时间。
+   * 读穿透时先取version()再查库，put()发现期间该分片有过失效则丢弃，
+   * 避免查库和修改并发时把修改前的定义写回缓存。capacity为0时不缓存。
+   */
+  class JobCache
+  {
+  public:
+    JobCache(size_t capacity, size_t shards, std::chrono::milliseconds ttl);
+
+    JobCache(const JobCache &) = delete;
+    JobCache &operator=(const JobCache &) = delete;
+
+    bool enabled() const { return capacity_ > 0; }
+
+    std::optional<JobInfo> get(const std::string &jobId);
+
+    // 查库前取得所在分片的失效版本
+    uint64_t version(const std::string &jobId) const;
+
+    // 分片的失效版本仍为version时才写入
+    void put(const JobInfo &job, uint64_t version);
+
+    void invalidate(const std::string &jobId);
+    void clear();
+
+    JobCacheStats getStats() const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+      JobInfo job;
+      Clock::time_point expires_at;
+    };
+
+    struct Shard
+    {
+      mutable std::mutex mutex;
+      std::list<Entry> lru; // 表头为最近访问的条目
+      std::unordered_map<std::string, std::list<Entry>::iterator> index;
+      uint64_t version = 0; // 每次失效加1
+    };
+
+    Shard &shardFor(const std::string &jobId) const;
+
+    size_t capacity_;
+    size_t shardCapacity_;
+    std::chrono::milliseconds ttl_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<uint64_t> invalidations_{0};
+  };
+
+} // namespace scheduler
@@ -4,8 +4,12 @@
 #include <vector>
 #include <memory>
 #include <optional>
+#include <future>
+#include <functional>
 #include "job.h"
 #include "db_connection_pool.h"
+#include "async_query_engine.h"
+#include "job_cache.h"
 
 namespace scheduler
 {
@@ -21,6 +25,14 @@ namespace scheduler
     std::chrono::system_clock::time_point last_heartbeat;
   };
 
+  // 执行器负载和任务计数的增量
+  struct ExecutorCounterDelta
+  {
+    std::string executor_id;
+    int load_delta = 0;
+    uint64_t tasks_executed = 0;
+  };
+
   class JobDAO
   {
   public:
@@ -31,29 +43,59 @@ namespace scheduler
     bool saveJob(const JobInfo &job);
     bool updateJob(const JobInfo &job);
     bool deleteJob(const std::string &jobId);
-    std::optional<JobInfo> getJob(const std::string &jobId);
+    // useCache为false时绕过任务定义缓存直接查库，用于取消、重新派发等依据任务定义做决定的路径
+    std::optional<JobInfo> getJob(const std::string &jobId, bool useCache = true);
     std::vector<JobInfo> getAllJobs(int offset = 0, int limit = 100);
     std::vector<JobInfo> getPendingJobs(int limit = 100);
     std::vector<JobInfo> getJobsByType(JobType type, int offset = 0, int limit = 100);
     int getJobCount();
 
     // 任务执行记录相关操作
-    bool saveExecution(const std::string &jobId, const std::string &executorId = "");
+    // 返回新执行记录的ID，失败返回0
+    uint64_t saveExecution(const std::string &jobId, const std::string &executorId = "");
+    // 删除任务未能发出的执行记录
+    bool deleteExecution(uint64_t executionId);
     bool updateExecutionStatus(uint64_t executionId, JobStatus status);
+    // 批量更新执行状态，每条语句最多kMaxBatchRows条。只更新仍为WAITING/RUNNING的执行记录，
+    // 延迟写入的状态不会覆盖已经写入的执行结果；首次变为RUNNING时记下开始时间
+    bool updateExecutionStatuses(const std::vector<std::pair<uint64_t, JobStatus>> &statuses);
     bool updateExecutionResult(uint64_t executionId, JobStatus status,
                                const std::string &output, const std::string &error);
+    bool updateExecutionResourceUsage(uint64_t executionId, const JobResult &result);
+    // 批量更新执行结果和资源使用，在一个事务中完成。只更新仍为WAITING/RUNNING的执行记录，
+    // 实际更新的执行ID写入applied，并发处理同一执行的多条结果时只有一条生效
+    bool updateExecutionResults(const std::vector<std::pair<uint64_t, JobResult>> &results,
+                                std::vector<uint64_t> *applied = nullptr);
     bool updateExecutionTimes(uint64_t executionId,
                               const std::chrono::system_clock::time_point &startTime,
                               const std::chrono::system_clock::time_point &endTime);
     std::vector<JobResult> getJobExecutions(const std::string &jobId, int offset = 0, int limit = 10);
     std::optional<JobResult> getExecution(uint64_t executionId);
+    // 获取执行器上尚未结束的执行记录（WAITING/RUNNING）
+    std::vector<JobResult> getInFlightExecutions(const std::string &executorId);
     std::vector<JobResult> getRecentExecutions(int limit = 100);
     int getExecutionCount(const std::string &jobId);
 
+    // 热点写操作的异步版本，在AsyncQueryEngine上执行，不占用调用线程，返回的future可以丢弃；
+    // 引擎未启动时同步执行
+    // 写入完成后以新执行记录的ID（失败为0）回调，回调在事件循环线程中执行，不应阻塞。
+    // 插入带客户端生成的派发令牌，失败（包括超时后结果未知）时以同一令牌幂等重试，
+    // 已提交的插入返回原执行ID；重试用尽后按令牌删除可能已提交的记录，不留下孤立的WAITING记录
+    void saveExecutionAsync(const std::string &jobId, const std::string &executorId,
+                            std::function<void(uint64_t)> onSaved);
+    std::future<bool> deleteExecutionAsync(uint64_t executionId);
+    // 按执行ID、任务ID和执行器ID带status IN ('WAITING','RUNNING')条件写入执行结果，
+    // 完成后以写入是否生效回调，结果需带execution_id和executor_id
+    void updateExecutionResultAsync(const JobResult &result, std::function<void(bool)> onDone);
+
     // 执行器节点相关操作
     bool registerExecutor(const std::string &executorId, const std::string &host, int port, int maxLoad = 10);
     bool updateExecutorStatus(const std::string &executorId, bool online);
+    // 标记执行器为排空中，选择执行器时不再选中
+    bool markExecutorDraining(const std::string &executorId);
     bool updateExecutorHeartbeat(const std::string &executorId);
+    // 批量刷新执行器心跳时间，一条UPDATE语句完成
+    bool updateExecutorHeartbeats(const std::vector<std::string> &executorIds);
     std::vector<std::pair<std::string, std::string>> getOnlineExecutors();
 
     // 新增：获取详细的执行器信息列表
@@ -64,6 +106,13 @@ namespace scheduler
     bool decrementExecutorLoad(const std::string &executorId);
     bool updateExecutorMaxLoad(const std::string &executorId, int maxLoad);
     bool incrementExecutorTaskCount(const std::string &executorId);
+    // 批量累加执行器负载和任务计数，负载不低于0，每条语句最多kMaxBatchRows个执行器，全部在一个事务中写入。
+    // 截断使负载增减的写入顺序有关：减量先于对应的增量写入时被截断掉，之后的增量使负载一直偏高，
+    // 调用方需保证一次派发的增量不晚于它的减量写入
+    bool updateExecutorCounters(const std::vector<ExecutorCounterDelta> &deltas);
+    // 按未结束的执行记录（WAITING/RUNNING）重新计算所有执行器的current_load，
+    // 校正崩溃时缓冲中丢失的负载增量
+    bool recomputeExecutorLoads();
 
     // 新增：获取单个执行器信息
     std::optional<ExecutorInfo> getExecutorInfo(const std::string &executorId);
@@ -80,21 +129,22 @@ namespace scheduler
     // 清理过期数据
     int cleanupExpiredExecutions(int days);
 
-  private:
-    // 时间点转换为MySQL时间戳字符串
-    std::string timePointToString(const std::chrono::system_clock::time_point &timePoint);
+    // 批量语句每条最多处理的行数
+    static constexpr size_t kMaxBatchRows = 256;
 
-    // MySQL时间戳字符串转换为时间点
-    std::chrono::system_clock::time_point stringToTimePoint(const std::string &timeStr);
+    // 进程内所有JobDAO共用的任务定义缓存，getJob读穿透，saveJob、updateJob、deleteJob时失效。
+    // 只在本进程内失效，其他节点的修改要等条目过期才可见
+    static JobCache &jobCache();
 
-    // 从结果集构建JobInfo对象
-    JobInfo buildJobInfoFromResult(MYSQL_RES *result);
+  private:
+    // 从预处理语句的当前行构建JobInfo对象
+    JobInfo buildJobInfo(const PreparedStatement &stmt);
 
-    // 从结果集构建JobResult对象
-    JobResult buildJobResultFromResult(MYSQL_RES *result);
+    // 从预处理语句的当前行构建JobResult对象
+    JobResult buildJobResult(const PreparedStatement &stmt);
 
-    // 从结果集构建ExecutorInfo对象
-    ExecutorInfo buildExecutorInfoFromResult(MYSQL_RES *result);
+    // 从预处理语句的当前行构建ExecutorInfo对象
+    ExecutorInfo buildExecutorInfo(const PreparedStatement &stmt);
   };
 
 } // namespace scheduler
\ No newline at end of file
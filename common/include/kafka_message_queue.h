@@ -2,6 +2,8 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <set>
 #include <memory>
 #include <functional>
 #include <thread>
@@ -9,82 +11,126 @@
 #include <mutex>
 #include <condition_variable>
 #include <librdkafka/rdkafkacpp.h>
-#include "job.h"
+#include "message_transport.h"
+#include "message_buffer_pool.h"
+#include "offset_tracker.h"
+#include "consumer_worker_pool.h"
 
 namespace scheduler
 {
 
-  // Kafka消息类型
-  enum class MessageType
-  {
-    JOB_SUBMIT,        // 任务提交
-    JOB_CANCEL,        // 任务取消
-    JOB_RESULT,        // 任务结果
-    EXECUTOR_HEARTBEAT // 执行器心跳
-  };
-
-  // Kafka消息
-  struct KafkaMessage
-  {
-    MessageType type;
-    std::string payload;
-    std::string key;
-
-    KafkaMessage() = default;
-    KafkaMessage(MessageType t, const std::string &p, const std::string &k = "")
-        : type(t), payload(p), key(k) {}
-  };
-
-  // 消息回调接口
-  using MessageCallback = std::function<void(const KafkaMessage &)>;
+  class RebalanceHandler;
 
   // Kafka消息队列类
-  class KafkaMessageQueue
+  class KafkaMessageQueue : public MessageTransport
   {
   public:
     KafkaMessageQueue();
-    ~KafkaMessageQueue();
+    ~KafkaMessageQueue() override;
 
-    // 初始化生产者
-    bool initProducer(const std::string &brokers);
+    bool initProducer(const std::string &brokers) override;
 
-    // 初始化消费者
     bool initConsumer(const std::string &brokers,
                       const std::string &groupId,
                       const std::vector<std::string> &topics,
-                      MessageCallback callback);
+                      MessageCallback callback,
+                      const std::string &offsetReset = "earliest") override;
+
+    // 默认在消费线程中逐条处理。消息按键（无键时按分区）固定分配到一个工作线程；
+    // 工作线程队列达到queueCapacity时暂停对应分区，所有队列回落到一半以下后恢复
+    void setConsumerWorkers(size_t workers, size_t queueCapacity) override;
 
-    // 发送消息
-    bool sendMessage(const std::string &topic, const KafkaMessage &message);
+    // onDelivery在收到传递报告后调用（在生产者轮询线程中）
+    bool sendMessage(const std::string &topic, const KafkaMessage &message,
+                     DeliveryCallback onDelivery = nullptr) override;
 
-    // 发送任务
-    bool sendJob(const std::string &topic, const JobInfo &job);
+    bool sendJob(const std::string &topic, const JobInfo &job, const std::string &executorId = "") override;
 
-    // 发送任务结果
-    bool sendJobResult(const std::string &topic, const JobResult &result);
+    bool sendJobResult(const std::string &topic, const JobResult &result,
+                       DeliveryCallback onDelivery = nullptr) override;
 
-    // 开始消费消息
-    bool startConsume();
+    bool sendJobResults(const std::string &topic, const std::vector<JobResult> &results,
+                        DeliveryCallback onDelivery = nullptr) override;
 
-    // 停止消费消息
-    void stopConsume();
+    bool startConsume() override;
 
-    // 检查生产者状态
-    bool isProducerReady() const;
+    void stopConsume() override;
 
-    // 检查消费者状态
-    bool isConsumerReady() const;
+    bool waitForAssignment(int timeoutMs) override;
+
+    bool isProducerReady() const override;
+
+    bool isConsumerReady() const override;
 
   private:
+    friend class RebalanceHandler;
+
+    // 分区分配变更
+    void onAssignment(const std::vector<RdKafka::TopicPartition *> &partitions, bool assigned);
+
+    // 结果消息的键
+    static std::string resultKey(const JobResult &result);
+
     // 消息类型转换为字符串
     std::string messageTypeToString(MessageType type);
 
     // 字符串转换为消息类型
     MessageType stringToMessageType(const std::string &typeStr);
 
+    // 待处理的消息及其偏移量
+    struct PendingMessage
+    {
+      KafkaMessage message;
+      std::string topic;
+      int32_t partition = 0;
+      int64_t offset = 0;
+    };
+
     // 消费线程函数
     void consumeThread();
 
+    // 解析一条消息并分发
+    void handleMessage(RdKafka::Message &msg);
+
+    // 分发到工作线程，未启用工作线程时直接处理
+    void dispatch(PendingMessage pending);
+
+    // 暂停或恢复消费这些分区
+    void pausePartitions(const std::vector<TopicPartitionKey> &partitions, bool pause);
+
+    // 调用消息回调并标记偏移量已处理
+    void process(PendingMessage &pending);
+
+    // 等待工作线程处理完已分发的消息
+    void waitForWorkers();
+
+    // 处理完队列中的消息后停止工作线程
+    void stopWorkers();
+
+    // 提交已处理完的偏移量；sync为true时同步提交所有分区的当前位置，用于分区收回和停止消费
+    void commitOffsets(bool sync);
+
+    // 生产者轮询线程函数，处理传递报告
+    void pollThread();
+
+    // 发送已序列化到buffer中的消息体，接管buffer，传递报告后（或发送失败时）归还缓冲池
+    bool produce(const std::string &topic, MessageType type, WireFormat format, const std::string &key,
+                 const std::map<std::string, std::string> &headers, ProduceBuffer *buffer,
+                 DeliveryCallback onDelivery);
+
+    // 缓冲池中保留的空闲缓冲区数，以及单个缓冲区保留的最大容量
+    static constexpr size_t kBufferPoolSize = 1024;
+    static constexpr size_t kMaxPooledBufferBytes = 1 << 20;
+
+    // 本地发送队列已满时的最长等待时间
+    static constexpr int kQueueFullWaitMs = 1000;
+
+    // 消费线程每轮最多取出的消息数
+    static constexpr size_t kConsumeBatchSize = 500;
+
+    // 发送时使用的消息体编码
+    WireFormat wireFormat_;
+
     // Kafka配置
     std::unique_ptr<RdKafka::Conf> producerConf_;
     std::unique_ptr<RdKafka::Conf> consumerConf_;
@@ -97,12 +143,33 @@ namespace scheduler
     std::thread consumeThread_;
     std::atomic<bool> running_;
 
+    // 生产者轮询线程
+    std::thread pollThread_;
+    std::atomic<bool> pollRunning_;
+
+    // 发送缓冲池，析构时先清空并销毁生产者再销毁缓冲池
+    MessageBufferPool bufferPool_;
+
     // 消息回调
     MessageCallback messageCallback_;
 
     // 消费的主题
     std::vector<std::string> topics_;
 
+    // 工作线程数及每个线程的队列容量，工作线程池在开始消费时创建
+    size_t workerCount_;
+    size_t workerQueueCapacity_;
+    std::unique_ptr<ConsumerWorkerPool> workers_;
+
+    // 已处理消息的偏移量，按时间间隔或完成条数批量提交
+    OffsetTracker offsetTracker_;
+    int commitIntervalMs_;
+    size_t commitBatchSize_;
+
+    // 分区分配回调及当前已分配的主题
+    std::unique_ptr<RebalanceHandler> rebalanceCb_;
+    std::set<std::string> assignedTopics_;
+
     // 互斥锁和条件变量，用于安全停止消费线程
     std::mutex mutex_;
     std::condition_variable condition_;
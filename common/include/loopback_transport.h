@@ -0,0 +1,130 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "message_transport.h"
+
+namespace scheduler
+{
+
+  /**
+   * @brief 进程内消息代理
+   *
+   * 每个主题是一段只追加的消息日志，每个消费组记录自己的读取位置：
+   * 不同消费组各自读到全部消息，同一消费组的多个消费者从同一位置取消息，互不重复。
+   * 所有消费组都读过的消息从日志中删除，没有消费组的主题最多保留kMaxRetained条。
+   */
+  class LoopbackBroker
+  {
+  public:
+    static LoopbackBroker &getInstance();
+
+    // 发布消息
+    void publish(const std::string &topic, KafkaMessage message);
+
+    // 加入消费组，消费组首次出现时从最早保留的消息（earliest）或当前末尾开始
+    void subscribe(const std::string &topic, const std::string &group, bool fromEarliest);
+
+    // 取出消费组的下一批消息，没有消息时最多等待timeoutMs，返回取出的条数
+    size_t poll(const std::string &topic, const std::string &group, int timeoutMs,
+                size_t maxMessages, std::vector<KafkaMessage> &out);
+
+  private:
+    struct Topic
+    {
+      std::deque<KafkaMessage> log;
+      uint64_t base = 0;                     // log中第一条消息的偏移量
+      std::map<std::string, uint64_t> groups; // 各消费组下一条待读取的偏移量
+      std::mutex mutex;
+      std::condition_variable condition;
+    };
+
+    Topic &topic(const std::string &name);
+
+    // 删除所有消费组都已读取的消息，调用方持有topic.mutex
+    static void trim(Topic &topic);
+
+    static constexpr size_t kMaxRetained = 100000;
+
+    std::map<std::string, std::unique_ptr<Topic>> topics_;
+    std::mutex mutex_;
+  };
+
+  /**
+   * @brief 进程内回环传输
+   *
+   * 通过LoopbackBroker在同一进程的调度器和执行器之间传递消息，不经过网络，
+   * 用于测试、延迟基准和单进程部署。消息在内存中，进程退出后丢失；
+   * 每个订阅主题一个消费线程，setConsumerWorkers不生效。
+   */
+  class LoopbackTransport : public MessageTransport
+  {
+  public:
+    explicit LoopbackTransport(LoopbackBroker &broker = LoopbackBroker::getInstance());
+    ~LoopbackTransport() override;
+
+    bool initProducer(const std::string &brokers) override;
+
+    bool initConsumer(const std::string &brokers,
+                      const std::string &groupId,
+                      const std::vector<std::string> &topics,
+                      MessageCallback callback,
+                      const std::string &offsetReset = "earliest") override;
+
+    void setConsumerWorkers(size_t workers, size_t queueCapacity) override;
+
+    // onDelivery在写入代理后立即在调用线程中调用
+    bool sendMessage(const std::string &topic, const KafkaMessage &message,
+                     DeliveryCallback onDelivery = nullptr) override;
+
+    bool sendJob(const std::string &topic, const JobInfo &job, const std::string &executorId = "") override;
+
+    bool sendJobResult(const std::string &topic, const JobResult &result,
+                       DeliveryCallback onDelivery = nullptr) override;
+
+    bool sendJobResults(const std::string &topic, const std::vector<JobResult> &results,
+                        DeliveryCallback onDelivery = nullptr) override;
+
+    bool startConsume() override;
+
+    void stopConsume() override;
+
+    // 订阅在startConsume时立即生效，无需等待
+    bool waitForAssignment(int timeoutMs) override;
+
+    bool isProducerReady() const override;
+
+    bool isConsumerReady() const override;
+
+  private:
+    // 写入代理并调用传递回调
+    bool publish(const std::string &topic, KafkaMessage message, DeliveryCallback onDelivery);
+
+    // 消费线程函数，每个主题一个
+    void consumeThread(const std::string &topic);
+
+    // 消费线程每轮最多取出的消息数
+    static constexpr size_t kConsumeBatchSize = 500;
+
+    LoopbackBroker &broker_;
+    bool producerReady_;
+
+    // 消费组、订阅的主题和回调
+    std::string groupId_;
+    std::vector<std::string> topics_;
+    MessageCallback messageCallback_;
+    bool fromEarliest_;
+
+    // 消费线程
+    std::vector<std::thread> consumeThreads_;
+    std::atomic<bool> running_;
+  };
+
+} // namespace scheduler
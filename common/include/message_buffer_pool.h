@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+
+namespace scheduler
+{
+
+  class MessageBufferPool;
+
+  // 一条待发送消息的缓冲区，在传递报告回调后归还缓冲池
+  struct ProduceBuffer
+  {
+    std::string data;                     // 消息体，发送期间由librdkafka直接引用
+    std::function<void(bool)> onDelivery; // 传递报告回调
+    MessageBufferPool *pool = nullptr;    // 所属缓冲池
+  };
+
+  /**
+   * @brief 发送缓冲区池
+   *
+   * 消息直接序列化到缓冲区中，以不复制的方式交给librdkafka，
+   * 收到传递报告后清空并放回池中，保留已分配的容量供下一条消息使用。
+   * 稳定运行时发送路径不再为消息体分配内存。
+   */
+  class MessageBufferPool
+  {
+  public:
+    /**
+     * @param max_buffers 池中最多保留的空闲缓冲区数
+     * @param max_buffer_bytes 容量超过该值的缓冲区归还时直接释放，避免偶发的大消息长期占用内存
+     */
+    MessageBufferPool(size_t max_buffers, size_t max_buffer_bytes);
+
+    // 取出一个空缓冲区，池为空时新建
+    ProduceBuffer *acquire();
+
+    // 归还缓冲区
+    void release(ProduceBuffer *buffer);
+
+    // 当前空闲缓冲区数
+    size_t idle() const;
+
+  private:
+    size_t max_buffers_;
+    size_t max_buffer_bytes_;
+    std::vector<std::unique_ptr<ProduceBuffer>> buffers_;
+    mutable std::mutex mutex_;
+  };
+
+} // namespace scheduler
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+#include "job.h"
+#include "wire_codec.h"
+
+namespace scheduler
+{
+
+  // Kafka消息类型
+  enum class MessageType
+  {
+    JOB_SUBMIT,        // 任务提交
+    JOB_CANCEL,        // 任务取消
+    JOB_RESULT,        // 任务结果
+    EXECUTOR_HEARTBEAT, // 执行器心跳
+    WORK_REQUEST,       // 执行器申请任务（拉取模式）
+    JOB_RESULT_BATCH,   // 批量任务结果
+    EXECUTOR_DRAIN,     // 调度器要求执行器排空
+    JOB_RETURN          // 执行器排空时退回的任务
+  };
+
+  // Kafka消息
+  struct KafkaMessage
+  {
+    MessageType type;
+    std::string payload;
+    std::string key;
+    std::map<std::string, std::string> headers; // 消息头，例如目标执行器ID
+    WireFormat format = WireFormat::JSON;        // 任务和任务结果消息体的编码方式
+
+    KafkaMessage() = default;
+    KafkaMessage(MessageType t, const std::string &p, const std::string &k = "")
+        : type(t), payload(p), key(k) {}
+  };
+
+  // 消息回调接口
+  using MessageCallback = std::function<void(const KafkaMessage &)>;
+
+  // 传递报告回调，delivered表示broker已确认写入
+  using DeliveryCallback = std::function<void(bool delivered)>;
+
+  // 消息头：任务的目标执行器ID
+  constexpr const char *kExecutorIdHeader = "executor_id";
+
+  // 消息头：消息类型和消息体编码，二进制格式下消息体不再包一层JSON
+  constexpr const char *kMessageTypeHeader = "type";
+  constexpr const char *kWireFormatHeader = "format";
+
+  // 消息头：执行器心跳中上报的任务消费者积压
+  constexpr const char *kConsumerLagHeader = "consumer_lag";
+
+  /**
+   * @brief 调度器和执行器之间的消息传输接口
+   *
+   * 按主题发布消息，按消费组订阅：不同消费组各自收到主题中的全部消息，
+   * 同一消费组内的消费者分摊消息。实现有Kafka（KafkaMessageQueue）和进程内回环（LoopbackTransport）。
+   */
+  class MessageTransport
+  {
+  public:
+    virtual ~MessageTransport() = default;
+
+    // 初始化生产者
+    virtual bool initProducer(const std::string &brokers) = 0;
+
+    // 初始化消费者，offsetReset为新消费者组的起始位置（earliest/latest）
+    virtual bool initConsumer(const std::string &brokers,
+                              const std::string &groupId,
+                              const std::vector<std::string> &topics,
+                              MessageCallback callback,
+                              const std::string &offsetReset = "earliest") = 0;
+
+    // 使用多个工作线程处理消息，需在startConsume前调用，同一消息键的消息保持顺序
+    virtual void setConsumerWorkers(size_t workers, size_t queueCapacity) = 0;
+
+    // 发送消息，onDelivery非空时在消息写入后调用
+    virtual bool sendMessage(const std::string &topic, const KafkaMessage &message,
+                             DeliveryCallback onDelivery = nullptr) = 0;
+
+    // 发送任务，executorId非空时写入消息头供执行器过滤
+    virtual bool sendJob(const std::string &topic, const JobInfo &job, const std::string &executorId = "") = 0;
+
+    // 发送任务结果
+    virtual bool sendJobResult(const std::string &topic, const JobResult &result,
+                               DeliveryCallback onDelivery = nullptr) = 0;
+
+    // 批量发送任务结果，合并为一条消息
+    virtual bool sendJobResults(const std::string &topic, const std::vector<JobResult> &results,
+                                DeliveryCallback onDelivery = nullptr) = 0;
+
+    // 开始消费消息
+    virtual bool startConsume() = 0;
+
+    // 停止消费消息
+    virtual void stopConsume() = 0;
+
+    // 等待所有订阅主题都分配到分区，用于latest起始位置下避免丢失注册后立即到达的消息
+    virtual bool waitForAssignment(int timeoutMs) = 0;
+
+    // 检查生产者状态
+    virtual bool isProducerReady() const = 0;
+
+    // 检查消费者状态
+    virtual bool isConsumerReady() const = 0;
+
+    // 按消息编码解析任务，失败返回false
+    static bool parseJob(const KafkaMessage &message, JobInfo &job);
+
+    // 按消息编码解析JOB_RESULT或JOB_RESULT_BATCH消息中的任务结果，失败返回false
+    static bool parseJobResults(const KafkaMessage &message, std::vector<JobResult> &results);
+
+    // 执行器专属的任务主题，例如 job-submit.<executor_id>
+    static std::string executorTopic(const std::string &baseTopic, const std::string &executorId);
+  };
+
+  // 消息传输工厂
+  class MessageTransportFactory
+  {
+  public:
+    // type为kafka或loopback，无法识别时使用kafka
+    static std::unique_ptr<MessageTransport> create(const std::string &type);
+  };
+
+} // namespace scheduler
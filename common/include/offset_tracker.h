@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <mutex>
+#include <cstdint>
+#include <utility>
+
+namespace scheduler
+{
+
+  // 一个分区待提交的偏移量，offset为下一条待消费消息的偏移量
+  struct PartitionOffset
+  {
+    std::string topic;
+    int32_t partition;
+    int64_t offset;
+  };
+
+  /**
+   * @brief 消费偏移量跟踪
+   *
+   * 收到消息时登记偏移量，处理完成后标记完成。每个分区的提交位置为最小的未完成偏移量，
+   * 没有未完成的消息时为已登记的最大偏移量加一。消息可以乱序完成，
+   * 提交位置只在之前的消息全部完成后才前进，崩溃重启后不会跳过未处理的消息。
+   */
+  class OffsetTracker
+  {
+  public:
+    // 收到消息，偏移量需按分区递增登记
+    void track(const std::string &topic, int32_t partition, int64_t offset);
+
+    // 消息处理完成
+    void complete(const std::string &topic, int32_t partition, int64_t offset);
+
+    // 取出自上次取出后提交位置前进的分区
+    std::vector<PartitionOffset> takeCommittable();
+
+    // 所有分区当前的提交位置，用于分区收回和停止消费时同步提交
+    std::vector<PartitionOffset> watermarks() const;
+
+    // 上次取出后完成的消息数
+    size_t completedSinceTake() const;
+
+    // 分区收回后丢弃全部状态
+    void clear();
+
+  private:
+    struct PartitionState
+    {
+      std::set<int64_t> inFlight; // 已登记未完成的偏移量
+      int64_t next = -1;          // 已登记的最大偏移量加一
+      int64_t committed = -1;     // 上次取出的提交位置
+
+      int64_t watermark() const
+      {
+        return inFlight.empty() ? next : *inFlight.begin();
+      }
+    };
+
+    std::map<std::pair<std::string, int32_t>, PartitionState> partitions_;
+    size_t completed_ = 0;
+    mutable std::mutex mutex_;
+  };
+
+} // namespace scheduler
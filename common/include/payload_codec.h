@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include "job.h"
+
+namespace scheduler
+{
+
+  /**
+   * @brief 任务输出的压缩和编码
+   *
+   * 压缩后的格式为4字节小端原始长度加压缩数据，空字符串不压缩。
+   * LZ4始终可用；ZSTD需要编译时启用HAVE_ZSTD。
+   * 压缩后的JobResult在JSON中以base64传输，在数据库中以BLOB保存，
+   * 只在API返回给用户时解压。
+   */
+  class PayloadCompressor
+  {
+  public:
+    // 压缩格式名称，与数据库和消息中的payload_codec一致
+    static std::string codecToString(PayloadCodec codec);
+
+    // 解析压缩格式名称（不区分大小写），无法识别返回false
+    static bool codecFromString(const std::string &name, PayloadCodec &codec);
+
+    // 当前构建是否支持该压缩格式
+    static bool isSupported(PayloadCodec codec);
+
+    // 压缩，失败返回false
+    static bool compress(PayloadCodec codec, const std::string &input, std::string &output);
+
+    // 解压，数据损坏或格式不支持返回false
+    static bool decompress(PayloadCodec codec, const std::string &input, std::string &output);
+
+    /**
+     * @brief 压缩任务结果的output和error
+     * @param result 未压缩的任务结果
+     * @param codec 压缩格式
+     * @param min_bytes output和error总长度小于该值时不压缩
+     * @return 是否已压缩；压缩后没有变小时保持原样
+     */
+    static bool compressResult(JobResult &result, PayloadCodec codec, size_t min_bytes);
+
+    // 解压任务结果的output和error，失败时保持原样并返回false
+    static bool decompressResult(JobResult &result);
+
+    static std::string base64Encode(const std::string &input);
+
+    // 输入不是合法base64时返回false
+    static bool base64Decode(const std::string &input, std::string &output);
+  };
+
+} // namespace scheduler
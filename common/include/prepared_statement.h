@@ -0,0 +1,117 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <mysql/mysql.h>
+
+namespace scheduler
+{
+
+  // MYSQL_BIND中的标志类型，MySQL 8.0起为bool，MariaDB和旧版本为my_bool
+  using BindFlag = std::remove_pointer_t<decltype(MYSQL_BIND::is_null)>;
+
+  /**
+   * @brief 预处理语句（mysql_stmt_*）
+   *
+   * SQL只在服务端解析一次，参数按类型绑定，不需要转义，结果集按二进制协议读取。
+   * 由DBConnection按SQL缓存，参数和结果缓冲区在多次执行之间复用。
+   * 参数下标和列下标都从0开始。
+   */
+  class PreparedStatement
+  {
+  public:
+    PreparedStatement(MYSQL *mysql, const std::string &sql);
+    ~PreparedStatement();
+
+    PreparedStatement(const PreparedStatement &) = delete;
+    PreparedStatement &operator=(const PreparedStatement &) = delete;
+
+    // 准备成功且连接未断开
+    bool isValid() const { return stmt_ != nullptr && !broken_; }
+
+    const std::string &sql() const { return sql_; }
+
+    // 绑定参数，execute前需绑定全部参数，绑定值在多次执行之间保留
+    void bindString(size_t index, const std::string &value);
+    // 按二进制绑定，不做字符集转换，用于压缩后的输出等BLOB列
+    void bindBlob(size_t index, const std::string &value);
+    void bindInt(size_t index, int64_t value);
+    void bindUInt(size_t index, uint64_t value);
+    void bindTime(size_t index, const std::chrono::system_clock::time_point &value);
+    void bindNull(size_t index);
+
+    // 空字符串绑定为NULL
+    void bindOptionalString(size_t index, const std::string &value);
+
+    // 执行语句，查询语句的结果集缓存到客户端，之后用fetch逐行读取
+    bool execute();
+
+    // 读取下一行，没有更多行或出错时返回false
+    bool fetch();
+
+    // 结果集行数、受影响的行数和自增ID
+    uint64_t rowCount() const;
+    uint64_t affectedRows() const;
+    uint64_t insertId() const;
+
+    // 读取当前行的列值
+    bool isNull(size_t column) const;
+    std::string getString(size_t column) const;
+    int64_t getInt(size_t column) const;
+    uint64_t getUInt(size_t column) const;
+    std::chrono::system_clock::time_point getTime(size_t column) const;
+
+    // 时间点与MYSQL_TIME之间按本地时间转换，精度为微秒
+    static MYSQL_TIME toMysqlTime(const std::chrono::system_clock::time_point &timePoint);
+    static std::chrono::system_clock::time_point fromMysqlTime(const MYSQL_TIME &time);
+
+    // count个以逗号分隔的占位符，用于IN列表
+    static std::string placeholders(size_t count);
+
+  private:
+    // 参数值，bind时指向这里的缓冲区
+    struct Param
+    {
+      enum_field_types type = MYSQL_TYPE_NULL;
+      std::string text;
+      int64_t number = 0;
+      MYSQL_TIME time{};
+      unsigned long length = 0;
+      BindFlag isNull = 1;
+      bool isUnsigned = false;
+    };
+
+    // 结果列，整数和时间按原类型读取，其他列读取为字节串
+    struct Column
+    {
+      enum_field_types type = MYSQL_TYPE_STRING;
+      std::vector<char> buffer;
+      int64_t number = 0;
+      MYSQL_TIME time{};
+      unsigned long length = 0;
+      BindFlag isNull = 0;
+      BindFlag error = 0;
+    };
+
+    // 读取结果集的列定义并分配缓冲区
+    void prepareColumns();
+    void bindColumns();
+
+    // 执行失败时判断连接是否已断开，断开后语句句柄失效
+    void checkBroken();
+
+    MYSQL_STMT *stmt_;
+    std::string sql_;
+    bool broken_;
+    bool hasResult_;
+
+    std::vector<Param> params_;
+    std::vector<MYSQL_BIND> paramBinds_;
+    std::vector<Column> columns_;
+    std::vector<MYSQL_BIND> columnBinds_;
+  };
+
+} // namespace scheduler
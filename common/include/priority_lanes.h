@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace scheduler
+{
+
+  // 一个优先级通道，优先级不低于min_priority的任务进入该通道
+  struct PriorityLane
+  {
+    std::string name;
+    int min_priority;
+    int weight; // 执行器按权重从各通道取任务
+  };
+
+  /**
+   * @brief 任务优先级通道
+   *
+   * 每个通道对应一个独立的任务主题，高优先级任务不会排在低优先级任务的积压之后。
+   * 配置格式为"名称:最低优先级:权重"，以逗号分隔，例如"high:50:8,normal:0:4,bulk:-100:1"。
+   * 低于所有通道下限的任务进入最低的通道。默认优先级0所在的通道沿用原来的主题名，
+   * 未配置通道时只有这一个通道。
+   */
+  class PriorityLanes
+  {
+  public:
+    // 单个默认通道
+    PriorityLanes();
+
+    // 解析通道配置，格式错误时返回false并保持原配置
+    bool parse(const std::string &spec);
+
+    const std::vector<PriorityLane> &lanes() const { return lanes_; }
+
+    // 任务优先级所属的通道下标，通道按最低优先级从高到低排列
+    size_t laneFor(int priority) const;
+
+    // 通道的执行器任务主题，例如 job-submit-high.<executor_id>
+    std::string topic(const std::string &baseTopic, size_t lane, const std::string &executorId) const;
+
+    // 执行器需要订阅的全部通道主题
+    std::vector<std::string> topics(const std::string &baseTopic, const std::string &executorId) const;
+
+  private:
+    std::vector<PriorityLane> lanes_;
+  };
+
+  /**
+   * @brief 按权重在各通道之间轮询（平滑加权轮询）
+   *
+   * 只在有任务的通道之间分配，空通道不占份额；权重8:4:1时，
+   * 三个通道都有积压的情况下每13次选择中分别选中8、4、1次，且交错分布。
+   */
+  class LaneSelector
+  {
+  public:
+    explicit LaneSelector(const std::vector<PriorityLane> &lanes);
+
+    // 选择下一个通道，backlog为各通道的排队数，全部为空时返回-1
+    int next(const std::vector<size_t> &backlog);
+
+  private:
+    std::vector<int> weights_;
+    std::vector<int64_t> current_;
+  };
+
+} // namespace scheduler
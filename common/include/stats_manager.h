@@ -9,6 +9,7 @@
 #include <memory>
 #include "job.h"
 #include "job_dao.h"
+#include "transport_stats.h"
 
 namespace scheduler
 {
@@ -38,6 +39,12 @@ namespace scheduler
     // 重试统计
     std::atomic<uint64_t> retry_count{0}; // 重试次数
 
+    // 资源使用统计
+    std::atomic<uint64_t> total_cpu_time{0};   // 总CPU时间(毫秒)
+    std::atomic<uint64_t> max_peak_rss{0};     // 最大峰值内存(KB)
+    std::atomic<uint64_t> total_io_read{0};    // 总读取字节数
+    std::atomic<uint64_t> total_io_write{0};   // 总写入字节数
+
     // 计算平均执行时间
     uint64_t getAvgExecutionTime() const
     {
@@ -60,6 +67,10 @@ namespace scheduler
       min_execution_time = UINT64_MAX;
       max_execution_time = 0;
       retry_count = 0;
+      total_cpu_time = 0;
+      max_peak_rss = 0;
+      total_io_read = 0;
+      total_io_write = 0;
     }
   };
 
@@ -89,6 +100,12 @@ namespace scheduler
     // 重试统计
     uint64_t retry_count{0}; // 重试次数
 
+    // 资源使用统计
+    uint64_t total_cpu_time{0}; // 总CPU时间(毫秒)
+    uint64_t max_peak_rss{0};   // 最大峰值内存(KB)
+    uint64_t total_io_read{0};  // 总读取字节数
+    uint64_t total_io_write{0}; // 总写入字节数
+
     // 计算平均执行时间
     uint64_t getAvgExecutionTime() const
     {
@@ -106,6 +123,11 @@ namespace scheduler
     std::atomic<uint64_t> db_query_time{0};      // 数据库查询总时间(毫秒)
     std::atomic<uint64_t> kafka_msg_sent{0};     // Kafka消息发送数
     std::atomic<uint64_t> kafka_msg_received{0}; // Kafka消息接收数
+    std::atomic<uint64_t> kafka_delivery_failed{0}; // Kafka消息传递失败数
+    std::atomic<uint64_t> kafka_delivered{0};       // Kafka消息传递成功数
+    std::atomic<uint64_t> kafka_delivery_latency_us{0};     // Kafka消息传递总延迟(微秒)
+    std::atomic<uint64_t> kafka_delivery_latency_max_us{0}; // Kafka消息最大传递延迟(微秒)
+    std::atomic<uint64_t> kafka_errors{0};          // Kafka客户端错误数（连接、消费错误等）
     std::atomic<uint64_t> scheduler_cycles{0};   // 调度周期数
 
     // 计算平均数据库查询时间
@@ -114,6 +136,12 @@ namespace scheduler
       return db_query_count > 0 ? db_query_time / db_query_count : 0;
     }
 
+    // 计算平均传递延迟
+    uint64_t getAvgDeliveryLatency() const
+    {
+      return kafka_delivered > 0 ? kafka_delivery_latency_us / kafka_delivered : 0;
+    }
+
     // 重置统计信息
     void reset()
     {
@@ -122,6 +150,11 @@ namespace scheduler
       db_query_time = 0;
       kafka_msg_sent = 0;
       kafka_msg_received = 0;
+      kafka_delivery_failed = 0;
+      kafka_delivered = 0;
+      kafka_delivery_latency_us = 0;
+      kafka_delivery_latency_max_us = 0;
+      kafka_errors = 0;
       scheduler_cycles = 0;
     }
   };
@@ -136,6 +169,11 @@ namespace scheduler
     uint64_t db_query_time{0};      // 数据库查询总时间(毫秒)
     uint64_t kafka_msg_sent{0};     // Kafka消息发送数
     uint64_t kafka_msg_received{0}; // Kafka消息接收数
+    uint64_t kafka_delivery_failed{0}; // Kafka消息传递失败数
+    uint64_t kafka_delivered{0};       // Kafka消息传递成功数
+    uint64_t kafka_delivery_latency_us{0};     // Kafka消息传递总延迟(微秒)
+    uint64_t kafka_delivery_latency_max_us{0}; // Kafka消息最大传递延迟(微秒)
+    uint64_t kafka_errors{0};          // Kafka客户端错误数（连接、消费错误等）
     uint64_t scheduler_cycles{0};   // 调度周期数
 
     // 计算平均数据库查询时间
@@ -143,6 +181,12 @@ namespace scheduler
     {
       return db_query_count > 0 ? db_query_time / db_query_count : 0;
     }
+
+    // 计算平均传递延迟
+    uint64_t getAvgDeliveryLatency() const
+    {
+      return kafka_delivered > 0 ? kafka_delivery_latency_us / kafka_delivered : 0;
+    }
   };
 
   /**
@@ -157,6 +201,7 @@ namespace scheduler
     uint64_t total_tasks_executed{0};                     // 已执行任务总数
     std::chrono::system_clock::time_point last_heartbeat; // 最后心跳时间
     bool is_online{false};                                // 是否在线
+    int64_t consumer_lag{-1};                             // 任务消费者积压的消息数，随心跳上报，未知为-1
 
     // 计算负载比例
     float getLoadRatio() const
@@ -215,6 +260,35 @@ namespace scheduler
      */
     void addKafkaMessage(bool sent);
 
+    /**
+     * @brief 增加Kafka消息传递失败计数（传递报告返回错误）
+     */
+    void addKafkaDeliveryFailure();
+
+    /**
+     * @brief 记录一条消息从发送到broker确认的延迟
+     * @param latencyUs 传递延迟(微秒)
+     */
+    void addKafkaDeliveryLatency(uint64_t latencyUs);
+
+    /**
+     * @brief 增加Kafka客户端错误计数
+     */
+    void addKafkaError();
+
+    /**
+     * @brief 更新一个Kafka客户端的运行状态（librdkafka统计回调）
+     * @param stats 客户端运行状态
+     */
+    void updateTransportStats(const TransportStats &stats);
+
+    /**
+     * @brief 更新执行器上报的任务消费者积压
+     * @param executorId 执行器ID
+     * @param lag 积压的消息数
+     */
+    void updateExecutorConsumerLag(const std::string &executorId, int64_t lag);
+
     /**
      * @brief 增加调度周期计数
      */
@@ -238,6 +312,12 @@ namespace scheduler
      */
     SystemStats getSystemStats() const;
 
+    /**
+     * @brief 获取本进程各Kafka客户端的运行状态
+     * @return 客户端运行状态列表
+     */
+    std::vector<TransportStats> getTransportStats() const;
+
     /**
      * @brief 重置所有统计信息
      */
@@ -278,6 +358,10 @@ namespace scheduler
     // 系统性能统计信息
     SystemStatsAtomic systemStats_;
 
+    // Kafka客户端运行状态，按客户端名称索引
+    std::map<std::string, TransportStats> transportStats_;
+    mutable std::mutex transportStatsMutex_;
+
     // 启动时间
     std::chrono::system_clock::time_point startTime_;
   };
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <nlohmann/json.hpp>
+
+namespace scheduler
+{
+
+  // 消费者在一个分区上的进度
+  struct PartitionLag
+  {
+    std::string topic;
+    int32_t partition = 0;
+    int64_t committed_offset = -1; // 已提交的偏移量，未提交过为-1
+    int64_t high_watermark = -1;   // 分区末尾的偏移量
+    int64_t lag = -1;              // 尚未消费的消息数，未知为-1
+  };
+
+  /**
+   * @brief 一个Kafka客户端（生产者或消费者）的运行状态
+   *
+   * 来自librdkafka按statistics.interval.ms定期回调的统计JSON。
+   */
+  struct TransportStats
+  {
+    std::string name;                 // 客户端名称，消费者为"<group.id>#consumer-N"
+    std::string type;                 // producer或consumer
+    uint64_t produce_queue_depth = 0; // 本地发送队列中的消息数
+    uint64_t produce_queue_bytes = 0; // 本地发送队列中的字节数
+    uint64_t broker_errors = 0;       // 与broker之间的收发错误和请求超时累计数
+    uint64_t broker_rtt_avg_us = 0;   // broker请求往返时间的平均值（微秒），取最慢的broker
+    std::vector<PartitionLag> partitions;
+    std::chrono::system_clock::time_point updated_at;
+
+    // 所有分区的积压消息总数，忽略未知的分区
+    int64_t totalLag() const;
+
+    nlohmann::json to_json() const;
+  };
+
+  // 解析librdkafka的统计JSON，失败返回false
+  bool parseKafkaStatistics(const std::string &json, TransportStats &stats);
+
+} // namespace scheduler
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "job.h"
+
+namespace scheduler
+{
+
+  // Kafka消息体的编码方式
+  enum class WireFormat
+  {
+    JSON,  // JSON文本，便于调试
+    BINARY // 二进制编码
+  };
+
+  /**
+   * @brief 任务和任务结果的二进制编码
+   *
+   * 消息以1字节格式版本开头，之后按固定顺序写入各字段：
+   * 整数和枚举使用varint（有符号数先zigzag），字符串为varint长度加原始字节，
+   * 时间为Unix毫秒。批量结果先写条数，每条结果带长度前缀。
+   *
+   * 新字段只追加在末尾，解码时忽略末尾无法识别的字节，旧版本可以读取新版本的消息；
+   * 不兼容的修改需要提升kVersion。
+   */
+  class WireCodec
+  {
+  public:
+    static constexpr uint8_t kVersion = 1;
+
+    static std::string encodeJob(const JobInfo &job);
+    static bool decodeJob(const std::string &data, JobInfo &job);
+
+    static std::string encodeResult(const JobResult &result);
+    static bool decodeResult(const std::string &data, JobResult &result);
+
+    static std::string encodeResults(const std::vector<JobResult> &results);
+    static bool decodeResults(const std::string &data, std::vector<JobResult> &results);
+
+    // 编码追加到out末尾，用于直接写入发送缓冲区
+    static void encodeJob(const JobInfo &job, std::string &out);
+    static void encodeResult(const JobResult &result, std::string &out);
+    static void encodeResults(const std::vector<JobResult> &results, std::string &out);
+
+    static std::string formatToString(WireFormat format);
+
+    // 无法识别时返回false
+    static bool formatFromString(const std::string &name, WireFormat &format);
+  };
+
+} // namespace scheduler
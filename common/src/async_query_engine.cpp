@@ -0,0 +1,744 @@
+#include "async_query_engine.h"
+#include "prepared_statement.h"
+#include "config_manager.h"
+#include "stats_manager.h"
+#include <spdlog/spdlog.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// 按客户端库选择非阻塞接口
+#if defined(MYSQL_WAIT_READ)
+// MariaDB：mysql_*_start/_cont，返回需要等待的读写事件
+#define SCHEDULER_DB_ASYNC_MARIADB 1
+#elif defined(MYSQL_VERSION_ID) && MYSQL_VERSION_ID >= 80016
+// MySQL 8.0.16起：mysql_*_nonblocking，以相同参数重复调用直到完成
+#define SCHEDULER_DB_ASYNC_MYSQL 1
+#endif
+
+namespace scheduler
+{
+
+  namespace
+  {
+    using Clock = std::chrono::steady_clock;
+
+#if defined(SCHEDULER_DB_ASYNC_MYSQL)
+    // mysql_*_nonblocking不区分等待读还是等待写，发送较大的语句时按这个间隔重试
+    constexpr int kRetryIntervalMs = 10;
+#endif
+
+    struct Task
+    {
+      AsyncStatement statement;
+      AsyncQueryCallback callback;
+    };
+
+    // 事件循环持有的一个连接，同一时间只执行一条语句
+    struct Slot
+    {
+      MYSQL *mysql = nullptr;
+      bool busy = false;
+      std::unique_ptr<Task> task;
+      std::string query;
+      int error = 0;                         // 语句执行结果，非0为失败
+      short events = 0;                      // 等待的poll事件
+      Clock::time_point startedAt;
+      Clock::time_point deadline;            // 超过后关闭连接，语句按超时失败
+      Clock::time_point wakeAt = Clock::time_point::max(); // 客户端库要求的超时唤醒
+    };
+
+    int socketOf(MYSQL *mysql)
+    {
+#if defined(SCHEDULER_DB_ASYNC_MARIADB)
+      return mysql_get_socket(mysql);
+#elif defined(SCHEDULER_DB_ASYNC_MYSQL)
+      return mysql->net.fd;
+#else
+      (void)mysql;
+      return -1;
+#endif
+    }
+
+#if defined(SCHEDULER_DB_ASYNC_MARIADB)
+    // 记录客户端库要求等待的事件，status为0表示已完成
+    bool awaitStatus(Slot &slot, int status)
+    {
+      if (status == 0)
+      {
+        return true;
+      }
+      slot.events = 0;
+      if (status & MYSQL_WAIT_READ)
+      {
+        slot.events |= POLLIN;
+      }
+      if (status & MYSQL_WAIT_WRITE)
+      {
+        slot.events |= POLLOUT;
+      }
+      if (status & MYSQL_WAIT_EXCEPT)
+      {
+        slot.events |= POLLPRI;
+      }
+      slot.wakeAt = (status & MYSQL_WAIT_TIMEOUT)
+                        ? Clock::now() + std::chrono::milliseconds(mysql_get_timeout_value_ms(slot.mysql))
+                        : Clock::time_point::max();
+      return false;
+    }
+#endif
+
+    // 开始执行，已完成时返回true，结果记录在slot.error中
+    bool beginQuery(Slot &slot)
+    {
+#if defined(SCHEDULER_DB_ASYNC_MARIADB)
+      int status = mysql_real_query_start(&slot.error, slot.mysql, slot.query.data(), slot.query.size());
+      return awaitStatus(slot, status);
+#elif defined(SCHEDULER_DB_ASYNC_MYSQL)
+      net_async_status status = mysql_real_query_nonblocking(slot.mysql, slot.query.data(), slot.query.size());
+      if (status == NET_ASYNC_NOT_READY)
+      {
+        slot.events = POLLIN;
+        return false;
+      }
+      slot.error = status == NET_ASYNC_ERROR ? 1 : 0;
+      return true;
+#else
+      slot.error = mysql_real_query(slot.mysql, slot.query.data(), slot.query.size());
+      return true;
+#endif
+    }
+
+    // 推进执行中的语句，revents为poll返回的事件
+    bool continueQuery(Slot &slot, short revents, Clock::time_point now)
+    {
+#if defined(SCHEDULER_DB_ASYNC_MARIADB)
+      int ready = 0;
+      if (revents & (POLLIN | POLLHUP | POLLERR))
+      {
+        ready |= MYSQL_WAIT_READ;
+      }
+      if (revents & POLLOUT)
+      {
+        ready |= MYSQL_WAIT_WRITE;
+      }
+      if (revents & POLLPRI)
+      {
+        ready |= MYSQL_WAIT_EXCEPT;
+      }
+      if (now >= slot.wakeAt)
+      {
+        ready |= MYSQL_WAIT_TIMEOUT;
+      }
+      if (ready == 0)
+      {
+        return false;
+      }
+      int status = mysql_real_query_cont(&slot.error, slot.mysql, ready);
+      return awaitStatus(slot, status);
+#elif defined(SCHEDULER_DB_ASYNC_MYSQL)
+      (void)revents;
+      (void)now;
+      return beginQuery(slot);
+#else
+      // 阻塞执行时beginQuery已经完成，不会走到这里
+      (void)slot;
+      (void)revents;
+      (void)now;
+      return true;
+#endif
+    }
+
+    void closeSlot(Slot &slot, std::atomic<size_t> &connections)
+    {
+      if (slot.mysql)
+      {
+        mysql_close(slot.mysql);
+        slot.mysql = nullptr;
+        connections--;
+      }
+    }
+
+    std::string hex(const std::string &value)
+    {
+      static const char digits[] = "0123456789ABCDEF";
+      std::string result;
+      result.reserve(value.size() * 2);
+      for (unsigned char c : value)
+      {
+        result += digits[c >> 4];
+        result += digits[c & 0x0F];
+      }
+      return result;
+    }
+  } // namespace
+
+  // AsyncStatement 实现
+  AsyncStatement::AsyncStatement(std::string sql)
+      : sql_(std::move(sql))
+  {
+  }
+
+  AsyncStatement::Param &AsyncStatement::param(size_t index)
+  {
+    if (params_.size() <= index)
+    {
+      params_.resize(index + 1);
+    }
+    return params_[index];
+  }
+
+  void AsyncStatement::bindString(size_t index, const std::string &value)
+  {
+    Param &p = param(index);
+    p.kind = ParamKind::String;
+    p.value = value;
+  }
+
+  void AsyncStatement::bindBlob(size_t index, const std::string &value)
+  {
+    Param &p = param(index);
+    p.kind = ParamKind::Blob;
+    p.value = value;
+  }
+
+  void AsyncStatement::bindInt(size_t index, int64_t value)
+  {
+    Param &p = param(index);
+    p.kind = ParamKind::Literal;
+    p.value = std::to_string(value);
+  }
+
+  void AsyncStatement::bindUInt(size_t index, uint64_t value)
+  {
+    Param &p = param(index);
+    p.kind = ParamKind::Literal;
+    p.value = std::to_string(value);
+  }
+
+  void AsyncStatement::bindTime(size_t index, const std::chrono::system_clock::time_point &value)
+  {
+    MYSQL_TIME time = PreparedStatement::toMysqlTime(value);
+    char buffer[40];
+    std::snprintf(buffer, sizeof(buffer), "'%04u-%02u-%02u %02u:%02u:%02u.%06lu'",
+                  time.year, time.month, time.day, time.hour, time.minute, time.second,
+                  static_cast<unsigned long>(time.second_part));
+
+    Param &p = param(index);
+    p.kind = ParamKind::Literal;
+    p.value = buffer;
+  }
+
+  void AsyncStatement::bindNull(size_t index)
+  {
+    Param &p = param(index);
+    p.kind = ParamKind::Null;
+    p.value.clear();
+  }
+
+  void AsyncStatement::bindOptionalString(size_t index, const std::string &value)
+  {
+    if (value.empty())
+    {
+      bindNull(index);
+    }
+    else
+    {
+      bindString(index, value);
+    }
+  }
+
+  std::string AsyncStatement::render(MYSQL *mysql) const
+  {
+    std::string result;
+    result.reserve(sql_.size() + params_.size() * 16);
+
+    size_t index = 0;
+    char quote = 0;
+    bool escaped = false;
+    for (char c : sql_)
+    {
+      // 引号内的问号不是占位符
+      if (quote != 0)
+      {
+        result += c;
+        if (escaped)
+        {
+          escaped = false;
+        }
+        else if (c == '\\')
+        {
+          escaped = true;
+        }
+        else if (c == quote)
+        {
+          quote = 0;
+        }
+        continue;
+      }
+      if (c == '\'' || c == '"' || c == '`')
+      {
+        quote = c;
+        result += c;
+        continue;
+      }
+      if (c != '?')
+      {
+        result += c;
+        continue;
+      }
+
+      if (index >= params_.size())
+      {
+        return "";
+      }
+      const Param &p = params_[index++];
+      switch (p.kind)
+      {
+      case ParamKind::Null:
+        result += "NULL";
+        break;
+      case ParamKind::Literal:
+        result += p.value;
+        break;
+      case ParamKind::Blob:
+        result += "X'" + hex(p.value) + "'";
+        break;
+      case ParamKind::String:
+      {
+        std::string buffer(p.value.size() * 2 + 1, '\0');
+        unsigned long length = mysql_real_escape_string(mysql, &buffer[0], p.value.data(), p.value.size());
+        buffer.resize(length);
+        result += '\'';
+        result += buffer;
+        result += '\'';
+        break;
+      }
+      }
+    }
+
+    return index == params_.size() ? result : "";
+  }
+
+  // 一个事件循环线程及其连接
+  struct AsyncQueryEngine::Loop
+  {
+    std::thread thread;
+    int wakeFd = -1;
+    std::mutex mutex;
+    std::deque<std::unique_ptr<Task>> pending;
+    bool stopping = false;
+    std::vector<Slot> slots;
+  };
+
+  // AsyncQueryEngine 实现
+  AsyncQueryEngine &AsyncQueryEngine::getInstance()
+  {
+    static AsyncQueryEngine instance;
+    return instance;
+  }
+
+  AsyncQueryEngine::~AsyncQueryEngine()
+  {
+    shutdown();
+  }
+
+  bool AsyncQueryEngine::nonBlockingSupported()
+  {
+#if defined(SCHEDULER_DB_ASYNC_MARIADB) || defined(SCHEDULER_DB_ASYNC_MYSQL)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  bool AsyncQueryEngine::initialize()
+  {
+    auto &config = ConfigManager::getInstance();
+    int threads = config.getInt("db.async.threads", 2);
+    int connectionsPerThread = config.getInt("db.async.connections_per_thread", 4);
+    if (threads <= 0)
+    {
+      spdlog::info("Async query engine disabled");
+      return false;
+    }
+    return initialize(threads, std::max(1, connectionsPerThread));
+  }
+
+  bool AsyncQueryEngine::initialize(size_t threads, size_t connectionsPerThread)
+  {
+    std::unique_lock<std::shared_mutex> lock(lifecycleMutex_);
+    if (running_)
+    {
+      return true;
+    }
+
+    auto &config = ConfigManager::getInstance();
+    auto [host, user, password, database, port] = config.getDBConnectionInfo();
+    host_ = host;
+    user_ = user;
+    password_ = password;
+    database_ = database;
+    port_ = port;
+    queryTimeout_ = std::chrono::milliseconds(std::max(1, config.getInt("db.async.query_timeout_ms", 30000)));
+
+    loops_.clear();
+    for (size_t i = 0; i < threads; ++i)
+    {
+      auto loop = std::make_unique<Loop>();
+      loop->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      if (loop->wakeFd < 0)
+      {
+        spdlog::error("Failed to create eventfd for async query engine: {}", std::strerror(errno));
+        for (auto &created : loops_)
+        {
+          close(created->wakeFd);
+        }
+        loops_.clear();
+        return false;
+      }
+      loop->slots.resize(connectionsPerThread);
+      loops_.push_back(std::move(loop));
+    }
+
+    running_ = true;
+    for (auto &loop : loops_)
+    {
+      Loop *raw = loop.get();
+      loop->thread = std::thread([this, raw]()
+                                 { run(*raw); });
+    }
+
+    spdlog::info("Async query engine started with {} threads x {} connections ({})",
+                 threads, connectionsPerThread, nonBlockingSupported() ? "non-blocking" : "blocking fallback");
+    return true;
+  }
+
+  void AsyncQueryEngine::shutdown()
+  {
+    {
+      std::unique_lock<std::shared_mutex> lock(lifecycleMutex_);
+      if (!running_)
+      {
+        return;
+      }
+      // 之后提交的语句直接失败，事件循环执行完已提交的语句后退出
+      running_ = false;
+      for (auto &loop : loops_)
+      {
+        std::lock_guard<std::mutex> loopLock(loop->mutex);
+        loop->stopping = true;
+      }
+    }
+
+    for (auto &loop : loops_)
+    {
+      uint64_t one = 1;
+      ssize_t written = write(loop->wakeFd, &one, sizeof(one));
+      (void)written;
+    }
+    for (auto &loop : loops_)
+    {
+      if (loop->thread.joinable())
+      {
+        loop->thread.join();
+      }
+      for (auto &slot : loop->slots)
+      {
+        closeSlot(slot, connections_);
+      }
+      close(loop->wakeFd);
+      loop->wakeFd = -1;
+    }
+    spdlog::info("Async query engine stopped");
+  }
+
+  bool AsyncQueryEngine::submit(AsyncStatement statement, AsyncQueryCallback callback)
+  {
+    {
+      std::shared_lock<std::shared_mutex> lock(lifecycleMutex_);
+      if (running_ && !loops_.empty())
+      {
+        Loop &loop = *loops_[nextLoop_++ % loops_.size()];
+        {
+          std::lock_guard<std::mutex> loopLock(loop.mutex);
+          loop.pending.push_back(std::make_unique<Task>(Task{std::move(statement), std::move(callback)}));
+        }
+        submitted_++;
+        uint64_t one = 1;
+        ssize_t written = write(loop.wakeFd, &one, sizeof(one));
+        (void)written;
+        return true;
+      }
+    }
+
+    AsyncQueryResult result;
+    result.error = "async query engine is not running";
+    if (callback)
+    {
+      callback(result);
+    }
+    return false;
+  }
+
+  std::future<AsyncQueryResult> AsyncQueryEngine::submit(AsyncStatement statement)
+  {
+    auto promise = std::make_shared<std::promise<AsyncQueryResult>>();
+    auto future = promise->get_future();
+    submit(std::move(statement), [promise](const AsyncQueryResult &result)
+           { promise->set_value(result); });
+    return future;
+  }
+
+  AsyncQueryStats AsyncQueryEngine::getStats() const
+  {
+    AsyncQueryStats stats;
+    std::shared_lock<std::shared_mutex> lock(lifecycleMutex_);
+    stats.running = running_;
+    stats.non_blocking = nonBlockingSupported();
+    stats.threads = running_ ? loops_.size() : 0;
+    for (const auto &loop : loops_)
+    {
+      std::lock_guard<std::mutex> loopLock(loop->mutex);
+      stats.queued += loop->pending.size();
+    }
+    stats.connections = connections_;
+    stats.in_flight = inFlight_;
+    stats.submitted = submitted_;
+    stats.completed = completed_;
+    stats.failed = failed_;
+    return stats;
+  }
+
+  void AsyncQueryEngine::run(Loop &loop)
+  {
+    // 结束一条语句并回调，result为空时从连接读取结果
+    auto finish = [this](Slot &slot, AsyncQueryResult result)
+    {
+      auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - slot.startedAt).count();
+      StatsManager::getInstance().addDbQuery(duration);
+
+      if (result.success)
+      {
+        completed_++;
+      }
+      else
+      {
+        failed_++;
+        spdlog::error("Async query failed: {}, sql: {}", result.error, slot.task->statement.sql());
+      }
+
+      std::unique_ptr<Task> task = std::move(slot.task);
+      slot.busy = false;
+      slot.query.clear();
+      inFlight_--;
+
+      if (task->callback)
+      {
+        try
+        {
+          task->callback(result);
+        }
+        catch (const std::exception &e)
+        {
+          spdlog::error("Async query callback threw: {}", e.what());
+        }
+      }
+    };
+
+    auto complete = [this, &finish](Slot &slot)
+    {
+      AsyncQueryResult result;
+      if (slot.error == 0)
+      {
+        result.success = true;
+        // 写语句没有结果集，误用于查询时丢弃结果集，连接才能继续使用
+        if (mysql_field_count(slot.mysql) > 0)
+        {
+          MYSQL_RES *res = mysql_store_result(slot.mysql);
+          if (res)
+          {
+            mysql_free_result(res);
+          }
+        }
+        result.affected_rows = mysql_affected_rows(slot.mysql);
+        result.insert_id = mysql_insert_id(slot.mysql);
+      }
+      else
+      {
+        result.error = mysql_error(slot.mysql);
+        // 2000-2999为客户端错误，连接已不可用，下次使用时重新建立
+        unsigned int err = mysql_errno(slot.mysql);
+        if (err >= 2000 && err < 3000)
+        {
+          closeSlot(slot, connections_);
+        }
+      }
+      finish(slot, std::move(result));
+    };
+
+    // 连接在首次使用或断开后重新建立，期间会阻塞本线程上的其他连接
+    auto connect = [this](Slot &slot)
+    {
+      slot.mysql = mysql_init(nullptr);
+      if (!slot.mysql)
+      {
+        return false;
+      }
+      int timeout = 5;
+      mysql_options(slot.mysql, MYSQL_OPT_CONNECT_TIMEOUT, &timeout);
+#if defined(SCHEDULER_DB_ASYNC_MARIADB)
+      mysql_options(slot.mysql, MYSQL_OPT_NONBLOCK, 0);
+#endif
+      if (!mysql_real_connect(slot.mysql, host_.c_str(), user_.c_str(), password_.c_str(),
+                              database_.c_str(), port_, nullptr, 0))
+      {
+        spdlog::error("Async query engine failed to connect to MySQL: {}", mysql_error(slot.mysql));
+        mysql_close(slot.mysql);
+        slot.mysql = nullptr;
+        return false;
+      }
+      mysql_set_character_set(slot.mysql, "utf8mb4");
+      connections_++;
+      return true;
+    };
+
+    std::vector<pollfd> fds;
+    std::vector<Slot *> polled;
+    std::vector<std::unique_ptr<Task>> tasks;
+
+    while (true)
+    {
+      // 把排队的语句分给空闲连接
+      bool stopping = false;
+      bool backlog = false;
+      {
+        std::lock_guard<std::mutex> lock(loop.mutex);
+        size_t idle = std::count_if(loop.slots.begin(), loop.slots.end(), [](const Slot &slot)
+                                    { return !slot.busy; });
+        while (idle-- > 0 && !loop.pending.empty())
+        {
+          tasks.push_back(std::move(loop.pending.front()));
+          loop.pending.pop_front();
+        }
+        backlog = !loop.pending.empty();
+        stopping = loop.stopping && !backlog;
+      }
+
+      for (auto &task : tasks)
+      {
+        Slot &slot = *std::find_if(loop.slots.begin(), loop.slots.end(), [](const Slot &s)
+                                   { return !s.busy; });
+        slot.busy = true;
+        slot.task = std::move(task);
+        slot.startedAt = Clock::now();
+        slot.deadline = slot.startedAt + queryTimeout_;
+        slot.wakeAt = Clock::time_point::max();
+        inFlight_++;
+
+        if (!slot.mysql && !connect(slot))
+        {
+          AsyncQueryResult result;
+          result.error = "failed to connect to database";
+          finish(slot, std::move(result));
+          continue;
+        }
+
+        slot.query = slot.task->statement.render(slot.mysql);
+        if (slot.query.empty())
+        {
+          AsyncQueryResult result;
+          result.error = "parameter count does not match placeholders";
+          finish(slot, std::move(result));
+          continue;
+        }
+
+        if (beginQuery(slot))
+        {
+          complete(slot);
+        }
+      }
+      tasks.clear();
+
+      size_t busy = std::count_if(loop.slots.begin(), loop.slots.end(), [](const Slot &slot)
+                                  { return slot.busy; });
+      if (stopping && busy == 0)
+      {
+        break;
+      }
+
+      // 等待唤醒或任意连接就绪
+      fds.clear();
+      polled.clear();
+      fds.push_back({loop.wakeFd, POLLIN, 0});
+      auto now = Clock::now();
+      auto wakeAt = Clock::time_point::max();
+      for (auto &slot : loop.slots)
+      {
+        if (!slot.busy)
+        {
+          continue;
+        }
+        fds.push_back({socketOf(slot.mysql), slot.events, 0});
+        polled.push_back(&slot);
+        wakeAt = std::min({wakeAt, slot.deadline, slot.wakeAt});
+      }
+
+      int timeout = -1;
+      if (wakeAt != Clock::time_point::max())
+      {
+        timeout = static_cast<int>(std::max<long long>(
+            0, std::chrono::duration_cast<std::chrono::milliseconds>(wakeAt - now).count() + 1));
+      }
+      // 还有排队的语句且有空闲连接时不等待，唤醒通知可能已在上一轮读掉
+      if (backlog && busy < loop.slots.size())
+      {
+        timeout = 0;
+      }
+#if defined(SCHEDULER_DB_ASYNC_MYSQL)
+      else if (!polled.empty())
+      {
+        timeout = timeout < 0 ? kRetryIntervalMs : std::min(timeout, kRetryIntervalMs);
+      }
+#endif
+
+      if (poll(fds.data(), fds.size(), timeout) < 0 && errno != EINTR)
+      {
+        spdlog::error("Async query engine poll failed: {}", std::strerror(errno));
+      }
+      if (fds[0].revents & POLLIN)
+      {
+        uint64_t value;
+        ssize_t n = read(loop.wakeFd, &value, sizeof(value));
+        (void)n;
+      }
+
+      // 推进就绪的语句，超时的语句关闭连接后失败
+      now = Clock::now();
+      for (size_t i = 0; i < polled.size(); ++i)
+      {
+        Slot &slot = *polled[i];
+        if (now >= slot.deadline)
+        {
+          closeSlot(slot, connections_);
+          AsyncQueryResult result;
+          result.error = "query timed out";
+          finish(slot, std::move(result));
+          continue;
+        }
+        if (continueQuery(slot, fds[i + 1].revents, now))
+        {
+          complete(slot);
+        }
+      }
+    }
+  }
+
+} // namespace scheduler
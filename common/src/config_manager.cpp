@@ -115,6 +115,17 @@ namespace scheduler
     }
   }
 
+  std::map<std::string, std::string> ConfigManager::getWithPrefix(const std::string &prefix) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::string, std::string> result;
+    for (auto it = config_.lower_bound(prefix); it != config_.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+    {
+      result[it->first.substr(prefix.size())] = it->second;
+    }
+    return result;
+  }
+
   bool ConfigManager::getBool(const std::string &key, bool defaultValue) const
   {
     std::string value = getString(key);
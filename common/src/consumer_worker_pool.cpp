@@ -0,0 +1,163 @@
+#include "consumer_worker_pool.h"
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace scheduler
+{
+
+  ConsumerWorkerPool::ConsumerWorkerPool(size_t workers, size_t queueCapacity, PartitionCallback onPause,
+                                         PartitionCallback onResume)
+      : queueCapacity_(std::max<size_t>(queueCapacity, 1)), onPause_(std::move(onPause)),
+        onResume_(std::move(onResume))
+  {
+    for (size_t i = 0; i < workers; ++i)
+    {
+      workers_.push_back(std::make_unique<Worker>());
+      workers_.back()->thread = std::thread(&ConsumerWorkerPool::run, this, workers_.back().get());
+    }
+  }
+
+  ConsumerWorkerPool::~ConsumerWorkerPool()
+  {
+    stop();
+  }
+
+  size_t ConsumerWorkerPool::workerIndex(const std::string &key, const std::string &topic, int32_t partition,
+                                         size_t workers)
+  {
+    size_t hash = key.empty() ? std::hash<std::string>()(topic) ^ static_cast<size_t>(partition)
+                              : std::hash<std::string>()(key);
+    return hash % workers;
+  }
+
+  void ConsumerWorkerPool::submit(const std::string &key, const std::string &topic, int32_t partition,
+                                  std::function<void()> task)
+  {
+    // 没有工作线程时在调用线程中直接处理
+    if (workers_.empty())
+    {
+      task();
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(pendingMutex_);
+      pending_++;
+    }
+
+    Worker &worker = *workers_[workerIndex(key, topic, partition, workers_.size())];
+    size_t queued;
+    {
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      worker.queue.push_back(std::move(task));
+      queued = worker.queue.size();
+    }
+    worker.condition.notify_one();
+
+    // 队列已满时暂停该分区，已取到本地的消息仍照常分发
+    TopicPartitionKey partitionKey(topic, partition);
+    if (queued >= queueCapacity_ && paused_.insert(partitionKey).second && onPause_)
+    {
+      onPause_({partitionKey});
+    }
+  }
+
+  void ConsumerWorkerPool::resumePaused()
+  {
+    if (paused_.empty())
+    {
+      return;
+    }
+
+    // 所有工作线程队列回落到一半以下才恢复，避免频繁暂停和恢复
+    for (const auto &worker : workers_)
+    {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      if (worker->queue.size() > queueCapacity_ / 2)
+      {
+        return;
+      }
+    }
+
+    std::vector<TopicPartitionKey> partitions(paused_.begin(), paused_.end());
+    paused_.clear();
+    if (onResume_)
+    {
+      onResume_(partitions);
+    }
+  }
+
+  void ConsumerWorkerPool::clearPaused()
+  {
+    paused_.clear();
+  }
+
+  void ConsumerWorkerPool::waitIdle()
+  {
+    std::unique_lock<std::mutex> lock(pendingMutex_);
+    idle_.wait(lock, [this]
+               { return pending_ == 0; });
+  }
+
+  size_t ConsumerWorkerPool::pending() const
+  {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    return pending_;
+  }
+
+  void ConsumerWorkerPool::run(Worker *worker)
+  {
+    while (true)
+    {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(worker->mutex);
+        worker->condition.wait(lock, [worker]
+                               { return worker->stopping || !worker->queue.empty(); });
+        // 停止时先处理完队列中的消息
+        if (worker->queue.empty())
+        {
+          break;
+        }
+        task = std::move(worker->queue.front());
+        worker->queue.pop_front();
+      }
+
+      try
+      {
+        task();
+      }
+      catch (const std::exception &e)
+      {
+        spdlog::error("Consumer worker task failed: {}", e.what());
+      }
+
+      std::lock_guard<std::mutex> lock(pendingMutex_);
+      if (--pending_ == 0)
+      {
+        idle_.notify_all();
+      }
+    }
+  }
+
+  void ConsumerWorkerPool::stop()
+  {
+    for (auto &worker : workers_)
+    {
+      {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->stopping = true;
+      }
+      worker->condition.notify_all();
+    }
+    for (auto &worker : workers_)
+    {
+      if (worker->thread.joinable())
+      {
+        worker->thread.join();
+      }
+    }
+    workers_.clear();
+  }
+
+} // namespace scheduler
@@ -2,6 +2,7 @@
 #include "config_manager.h"
 #include "stats_manager.h"
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <chrono>
 
 namespace scheduler
@@ -14,7 +15,8 @@ namespace scheduler
                              const std::string &database,
                              unsigned int port)
       : host_(host), user_(user), password_(password), database_(database), port_(port),
-        mysql_(nullptr), connected_(false)
+        mysql_(nullptr), connected_(false), failed_(false), statementThreadId_(0),
+        statementCacheSize_(std::max(1, ConfigManager::getInstance().getInt("db.statement_cache_size", 64)))
   {
     mysql_ = mysql_init(nullptr);
   }
@@ -61,11 +63,15 @@ namespace scheduler
     mysql_set_character_set(mysql_, "utf8mb4");
 
     connected_ = true;
+    failed_ = false;
+    createdAt_ = std::chrono::steady_clock::now();
+    lastUsed_ = createdAt_;
     return true;
   }
 
   void DBConnection::disconnect()
   {
+    clearStatements();
     if (mysql_)
     {
       mysql_close(mysql_);
@@ -85,9 +91,31 @@ namespace scheduler
     return connected_ && (mysql_ping(mysql_) == 0);
   }
 
+  bool DBConnection::needsValidation() const
+  {
+    if (!connected_ || failed_)
+    {
+      return true;
+    }
+    // 预处理语句执行时发现连接断开
+    return std::any_of(statements_.begin(), statements_.end(), [](const auto &entry)
+                       { return !entry.second->isValid(); });
+  }
+
+  bool DBConnection::validate()
+  {
+    failed_ = false;
+    if (isConnected())
+    {
+      return true;
+    }
+    spdlog::warn("Database connection lost, reconnecting to {}:{}", host_, port_);
+    return reconnect();
+  }
+
   bool DBConnection::executeQuery(const std::string &query)
   {
-    if (!isConnected() && !reconnect())
+    if (!connected_ && !connect())
     {
       return false;
     }
@@ -107,6 +135,12 @@ namespace scheduler
     if (result != 0)
     {
       spdlog::error("Query execution failed: {}", mysql_error(mysql_));
+      // 2000-2999为客户端错误（连接断开、服务端已关闭等）
+      unsigned int err = mysql_errno(mysql_);
+      if (err >= 2000 && err < 3000)
+      {
+        failed_ = true;
+      }
       return false;
     }
 
@@ -133,6 +167,104 @@ namespace scheduler
     return mysql_store_result(mysql_);
   }
 
+  std::shared_ptr<PreparedStatement> DBConnection::prepare(const std::string &sql)
+  {
+    if (!connected_ && !connect())
+    {
+      return nullptr;
+    }
+
+    // 自动重连会换一个服务端线程，之前准备的语句全部失效
+    unsigned long threadId = mysql_thread_id(mysql_);
+    if (threadId != statementThreadId_)
+    {
+      clearStatements();
+      statementThreadId_ = threadId;
+    }
+
+    auto it = statements_.find(sql);
+    if (it != statements_.end())
+    {
+      if (it->second->isValid())
+      {
+        return it->second;
+      }
+      statements_.erase(it);
+    }
+
+    auto stmt = std::make_shared<PreparedStatement>(mysql_, sql);
+    if (!stmt->isValid())
+    {
+      return nullptr;
+    }
+
+    // 缓存满时随意淘汰一条，DAO中的语句是固定的，正常情况下不会触发
+    if (statements_.size() >= statementCacheSize_)
+    {
+      statements_.erase(statements_.begin());
+    }
+    statements_.emplace(sql, stmt);
+    return stmt;
+  }
+
+  void DBConnection::clearStatements()
+  {
+    statements_.clear();
+    statementThreadId_ = 0;
+  }
+
+  // ConnectionLease 实现
+  ConnectionLease::ConnectionLease(DBConnectionPool *pool, std::shared_ptr<DBConnection> conn)
+      : pool_(pool), conn_(std::move(conn))
+  {
+  }
+
+  ConnectionLease::~ConnectionLease()
+  {
+    release();
+  }
+
+  ConnectionLease::ConnectionLease(ConnectionLease &&other) noexcept
+      : pool_(other.pool_), conn_(std::move(other.conn_))
+  {
+    other.pool_ = nullptr;
+  }
+
+  ConnectionLease &ConnectionLease::operator=(ConnectionLease &&other) noexcept
+  {
+    if (this != &other)
+    {
+      release();
+      pool_ = other.pool_;
+      conn_ = std::move(other.conn_);
+      other.pool_ = nullptr;
+    }
+    return *this;
+  }
+
+  void ConnectionLease::release()
+  {
+    if (pool_ && conn_)
+    {
+      pool_->releaseConnection(std::move(conn_));
+    }
+    conn_.reset();
+    pool_ = nullptr;
+  }
+
+  namespace
+  {
+    // 当前线程上次使用的连接，借出时优先取回，服务端的语句缓存和缓冲区更可能是热的
+    thread_local std::weak_ptr<DBConnection> lastConnection;
+
+    uint64_t elapsedMicros(std::chrono::steady_clock::time_point since)
+    {
+      return std::chrono::duration_cast<std::chrono::microseconds>(
+                 std::chrono::steady_clock::now() - since)
+          .count();
+    }
+  } // namespace
+
   // DBConnectionPool 实现
   DBConnectionPool &DBConnectionPool::getInstance()
   {
@@ -156,6 +288,8 @@ namespace scheduler
                                     size_t initialSize,
                                     size_t maxSize)
   {
+    auto &config = ConfigManager::getInstance();
+
     std::lock_guard<std::mutex> lock(mutex_);
 
     host_ = host;
@@ -166,7 +300,10 @@ namespace scheduler
     initialSize_ = initialSize;
     maxSize_ = maxSize;
     activeConnections_ = 0;
+    totalConnections_ = 0;
     shutdown_ = false;
+    validateIdle_ = std::chrono::milliseconds(std::max(0, config.getInt("db.pool.validate_idle_ms", 30000)));
+    maxLifetime_ = std::chrono::seconds(std::max(0, config.getInt("db.pool.max_lifetime_s", 1800)));
 
     // 创建初始连接
     for (size_t i = 0; i < initialSize_; ++i)
@@ -174,12 +311,13 @@ namespace scheduler
       auto conn = createConnection();
       if (conn)
       {
-        connectionPool_.push(conn);
+        idle_.push_back(conn);
+        totalConnections_++;
       }
     }
 
-    spdlog::info("Database connection pool initialized with {} connections to {}@{}:{}/{}",
-                 connectionPool_.size(), user_, host_, port_, database_);
+    spdlog::info("Database connection pool initialized with {} connections to {}@{}:{}/{}, validate idle {}ms, max lifetime {}s",
+                 idle_.size(), user_, host_, port_, database_, validateIdle_.count(), maxLifetime_.count());
   }
 
   DBConnectionPool::~DBConnectionPool()
@@ -187,59 +325,102 @@ namespace scheduler
     shutdown();
   }
 
-  std::shared_ptr<DBConnection> DBConnectionPool::getConnection(unsigned int timeoutMs)
+  ConnectionLease DBConnectionPool::getConnection(unsigned int timeoutMs)
   {
-    std::unique_lock<std::mutex> lock(mutex_);
+    auto start = std::chrono::steady_clock::now();
+    auto waitUntil = start + std::chrono::milliseconds(timeoutMs);
 
-    if (shutdown_)
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
     {
-      spdlog::error("Connection pool is shut down");
-      return nullptr;
-    }
-
-    auto waitUntil = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+      if (shutdown_)
+      {
+        spdlog::error("Connection pool is shut down");
+        return ConnectionLease();
+      }
 
-    // 等待可用连接或超时
-    while (connectionPool_.empty())
-    {
-      // 如果活跃连接数小于最大连接数，创建新连接
-      if (activeConnections_ < maxSize_)
+      std::shared_ptr<DBConnection> conn = takeIdle();
+      bool created = false;
+      if (!conn && totalConnections_ < maxSize_)
       {
-        auto conn = createConnection();
+        // 先占住名额，在锁外建立连接
+        totalConnections_++;
+        lock.unlock();
+        conn = createConnection();
+        lock.lock();
         if (conn)
         {
-          activeConnections_++;
-          return conn;
+          created = true;
+        }
+        else
+        {
+          totalConnections_--;
         }
       }
 
-      // 等待连接释放
-      auto status = condition_.wait_until(lock, waitUntil);
-      if (status == std::cv_status::timeout)
+      if (conn)
       {
-        spdlog::error("Timeout waiting for database connection");
-        return nullptr;
+        activeConnections_++;
+        lock.unlock();
+
+        // 只有空闲较久或上次执行出错的连接才ping，避免每次借出都多一次网络往返
+        bool idleTooLong = validateIdle_.count() > 0 &&
+                           std::chrono::steady_clock::now() - conn->lastUsed_ > validateIdle_;
+        if (!created && (idleTooLong || conn->needsValidation()))
+        {
+          validations_++;
+          if (!conn->validate())
+          {
+            conn.reset();
+            lock.lock();
+            activeConnections_--;
+            totalConnections_--;
+            continue;
+          }
+        }
+
+        uint64_t waited = elapsedMicros(start);
+        acquisitions_++;
+        waitTimeTotalUs_ += waited;
+        uint64_t currentMax = waitTimeMaxUs_.load();
+        while (waited > currentMax && !waitTimeMaxUs_.compare_exchange_weak(currentMax, waited))
+        {
+        }
+
+        lastConnection = conn;
+        return ConnectionLease(this, std::move(conn));
       }
 
-      if (shutdown_)
+      // 等待连接释放，建立连接失败时也在这里等待，避免反复重试
+      if (condition_.wait_until(lock, waitUntil) == std::cv_status::timeout && idle_.empty())
       {
-        spdlog::error("Connection pool was shut down while waiting");
-        return nullptr;
+        timeouts_++;
+        spdlog::error("Timeout waiting for database connection after {}ms", timeoutMs);
+        return ConnectionLease();
       }
     }
+  }
 
-    // 获取连接
-    auto conn = connectionPool_.front();
-    connectionPool_.pop();
-    activeConnections_++;
+  std::shared_ptr<DBConnection> DBConnectionPool::takeIdle()
+  {
+    if (idle_.empty())
+    {
+      return nullptr;
+    }
 
-    // 检查连接是否有效，如果无效则重新连接
-    if (!conn->isConnected() && !conn->reconnect())
+    if (auto preferred = lastConnection.lock())
     {
-      activeConnections_--;
-      return getConnection(timeoutMs);
+      auto it = std::find(idle_.begin(), idle_.end(), preferred);
+      if (it != idle_.end())
+      {
+        idle_.erase(it);
+        return preferred;
+      }
     }
 
+    // 取最近归还的连接，长时间不用的连接留在队头，超过存活时间后被回收
+    auto conn = idle_.back();
+    idle_.pop_back();
     return conn;
   }
 
@@ -250,34 +431,51 @@ namespace scheduler
       return;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    if (!shutdown_)
+    auto now = std::chrono::steady_clock::now();
+    bool expired = maxLifetime_.count() > 0 && now - conn->createdAt_ > maxLifetime_;
     {
-      connectionPool_.push(conn);
+      std::lock_guard<std::mutex> lock(mutex_);
       activeConnections_--;
+      if (shutdown_ || expired)
+      {
+        totalConnections_--;
+      }
+      else
+      {
+        conn->lastUsed_ = now;
+        idle_.push_back(conn);
+        conn.reset();
+      }
       condition_.notify_one();
     }
+
+    // 超过最长存活时间的连接在锁外关闭，需要时再新建
+    if (expired && conn)
+    {
+      recycled_++;
+      spdlog::debug("Recycling database connection after {}s", maxLifetime_.count());
+    }
   }
 
   void DBConnectionPool::shutdown()
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    if (shutdown_)
+    std::deque<std::shared_ptr<DBConnection>> idle;
     {
-      return;
-    }
+      std::lock_guard<std::mutex> lock(mutex_);
 
-    shutdown_ = true;
+      if (shutdown_)
+      {
+        return;
+      }
 
-    // 清空连接池
-    while (!connectionPool_.empty())
-    {
-      connectionPool_.pop();
-    }
+      shutdown_ = true;
+
+      // 清空连接池，已借出的连接在归还时关闭
+      totalConnections_ -= idle_.size();
+      idle.swap(idle_);
 
-    condition_.notify_all();
+      condition_.notify_all();
+    }
     spdlog::info("Database connection pool shut down");
   }
 
@@ -294,12 +492,33 @@ namespace scheduler
 
   size_t DBConnectionPool::getActiveConnections() const
   {
+    std::lock_guard<std::mutex> lock(mutex_);
     return activeConnections_;
   }
 
   size_t DBConnectionPool::getIdleConnections() const
   {
-    return connectionPool_.size();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idle_.size();
+  }
+
+  ConnectionPoolStats DBConnectionPool::getStats() const
+  {
+    ConnectionPoolStats stats;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats.total = totalConnections_;
+      stats.in_use = activeConnections_;
+      stats.idle = idle_.size();
+      stats.max_size = maxSize_;
+    }
+    stats.acquisitions = acquisitions_.load();
+    stats.timeouts = timeouts_.load();
+    stats.wait_time_total_us = waitTimeTotalUs_.load();
+    stats.wait_time_max_us = waitTimeMaxUs_.load();
+    stats.validations = validations_.load();
+    stats.recycled = recycled_.load();
+    return stats;
   }
 
 } // namespace scheduler
\ No newline at end of file
@@ -13,6 +13,12 @@ CREATE TABLE IF NOT EXISTS job_info (
     timeout INT NOT NULL DEFAULT 60,
     retry_count INT NOT NULL DEFAULT 0,
     retry_interval INT NOT NULL DEFAULT 0,
+    cpu_weight INT NOT NULL DEFAULT 0 COMMENT 'cgroup cpu.weight，0表示不限制',
+    memory_limit_mb BIGINT NOT NULL DEFAULT 0 COMMENT '内存上限（MB），0表示不限制',
+    use_warm_pool TINYINT(1) NOT NULL DEFAULT 0 COMMENT '是否在预热工作进程中执行',
+    exec_type ENUM('SHELL', 'SHARED_LIBRARY') NOT NULL DEFAULT 'SHELL' COMMENT '执行方式',
+    library_path VARCHAR(512) COMMENT '共享库路径',
+    entry_symbol VARCHAR(255) COMMENT '共享库入口函数',
     create_time TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
     update_time TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
     INDEX idx_priority (priority),
@@ -27,8 +33,13 @@ CREATE TABLE IF NOT EXISTS job_execution (
     status ENUM('WAITING', 'RUNNING', 'SUCCESS', 'FAILED', 'TIMEOUT') NOT NULL,
     start_time TIMESTAMP NULL,
     end_time TIMESTAMP NULL,
-    output TEXT,
-    error TEXT,
+    output MEDIUMBLOB COMMENT '执行输出，按payload_codec压缩',
+    error BLOB COMMENT '错误信息，按payload_codec压缩',
+    payload_codec ENUM('NONE', 'LZ4', 'ZSTD') NOT NULL DEFAULT 'NONE' COMMENT 'output和error的压缩格式',
+    cpu_time_ms BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'CPU时间（毫秒）',
+    peak_rss_kb BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '峰值内存（KB）',
+    io_read_bytes BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '读取字节数',
+    io_write_bytes BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '写入字节数',
     retry_count INT NOT NULL DEFAULT 0,
     trigger_time TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
     INDEX idx_job_id (job_id),
@@ -42,7 +53,7 @@ CREATE TABLE IF NOT EXISTS executor_node (
     executor_id VARCHAR(64) PRIMARY KEY,
     host VARCHAR(255) NOT NULL,
     port INT NOT NULL,
-    status ENUM('ONLINE', 'OFFLINE') NOT NULL,
+    status ENUM('ONLINE', 'OFFLINE', 'DRAINING') NOT NULL,
     last_heartbeat TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
     register_time TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
     INDEX idx_status (status),
@@ -6,4 +6,40 @@ ADD COLUMN total_tasks_executed BIGINT NOT NULL DEFAULT 0 COMMENT '已执行任
 ADD INDEX idx_current_load (current_load);
 
 -- 更新现有记录，设置默认最大负载
-UPDATE executor_node SET max_load = 10 WHERE max_load = 0; 
\ No newline at end of file
+UPDATE executor_node SET max_load = 10 WHERE max_load = 0; 
+
+-- 任务资源限制与资源使用统计
+ALTER TABLE job_info
+ADD COLUMN cpu_weight INT NOT NULL DEFAULT 0 COMMENT 'cgroup cpu.weight，0表示不限制',
+ADD COLUMN memory_limit_mb BIGINT NOT NULL DEFAULT 0 COMMENT '内存上限（MB），0表示不限制';
+
+ALTER TABLE job_execution
+ADD COLUMN cpu_time_ms BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'CPU时间（毫秒）',
+ADD COLUMN peak_rss_kb BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '峰值内存（KB）',
+ADD COLUMN io_read_bytes BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '读取字节数',
+ADD COLUMN io_write_bytes BIGINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '写入字节数';
+
+-- 预热工作进程池开关
+ALTER TABLE job_info
+ADD COLUMN use_warm_pool TINYINT(1) NOT NULL DEFAULT 0 COMMENT '是否在预热工作进程中执行';
+
+-- 共享库任务
+ALTER TABLE job_info
+ADD COLUMN exec_type ENUM('SHELL', 'SHARED_LIBRARY') NOT NULL DEFAULT 'SHELL' COMMENT '执行方式',
+ADD COLUMN library_path VARCHAR(512) COMMENT '共享库路径',
+ADD COLUMN entry_symbol VARCHAR(255) COMMENT '共享库入口函数';
+
+-- 执行器排空状态
+ALTER TABLE executor_node
+MODIFY COLUMN status ENUM('ONLINE', 'OFFLINE', 'DRAINING') NOT NULL;
+
+-- 任务输出压缩存储
+ALTER TABLE job_execution
+MODIFY COLUMN output MEDIUMBLOB COMMENT '执行输出，按payload_codec压缩',
+MODIFY COLUMN error BLOB COMMENT '错误信息，按payload_codec压缩',
+ADD COLUMN payload_codec ENUM('NONE', 'LZ4', 'ZSTD') NOT NULL DEFAULT 'NONE' COMMENT 'output和error的压缩格式';
+
+-- 执行记录的派发令牌，异步插入超时后以同一令牌幂等重试
+ALTER TABLE job_execution
+ADD COLUMN dispatch_token CHAR(32) NULL COMMENT '调度器生成的派发令牌，插入超时后幂等重试',
+ADD UNIQUE INDEX uk_dispatch_token (dispatch_token);
\ No newline at end of file
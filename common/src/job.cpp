@@ -1,7 +1,9 @@
 #include "job.h"
+#include "payload_codec.h"
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <stdexcept>
 
 namespace scheduler
 {
@@ -37,6 +39,32 @@ namespace scheduler
     }
   }
 
+  // JobExecType 转换为字符串
+  std::string job_exec_type_to_string(JobExecType type)
+  {
+    switch (type)
+    {
+    case JobExecType::SHARED_LIBRARY:
+      return "SHARED_LIBRARY";
+    case JobExecType::SHELL:
+    default:
+      return "SHELL";
+    }
+  }
+
+  // 字符串转换为 JobExecType
+  JobExecType string_to_job_exec_type(const std::string &type_str)
+  {
+    if (type_str == "SHARED_LIBRARY")
+    {
+      return JobExecType::SHARED_LIBRARY;
+    }
+    else
+    {
+      return JobExecType::SHELL; // 默认为shell命令
+    }
+  }
+
   // JobStatus 转换为字符串
   std::string job_status_to_string(JobStatus status)
   {
@@ -117,6 +145,13 @@ namespace scheduler
     j["timeout"] = timeout;
     j["retry_count"] = retry_count;
     j["retry_interval"] = retry_interval;
+    j["cpu_weight"] = cpu_weight;
+    j["memory_limit_mb"] = memory_limit_mb;
+    j["use_warm_pool"] = use_warm_pool;
+    j["exec_type"] = job_exec_type_to_string(exec_type);
+    j["library_path"] = library_path;
+    j["entry_symbol"] = entry_symbol;
+    j["execution_id"] = execution_id;
     return j;
   }
 
@@ -133,6 +168,13 @@ namespace scheduler
     job.timeout = j.value("timeout", 0);
     job.retry_count = j.value("retry_count", 0);
     job.retry_interval = j.value("retry_interval", 0);
+    job.cpu_weight = j.value("cpu_weight", 0);
+    job.memory_limit_mb = j.value("memory_limit_mb", static_cast<int64_t>(0));
+    job.use_warm_pool = j.value("use_warm_pool", false);
+    job.exec_type = string_to_job_exec_type(j.value("exec_type", "SHELL"));
+    job.library_path = j.value("library_path", "");
+    job.entry_symbol = j.value("entry_symbol", "");
+    job.execution_id = j.value("execution_id", 0ULL);
     return job;
   }
 
@@ -142,11 +184,26 @@ namespace scheduler
     nlohmann::json j;
     j["job_id"] = job_id;
     j["execution_id"] = execution_id;
+    j["executor_id"] = executor_id;
     j["status"] = job_status_to_string(status);
-    j["output"] = output;
-    j["error"] = error;
+    // 压缩后的内容不是合法的UTF-8，以base64传输
+    if (payload_codec != PayloadCodec::NONE)
+    {
+      j["payload_codec"] = PayloadCompressor::codecToString(payload_codec);
+      j["output"] = PayloadCompressor::base64Encode(output);
+      j["error"] = PayloadCompressor::base64Encode(error);
+    }
+    else
+    {
+      j["output"] = output;
+      j["error"] = error;
+    }
     j["start_time"] = time_point_to_string(start_time);
     j["end_time"] = time_point_to_string(end_time);
+    j["cpu_time_ms"] = cpu_time_ms;
+    j["peak_rss_kb"] = peak_rss_kb;
+    j["io_read_bytes"] = io_read_bytes;
+    j["io_write_bytes"] = io_write_bytes;
     return j;
   }
 
@@ -156,11 +213,26 @@ namespace scheduler
     JobResult result;
     result.job_id = j.value("job_id", "");
     result.execution_id = j.value("execution_id", 0ULL);
+    result.executor_id = j.value("executor_id", "");
     result.status = string_to_job_status(j.value("status", "WAITING"));
     result.output = j.value("output", "");
     result.error = j.value("error", "");
+    if (j.contains("payload_codec") &&
+        PayloadCompressor::codecFromString(j["payload_codec"].get<std::string>(), result.payload_codec) &&
+        result.payload_codec != PayloadCodec::NONE)
+    {
+      if (!PayloadCompressor::base64Decode(result.output, result.output) ||
+          !PayloadCompressor::base64Decode(result.error, result.error))
+      {
+        throw std::invalid_argument("Invalid base64 payload for job: " + result.job_id);
+      }
+    }
     result.start_time = string_to_time_point(j.value("start_time", "1970-01-01T00:00:00Z"));
     result.end_time = string_to_time_point(j.value("end_time", "1970-01-01T00:00:00Z"));
+    result.cpu_time_ms = j.value("cpu_time_ms", 0ULL);
+    result.peak_rss_kb = j.value("peak_rss_kb", 0ULL);
+    result.io_read_bytes = j.value("io_read_bytes", 0ULL);
+    result.io_write_bytes = j.value("io_write_bytes", 0ULL);
     return result;
   }
 
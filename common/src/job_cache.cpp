@@ -0,0 +1,141 @@
+#include "job_cache.h"
+#include <algorithm>
+#include <functional>
+
+namespace scheduler
+{
+
+  JobCache::JobCache(size_t capacity, size_t shards, std::chrono::milliseconds ttl)
+      : capacity_(capacity), ttl_(ttl)
+  {
+    // 分片数不超过容量，每个分片至少能放一个条目
+    shards = std::max<size_t>(1, std::min(shards, std::max<size_t>(1, capacity)));
+    shardCapacity_ = (capacity + shards - 1) / shards;
+    shards_.reserve(shards);
+    for (size_t i = 0; i < shards; ++i)
+    {
+      shards_.push_back(std::make_unique<Shard>());
+    }
+  }
+
+  JobCache::Shard &JobCache::shardFor(const std::string &jobId) const
+  {
+    return *shards_[std::hash<std::string>{}(jobId) % shards_.size()];
+  }
+
+  std::optional<JobInfo> JobCache::get(const std::string &jobId)
+  {
+    if (!enabled())
+    {
+      return std::nullopt;
+    }
+
+    Shard &shard = shardFor(jobId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(jobId);
+    if (it == shard.index.end())
+    {
+      misses_++;
+      return std::nullopt;
+    }
+
+    if (ttl_.count() > 0 && Clock::now() >= it->second->expires_at)
+    {
+      shard.lru.erase(it->second);
+      shard.index.erase(it);
+      misses_++;
+      return std::nullopt;
+    }
+
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    hits_++;
+    return it->second->job;
+  }
+
+  uint64_t JobCache::version(const std::string &jobId) const
+  {
+    Shard &shard = shardFor(jobId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.version;
+  }
+
+  void JobCache::put(const JobInfo &job, uint64_t version)
+  {
+    if (!enabled())
+    {
+      return;
+    }
+
+    Shard &shard = shardFor(job.job_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // 查库期间有过失效，读到的可能是修改前的定义
+    if (shard.version != version)
+    {
+      return;
+    }
+
+    Clock::time_point expiresAt = Clock::now() + ttl_;
+    auto it = shard.index.find(job.job_id);
+    if (it != shard.index.end())
+    {
+      it->second->job = job;
+      it->second->expires_at = expiresAt;
+      shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+      return;
+    }
+
+    if (shard.lru.size() >= shardCapacity_)
+    {
+      shard.index.erase(shard.lru.back().job.job_id);
+      shard.lru.pop_back();
+      evictions_++;
+    }
+
+    shard.lru.push_front(Entry{job, expiresAt});
+    shard.index.emplace(job.job_id, shard.lru.begin());
+  }
+
+  void JobCache::invalidate(const std::string &jobId)
+  {
+    Shard &shard = shardFor(jobId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // 不在缓存中也要加版本，让并发查库的结果不再写入
+    shard.version++;
+    auto it = shard.index.find(jobId);
+    if (it != shard.index.end())
+    {
+      shard.lru.erase(it->second);
+      shard.index.erase(it);
+      invalidations_++;
+    }
+  }
+
+  void JobCache::clear()
+  {
+    for (auto &shard : shards_)
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->version++;
+      shard->lru.clear();
+      shard->index.clear();
+    }
+  }
+
+  JobCacheStats JobCache::getStats() const
+  {
+    JobCacheStats stats;
+    for (const auto &shard : shards_)
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      stats.size += shard->lru.size();
+    }
+    stats.capacity = capacity_;
+    stats.shards = shards_.size();
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats.invalidations = invalidations_;
+    return stats;
+  }
+
+} // namespace scheduler
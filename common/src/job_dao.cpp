@@ -1,54 +1,159 @@
 #include "job_dao.h"
+#include "payload_codec.h"
+#include "config_manager.h"
 #include <spdlog/spdlog.h>
-#include <iomanip>
+#include <algorithm>
 #include <sstream>
 #include <chrono>
+#include <random>
 
 namespace scheduler
 {
 
-  JobDAO::JobDAO()
+  namespace
   {
-    // 构造函数，不需要特殊初始化
-  }
+    // 任务信息和执行记录的查询列，顺序与buildJobInfo、buildJobResult一致
+    const std::string kJobColumns =
+        "job_id, name, command, job_type, priority, "
+        "cron_expression, timeout, retry_count, retry_interval, cpu_weight, memory_limit_mb, use_warm_pool, "
+        "exec_type, library_path, entry_symbol ";
+    const std::string kExecutionColumns =
+        "execution_id, job_id, executor_id, status, start_time, end_time, output, error, "
+        "cpu_time_ms, peak_rss_kb, io_read_bytes, io_write_bytes, payload_codec ";
+    const std::string kExecutorColumns =
+        "executor_id, host, port, current_load, max_load, total_tasks_executed, last_heartbeat ";
 
-  // 时间点转换为MySQL时间戳字符串
-  std::string JobDAO::timePointToString(const std::chrono::system_clock::time_point &timePoint)
-  {
-    auto time_t = std::chrono::system_clock::to_time_t(timePoint);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                  timePoint.time_since_epoch())
-                  .count() %
-              1000;
+    std::string jobTypeToString(JobType type)
+    {
+      return type == JobType::PERIODIC ? "PERIODIC" : "ONCE";
+    }
 
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    ss << '.' << std::setfill('0') << std::setw(3) << ms;
+    std::string jobStatusToString(JobStatus status)
+    {
+      switch (status)
+      {
+      case JobStatus::WAITING:
+        return "WAITING";
+      case JobStatus::RUNNING:
+        return "RUNNING";
+      case JobStatus::SUCCESS:
+        return "SUCCESS";
+      case JobStatus::FAILED:
+        return "FAILED";
+      case JobStatus::TIMEOUT:
+        return "TIMEOUT";
+      }
+      return "WAITING";
+    }
 
-    return ss.str();
-  }
+    // 向上取到2的幂，IN列表的占位符个数只有少数几种，缓存的语句数量有限
+    size_t roundUpPowerOfTwo(size_t n)
+    {
+      size_t result = 1;
+      while (result < n)
+      {
+        result <<= 1;
+      }
+      return result;
+    }
 
-  // MySQL时间戳字符串转换为时间点
-  std::chrono::system_clock::time_point JobDAO::stringToTimePoint(const std::string &timeStr)
-  {
-    std::tm tm = {};
-    int milliseconds = 0;
+    std::future<bool> readyFuture(bool value)
+    {
+      std::promise<bool> promise;
+      promise.set_value(value);
+      return promise.get_future();
+    }
 
-    // 解析日期时间部分
-    std::istringstream ss(timeStr);
-    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    // 异步插入执行记录的尝试次数，超时后插入结果未知，以同一派发令牌重试
+    constexpr int kSaveExecutionAttempts = 3;
 
-    // 解析毫秒部分（如果有）
-    if (ss.peek() == '.')
+    // 客户端生成的派发令牌，32位十六进制
+    std::string newDispatchToken()
     {
-      char dot;
-      ss >> dot >> milliseconds;
+      thread_local std::mt19937_64 generator(std::random_device{}());
+      static const char digits[] = "0123456789abcdef";
+      std::string token;
+      token.reserve(32);
+      for (int i = 0; i < 2; ++i)
+      {
+        uint64_t value = generator();
+        for (int j = 0; j < 16; ++j)
+        {
+          token += digits[value & 0x0F];
+          value >>= 4;
+        }
+      }
+      return token;
+    }
+
+    // 以派发令牌幂等插入执行记录：令牌已存在时LAST_INSERT_ID返回已有记录的ID
+    void insertExecutionAsync(const std::string &jobId, const std::string &executorId, const std::string &token,
+                              int attempt, std::function<void(uint64_t)> onSaved)
+    {
+      AsyncStatement stmt(
+          "INSERT INTO job_execution (job_id, executor_id, status, dispatch_token) VALUES (?, ?, 'WAITING', ?) "
+          "ON DUPLICATE KEY UPDATE execution_id = LAST_INSERT_ID(execution_id)");
+      stmt.bindString(0, jobId);
+      stmt.bindOptionalString(1, executorId);
+      stmt.bindString(2, token);
+      AsyncQueryEngine::getInstance().submit(std::move(stmt), [jobId, executorId, token, attempt, onSaved](const AsyncQueryResult &result)
+                                             {
+        if (result.success)
+        {
+          spdlog::info("Execution saved successfully for job: {}, execution ID: {}", jobId, result.insert_id);
+          onSaved(result.insert_id);
+          return;
+        }
+
+        if (attempt < kSaveExecutionAttempts)
+        {
+          spdlog::warn("Failed to save execution for job: {}, retrying ({}/{})", jobId, attempt, kSaveExecutionAttempts);
+          insertExecutionAsync(jobId, executorId, token, attempt + 1, onSaved);
+          return;
+        }
+
+        // 最后一次也可能是超时，插入可能已经提交：按令牌删除，任务撤销派发后不留下孤立的WAITING记录
+        spdlog::error("Failed to save execution for job: {}", jobId);
+        AsyncStatement cleanup("DELETE FROM job_execution WHERE dispatch_token = ? AND status = 'WAITING'");
+        cleanup.bindString(0, token);
+        AsyncQueryEngine::getInstance().submit(std::move(cleanup), [jobId, token](const AsyncQueryResult &deleted)
+                                               {
+          if (!deleted.success)
+          {
+            spdlog::error("Failed to clean up execution of job: {}, dispatch token: {}", jobId, token);
+          } });
+        onSaved(0); });
+    }
+
+    // 提交到异步引擎，完成后记录日志并设置future
+    std::future<bool> submitAsync(AsyncStatement statement, std::function<void(const AsyncQueryResult &)> log)
+    {
+      auto promise = std::make_shared<std::promise<bool>>();
+      auto future = promise->get_future();
+      AsyncQueryEngine::getInstance().submit(std::move(statement), [promise, log](const AsyncQueryResult &result)
+                                             {
+        log(result);
+        promise->set_value(result.success); });
+      return future;
     }
+  }
 
-    auto timePoint = std::chrono::system_clock::from_time_t(std::mktime(&tm));
-    timePoint += std::chrono::milliseconds(milliseconds);
+  JobDAO::JobDAO()
+  {
+    // 构造函数，不需要特殊初始化
+  }
 
-    return timePoint;
+  JobCache &JobDAO::jobCache()
+  {
+    static JobCache cache = []()
+    {
+      auto &config = ConfigManager::getInstance();
+      size_t capacity = std::max(0, config.getInt("db.job_cache.capacity", 10000));
+      size_t shards = std::max(1, config.getInt("db.job_cache.shards", 16));
+      auto ttl = std::chrono::milliseconds(std::max(0, config.getInt("db.job_cache.ttl_ms", 60000)));
+      return JobCache(capacity, shards, ttl);
+    }();
+    return cache;
   }
 
   // 保存任务信息
@@ -61,31 +166,34 @@ namespace scheduler
       return false;
     }
 
-    std::string jobType;
-    if (job.type == JobType::ONCE)
-    {
-      jobType = "ONCE";
-    }
-    else if (job.type == JobType::PERIODIC)
+    auto stmt = conn->prepare(
+        "INSERT INTO job_info (job_id, name, command, job_type, priority, "
+        "cron_expression, timeout, retry_count, retry_interval, cpu_weight, memory_limit_mb, "
+        "use_warm_pool, exec_type, library_path, entry_symbol) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+
+    bool result = false;
+    if (stmt)
     {
-      jobType = "PERIODIC";
+      stmt->bindString(0, job.job_id);
+      stmt->bindString(1, job.name);
+      stmt->bindString(2, job.command);
+      stmt->bindString(3, jobTypeToString(job.type));
+      stmt->bindInt(4, job.priority);
+      stmt->bindOptionalString(5, job.cron_expression);
+      stmt->bindInt(6, job.timeout);
+      stmt->bindInt(7, job.retry_count);
+      stmt->bindInt(8, job.retry_interval);
+      stmt->bindInt(9, job.cpu_weight);
+      stmt->bindInt(10, job.memory_limit_mb);
+      stmt->bindInt(11, job.use_warm_pool ? 1 : 0);
+      stmt->bindString(12, job.exec_type == JobExecType::SHARED_LIBRARY ? "SHARED_LIBRARY" : "SHELL");
+      stmt->bindOptionalString(13, job.library_path);
+      stmt->bindOptionalString(14, job.entry_symbol);
+      result = stmt->execute();
     }
 
-    std::stringstream ss;
-    ss << "INSERT INTO job_info (job_id, name, command, job_type, priority, "
-       << "cron_expression, timeout, retry_count, retry_interval) VALUES ("
-       << "'" << job.job_id << "', "
-       << "'" << job.name << "', "
-       << "'" << job.command << "', "
-       << "'" << jobType << "', "
-       << job.priority << ", "
-       << (job.cron_expression.empty() ? "NULL" : ("'" + job.cron_expression + "'")) << ", "
-       << job.timeout << ", "
-       << job.retry_count << ", "
-       << job.retry_interval << ")";
-
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    jobCache().invalidate(job.job_id);
 
     if (!result)
     {
@@ -109,30 +217,35 @@ namespace scheduler
       return false;
     }
 
-    std::string jobType;
-    if (job.type == JobType::ONCE)
-    {
-      jobType = "ONCE";
-    }
-    else if (job.type == JobType::PERIODIC)
-    {
-      jobType = "PERIODIC";
-    }
-
-    std::stringstream ss;
-    ss << "UPDATE job_info SET "
-       << "name = '" << job.name << "', "
-       << "command = '" << job.command << "', "
-       << "job_type = '" << jobType << "', "
-       << "priority = " << job.priority << ", "
-       << "cron_expression = " << (job.cron_expression.empty() ? "NULL" : ("'" + job.cron_expression + "'")) << ", "
-       << "timeout = " << job.timeout << ", "
-       << "retry_count = " << job.retry_count << ", "
-       << "retry_interval = " << job.retry_interval
-       << " WHERE job_id = '" << job.job_id << "'";
-
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    auto stmt = conn->prepare(
+        "UPDATE job_info SET name = ?, command = ?, job_type = ?, priority = ?, cron_expression = ?, "
+        "timeout = ?, retry_count = ?, retry_interval = ?, cpu_weight = ?, memory_limit_mb = ?, "
+        "use_warm_pool = ?, exec_type = ?, library_path = ?, entry_symbol = ? "
+        "WHERE job_id = ?");
+
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindString(0, job.name);
+      stmt->bindString(1, job.command);
+      stmt->bindString(2, jobTypeToString(job.type));
+      stmt->bindInt(3, job.priority);
+      stmt->bindOptionalString(4, job.cron_expression);
+      stmt->bindInt(5, job.timeout);
+      stmt->bindInt(6, job.retry_count);
+      stmt->bindInt(7, job.retry_interval);
+      stmt->bindInt(8, job.cpu_weight);
+      stmt->bindInt(9, job.memory_limit_mb);
+      stmt->bindInt(10, job.use_warm_pool ? 1 : 0);
+      stmt->bindString(11, job.exec_type == JobExecType::SHARED_LIBRARY ? "SHARED_LIBRARY" : "SHELL");
+      stmt->bindOptionalString(12, job.library_path);
+      stmt->bindOptionalString(13, job.entry_symbol);
+      stmt->bindString(14, job.job_id);
+      result = stmt->execute();
+    }
+
+    // 写库之后失效，写库期间读穿透取到的旧定义也不会写回缓存
+    jobCache().invalidate(job.job_id);
 
     if (!result)
     {
@@ -156,11 +269,16 @@ namespace scheduler
       return false;
     }
 
-    std::stringstream ss;
-    ss << "DELETE FROM job_info WHERE job_id = '" << jobId << "'";
+    auto stmt = conn->prepare("DELETE FROM job_info WHERE job_id = ?");
 
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindString(0, jobId);
+      result = stmt->execute();
+    }
+
+    jobCache().invalidate(jobId);
 
     if (!result)
     {
@@ -174,64 +292,63 @@ namespace scheduler
     return result;
   }
 
-  // 从结果集构建JobInfo对象
-  JobInfo JobDAO::buildJobInfoFromResult(MYSQL_RES *result)
+  // 从当前行构建JobInfo对象
+  JobInfo JobDAO::buildJobInfo(const PreparedStatement &stmt)
   {
     JobInfo job;
 
-    if (!result)
-    {
-      return job;
-    }
+    job.job_id = stmt.getString(0);
+    job.name = stmt.getString(1);
+    job.command = stmt.getString(2);
 
-    MYSQL_ROW row = mysql_fetch_row(result);
-    if (!row)
+    // 解析任务类型
+    std::string typeStr = stmt.getString(3);
+    if (typeStr == "ONCE")
     {
-      return job;
+      job.type = JobType::ONCE;
     }
-
-    unsigned long *lengths = mysql_fetch_lengths(result);
-
-    // 获取字段值
-    if (row[0])
-      job.job_id = std::string(row[0], lengths[0]);
-    if (row[1])
-      job.name = std::string(row[1], lengths[1]);
-    if (row[2])
-      job.command = std::string(row[2], lengths[2]);
-
-    // 解析任务类型
-    if (row[3])
+    else if (typeStr == "PERIODIC")
     {
-      std::string typeStr = std::string(row[3], lengths[3]);
-      if (typeStr == "ONCE")
-      {
-        job.type = JobType::ONCE;
-      }
-      else if (typeStr == "PERIODIC")
-      {
-        job.type = JobType::PERIODIC;
-      }
+      job.type = JobType::PERIODIC;
     }
 
     // 解析其他字段
-    if (row[4])
-      job.priority = std::stoi(std::string(row[4], lengths[4]));
-    if (row[5])
-      job.cron_expression = std::string(row[5], lengths[5]);
-    if (row[6])
-      job.timeout = std::stoi(std::string(row[6], lengths[6]));
-    if (row[7])
-      job.retry_count = std::stoi(std::string(row[7], lengths[7]));
-    if (row[8])
-      job.retry_interval = std::stoi(std::string(row[8], lengths[8]));
+    if (!stmt.isNull(4))
+      job.priority = static_cast<int>(stmt.getInt(4));
+    job.cron_expression = stmt.getString(5);
+    if (!stmt.isNull(6))
+      job.timeout = static_cast<int>(stmt.getInt(6));
+    if (!stmt.isNull(7))
+      job.retry_count = static_cast<int>(stmt.getInt(7));
+    if (!stmt.isNull(8))
+      job.retry_interval = static_cast<int>(stmt.getInt(8));
+    if (!stmt.isNull(9))
+      job.cpu_weight = static_cast<int>(stmt.getInt(9));
+    if (!stmt.isNull(10))
+      job.memory_limit_mb = stmt.getInt(10);
+    if (!stmt.isNull(11))
+      job.use_warm_pool = stmt.getInt(11) != 0;
+    if (stmt.getString(12) == "SHARED_LIBRARY")
+      job.exec_type = JobExecType::SHARED_LIBRARY;
+    job.library_path = stmt.getString(13);
+    job.entry_symbol = stmt.getString(14);
 
     return job;
   }
 
   // 获取任务信息
-  std::optional<JobInfo> JobDAO::getJob(const std::string &jobId)
+  std::optional<JobInfo> JobDAO::getJob(const std::string &jobId, bool useCache)
   {
+    JobCache &cache = jobCache();
+    if (useCache)
+    {
+      if (auto cached = cache.get(jobId))
+      {
+        return cached;
+      }
+    }
+    uint64_t version = cache.version(jobId);
+
     auto conn = DBConnectionPool::getInstance().getConnection();
     if (!conn)
     {
@@ -239,31 +356,28 @@ namespace scheduler
       return std::nullopt;
     }
 
-    std::stringstream ss;
-    ss << "SELECT job_id, name, command, job_type, priority, "
-       << "cron_expression, timeout, retry_count, retry_interval "
-       << "FROM job_info WHERE job_id = '" << jobId << "'";
+    auto stmt = conn->prepare("SELECT " + kJobColumns + "FROM job_info WHERE job_id = ?");
+    if (!stmt)
+    {
+      spdlog::error("Failed to query job: {}", jobId);
+      return std::nullopt;
+    }
 
-    if (!conn->executeQuery(ss.str()))
+    stmt->bindString(0, jobId);
+    if (!stmt->execute())
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
       spdlog::error("Failed to query job: {}", jobId);
       return std::nullopt;
     }
 
-    MYSQL_RES *result = conn->getResult();
-    if (!result || mysql_num_rows(result) == 0)
+    if (!stmt->fetch())
     {
-      if (result)
-        mysql_free_result(result);
-      DBConnectionPool::getInstance().releaseConnection(conn);
       spdlog::warn("Job not found: {}", jobId);
       return std::nullopt;
     }
 
-    JobInfo job = buildJobInfoFromResult(result);
-    mysql_free_result(result);
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    JobInfo job = buildJobInfo(*stmt);
+    cache.put(job, version);
 
     return job;
   }
@@ -280,38 +394,28 @@ namespace scheduler
       return jobs;
     }
 
-    std::stringstream ss;
-    ss << "SELECT job_id, name, command, job_type, priority, "
-       << "cron_expression, timeout, retry_count, retry_interval "
-       << "FROM job_info ORDER BY priority DESC, create_time DESC "
-       << "LIMIT " << limit << " OFFSET " << offset;
-
-    if (!conn->executeQuery(ss.str()))
+    auto stmt = conn->prepare("SELECT " + kJobColumns +
+                              "FROM job_info ORDER BY priority DESC, create_time DESC LIMIT ? OFFSET ?");
+    if (!stmt)
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
       spdlog::error("Failed to query jobs");
       return jobs;
     }
 
-    MYSQL_RES *result = conn->getResult();
-    if (!result)
+    stmt->bindInt(0, limit);
+    stmt->bindInt(1, offset);
+    if (!stmt->execute())
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
-      spdlog::error("Failed to get result set");
+      spdlog::error("Failed to query jobs");
       return jobs;
     }
 
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result)))
+    jobs.reserve(stmt->rowCount());
+    while (stmt->fetch())
     {
-      mysql_data_seek(result, jobs.size());
-      JobInfo job = buildJobInfoFromResult(result);
-      jobs.push_back(job);
+      jobs.push_back(buildJobInfo(*stmt));
     }
 
-    mysql_free_result(result);
-    DBConnectionPool::getInstance().releaseConnection(conn);
-
     return jobs;
   }
 
@@ -328,41 +432,34 @@ namespace scheduler
     }
 
     // 查询没有正在执行的任务
-    std::stringstream ss;
-    ss << "SELECT j.job_id, j.name, j.command, j.job_type, j.priority, "
-       << "j.cron_expression, j.timeout, j.retry_count, j.retry_interval "
-       << "FROM job_info j "
-       << "LEFT JOIN job_execution e ON j.job_id = e.job_id AND e.status = 'RUNNING' "
-       << "WHERE e.job_id IS NULL "
-       << "ORDER BY j.priority DESC, j.create_time ASC "
-       << "LIMIT " << limit;
-
-    if (!conn->executeQuery(ss.str()))
-    {
-      DBConnectionPool::getInstance().releaseConnection(conn);
+    auto stmt = conn->prepare(
+        "SELECT j.job_id, j.name, j.command, j.job_type, j.priority, "
+        "j.cron_expression, j.timeout, j.retry_count, j.retry_interval, j.cpu_weight, j.memory_limit_mb, j.use_warm_pool, "
+        "j.exec_type, j.library_path, j.entry_symbol "
+        "FROM job_info j "
+        "LEFT JOIN job_execution e ON j.job_id = e.job_id AND e.status = 'RUNNING' "
+        "WHERE e.job_id IS NULL "
+        "ORDER BY j.priority DESC, j.create_time ASC "
+        "LIMIT ?");
+    if (!stmt)
+    {
       spdlog::error("Failed to query pending jobs");
       return jobs;
     }
 
-    MYSQL_RES *result = conn->getResult();
-    if (!result)
+    stmt->bindInt(0, limit);
+    if (!stmt->execute())
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
-      spdlog::error("Failed to get result set");
+      spdlog::error("Failed to query pending jobs");
       return jobs;
     }
 
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result)))
+    jobs.reserve(stmt->rowCount());
+    while (stmt->fetch())
     {
-      mysql_data_seek(result, jobs.size());
-      JobInfo job = buildJobInfoFromResult(result);
-      jobs.push_back(job);
+      jobs.push_back(buildJobInfo(*stmt));
     }
 
-    mysql_free_result(result);
-    DBConnectionPool::getInstance().releaseConnection(conn);
-
     return jobs;
   }
 
@@ -378,49 +475,30 @@ namespace scheduler
       return jobs;
     }
 
-    std::string jobType;
-    if (type == JobType::ONCE)
-    {
-      jobType = "ONCE";
-    }
-    else if (type == JobType::PERIODIC)
-    {
-      jobType = "PERIODIC";
-    }
-
-    std::stringstream ss;
-    ss << "SELECT job_id, name, command, job_type, priority, "
-       << "cron_expression, timeout, retry_count, retry_interval "
-       << "FROM job_info WHERE job_type = '" << jobType << "' "
-       << "ORDER BY priority DESC, create_time DESC "
-       << "LIMIT " << limit << " OFFSET " << offset;
-
-    if (!conn->executeQuery(ss.str()))
+    auto stmt = conn->prepare("SELECT " + kJobColumns +
+                              "FROM job_info WHERE job_type = ? "
+                              "ORDER BY priority DESC, create_time DESC LIMIT ? OFFSET ?");
+    if (!stmt)
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
       spdlog::error("Failed to query jobs by type");
       return jobs;
     }
 
-    MYSQL_RES *result = conn->getResult();
-    if (!result)
+    stmt->bindString(0, jobTypeToString(type));
+    stmt->bindInt(1, limit);
+    stmt->bindInt(2, offset);
+    if (!stmt->execute())
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
-      spdlog::error("Failed to get result set");
+      spdlog::error("Failed to query jobs by type");
       return jobs;
     }
 
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result)))
+    jobs.reserve(stmt->rowCount());
+    while (stmt->fetch())
     {
-      mysql_data_seek(result, jobs.size());
-      JobInfo job = buildJobInfoFromResult(result);
-      jobs.push_back(job);
+      jobs.push_back(buildJobInfo(*stmt));
     }
 
-    mysql_free_result(result);
-    DBConnectionPool::getInstance().releaseConnection(conn);
-
     return jobs;
   }
 
@@ -434,137 +512,105 @@ namespace scheduler
       return 0;
     }
 
-    std::string query = "SELECT COUNT(*) FROM job_info";
-
-    if (!conn->executeQuery(query))
+    auto stmt = conn->prepare("SELECT COUNT(*) FROM job_info");
+    if (!stmt || !stmt->execute())
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
       spdlog::error("Failed to count jobs");
       return 0;
     }
 
-    MYSQL_RES *result = conn->getResult();
-    if (!result)
-    {
-      DBConnectionPool::getInstance().releaseConnection(conn);
-      spdlog::error("Failed to get result set");
-      return 0;
-    }
-
-    MYSQL_ROW row = mysql_fetch_row(result);
     int count = 0;
-
-    if (row && row[0])
+    if (stmt->fetch())
     {
-      count = std::stoi(row[0]);
+      count = static_cast<int>(stmt->getInt(0));
     }
 
-    mysql_free_result(result);
-    DBConnectionPool::getInstance().releaseConnection(conn);
-
     return count;
   }
 
-  // 从结果集构建JobResult对象
-  JobResult JobDAO::buildJobResultFromResult(MYSQL_RES *result)
+  // 从当前行构建JobResult对象
+  JobResult JobDAO::buildJobResult(const PreparedStatement &stmt)
   {
     JobResult jobResult;
 
-    if (!result)
+    // 获取字段值
+    jobResult.execution_id = stmt.getUInt(0);
+    jobResult.job_id = stmt.getString(1);
+    jobResult.executor_id = stmt.getString(2);
+
+    // 解析任务状态
+    std::string statusStr = stmt.getString(3);
+    if (statusStr == "WAITING")
     {
-      return jobResult;
+      jobResult.status = JobStatus::WAITING;
     }
-
-    MYSQL_ROW row = mysql_fetch_row(result);
-    if (!row)
+    else if (statusStr == "RUNNING")
     {
-      return jobResult;
+      jobResult.status = JobStatus::RUNNING;
     }
-
-    unsigned long *lengths = mysql_fetch_lengths(result);
-
-    // 获取字段值
-    if (row[0]) // execution_id
+    else if (statusStr == "SUCCESS")
     {
-      try
-      {
-        jobResult.execution_id = std::stoull(std::string(row[0], lengths[0]));
-      }
-      catch (const std::exception &e)
-      {
-        spdlog::error("Failed to parse execution_id: {}", e.what());
-      }
+      jobResult.status = JobStatus::SUCCESS;
     }
-    if (row[1])
-      jobResult.job_id = std::string(row[1], lengths[1]);
-
-    // 解析任务状态
-    if (row[3])
+    else if (statusStr == "FAILED")
     {
-      std::string statusStr = std::string(row[3], lengths[3]);
-      if (statusStr == "WAITING")
-      {
-        jobResult.status = JobStatus::WAITING;
-      }
-      else if (statusStr == "RUNNING")
-      {
-        jobResult.status = JobStatus::RUNNING;
-      }
-      else if (statusStr == "SUCCESS")
-      {
-        jobResult.status = JobStatus::SUCCESS;
-      }
-      else if (statusStr == "FAILED")
-      {
-        jobResult.status = JobStatus::FAILED;
-      }
-      else if (statusStr == "TIMEOUT")
-      {
-        jobResult.status = JobStatus::TIMEOUT;
-      }
+      jobResult.status = JobStatus::FAILED;
+    }
+    else if (statusStr == "TIMEOUT")
+    {
+      jobResult.status = JobStatus::TIMEOUT;
     }
 
     // 解析开始和结束时间
-    if (row[4])
-      jobResult.start_time = stringToTimePoint(std::string(row[4], lengths[4]));
-    if (row[5])
-      jobResult.end_time = stringToTimePoint(std::string(row[5], lengths[5]));
+    if (!stmt.isNull(4))
+      jobResult.start_time = stmt.getTime(4);
+    if (!stmt.isNull(5))
+      jobResult.end_time = stmt.getTime(5);
 
     // 解析输出和错误信息
-    if (row[6])
-      jobResult.output = std::string(row[6], lengths[6]);
-    if (row[7])
-      jobResult.error = std::string(row[7], lengths[7]);
+    jobResult.output = stmt.getString(6);
+    jobResult.error = stmt.getString(7);
+
+    // 解析资源使用统计
+    jobResult.cpu_time_ms = stmt.getUInt(8);
+    jobResult.peak_rss_kb = stmt.getUInt(9);
+    jobResult.io_read_bytes = stmt.getUInt(10);
+    jobResult.io_write_bytes = stmt.getUInt(11);
+
+    // output和error保持压缩状态，由调用方按需解压
+    if (!stmt.isNull(12) && !PayloadCompressor::codecFromString(stmt.getString(12), jobResult.payload_codec))
+    {
+      spdlog::error("Unknown payload codec for execution: {}", jobResult.execution_id);
+    }
 
     return jobResult;
   }
 
   // 保存任务执行记录
-  bool JobDAO::saveExecution(const std::string &jobId, const std::string &executorId)
+  uint64_t JobDAO::saveExecution(const std::string &jobId, const std::string &executorId)
   {
     auto conn = DBConnectionPool::getInstance().getConnection();
     if (!conn)
     {
       spdlog::error("Failed to get database connection");
-      return false;
+      return 0;
     }
 
-    std::stringstream ss;
-    ss << "INSERT INTO job_execution (job_id, executor_id, status) VALUES ("
-       << "'" << jobId << "', "
-       << (executorId.empty() ? "NULL" : ("'" + executorId + "'")) << ", "
-       << "'WAITING')";
+    auto stmt = conn->prepare("INSERT INTO job_execution (job_id, executor_id, status) VALUES (?, ?, 'WAITING')");
 
-    bool result = conn->executeUpdate(ss.str());
+    bool result = false;
     uint64_t executionId = 0;
-
-    if (result)
+    if (stmt)
     {
-      executionId = conn->getLastInsertId();
+      stmt->bindString(0, jobId);
+      stmt->bindOptionalString(1, executorId);
+      result = stmt->execute();
+      if (result)
+      {
+        executionId = stmt->insertId();
+      }
     }
 
-    DBConnectionPool::getInstance().releaseConnection(conn);
-
     if (!result)
     {
       spdlog::error("Failed to save execution for job: {}", jobId);
@@ -574,9 +620,104 @@ namespace scheduler
       spdlog::info("Execution saved successfully for job: {}, execution ID: {}", jobId, executionId);
     }
 
+    return executionId;
+  }
+
+  // 删除执行记录
+  bool JobDAO::deleteExecution(uint64_t executionId)
+  {
+    auto conn = DBConnectionPool::getInstance().getConnection();
+    if (!conn)
+    {
+      spdlog::error("Failed to get database connection");
+      return false;
+    }
+
+    auto stmt = conn->prepare("DELETE FROM job_execution WHERE execution_id = ?");
+
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindUInt(0, executionId);
+      result = stmt->execute();
+    }
+
+    if (!result)
+    {
+      spdlog::error("Failed to delete execution: {}", executionId);
+    }
+
     return result;
   }
 
+  // 异步删除执行记录
+  std::future<bool> JobDAO::deleteExecutionAsync(uint64_t executionId)
+  {
+    if (!AsyncQueryEngine::getInstance().isRunning())
+    {
+      return readyFuture(deleteExecution(executionId));
+    }
+
+    AsyncStatement stmt("DELETE FROM job_execution WHERE execution_id = ?");
+    stmt.bindUInt(0, executionId);
+    return submitAsync(std::move(stmt), [executionId](const AsyncQueryResult &result)
+                       {
+      if (!result.success)
+      {
+        spdlog::error("Failed to delete execution: {}", executionId);
+      } });
+  }
+
+  // 异步保存任务执行记录
+  void JobDAO::saveExecutionAsync(const std::string &jobId, const std::string &executorId,
+                                  std::function<void(uint64_t)> onSaved)
+  {
+    if (!AsyncQueryEngine::getInstance().isRunning())
+    {
+      onSaved(saveExecution(jobId, executorId));
+      return;
+    }
+
+    insertExecutionAsync(jobId, executorId, newDispatchToken(), 1, std::move(onSaved));
+  }
+
+  // 异步写入执行结果
+  void JobDAO::updateExecutionResultAsync(const JobResult &result, std::function<void(bool)> onDone)
+  {
+    if (!AsyncQueryEngine::getInstance().isRunning())
+    {
+      std::vector<uint64_t> applied;
+      updateExecutionResults({{result.execution_id, result}}, &applied);
+      onDone(!applied.empty());
+      return;
+    }
+
+    // 执行器ID也作为条件：执行记录被重新派发给其他执行器后，原执行器迟到的结果不生效
+    AsyncStatement stmt(
+        "UPDATE job_execution SET status = ?, output = ?, error = ?, payload_codec = ?, "
+        "cpu_time_ms = ?, peak_rss_kb = ?, io_read_bytes = ?, io_write_bytes = ?, end_time = CURRENT_TIMESTAMP "
+        "WHERE execution_id = ? AND job_id = ? AND executor_id = ? AND status IN ('WAITING', 'RUNNING')");
+    stmt.bindString(0, jobStatusToString(result.status));
+    stmt.bindBlob(1, result.output);
+    stmt.bindBlob(2, result.error);
+    stmt.bindString(3, PayloadCompressor::codecToString(result.payload_codec));
+    stmt.bindUInt(4, result.cpu_time_ms);
+    stmt.bindUInt(5, result.peak_rss_kb);
+    stmt.bindUInt(6, result.io_read_bytes);
+    stmt.bindUInt(7, result.io_write_bytes);
+    stmt.bindUInt(8, result.execution_id);
+    stmt.bindString(9, result.job_id);
+    stmt.bindString(10, result.executor_id);
+    uint64_t executionId = result.execution_id;
+    AsyncQueryEngine::getInstance().submit(std::move(stmt), [executionId, onDone](const AsyncQueryResult &written)
+                                           {
+      if (!written.success)
+      {
+        spdlog::error("Failed to update execution result: {}", executionId);
+      }
+      onDone(written.success && written.affected_rows == 1); });
+  }
+
   // 更新任务执行状态
   bool JobDAO::updateExecutionStatus(uint64_t executionId, JobStatus status)
   {
@@ -587,33 +728,17 @@ namespace scheduler
       return false;
     }
 
-    std::string statusStr;
-    switch (status)
+    std::string statusStr = jobStatusToString(status);
+    auto stmt = conn->prepare("UPDATE job_execution SET status = ? WHERE execution_id = ?");
+
+    bool result = false;
+    if (stmt)
     {
-    case JobStatus::WAITING:
-      statusStr = "WAITING";
-      break;
-    case JobStatus::RUNNING:
-      statusStr = "RUNNING";
-      break;
-    case JobStatus::SUCCESS:
-      statusStr = "SUCCESS";
-      break;
-    case JobStatus::FAILED:
-      statusStr = "FAILED";
-      break;
-    case JobStatus::TIMEOUT:
-      statusStr = "TIMEOUT";
-      break;
+      stmt->bindString(0, statusStr);
+      stmt->bindUInt(1, executionId);
+      result = stmt->execute();
     }
 
-    std::stringstream ss;
-    ss << "UPDATE job_execution SET status = '" << statusStr << "' "
-       << "WHERE execution_id = " << executionId;
-
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
-
     if (!result)
     {
       spdlog::error("Failed to update execution status: {}", executionId);
@@ -626,10 +751,14 @@ namespace scheduler
     return result;
   }
 
-  // 更新任务执行结果
-  bool JobDAO::updateExecutionResult(uint64_t executionId, JobStatus status,
-                                     const std::string &output, const std::string &error)
+  // 批量更新任务执行状态
+  bool JobDAO::updateExecutionStatuses(const std::vector<std::pair<uint64_t, JobStatus>> &statuses)
   {
+    if (statuses.empty())
+    {
+      return true;
+    }
+
     auto conn = DBConnectionPool::getInstance().getConnection();
     if (!conn)
     {
@@ -637,47 +766,77 @@ namespace scheduler
       return false;
     }
 
-    std::string statusStr;
-    switch (status)
+    bool result = true;
+    for (size_t begin = 0; begin < statuses.size() && result; begin += kMaxBatchRows)
     {
-    case JobStatus::WAITING:
-      statusStr = "WAITING";
-      break;
-    case JobStatus::RUNNING:
-      statusStr = "RUNNING";
-      break;
-    case JobStatus::SUCCESS:
-      statusStr = "SUCCESS";
-      break;
-    case JobStatus::FAILED:
-      statusStr = "FAILED";
-      break;
-    case JobStatus::TIMEOUT:
-      statusStr = "TIMEOUT";
-      break;
-    }
+      size_t count = std::min(kMaxBatchRows, statuses.size() - begin);
 
-    // 转义输出和错误信息中的特殊字符
-    char *escapedOutput = new char[output.length() * 2 + 1];
-    char *escapedError = new char[error.length() * 2 + 1];
+      // 占位符个数取2的幂，多出的位置重复最后一条，CASE取第一个匹配的分支。
+      // MySQL按顺序赋值，start_time的表达式读到的是更新后的状态。重复执行结果相同，分多条写入不需要事务
+      size_t slots = roundUpPowerOfTwo(count);
+      std::string cases;
+      for (size_t i = 0; i < slots; ++i)
+      {
+        cases += "WHEN ? THEN ? ";
+      }
+      auto stmt = conn->prepare(
+          "UPDATE job_execution SET status = CASE execution_id " + cases + "END, "
+          "start_time = IF(status = 'RUNNING', COALESCE(start_time, CURRENT_TIMESTAMP), start_time) "
+          "WHERE execution_id IN (" + PreparedStatement::placeholders(slots) + ") "
+          "AND status IN ('WAITING', 'RUNNING')");
+      if (!stmt)
+      {
+        result = false;
+        break;
+      }
 
-    mysql_real_escape_string(conn->getRawConnection(), escapedOutput, output.c_str(), output.length());
-    mysql_real_escape_string(conn->getRawConnection(), escapedError, error.c_str(), error.length());
+      for (size_t i = 0; i < slots; ++i)
+      {
+        const auto &entry = statuses[begin + std::min(i, count - 1)];
+        stmt->bindUInt(2 * i, entry.first);
+        stmt->bindString(2 * i + 1, jobStatusToString(entry.second));
+        stmt->bindUInt(2 * slots + i, entry.first);
+      }
+      result = stmt->execute();
+    }
 
-    std::stringstream ss;
-    ss << "UPDATE job_execution SET "
-       << "status = '" << statusStr << "', "
-       << "output = '" << escapedOutput << "', "
-       << "error = '" << escapedError << "', "
-       << "end_time = CURRENT_TIMESTAMP "
-       << "WHERE execution_id = " << executionId;
+    if (!result)
+    {
+      spdlog::error("Failed to update status of {} executions", statuses.size());
+    }
+    else
+    {
+      spdlog::debug("Execution statuses updated: {}", statuses.size());
+    }
+
+    return result;
+  }
 
-    bool result = conn->executeUpdate(ss.str());
+  // 更新任务执行结果
+  bool JobDAO::updateExecutionResult(uint64_t executionId, JobStatus status,
+                                     const std::string &output, const std::string &error)
+  {
+    auto conn = DBConnectionPool::getInstance().getConnection();
+    if (!conn)
+    {
+      spdlog::error("Failed to get database connection");
+      return false;
+    }
 
-    delete[] escapedOutput;
-    delete[] escapedError;
+    // 输出和错误信息按二进制绑定，不需要转义
+    auto stmt = conn->prepare(
+        "UPDATE job_execution SET status = ?, output = ?, error = ?, payload_codec = 'NONE', "
+        "end_time = CURRENT_TIMESTAMP WHERE execution_id = ?");
 
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindString(0, jobStatusToString(status));
+      stmt->bindBlob(1, output);
+      stmt->bindBlob(2, error);
+      stmt->bindUInt(3, executionId);
+      result = stmt->execute();
+    }
 
     if (!result)
     {
@@ -691,10 +850,80 @@ namespace scheduler
     return result;
   }
 
-  // 更新任务执行时间
-  bool JobDAO::updateExecutionTimes(uint64_t executionId,
-                                    const std::chrono::system_clock::time_point &startTime,
-                                    const std::chrono::system_clock::time_point &endTime)
+  // 批量更新任务执行结果
+  bool JobDAO::updateExecutionResults(const std::vector<std::pair<uint64_t, JobResult>> &results,
+                                      std::vector<uint64_t> *applied)
+  {
+    if (results.empty())
+    {
+      return true;
+    }
+
+    auto conn = DBConnectionPool::getInstance().getConnection();
+    if (!conn)
+    {
+      spdlog::error("Failed to get database connection");
+      return false;
+    }
+
+    // 同一条语句在事务中按每个结果重新绑定执行；
+    // 检查状态和写入结果在同一条语句中完成，已结束的执行记录影响行数为0
+    auto stmt = conn->prepare(
+        "UPDATE job_execution SET status = ?, output = ?, error = ?, payload_codec = ?, "
+        "cpu_time_ms = ?, peak_rss_kb = ?, io_read_bytes = ?, io_write_bytes = ?, "
+        "end_time = CURRENT_TIMESTAMP WHERE execution_id = ? AND status IN ('WAITING', 'RUNNING')");
+    if (!stmt || !conn->executeUpdate("START TRANSACTION"))
+    {
+      return false;
+    }
+
+    bool ok = true;
+    std::vector<uint64_t> updated;
+    for (const auto &entry : results)
+    {
+      const JobResult &result = entry.second;
+
+      stmt->bindString(0, jobStatusToString(result.status));
+      stmt->bindBlob(1, result.output);
+      stmt->bindBlob(2, result.error);
+      stmt->bindString(3, PayloadCompressor::codecToString(result.payload_codec));
+      stmt->bindUInt(4, result.cpu_time_ms);
+      stmt->bindUInt(5, result.peak_rss_kb);
+      stmt->bindUInt(6, result.io_read_bytes);
+      stmt->bindUInt(7, result.io_write_bytes);
+      stmt->bindUInt(8, entry.first);
+
+      if (!stmt->execute())
+      {
+        ok = false;
+        break;
+      }
+      if (stmt->affectedRows() == 1)
+      {
+        updated.push_back(entry.first);
+      }
+    }
+
+    ok = conn->executeUpdate(ok ? "COMMIT" : "ROLLBACK") && ok;
+    if (ok && applied)
+    {
+      applied->insert(applied->end(), updated.begin(), updated.end());
+    }
+
+    if (!ok)
+    {
+      spdlog::error("Failed to update {} execution results", results.size());
+    }
+    else
+    {
+      spdlog::debug("Execution results updated: {}/{}", updated.size(), results.size());
+    }
+
+    return ok;
+  }
+
+  // 更新任务执行资源使用
+  bool JobDAO::updateExecutionResourceUsage(uint64_t executionId, const JobResult &result)
   {
     auto conn = DBConnectionPool::getInstance().getConnection();
     if (!conn)
@@ -703,27 +932,63 @@ namespace scheduler
       return false;
     }
 
-    std::string startTimeStr = timePointToString(startTime);
-    std::string endTimeStr;
+    auto stmt = conn->prepare(
+        "UPDATE job_execution SET cpu_time_ms = ?, peak_rss_kb = ?, io_read_bytes = ?, io_write_bytes = ? "
+        "WHERE execution_id = ?");
 
-    // 如果结束时间是默认值，则设置为NULL
-    if (endTime == std::chrono::system_clock::time_point())
+    bool ok = false;
+    if (stmt)
     {
-      endTimeStr = "NULL";
+      stmt->bindUInt(0, result.cpu_time_ms);
+      stmt->bindUInt(1, result.peak_rss_kb);
+      stmt->bindUInt(2, result.io_read_bytes);
+      stmt->bindUInt(3, result.io_write_bytes);
+      stmt->bindUInt(4, executionId);
+      ok = stmt->execute();
+    }
+
+    if (!ok)
+    {
+      spdlog::error("Failed to update execution resource usage: {}", executionId);
     }
     else
     {
-      endTimeStr = "'" + timePointToString(endTime) + "'";
+      spdlog::debug("Execution resource usage updated: {}", executionId);
+    }
+
+    return ok;
+  }
+
+  // 更新任务执行时间
+  bool JobDAO::updateExecutionTimes(uint64_t executionId,
+                                    const std::chrono::system_clock::time_point &startTime,
+                                    const std::chrono::system_clock::time_point &endTime)
+  {
+    auto conn = DBConnectionPool::getInstance().getConnection();
+    if (!conn)
+    {
+      spdlog::error("Failed to get database connection");
+      return false;
     }
 
-    std::stringstream ss;
-    ss << "UPDATE job_execution SET "
-       << "start_time = '" << startTimeStr << "', "
-       << "end_time = " << endTimeStr << " "
-       << "WHERE execution_id = " << executionId;
+    auto stmt = conn->prepare("UPDATE job_execution SET start_time = ?, end_time = ? WHERE execution_id = ?");
 
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindTime(0, startTime);
+      // 如果结束时间是默认值，则设置为NULL
+      if (endTime == std::chrono::system_clock::time_point())
+      {
+        stmt->bindNull(1);
+      }
+      else
+      {
+        stmt->bindTime(1, endTime);
+      }
+      stmt->bindUInt(2, executionId);
+      result = stmt->execute();
+    }
 
     if (!result)
     {
@@ -749,37 +1014,66 @@ namespace scheduler
       return results;
     }
 
-    std::stringstream ss;
-    ss << "SELECT execution_id, job_id, executor_id, status, start_time, end_time, output, error "
-       << "FROM job_execution WHERE job_id = '" << jobId << "' "
-       << "ORDER BY trigger_time DESC "
-       << "LIMIT " << limit << " OFFSET " << offset;
+    auto stmt = conn->prepare("SELECT " + kExecutionColumns +
+                              "FROM job_execution WHERE job_id = ? "
+                              "ORDER BY trigger_time DESC LIMIT ? OFFSET ?");
+    if (!stmt)
+    {
+      spdlog::error("Failed to query job executions: {}", jobId);
+      return results;
+    }
 
-    if (!conn->executeQuery(ss.str()))
+    stmt->bindString(0, jobId);
+    stmt->bindInt(1, limit);
+    stmt->bindInt(2, offset);
+    if (!stmt->execute())
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
       spdlog::error("Failed to query job executions: {}", jobId);
       return results;
     }
 
-    MYSQL_RES *result = conn->getResult();
-    if (!result)
+    results.reserve(stmt->rowCount());
+    while (stmt->fetch())
+    {
+      results.push_back(buildJobResult(*stmt));
+    }
+
+    return results;
+  }
+
+  // 获取执行器上尚未结束的执行记录
+  std::vector<JobResult> JobDAO::getInFlightExecutions(const std::string &executorId)
+  {
+    std::vector<JobResult> results;
+
+    auto conn = DBConnectionPool::getInstance().getConnection();
+    if (!conn)
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
-      spdlog::error("Failed to get result set");
+      spdlog::error("Failed to get database connection");
       return results;
     }
 
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result)))
+    auto stmt = conn->prepare("SELECT " + kExecutionColumns +
+                              "FROM job_execution WHERE executor_id = ? "
+                              "AND status IN ('WAITING', 'RUNNING')");
+    if (!stmt)
     {
-      mysql_data_seek(result, results.size());
-      JobResult jobResult = buildJobResultFromResult(result);
-      results.push_back(jobResult);
+      spdlog::error("Failed to query in-flight executions: {}", executorId);
+      return results;
+    }
+
+    stmt->bindString(0, executorId);
+    if (!stmt->execute())
+    {
+      spdlog::error("Failed to query in-flight executions: {}", executorId);
+      return results;
     }
 
-    mysql_free_result(result);
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    results.reserve(stmt->rowCount());
+    while (stmt->fetch())
+    {
+      results.push_back(buildJobResult(*stmt));
+    }
 
     return results;
   }
@@ -794,30 +1088,27 @@ namespace scheduler
       return std::nullopt;
     }
 
-    std::stringstream ss;
-    ss << "SELECT execution_id, job_id, executor_id, status, start_time, end_time, output, error "
-       << "FROM job_execution WHERE execution_id = " << executionId;
+    auto stmt = conn->prepare("SELECT " + kExecutionColumns + "FROM job_execution WHERE execution_id = ?");
+    if (!stmt)
+    {
+      spdlog::error("Failed to query execution: {}", executionId);
+      return std::nullopt;
+    }
 
-    if (!conn->executeQuery(ss.str()))
+    stmt->bindUInt(0, executionId);
+    if (!stmt->execute())
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
       spdlog::error("Failed to query execution: {}", executionId);
       return std::nullopt;
     }
 
-    MYSQL_RES *result = conn->getResult();
-    if (!result || mysql_num_rows(result) == 0)
+    if (!stmt->fetch())
     {
-      if (result)
-        mysql_free_result(result);
-      DBConnectionPool::getInstance().releaseConnection(conn);
       spdlog::warn("Execution not found: {}", executionId);
       return std::nullopt;
     }
 
-    JobResult jobResult = buildJobResultFromResult(result);
-    mysql_free_result(result);
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    JobResult jobResult = buildJobResult(*stmt);
 
     return jobResult;
   }
@@ -834,38 +1125,27 @@ namespace scheduler
       return results;
     }
 
-    std::stringstream ss;
-    ss << "SELECT execution_id, job_id, executor_id, status, start_time, end_time, output, error "
-       << "FROM job_execution "
-       << "ORDER BY trigger_time DESC "
-       << "LIMIT " << limit;
-
-    if (!conn->executeQuery(ss.str()))
+    auto stmt = conn->prepare("SELECT " + kExecutionColumns +
+                              "FROM job_execution ORDER BY trigger_time DESC LIMIT ?");
+    if (!stmt)
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
       spdlog::error("Failed to query recent executions");
       return results;
     }
 
-    MYSQL_RES *result = conn->getResult();
-    if (!result)
+    stmt->bindInt(0, limit);
+    if (!stmt->execute())
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
-      spdlog::error("Failed to get result set");
+      spdlog::error("Failed to query recent executions");
       return results;
     }
 
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result)))
+    results.reserve(stmt->rowCount());
+    while (stmt->fetch())
     {
-      mysql_data_seek(result, results.size());
-      JobResult jobResult = buildJobResultFromResult(result);
-      results.push_back(jobResult);
+      results.push_back(buildJobResult(*stmt));
     }
 
-    mysql_free_result(result);
-    DBConnectionPool::getInstance().releaseConnection(conn);
-
     return results;
   }
 
@@ -879,35 +1159,23 @@ namespace scheduler
       return 0;
     }
 
-    std::stringstream ss;
-    ss << "SELECT COUNT(*) FROM job_execution WHERE job_id = '" << jobId << "'";
-
-    if (!conn->executeQuery(ss.str()))
+    auto stmt = conn->prepare("SELECT COUNT(*) FROM job_execution WHERE job_id = ?");
+    if (stmt)
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
-      spdlog::error("Failed to count executions for job: {}", jobId);
-      return 0;
+      stmt->bindString(0, jobId);
     }
-
-    MYSQL_RES *result = conn->getResult();
-    if (!result)
+    if (!stmt || !stmt->execute())
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
-      spdlog::error("Failed to get result set");
+      spdlog::error("Failed to count executions for job: {}", jobId);
       return 0;
     }
 
-    MYSQL_ROW row = mysql_fetch_row(result);
     int count = 0;
-
-    if (row && row[0])
+    if (stmt->fetch())
     {
-      count = std::stoi(row[0]);
+      count = static_cast<int>(stmt->getInt(0));
     }
 
-    mysql_free_result(result);
-    DBConnectionPool::getInstance().releaseConnection(conn);
-
     return count;
   }
 
@@ -923,22 +1191,20 @@ namespace scheduler
       return false;
     }
 
-    std::stringstream ss;
-    ss << "INSERT INTO executor_node (executor_id, host, port, status, max_load) VALUES ("
-       << "'" << executorId << "', "
-       << "'" << host << "', "
-       << port << ", "
-       << "'ONLINE', "
-       << maxLoad << ") "
-       << "ON DUPLICATE KEY UPDATE "
-       << "host = '" << host << "', "
-       << "port = " << port << ", "
-       << "status = 'ONLINE', "
-       << "max_load = " << maxLoad << ", "
-       << "last_heartbeat = CURRENT_TIMESTAMP";
+    auto stmt = conn->prepare(
+        "INSERT INTO executor_node (executor_id, host, port, status, max_load) VALUES (?, ?, ?, 'ONLINE', ?) "
+        "ON DUPLICATE KEY UPDATE host = VALUES(host), port = VALUES(port), status = 'ONLINE', "
+        "max_load = VALUES(max_load), last_heartbeat = CURRENT_TIMESTAMP");
 
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindString(0, executorId);
+      stmt->bindString(1, host);
+      stmt->bindInt(2, port);
+      stmt->bindInt(3, maxLoad);
+      result = stmt->execute();
+    }
 
     if (!result)
     {
@@ -964,14 +1230,18 @@ namespace scheduler
 
     std::string status = online ? "ONLINE" : "OFFLINE";
 
-    std::stringstream ss;
-    ss << "UPDATE executor_node SET "
-       << "status = '" << status << "', "
-       << "last_heartbeat = " << (online ? "CURRENT_TIMESTAMP" : "last_heartbeat")
-       << " WHERE executor_id = '" << executorId << "'";
+    // 上线时同时刷新心跳时间
+    auto stmt = conn->prepare(online
+                                  ? "UPDATE executor_node SET status = ?, last_heartbeat = CURRENT_TIMESTAMP WHERE executor_id = ?"
+                                  : "UPDATE executor_node SET status = ? WHERE executor_id = ?");
 
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindString(0, status);
+      stmt->bindString(1, executorId);
+      result = stmt->execute();
+    }
 
     if (!result)
     {
@@ -985,6 +1255,37 @@ namespace scheduler
     return result;
   }
 
+  // 标记执行器为排空中
+  bool JobDAO::markExecutorDraining(const std::string &executorId)
+  {
+    auto conn = DBConnectionPool::getInstance().getConnection();
+    if (!conn)
+    {
+      spdlog::error("Failed to get database connection");
+      return false;
+    }
+
+    auto stmt = conn->prepare("UPDATE executor_node SET status = 'DRAINING' WHERE executor_id = ?");
+
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindString(0, executorId);
+      result = stmt->execute();
+    }
+
+    if (!result)
+    {
+      spdlog::error("Failed to mark executor draining: {}", executorId);
+    }
+    else
+    {
+      spdlog::info("Executor marked draining: {}", executorId);
+    }
+
+    return result;
+  }
+
   // 更新执行器心跳
   bool JobDAO::updateExecutorHeartbeat(const std::string &executorId)
   {
@@ -995,13 +1296,14 @@ namespace scheduler
       return false;
     }
 
-    std::stringstream ss;
-    ss << "UPDATE executor_node SET "
-       << "last_heartbeat = CURRENT_TIMESTAMP "
-       << "WHERE executor_id = '" << executorId << "'";
+    auto stmt = conn->prepare("UPDATE executor_node SET last_heartbeat = CURRENT_TIMESTAMP WHERE executor_id = ?");
 
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindString(0, executorId);
+      result = stmt->execute();
+    }
 
     if (!result)
     {
@@ -1015,6 +1317,48 @@ namespace scheduler
     return result;
   }
 
+  // 批量更新执行器心跳
+  bool JobDAO::updateExecutorHeartbeats(const std::vector<std::string> &executorIds)
+  {
+    if (executorIds.empty())
+    {
+      return true;
+    }
+
+    auto conn = DBConnectionPool::getInstance().getConnection();
+    if (!conn)
+    {
+      spdlog::error("Failed to get database connection");
+      return false;
+    }
+
+    // 占位符个数取2的幂，多出的位置重复最后一个ID
+    size_t slots = roundUpPowerOfTwo(executorIds.size());
+    auto stmt = conn->prepare("UPDATE executor_node SET last_heartbeat = CURRENT_TIMESTAMP WHERE executor_id IN (" +
+                              PreparedStatement::placeholders(slots) + ")");
+
+    bool result = false;
+    if (stmt)
+    {
+      for (size_t i = 0; i < slots; ++i)
+      {
+        stmt->bindString(i, executorIds[std::min(i, executorIds.size() - 1)]);
+      }
+      result = stmt->execute();
+    }
+
+    if (!result)
+    {
+      spdlog::error("Failed to update heartbeats of {} executors", executorIds.size());
+    }
+    else
+    {
+      spdlog::debug("Heartbeats updated for {} executors", executorIds.size());
+    }
+
+    return result;
+  }
+
   // 获取在线执行器列表
   std::vector<std::pair<std::string, std::string>> JobDAO::getOnlineExecutors()
   {
@@ -1028,46 +1372,27 @@ namespace scheduler
     }
 
     // 获取最近5分钟有心跳的执行器
-    std::stringstream ss;
-    ss << "SELECT executor_id, host, port FROM executor_node "
-       << "WHERE status = 'ONLINE' AND "
-       << "last_heartbeat > DATE_SUB(NOW(), INTERVAL 5 MINUTE)";
-
-    if (!conn->executeQuery(ss.str()))
+    auto stmt = conn->prepare(
+        "SELECT executor_id, host, port FROM executor_node "
+        "WHERE status = 'ONLINE' AND last_heartbeat > DATE_SUB(NOW(), INTERVAL 5 MINUTE)");
+    if (!stmt || !stmt->execute())
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
       spdlog::error("Failed to query online executors");
       return executors;
     }
 
-    MYSQL_RES *result = conn->getResult();
-    if (!result)
-    {
-      DBConnectionPool::getInstance().releaseConnection(conn);
-      spdlog::error("Failed to get result set");
-      return executors;
-    }
-
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result)))
+    while (stmt->fetch())
     {
-      if (row[0] && row[1] && row[2])
+      if (!stmt->isNull(0) && !stmt->isNull(1) && !stmt->isNull(2))
       {
-        std::string executorId = row[0];
-        std::string host = row[1];
-        int port = std::stoi(row[2]);
-
         // 构建地址字符串
         std::stringstream addrSs;
-        addrSs << host << ":" << port;
+        addrSs << stmt->getString(1) << ":" << stmt->getInt(2);
 
-        executors.emplace_back(executorId, addrSs.str());
+        executors.emplace_back(stmt->getString(0), addrSs.str());
       }
     }
 
-    mysql_free_result(result);
-    DBConnectionPool::getInstance().releaseConnection(conn);
-
     return executors;
   }
 
@@ -1084,53 +1409,45 @@ namespace scheduler
     }
 
     // 首先清理过期的锁
-    std::stringstream cleanSs;
-    cleanSs << "DELETE FROM job_lock WHERE expire_time < NOW()";
-    conn->executeUpdate(cleanSs.str());
+    auto clean = conn->prepare("DELETE FROM job_lock WHERE expire_time < NOW()");
+    if (clean)
+    {
+      clean->execute();
+    }
 
     // 尝试获取锁
-    std::stringstream ss;
-    ss << "INSERT INTO job_lock (lock_name, lock_owner, expire_time) VALUES ("
-       << "'" << lockName << "', "
-       << "'" << owner << "', "
-       << "DATE_ADD(NOW(), INTERVAL " << expireSeconds << " SECOND)) "
-       << "ON DUPLICATE KEY UPDATE "
-       << "lock_owner = IF(expire_time < NOW(), VALUES(lock_owner), lock_owner), "
-       << "expire_time = IF(expire_time < NOW() OR lock_owner = VALUES(lock_owner), "
-       << "VALUES(expire_time), expire_time), "
-       << "lock_time = IF(expire_time < NOW() OR lock_owner = VALUES(lock_owner), "
-       << "NOW(), lock_time)";
-
-    bool result = conn->executeUpdate(ss.str());
+    auto stmt = conn->prepare(
+        "INSERT INTO job_lock (lock_name, lock_owner, expire_time) "
+        "VALUES (?, ?, DATE_ADD(NOW(), INTERVAL ? SECOND)) "
+        "ON DUPLICATE KEY UPDATE "
+        "lock_owner = IF(expire_time < NOW(), VALUES(lock_owner), lock_owner), "
+        "expire_time = IF(expire_time < NOW() OR lock_owner = VALUES(lock_owner), VALUES(expire_time), expire_time), "
+        "lock_time = IF(expire_time < NOW() OR lock_owner = VALUES(lock_owner), NOW(), lock_time)");
+
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindString(0, lockName);
+      stmt->bindString(1, owner);
+      stmt->bindInt(2, expireSeconds);
+      result = stmt->execute();
+    }
 
     // 检查是否真的获取了锁
     if (result)
     {
-      std::stringstream checkSs;
-      checkSs << "SELECT lock_owner FROM job_lock "
-              << "WHERE lock_name = '" << lockName << "' "
-              << "AND lock_owner = '" << owner << "'";
-
-      if (!conn->executeQuery(checkSs.str()))
+      auto check = conn->prepare("SELECT lock_owner FROM job_lock WHERE lock_name = ? AND lock_owner = ?");
+      if (check)
       {
-        DBConnectionPool::getInstance().releaseConnection(conn);
-        return false;
+        check->bindString(0, lockName);
+        check->bindString(1, owner);
       }
-
-      MYSQL_RES *checkResult = conn->getResult();
-      if (!checkResult || mysql_num_rows(checkResult) == 0)
+      if (!check || !check->execute() || !check->fetch())
       {
-        if (checkResult)
-          mysql_free_result(checkResult);
-        DBConnectionPool::getInstance().releaseConnection(conn);
         return false;
       }
-
-      mysql_free_result(checkResult);
     }
 
-    DBConnectionPool::getInstance().releaseConnection(conn);
-
     if (result)
     {
       spdlog::debug("Lock acquired: {}, owner: {}", lockName, owner);
@@ -1153,13 +1470,15 @@ namespace scheduler
       return false;
     }
 
-    std::stringstream ss;
-    ss << "DELETE FROM job_lock "
-       << "WHERE lock_name = '" << lockName << "' "
-       << "AND lock_owner = '" << owner << "'";
+    auto stmt = conn->prepare("DELETE FROM job_lock WHERE lock_name = ? AND lock_owner = ?");
 
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindString(0, lockName);
+      stmt->bindString(1, owner);
+      result = stmt->execute();
+    }
 
     if (result)
     {
@@ -1183,14 +1502,18 @@ namespace scheduler
       return false;
     }
 
-    std::stringstream ss;
-    ss << "UPDATE job_lock SET "
-       << "expire_time = DATE_ADD(NOW(), INTERVAL " << expireSeconds << " SECOND) "
-       << "WHERE lock_name = '" << lockName << "' "
-       << "AND lock_owner = '" << owner << "'";
+    auto stmt = conn->prepare(
+        "UPDATE job_lock SET expire_time = DATE_ADD(NOW(), INTERVAL ? SECOND) "
+        "WHERE lock_name = ? AND lock_owner = ?");
 
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindInt(0, expireSeconds);
+      stmt->bindString(1, lockName);
+      stmt->bindString(2, owner);
+      result = stmt->execute();
+    }
 
     if (result)
     {
@@ -1216,37 +1539,23 @@ namespace scheduler
       return defaultValue;
     }
 
-    std::stringstream ss;
-    ss << "SELECT config_value FROM system_config "
-       << "WHERE config_key = '" << key << "'";
-
-    if (!conn->executeQuery(ss.str()))
+    auto stmt = conn->prepare("SELECT config_value FROM system_config WHERE config_key = ?");
+    if (stmt)
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
-      spdlog::error("Failed to query config: {}", key);
-      return defaultValue;
+      stmt->bindString(0, key);
     }
-
-    MYSQL_RES *result = conn->getResult();
-    if (!result || mysql_num_rows(result) == 0)
+    if (!stmt || !stmt->execute())
     {
-      if (result)
-        mysql_free_result(result);
-      DBConnectionPool::getInstance().releaseConnection(conn);
+      spdlog::error("Failed to query config: {}", key);
       return defaultValue;
     }
 
-    MYSQL_ROW row = mysql_fetch_row(result);
     std::string value = defaultValue;
-
-    if (row && row[0])
+    if (stmt->fetch() && !stmt->isNull(0))
     {
-      value = row[0];
+      value = stmt->getString(0);
     }
 
-    mysql_free_result(result);
-    DBConnectionPool::getInstance().releaseConnection(conn);
-
     return value;
   }
 
@@ -1260,17 +1569,20 @@ namespace scheduler
       return false;
     }
 
-    std::stringstream ss;
-    ss << "INSERT INTO system_config (config_key, config_value, description) VALUES ("
-       << "'" << key << "', "
-       << "'" << value << "', "
-       << (description.empty() ? "NULL" : ("'" + description + "'")) << ") "
-       << "ON DUPLICATE KEY UPDATE "
-       << "config_value = '" << value << "', "
-       << "description = " << (description.empty() ? "description" : ("'" + description + "'"));
+    // 未提供描述时保留原有描述
+    auto stmt = conn->prepare(
+        "INSERT INTO system_config (config_key, config_value, description) VALUES (?, ?, ?) "
+        "ON DUPLICATE KEY UPDATE config_value = VALUES(config_value), "
+        "description = COALESCE(VALUES(description), description)");
 
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindString(0, key);
+      stmt->bindString(1, value);
+      stmt->bindOptionalString(2, description);
+      result = stmt->execute();
+    }
 
     if (!result)
     {
@@ -1294,65 +1606,44 @@ namespace scheduler
       return 0;
     }
 
-    std::stringstream ss;
-    ss << "DELETE FROM job_execution "
-       << "WHERE trigger_time < DATE_SUB(NOW(), INTERVAL " << days << " DAY)";
-
-    if (!conn->executeUpdate(ss.str()))
+    auto stmt = conn->prepare("DELETE FROM job_execution WHERE trigger_time < DATE_SUB(NOW(), INTERVAL ? DAY)");
+    if (stmt)
+    {
+      stmt->bindInt(0, days);
+    }
+    if (!stmt || !stmt->execute())
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
       spdlog::error("Failed to cleanup expired executions");
       return 0;
     }
 
-    int count = conn->getAffectedRows();
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    int count = static_cast<int>(stmt->affectedRows());
 
     spdlog::info("Cleaned up {} expired executions", count);
     return count;
   }
 
-  // 从结果集构建ExecutorInfo对象
-  ExecutorInfo JobDAO::buildExecutorInfoFromResult(MYSQL_RES *result)
+  // 从当前行构建ExecutorInfo对象
+  ExecutorInfo JobDAO::buildExecutorInfo(const PreparedStatement &stmt)
   {
     ExecutorInfo info;
 
-    if (!result)
-    {
-      return info;
-    }
-
-    MYSQL_ROW row = mysql_fetch_row(result);
-    if (!row)
-    {
-      return info;
-    }
-
-    unsigned long *lengths = mysql_fetch_lengths(result);
-
-    // 获取字段值
-    if (row[0])
-      info.executor_id = std::string(row[0], lengths[0]);
+    info.executor_id = stmt.getString(0);
 
     // 构建地址
-    if (row[1] && row[2])
+    if (!stmt.isNull(1) && !stmt.isNull(2))
     {
-      std::string host = std::string(row[1], lengths[1]);
-      int port = std::stoi(std::string(row[2], lengths[2]));
       std::stringstream addrSs;
-      addrSs << host << ":" << port;
+      addrSs << stmt.getString(1) << ":" << stmt.getInt(2);
       info.address = addrSs.str();
     }
 
     // 获取负载信息
-    if (row[3])
-      info.current_load = std::stoi(std::string(row[3], lengths[3]));
-    if (row[4])
-      info.max_load = std::stoi(std::string(row[4], lengths[4]));
-    if (row[5])
-      info.total_tasks_executed = std::stoull(std::string(row[5], lengths[5]));
-    if (row[6])
-      info.last_heartbeat = stringToTimePoint(std::string(row[6], lengths[6]));
+    info.current_load = static_cast<int>(stmt.getInt(3));
+    info.max_load = static_cast<int>(stmt.getInt(4));
+    info.total_tasks_executed = stmt.getUInt(5);
+    if (!stmt.isNull(6))
+      info.last_heartbeat = stmt.getTime(6);
 
     return info;
   }
@@ -1370,38 +1661,21 @@ namespace scheduler
     }
 
     // 获取最近5分钟有心跳的执行器
-    std::stringstream ss;
-    ss << "SELECT executor_id, host, port, current_load, max_load, total_tasks_executed, last_heartbeat "
-       << "FROM executor_node "
-       << "WHERE status = 'ONLINE' AND "
-       << "last_heartbeat > DATE_SUB(NOW(), INTERVAL 5 MINUTE)";
-
-    if (!conn->executeQuery(ss.str()))
+    auto stmt = conn->prepare("SELECT " + kExecutorColumns +
+                              "FROM executor_node "
+                              "WHERE status = 'ONLINE' AND last_heartbeat > DATE_SUB(NOW(), INTERVAL 5 MINUTE)");
+    if (!stmt || !stmt->execute())
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
       spdlog::error("Failed to query online executors with load");
       return executors;
     }
 
-    MYSQL_RES *result = conn->getResult();
-    if (!result)
-    {
-      DBConnectionPool::getInstance().releaseConnection(conn);
-      spdlog::error("Failed to get result set");
-      return executors;
-    }
-
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result)))
+    executors.reserve(stmt->rowCount());
+    while (stmt->fetch())
     {
-      mysql_data_seek(result, executors.size());
-      ExecutorInfo info = buildExecutorInfoFromResult(result);
-      executors.push_back(info);
+      executors.push_back(buildExecutorInfo(*stmt));
     }
 
-    mysql_free_result(result);
-    DBConnectionPool::getInstance().releaseConnection(conn);
-
     return executors;
   }
 
@@ -1415,31 +1689,24 @@ namespace scheduler
       return std::nullopt;
     }
 
-    std::stringstream ss;
-    ss << "SELECT executor_id, host, port, current_load, max_load, total_tasks_executed, last_heartbeat "
-       << "FROM executor_node "
-       << "WHERE executor_id = '" << executorId << "'";
-
-    if (!conn->executeQuery(ss.str()))
+    auto stmt = conn->prepare("SELECT " + kExecutorColumns + "FROM executor_node WHERE executor_id = ?");
+    if (stmt)
+    {
+      stmt->bindString(0, executorId);
+    }
+    if (!stmt || !stmt->execute())
     {
-      DBConnectionPool::getInstance().releaseConnection(conn);
       spdlog::error("Failed to query executor info: {}", executorId);
       return std::nullopt;
     }
 
-    MYSQL_RES *result = conn->getResult();
-    if (!result || mysql_num_rows(result) == 0)
+    if (!stmt->fetch())
     {
-      if (result)
-        mysql_free_result(result);
-      DBConnectionPool::getInstance().releaseConnection(conn);
       spdlog::warn("Executor not found: {}", executorId);
       return std::nullopt;
     }
 
-    ExecutorInfo info = buildExecutorInfoFromResult(result);
-    mysql_free_result(result);
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    ExecutorInfo info = buildExecutorInfo(*stmt);
 
     return info;
   }
@@ -1454,13 +1721,14 @@ namespace scheduler
       return false;
     }
 
-    std::stringstream ss;
-    ss << "UPDATE executor_node SET "
-       << "current_load = current_load + 1 "
-       << "WHERE executor_id = '" << executorId << "'";
+    auto stmt = conn->prepare("UPDATE executor_node SET current_load = current_load + 1 WHERE executor_id = ?");
 
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindString(0, executorId);
+      result = stmt->execute();
+    }
 
     if (!result)
     {
@@ -1484,13 +1752,15 @@ namespace scheduler
       return false;
     }
 
-    std::stringstream ss;
-    ss << "UPDATE executor_node SET "
-       << "current_load = GREATEST(0, current_load - 1) "
-       << "WHERE executor_id = '" << executorId << "'";
+    auto stmt = conn->prepare(
+        "UPDATE executor_node SET current_load = GREATEST(0, current_load - 1) WHERE executor_id = ?");
 
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindString(0, executorId);
+      result = stmt->execute();
+    }
 
     if (!result)
     {
@@ -1504,6 +1774,104 @@ namespace scheduler
     return result;
   }
 
+  // 批量累加执行器负载和任务计数
+  bool JobDAO::updateExecutorCounters(const std::vector<ExecutorCounterDelta> &deltas)
+  {
+    if (deltas.empty())
+    {
+      return true;
+    }
+
+    auto conn = DBConnectionPool::getInstance().getConnection();
+    if (!conn)
+    {
+      spdlog::error("Failed to get database connection");
+      return false;
+    }
+
+    // 超过kMaxBatchRows个执行器时分多条语句写入，放在一个事务中：失败时整体回滚，
+    // 调用方放回缓冲区重试时不会重复累加已写入的部分
+    if (!conn->executeUpdate("START TRANSACTION"))
+    {
+      return false;
+    }
+
+    bool result = true;
+    for (size_t begin = 0; begin < deltas.size() && result; begin += kMaxBatchRows)
+    {
+      size_t count = std::min(kMaxBatchRows, deltas.size() - begin);
+
+      // 占位符个数取2的幂，多出的位置重复最后一条，CASE取第一个匹配的分支，不会重复累加
+      size_t slots = roundUpPowerOfTwo(count);
+      std::string cases;
+      for (size_t i = 0; i < slots; ++i)
+      {
+        cases += "WHEN ? THEN ? ";
+      }
+      auto stmt = conn->prepare(
+          "UPDATE executor_node SET "
+          "current_load = GREATEST(0, current_load + CASE executor_id " + cases + "ELSE 0 END), "
+          "total_tasks_executed = total_tasks_executed + CASE executor_id " + cases + "ELSE 0 END "
+          "WHERE executor_id IN (" + PreparedStatement::placeholders(slots) + ")");
+      if (!stmt)
+      {
+        result = false;
+        break;
+      }
+
+      for (size_t i = 0; i < slots; ++i)
+      {
+        const ExecutorCounterDelta &delta = deltas[begin + std::min(i, count - 1)];
+        stmt->bindString(2 * i, delta.executor_id);
+        stmt->bindInt(2 * i + 1, delta.load_delta);
+        stmt->bindString(2 * slots + 2 * i, delta.executor_id);
+        stmt->bindUInt(2 * slots + 2 * i + 1, delta.tasks_executed);
+        stmt->bindString(4 * slots + i, delta.executor_id);
+      }
+      result = stmt->execute();
+    }
+
+    result = conn->executeUpdate(result ? "COMMIT" : "ROLLBACK") && result;
+
+    if (!result)
+    {
+      spdlog::error("Failed to update counters of {} executors", deltas.size());
+    }
+    else
+    {
+      spdlog::debug("Executor counters updated: {}", deltas.size());
+    }
+
+    return result;
+  }
+
+  // 按未结束的执行记录重新计算执行器负载
+  bool JobDAO::recomputeExecutorLoads()
+  {
+    auto conn = DBConnectionPool::getInstance().getConnection();
+    if (!conn)
+    {
+      spdlog::error("Failed to get database connection");
+      return false;
+    }
+
+    bool result = conn->executeUpdate(
+        "UPDATE executor_node e SET current_load = "
+        "(SELECT COUNT(*) FROM job_execution x WHERE x.executor_id = e.executor_id "
+        "AND x.status IN ('WAITING', 'RUNNING'))");
+
+    if (!result)
+    {
+      spdlog::error("Failed to recompute executor loads");
+    }
+    else
+    {
+      spdlog::info("Executor loads recomputed from in-flight executions");
+    }
+
+    return result;
+  }
+
   // 更新执行器最大负载
   bool JobDAO::updateExecutorMaxLoad(const std::string &executorId, int maxLoad)
   {
@@ -1514,13 +1882,15 @@ namespace scheduler
       return false;
     }
 
-    std::stringstream ss;
-    ss << "UPDATE executor_node SET "
-       << "max_load = " << maxLoad << " "
-       << "WHERE executor_id = '" << executorId << "'";
+    auto stmt = conn->prepare("UPDATE executor_node SET max_load = ? WHERE executor_id = ?");
 
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindInt(0, maxLoad);
+      stmt->bindString(1, executorId);
+      result = stmt->execute();
+    }
 
     if (!result)
     {
@@ -1544,13 +1914,15 @@ namespace scheduler
       return false;
     }
 
-    std::stringstream ss;
-    ss << "UPDATE executor_node SET "
-       << "total_tasks_executed = total_tasks_executed + 1 "
-       << "WHERE executor_id = '" << executorId << "'";
+    auto stmt = conn->prepare(
+        "UPDATE executor_node SET total_tasks_executed = total_tasks_executed + 1 WHERE executor_id = ?");
 
-    bool result = conn->executeUpdate(ss.str());
-    DBConnectionPool::getInstance().releaseConnection(conn);
+    bool result = false;
+    if (stmt)
+    {
+      stmt->bindString(0, executorId);
+      result = stmt->execute();
+    }
 
     if (!result)
     {
@@ -1564,4 +1936,4 @@ namespace scheduler
     return result;
   }
 
-} // namespace scheduler
\ No newline at end of file
+} // namespace scheduler
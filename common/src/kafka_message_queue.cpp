@@ -1,12 +1,105 @@
 #include "kafka_message_queue.h"
 #include "stats_manager.h"
+#include "config_manager.h"
 #include <spdlog/spdlog.h>
 #include <nlohmann/json.hpp>
 #include <chrono>
+#include <deque>
+#include <algorithm>
 
 namespace scheduler
 {
 
+  namespace
+  {
+    // 按JSON字符串转义后追加到目标字符串的输出适配器，序列化结果直接写入{type, payload}封装的payload字段
+    class JsonStringOutput : public nlohmann::detail::output_adapter_protocol<char>
+    {
+    public:
+      explicit JsonStringOutput(std::string &out) : out_(out) {}
+
+      void write_character(char c) override
+      {
+        append(c);
+      }
+
+      void write_characters(const char *s, std::size_t length) override
+      {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+          append(s[i]);
+        }
+      }
+
+      // 与nlohmann::json的转义一致：引号、反斜杠和控制字符转义，其他字节原样写入
+      void append(char c)
+      {
+        static const char digits[] = "0123456789abcdef";
+        switch (c)
+        {
+        case '"':
+          out_ += "\\\"";
+          break;
+        case '\\':
+          out_ += "\\\\";
+          break;
+        case '\n':
+          out_ += "\\n";
+          break;
+        case '\r':
+          out_ += "\\r";
+          break;
+        case '\t':
+          out_ += "\\t";
+          break;
+        case '\b':
+          out_ += "\\b";
+          break;
+        case '\f':
+          out_ += "\\f";
+          break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20)
+          {
+            out_ += "\\u00";
+            out_ += digits[(c >> 4) & 0x0F];
+            out_ += digits[c & 0x0F];
+          }
+          else
+          {
+            out_ += c;
+          }
+        }
+      }
+
+    private:
+      std::string &out_;
+    };
+
+    // JSON格式的{type, payload}封装，键的顺序与nlohmann::json::dump()相同。
+    // 写入前清空但保留缓冲区容量，不再先生成消息体字符串再整体转义一遍
+    void beginEnvelope(std::string &out)
+    {
+      out.clear();
+      out += "{\"payload\":\"";
+    }
+
+    void endEnvelope(std::string &out, const std::string &type)
+    {
+      out += "\",\"type\":\"";
+      out += type;
+      out += "\"}";
+    }
+
+    void writeEnvelope(const nlohmann::json &payload, const std::string &type, std::string &out)
+    {
+      beginEnvelope(out);
+      nlohmann::detail::serializer<nlohmann::json> serializer(std::make_shared<JsonStringOutput>(out), ' ');
+      serializer.dump(payload, false, false, 0);
+      endEnvelope(out, type);
+    }
+  } // namespace
+
   // 消息传递错误回调类
   class DeliveryReportCb : public RdKafka::DeliveryReportCb
   {
@@ -16,11 +109,27 @@ namespace scheduler
       if (message.err())
       {
         spdlog::error("Message delivery failed: {}", message.errstr());
+        StatsManager::getInstance().addKafkaDeliveryFailure();
       }
       else
       {
         spdlog::debug("Message delivered to topic {}, partition [{}]",
                       message.topic_name(), message.partition());
+        if (message.latency() >= 0)
+        {
+          StatsManager::getInstance().addKafkaDeliveryLatency(static_cast<uint64_t>(message.latency()));
+        }
+      }
+
+      // 通知发送方，并把消息体缓冲区归还缓冲池
+      if (message.msg_opaque())
+      {
+        auto *buffer = static_cast<ProduceBuffer *>(message.msg_opaque());
+        if (buffer->onDelivery)
+        {
+          buffer->onDelivery(!message.err());
+        }
+        buffer->pool->release(buffer);
       }
     }
   };
@@ -35,7 +144,18 @@ namespace scheduler
       {
       case RdKafka::Event::EVENT_ERROR:
         spdlog::error("Kafka error: {}", RdKafka::err2str(event.err()));
+        StatsManager::getInstance().addKafkaError();
         break;
+      case RdKafka::Event::EVENT_STATS:
+      {
+        // 按statistics.interval.ms定期回调，包含发送队列深度和各分区的消费积压
+        TransportStats stats;
+        if (parseKafkaStatistics(event.str(), stats))
+        {
+          StatsManager::getInstance().updateTransportStats(stats);
+        }
+        break;
+      }
       case RdKafka::Event::EVENT_LOG:
         spdlog::debug("Kafka log: {} ({}): {}", event.fac(), event.severity(), event.str());
         break;
@@ -46,12 +166,97 @@ namespace scheduler
     }
   };
 
+  // 分区分配回调类
+  class RebalanceHandler : public RdKafka::RebalanceCb
+  {
+  public:
+    explicit RebalanceHandler(KafkaMessageQueue *queue) : queue_(queue) {}
+
+    void rebalance_cb(RdKafka::KafkaConsumer *consumer, RdKafka::ErrorCode err,
+                      std::vector<RdKafka::TopicPartition *> &partitions) override
+    {
+      if (err == RdKafka::ERR__ASSIGN_PARTITIONS)
+      {
+        consumer->assign(partitions);
+        queue_->onAssignment(partitions, true);
+      }
+      else
+      {
+        // 等待已分发的消息处理完，提交偏移量后再收回，新的消费者从这里继续
+        queue_->waitForWorkers();
+        queue_->commitOffsets(true);
+        consumer->unassign();
+        queue_->onAssignment(partitions, false);
+      }
+    }
+
+  private:
+    KafkaMessageQueue *queue_;
+  };
+
   // 静态回调实例
   static DeliveryReportCb s_deliveryReportCb;
   static ErrorCb s_errorCb;
 
+  // 生产者预设配置
+  static std::map<std::string, std::string> producerProfile(const std::string &name)
+  {
+    if (name == "latency")
+    {
+      // 立即发送，不压缩
+      return {
+          {"linger.ms", "0"},
+          {"batch.num.messages", "1000"},
+          {"compression.type", "none"},
+          {"acks", "1"},
+      };
+    }
+    if (name == "durable")
+    {
+      // 全部副本确认，幂等写入避免重试产生重复和乱序
+      return {
+          {"linger.ms", "5"},
+          {"batch.num.messages", "10000"},
+          {"compression.type", "lz4"},
+          {"acks", "all"},
+          {"enable.idempotence", "true"},
+          {"max.in.flight.requests.per.connection", "5"},
+      };
+    }
+    if (name != "throughput")
+    {
+      spdlog::warn("Unknown producer profile: {}, using throughput", name);
+    }
+    // 等待更长时间凑批，批次压缩后发送；全部副本确认，结果预写日志收到确认后才删除段文件
+    return {
+        {"linger.ms", "20"},
+        {"batch.num.messages", "10000"},
+        {"batch.size", "1048576"},
+        {"compression.type", "lz4"},
+        {"acks", "all"},
+        {"enable.idempotence", "true"},
+        {"queue.buffering.max.messages", "500000"},
+        {"queue.buffering.max.kbytes", "1048576"},
+    };
+  }
+
+  // 设置统计回调间隔，kafka.statistics_interval_ms为0时不回调
+  static bool setStatisticsInterval(RdKafka::Conf *conf)
+  {
+    std::string errstr;
+    std::string interval = std::to_string(ConfigManager::getInstance().getInt("kafka.statistics_interval_ms", 5000));
+    if (conf->set("statistics.interval.ms", interval, errstr) != RdKafka::Conf::CONF_OK)
+    {
+      spdlog::error("Failed to set statistics.interval.ms: {}", errstr);
+      return false;
+    }
+    return true;
+  }
+
   KafkaMessageQueue::KafkaMessageQueue()
-      : running_(false)
+      : wireFormat_(WireFormat::JSON), running_(false), pollRunning_(false),
+        bufferPool_(kBufferPoolSize, kMaxPooledBufferBytes), workerCount_(0), workerQueueCapacity_(0),
+        commitIntervalMs_(1000), commitBatchSize_(500)
   {
   }
 
@@ -59,11 +264,23 @@ namespace scheduler
   {
     stopConsume();
 
+    // 停止轮询线程，之后由flush处理剩余的传递报告
+    pollRunning_ = false;
+    if (pollThread_.joinable())
+    {
+      pollThread_.join();
+    }
+
     // 等待消息队列中的消息发送完成
     if (producer_)
     {
       spdlog::info("Flushing producer...");
       producer_->flush(5000);
+
+      // 未发送完的消息清出队列并触发传递报告，在缓冲池销毁前归还其缓冲区
+      producer_->purge(RdKafka::Producer::PURGE_QUEUE | RdKafka::Producer::PURGE_INFLIGHT);
+      producer_->poll(0);
+      producer_.reset();
     }
   }
 
@@ -81,6 +298,36 @@ namespace scheduler
       return false;
     }
 
+    // 预设配置，kafka.producer.*中的配置原样传给librdkafka并覆盖预设
+    std::string profile = ConfigManager::getInstance().getString("kafka.producer_profile", "throughput");
+    std::map<std::string, std::string> settings = producerProfile(profile);
+    for (const auto &item : ConfigManager::getInstance().getWithPrefix("kafka.producer."))
+    {
+      settings[item.first] = item.second;
+    }
+    for (const auto &item : settings)
+    {
+      if (producerConf_->set(item.first, item.second, errstr) != RdKafka::Conf::CONF_OK)
+      {
+        spdlog::error("Failed to set producer config {}={}: {}", item.first, item.second, errstr);
+        return false;
+      }
+    }
+
+    // 定期回调统计信息
+    if (!setStatisticsInterval(producerConf_.get()))
+    {
+      return false;
+    }
+
+    // 消息体编码；默认json，旧版本节点只能读取json，所有节点升级后再切换为binary
+    std::string wireFormat = ConfigManager::getInstance().getString("kafka.wire_format", "json");
+    if (!WireCodec::formatFromString(wireFormat, wireFormat_))
+    {
+      spdlog::warn("Unknown kafka.wire_format: {}, using json", wireFormat);
+      wireFormat_ = WireFormat::JSON;
+    }
+
     // 设置传递报告回调
     if (producerConf_->set("dr_cb", &s_deliveryReportCb, errstr) != RdKafka::Conf::CONF_OK)
     {
@@ -103,14 +350,19 @@ namespace scheduler
       return false;
     }
 
-    spdlog::info("Kafka producer initialized, connected to {}", brokers);
+    // 由独立线程处理传递报告，发送路径不再调用poll
+    pollRunning_ = true;
+    pollThread_ = std::thread(&KafkaMessageQueue::pollThread, this);
+
+    spdlog::info("Kafka producer initialized, connected to {}, profile: {}", brokers, profile);
     return true;
   }
 
   bool KafkaMessageQueue::initConsumer(const std::string &brokers,
                                        const std::string &groupId,
                                        const std::vector<std::string> &topics,
-                                       MessageCallback callback)
+                                       MessageCallback callback,
+                                       const std::string &offsetReset)
   {
     std::string errstr;
 
@@ -135,6 +387,13 @@ namespace scheduler
       return false;
     }
 
+    // 客户端名称使用消费者组ID，统计信息中按名称区分各消费者
+    if (consumerConf_->set("client.id", groupId, errstr) != RdKafka::Conf::CONF_OK)
+    {
+      spdlog::error("Failed to set client.id: {}", errstr);
+      return false;
+    }
+
     // 设置错误回调
     if (consumerConf_->set("event_cb", &s_errorCb, errstr) != RdKafka::Conf::CONF_OK)
     {
@@ -142,27 +401,45 @@ namespace scheduler
       return false;
     }
 
-    // 设置自动提交
-    if (consumerConf_->set("enable.auto.commit", "true", errstr) != RdKafka::Conf::CONF_OK)
+    // 定期回调统计信息
+    if (!setStatisticsInterval(consumerConf_.get()))
     {
-      spdlog::error("Failed to set enable.auto.commit: {}", errstr);
       return false;
     }
 
-    // 设置自动提交间隔
-    if (consumerConf_->set("auto.commit.interval.ms", "5000", errstr) != RdKafka::Conf::CONF_OK)
+    // 关闭自动提交，消息处理完成后再提交偏移量（至少一次）
+    if (consumerConf_->set("enable.auto.commit", "false", errstr) != RdKafka::Conf::CONF_OK)
     {
-      spdlog::error("Failed to set auto.commit.interval.ms: {}", errstr);
+      spdlog::error("Failed to set enable.auto.commit: {}", errstr);
       return false;
     }
 
+    // 批量提交的时间间隔和完成条数
+    commitIntervalMs_ = ConfigManager::getInstance().getInt("kafka.commit_interval_ms", 1000);
+    commitBatchSize_ = static_cast<size_t>(ConfigManager::getInstance().getInt("kafka.commit_batch_size", 500));
+
     // 设置自动偏移量重置
-    if (consumerConf_->set("auto.offset.reset", "earliest", errstr) != RdKafka::Conf::CONF_OK)
+    if (consumerConf_->set("auto.offset.reset", offsetReset, errstr) != RdKafka::Conf::CONF_OK)
     {
       spdlog::error("Failed to set auto.offset.reset: {}", errstr);
       return false;
     }
 
+    // 订阅时自动创建主题，执行器专属主题在执行器启动时才存在
+    if (consumerConf_->set("allow.auto.create.topics", "true", errstr) != RdKafka::Conf::CONF_OK)
+    {
+      spdlog::error("Failed to set allow.auto.create.topics: {}", errstr);
+      return false;
+    }
+
+    // 设置分区分配回调
+    rebalanceCb_ = std::make_unique<RebalanceHandler>(this);
+    if (consumerConf_->set("rebalance_cb", rebalanceCb_.get(), errstr) != RdKafka::Conf::CONF_OK)
+    {
+      spdlog::error("Failed to set rebalance_cb: {}", errstr);
+      return false;
+    }
+
     // 创建消费者
     consumer_.reset(RdKafka::KafkaConsumer::create(consumerConf_.get(), errstr));
     if (!consumer_)
@@ -175,73 +452,192 @@ namespace scheduler
     return true;
   }
 
-  bool KafkaMessageQueue::sendMessage(const std::string &topic, const KafkaMessage &message)
+  bool KafkaMessageQueue::sendMessage(const std::string &topic, const KafkaMessage &message,
+                                       DeliveryCallback onDelivery)
+  {
+    ProduceBuffer *buffer = bufferPool_.acquire();
+    if (wireFormat_ == WireFormat::BINARY)
+    {
+      buffer->data.assign(message.payload);
+    }
+    else
+    {
+      beginEnvelope(buffer->data);
+      JsonStringOutput(buffer->data).write_characters(message.payload.data(), message.payload.size());
+      endEnvelope(buffer->data, messageTypeToString(message.type));
+    }
+    return produce(topic, message.type, message.format, message.key, message.headers, buffer, std::move(onDelivery));
+  }
+
+  bool KafkaMessageQueue::produce(const std::string &topic, MessageType type, WireFormat format,
+                                  const std::string &key, const std::map<std::string, std::string> &extraHeaders,
+                                  ProduceBuffer *buffer, DeliveryCallback onDelivery)
   {
     if (!producer_)
     {
       spdlog::error("Producer not initialized");
+      bufferPool_.release(buffer);
       return false;
     }
 
-    // 构建消息JSON
-    nlohmann::json j;
-    j["type"] = messageTypeToString(message.type);
-    j["payload"] = message.payload;
+    // 构建消息头，发送成功后由librdkafka释放
+    RdKafka::Headers *headers = nullptr;
+    if (!extraHeaders.empty() || wireFormat_ == WireFormat::BINARY)
+    {
+      headers = RdKafka::Headers::create();
+      for (const auto &header : extraHeaders)
+      {
+        headers->add(header.first, header.second);
+      }
+    }
 
-    std::string messageStr = j.dump();
+    // 二进制格式：类型放在消息头，消息体原样发送；JSON格式的{type, payload}封装已由调用方写入缓冲区
+    if (wireFormat_ == WireFormat::BINARY)
+    {
+      headers->add(kMessageTypeHeader, messageTypeToString(type));
+      headers->add(kWireFormatHeader, WireCodec::formatToString(format));
+    }
 
-    // 发送消息
-    RdKafka::ErrorCode err = producer_->produce(
-        topic,
-        RdKafka::Topic::PARTITION_UA,   // 使用自动分区
-        RdKafka::Producer::RK_MSG_COPY, // 复制消息
-        const_cast<char *>(messageStr.c_str()),
-        messageStr.size(),
-        message.key.empty() ? nullptr : message.key.c_str(), // 消息键
-        message.key.size(),
-        0,      // 不使用时间戳
-        nullptr // 不使用消息不透明指针
-    );
+    // 消息体不复制，librdkafka直接引用缓冲区，传递报告回调中归还缓冲池
+    buffer->onDelivery = std::move(onDelivery);
+
+    // 发送消息；本地队列已满时等待轮询线程腾出空间
+    RdKafka::ErrorCode err;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kQueueFullWaitMs);
+    while (true)
+    {
+      err = producer_->produce(
+          topic,
+          RdKafka::Topic::PARTITION_UA, // 使用自动分区
+          0,                            // 不复制也不释放，由缓冲池管理
+          const_cast<char *>(buffer->data.data()),
+          buffer->data.size(),
+          key.empty() ? nullptr : key.c_str(), // 消息键
+          key.size(),
+          0,       // 不使用时间戳
+          headers, // 消息头
+          buffer   // 传递报告中归还
+      );
+      if (err != RdKafka::ERR__QUEUE_FULL || std::chrono::steady_clock::now() >= deadline)
+      {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
 
     if (err != RdKafka::ERR_NO_ERROR)
     {
       spdlog::error("Failed to produce message: {}", RdKafka::err2str(err));
+      delete headers;
+      bufferPool_.release(buffer);
       return false;
     }
 
-    // 轮询以触发传递报告回调
-    producer_->poll(0);
-
     // 更新统计信息
     StatsManager::getInstance().addKafkaMessage(true);
 
     return true;
   }
 
-  bool KafkaMessageQueue::sendJob(const std::string &topic, const JobInfo &job)
+  bool KafkaMessageQueue::sendJob(const std::string &topic, const JobInfo &job, const std::string &executorId)
   {
-    // 将任务转换为JSON
-    nlohmann::json jobJson = job.to_json();
-    std::string jobStr = jobJson.dump();
+    // 直接序列化到发送缓冲区
+    ProduceBuffer *buffer = bufferPool_.acquire();
+    if (wireFormat_ == WireFormat::BINARY)
+    {
+      WireCodec::encodeJob(job, buffer->data);
+    }
+    else
+    {
+      writeEnvelope(job.to_json(), messageTypeToString(MessageType::JOB_SUBMIT), buffer->data);
+    }
 
-    // 创建消息
-    KafkaMessage message(MessageType::JOB_SUBMIT, jobStr, job.job_id);
+    std::map<std::string, std::string> headers;
+    if (!executorId.empty())
+    {
+      headers[kExecutorIdHeader] = executorId;
+    }
 
     // 发送消息
-    return sendMessage(topic, message);
+    return produce(topic, MessageType::JOB_SUBMIT, wireFormat_, job.job_id, headers, buffer, nullptr);
   }
 
-  bool KafkaMessageQueue::sendJobResult(const std::string &topic, const JobResult &result)
+  std::string KafkaMessageQueue::resultKey(const JobResult &result)
   {
-    // 将结果转换为JSON
-    nlohmann::json resultJson = result.to_json();
-    std::string resultStr = resultJson.dump();
+    // 按执行器ID作为键，同一执行器的结果和JOB_RETURN落在同一分区、由同一工作线程按顺序处理；
+    // 按任务ID作为键时一批中其他任务的结果会和这些任务的单条结果并发处理。旧版本执行器不带执行器ID
+    return result.executor_id.empty() ? result.job_id : result.executor_id;
+  }
 
-    // 创建消息
-    KafkaMessage message(MessageType::JOB_RESULT, resultStr, result.job_id);
+  bool KafkaMessageQueue::sendJobResult(const std::string &topic, const JobResult &result,
+                                         DeliveryCallback onDelivery)
+  {
+    // 直接序列化到发送缓冲区
+    ProduceBuffer *buffer = bufferPool_.acquire();
+    if (wireFormat_ == WireFormat::BINARY)
+    {
+      WireCodec::encodeResult(result, buffer->data);
+    }
+    else
+    {
+      writeEnvelope(result.to_json(), messageTypeToString(MessageType::JOB_RESULT), buffer->data);
+    }
 
-    // 发送消息
-    return sendMessage(topic, message);
+    // 发送消息，键与批量结果相同
+    return produce(topic, MessageType::JOB_RESULT, wireFormat_, resultKey(result), {}, buffer, std::move(onDelivery));
+  }
+
+  bool KafkaMessageQueue::sendJobResults(const std::string &topic, const std::vector<JobResult> &results,
+                                          DeliveryCallback onDelivery)
+  {
+    if (results.empty())
+    {
+      if (onDelivery)
+      {
+        onDelivery(true);
+      }
+      return true;
+    }
+
+    // 单条结果保持原有消息格式
+    if (results.size() == 1)
+    {
+      return sendJobResult(topic, results[0], std::move(onDelivery));
+    }
+
+    // 合并为一条消息，直接序列化到发送缓冲区
+    ProduceBuffer *buffer = bufferPool_.acquire();
+    if (wireFormat_ == WireFormat::BINARY)
+    {
+      WireCodec::encodeResults(results, buffer->data);
+    }
+    else
+    {
+      nlohmann::json resultsJson = nlohmann::json::array();
+      for (const auto &result : results)
+      {
+        resultsJson.push_back(result.to_json());
+      }
+      writeEnvelope(resultsJson, messageTypeToString(MessageType::JOB_RESULT_BATCH), buffer->data);
+    }
+
+    // 发送消息，一批结果来自同一个执行器
+    return produce(topic, MessageType::JOB_RESULT_BATCH, wireFormat_, resultKey(results[0]), {}, buffer,
+                   std::move(onDelivery));
+  }
+
+  void KafkaMessageQueue::pollThread()
+  {
+    while (pollRunning_)
+    {
+      producer_->poll(100);
+    }
+  }
+
+  void KafkaMessageQueue::setConsumerWorkers(size_t workers, size_t queueCapacity)
+  {
+    workerCount_ = workers;
+    workerQueueCapacity_ = std::max<size_t>(queueCapacity, 1);
   }
 
   bool KafkaMessageQueue::startConsume()
@@ -260,6 +656,14 @@ namespace scheduler
       return false;
     }
 
+    // 启动工作线程
+    workers_ = std::make_unique<ConsumerWorkerPool>(
+        workerCount_, workerQueueCapacity_,
+        [this](const std::vector<TopicPartitionKey> &partitions)
+        { pausePartitions(partitions, true); },
+        [this](const std::vector<TopicPartitionKey> &partitions)
+        { pausePartitions(partitions, false); });
+
     // 启动消费线程
     running_ = true;
     consumeThread_ = std::thread(&KafkaMessageQueue::consumeThread, this);
@@ -293,9 +697,13 @@ namespace scheduler
         consumeThread_.join();
       }
 
-      // 关闭消费者
+      // 处理完已分发的消息
+      stopWorkers();
+
+      // 提交最后处理完的偏移量，然后关闭消费者
       if (consumer_)
       {
+        commitOffsets(true);
         consumer_->close();
       }
 
@@ -303,64 +711,239 @@ namespace scheduler
     }
   }
 
-  void KafkaMessageQueue::consumeThread()
+  bool KafkaMessageQueue::waitForAssignment(int timeoutMs)
   {
-    while (running_)
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool ok = condition_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]
+                                  { return assignedTopics_.size() >= topics_.size(); });
+    if (!ok)
     {
-      // 消费消息，超时时间为100ms
-      std::unique_ptr<RdKafka::Message> msg(consumer_->consume(100));
+      spdlog::warn("Timed out waiting for partition assignment ({}/{} topics)",
+                   assignedTopics_.size(), topics_.size());
+    }
+    return ok;
+  }
 
-      switch (msg->err())
+  void KafkaMessageQueue::onAssignment(const std::vector<RdKafka::TopicPartition *> &partitions, bool assigned)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (assigned)
+    {
+      for (const auto *partition : partitions)
       {
-      case RdKafka::ERR_NO_ERROR:
+        assignedTopics_.insert(partition->topic());
+      }
+    }
+    else
+    {
+      assignedTopics_.clear();
+      offsetTracker_.clear();
+      if (workers_)
       {
-        // 处理消息
-        std::string messageStr(static_cast<const char *>(msg->payload()), msg->len());
+        workers_->clearPaused();
+      }
+    }
+    condition_.notify_all();
+
+    spdlog::info("Partition {} for {} partitions", assigned ? "assigned" : "revoked", partitions.size());
+  }
+
+  void KafkaMessageQueue::commitOffsets(bool sync)
+  {
+    std::vector<PartitionOffset> offsets = sync ? offsetTracker_.watermarks() : offsetTracker_.takeCommittable();
+    if (offsets.empty())
+    {
+      return;
+    }
 
-        try
+    std::vector<RdKafka::TopicPartition *> partitions;
+    partitions.reserve(offsets.size());
+    for (const auto &offset : offsets)
+    {
+      partitions.push_back(RdKafka::TopicPartition::create(offset.topic, offset.partition, offset.offset));
+    }
+
+    RdKafka::ErrorCode err = sync ? consumer_->commitSync(partitions) : consumer_->commitAsync(partitions);
+    if (err != RdKafka::ERR_NO_ERROR)
+    {
+      // 提交失败时重启后从上次提交的位置重放，由结果处理的幂等保证正确
+      spdlog::warn("Failed to commit offsets for {} partitions: {}", partitions.size(), RdKafka::err2str(err));
+    }
+    RdKafka::TopicPartition::destroy(partitions);
+  }
+
+  void KafkaMessageQueue::consumeThread()
+  {
+    auto lastCommit = std::chrono::steady_clock::now();
+    while (running_)
+    {
+      // 批量消费：第一条最多等待100ms，之后取走本地队列中已到达的消息
+      int timeoutMs = 100;
+      for (size_t i = 0; i < kConsumeBatchSize && running_; ++i)
+      {
+        std::unique_ptr<RdKafka::Message> msg(consumer_->consume(timeoutMs));
+        if (msg->err() == RdKafka::ERR__TIMED_OUT)
         {
-          // 解析消息JSON
-          nlohmann::json j = nlohmann::json::parse(messageStr);
+          break;
+        }
+        handleMessage(*msg);
+        timeoutMs = 0;
+      }
 
-          // 创建消息对象
-          KafkaMessage message;
-          message.type = stringToMessageType(j["type"].get<std::string>());
-          message.payload = j["payload"].get<std::string>();
-          message.key = msg->key() ? *msg->key() : "";
+      // 工作线程队列回落后恢复暂停的分区
+      workers_->resumePaused();
 
-          // 更新统计信息
-          StatsManager::getInstance().addKafkaMessage(false);
+      // 达到提交间隔或完成条数时异步提交
+      auto now = std::chrono::steady_clock::now();
+      if (offsetTracker_.completedSinceTake() >= commitBatchSize_ ||
+          now - lastCommit >= std::chrono::milliseconds(commitIntervalMs_))
+      {
+        commitOffsets(false);
+        lastCommit = now;
+      }
+    }
+  }
+
+  void KafkaMessageQueue::handleMessage(RdKafka::Message &msg)
+  {
+    switch (msg.err())
+    {
+    case RdKafka::ERR_NO_ERROR:
+    {
+      // 处理消息
+      std::string messageStr(static_cast<const char *>(msg.payload()), msg.len());
+      offsetTracker_.track(msg.topic_name(), msg.partition(), msg.offset());
 
-          // 调用回调
-          if (messageCallback_)
+      PendingMessage pending;
+      pending.topic = msg.topic_name();
+      pending.partition = msg.partition();
+      pending.offset = msg.offset();
+
+      try
+      {
+        // 创建消息对象
+        KafkaMessage &message = pending.message;
+        message.key = msg.key() ? *msg.key() : "";
+
+        // 读取消息头
+        if (RdKafka::Headers *headers = msg.headers())
+        {
+          for (const auto &header : headers->get_all())
           {
-            messageCallback_(message);
+            if (header.value() != nullptr)
+            {
+              message.headers[header.key()] = std::string(static_cast<const char *>(header.value()), header.value_size());
+            }
           }
         }
-        catch (const std::exception &e)
+
+        // 消息头带类型时消息体即为内容，否则按{type, payload}封装解析
+        auto typeIt = message.headers.find(kMessageTypeHeader);
+        if (typeIt != message.headers.end())
         {
-          spdlog::error("Failed to parse message: {}", e.what());
+          message.type = stringToMessageType(typeIt->second);
+          auto formatIt = message.headers.find(kWireFormatHeader);
+          if (formatIt != message.headers.end())
+          {
+            WireCodec::formatFromString(formatIt->second, message.format);
+          }
+          message.payload = std::move(messageStr);
         }
-        break;
+        else
+        {
+          nlohmann::json j = nlohmann::json::parse(messageStr);
+          message.type = stringToMessageType(j["type"].get<std::string>());
+          message.payload = j["payload"].get<std::string>();
+        }
+
+        // 更新统计信息
+        StatsManager::getInstance().addKafkaMessage(false);
       }
-      case RdKafka::ERR__PARTITION_EOF:
-        // 分区结束，不是错误
-        break;
-      case RdKafka::ERR__TIMED_OUT:
-        // 超时，不是错误
-        break;
-      default:
-        // 其他错误
-        spdlog::error("Consumer error: {}", msg->errstr());
+      catch (const std::exception &e)
+      {
+        // 无法解析的消息同样视为已处理，避免阻塞提交位置
+        spdlog::error("Failed to parse message: {}", e.what());
+        offsetTracker_.complete(pending.topic, pending.partition, pending.offset);
         break;
       }
 
-      // 检查是否需要停止
-      if (!running_)
+      dispatch(std::move(pending));
+      break;
+    }
+    case RdKafka::ERR__PARTITION_EOF:
+      // 分区结束，不是错误
+      break;
+    case RdKafka::ERR__TIMED_OUT:
+      // 超时，不是错误
+      break;
+    default:
+      // 其他错误
+      spdlog::error("Consumer error: {}", msg.errstr());
+      StatsManager::getInstance().addKafkaError();
+      break;
+    }
+  }
+
+  void KafkaMessageQueue::process(PendingMessage &pending)
+  {
+    try
+    {
+      if (messageCallback_)
       {
-        break;
+        messageCallback_(pending.message);
       }
     }
+    catch (const std::exception &e)
+    {
+      spdlog::error("Failed to handle message: {}", e.what());
+    }
+    offsetTracker_.complete(pending.topic, pending.partition, pending.offset);
+  }
+
+  void KafkaMessageQueue::dispatch(PendingMessage pending)
+  {
+    // 按消息键分配工作线程，同一键的消息由同一线程按顺序处理；未启用工作线程时在消费线程中直接处理
+    std::string key = pending.message.key;
+    std::string topic = pending.topic;
+    int32_t partition = pending.partition;
+    workers_->submit(key, topic, partition, [this, pending = std::move(pending)]() mutable
+                     { process(pending); });
+  }
+
+  void KafkaMessageQueue::pausePartitions(const std::vector<TopicPartitionKey> &partitions, bool pause)
+  {
+    std::vector<RdKafka::TopicPartition *> topicPartitions;
+    for (const auto &partition : partitions)
+    {
+      topicPartitions.push_back(RdKafka::TopicPartition::create(partition.first, partition.second));
+    }
+    RdKafka::ErrorCode err = pause ? consumer_->pause(topicPartitions) : consumer_->resume(topicPartitions);
+    if (err != RdKafka::ERR_NO_ERROR)
+    {
+      spdlog::warn("Failed to {} {} partitions: {}", pause ? "pause" : "resume", partitions.size(),
+                   RdKafka::err2str(err));
+    }
+    else if (pause)
+    {
+      spdlog::debug("Paused {} [{}], worker queue full", partitions[0].first, partitions[0].second);
+    }
+    RdKafka::TopicPartition::destroy(topicPartitions);
+  }
+
+  void KafkaMessageQueue::waitForWorkers()
+  {
+    if (workers_)
+    {
+      workers_->waitIdle();
+    }
+  }
+
+  void KafkaMessageQueue::stopWorkers()
+  {
+    if (workers_)
+    {
+      workers_->stop();
+    }
   }
 
   bool KafkaMessageQueue::isProducerReady() const
@@ -385,6 +968,14 @@ namespace scheduler
       return "JOB_RESULT";
     case MessageType::EXECUTOR_HEARTBEAT:
       return "EXECUTOR_HEARTBEAT";
+    case MessageType::WORK_REQUEST:
+      return "WORK_REQUEST";
+    case MessageType::JOB_RESULT_BATCH:
+      return "JOB_RESULT_BATCH";
+    case MessageType::EXECUTOR_DRAIN:
+      return "EXECUTOR_DRAIN";
+    case MessageType::JOB_RETURN:
+      return "JOB_RETURN";
     default:
       return "UNKNOWN";
     }
@@ -408,6 +999,22 @@ namespace scheduler
     {
       return MessageType::EXECUTOR_HEARTBEAT;
     }
+    else if (typeStr == "WORK_REQUEST")
+    {
+      return MessageType::WORK_REQUEST;
+    }
+    else if (typeStr == "JOB_RESULT_BATCH")
+    {
+      return MessageType::JOB_RESULT_BATCH;
+    }
+    else if (typeStr == "EXECUTOR_DRAIN")
+    {
+      return MessageType::EXECUTOR_DRAIN;
+    }
+    else if (typeStr == "JOB_RETURN")
+    {
+      return MessageType::JOB_RETURN;
+    }
     else
     {
       spdlog::warn("Unknown message type: {}", typeStr);
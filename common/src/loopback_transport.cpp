@@ -0,0 +1,281 @@
+#include "loopback_transport.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+
+namespace scheduler
+{
+
+  LoopbackBroker &LoopbackBroker::getInstance()
+  {
+    static LoopbackBroker instance;
+    return instance;
+  }
+
+  LoopbackBroker::Topic &LoopbackBroker::topic(const std::string &name)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &topic = topics_[name];
+    if (!topic)
+    {
+      topic = std::make_unique<Topic>();
+    }
+    return *topic;
+  }
+
+  void LoopbackBroker::publish(const std::string &name, KafkaMessage message)
+  {
+    Topic &t = topic(name);
+    {
+      std::lock_guard<std::mutex> lock(t.mutex);
+      t.log.push_back(std::move(message));
+      trim(t);
+    }
+    t.condition.notify_all();
+  }
+
+  void LoopbackBroker::subscribe(const std::string &name, const std::string &group, bool fromEarliest)
+  {
+    Topic &t = topic(name);
+    std::lock_guard<std::mutex> lock(t.mutex);
+    if (t.groups.find(group) == t.groups.end())
+    {
+      t.groups[group] = fromEarliest ? t.base : t.base + t.log.size();
+    }
+  }
+
+  size_t LoopbackBroker::poll(const std::string &name, const std::string &group, int timeoutMs,
+                              size_t maxMessages, std::vector<KafkaMessage> &out)
+  {
+    Topic &t = topic(name);
+    std::unique_lock<std::mutex> lock(t.mutex);
+    auto it = t.groups.find(group);
+    if (it == t.groups.end())
+    {
+      return 0;
+    }
+
+    uint64_t &next = it->second;
+    t.condition.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&t, &next]
+                         { return next < t.base + t.log.size(); });
+
+    size_t count = 0;
+    while (count < maxMessages && next < t.base + t.log.size())
+    {
+      out.push_back(t.log[next - t.base]);
+      ++next;
+      ++count;
+    }
+
+    if (count > 0)
+    {
+      trim(t);
+    }
+    return count;
+  }
+
+  void LoopbackBroker::trim(Topic &topic)
+  {
+    uint64_t end = topic.base + topic.log.size();
+    uint64_t keepFrom = end > kMaxRetained ? end - kMaxRetained : 0;
+    if (!topic.groups.empty())
+    {
+      keepFrom = end;
+      for (const auto &group : topic.groups)
+      {
+        keepFrom = std::min(keepFrom, group.second);
+      }
+    }
+
+    while (topic.base < keepFrom)
+    {
+      topic.log.pop_front();
+      ++topic.base;
+    }
+  }
+
+  LoopbackTransport::LoopbackTransport(LoopbackBroker &broker)
+      : broker_(broker), producerReady_(false), fromEarliest_(true), running_(false)
+  {
+  }
+
+  LoopbackTransport::~LoopbackTransport()
+  {
+    stopConsume();
+  }
+
+  bool LoopbackTransport::initProducer(const std::string &)
+  {
+    producerReady_ = true;
+    spdlog::info("Loopback producer initialized");
+    return true;
+  }
+
+  bool LoopbackTransport::initConsumer(const std::string &,
+                                       const std::string &groupId,
+                                       const std::vector<std::string> &topics,
+                                       MessageCallback callback,
+                                       const std::string &offsetReset)
+  {
+    groupId_ = groupId;
+    topics_ = topics;
+    messageCallback_ = callback;
+    fromEarliest_ = offsetReset != "latest";
+
+    spdlog::info("Loopback consumer initialized, group: {}", groupId);
+    return true;
+  }
+
+  void LoopbackTransport::setConsumerWorkers(size_t workers, size_t)
+  {
+    if (workers > 1)
+    {
+      spdlog::debug("Loopback transport consumes each topic in one thread, ignoring {} workers", workers);
+    }
+  }
+
+  bool LoopbackTransport::publish(const std::string &topic, KafkaMessage message, DeliveryCallback onDelivery)
+  {
+    if (!producerReady_)
+    {
+      spdlog::error("Producer not initialized");
+      return false;
+    }
+
+    broker_.publish(topic, std::move(message));
+    if (onDelivery)
+    {
+      onDelivery(true);
+    }
+    return true;
+  }
+
+  bool LoopbackTransport::sendMessage(const std::string &topic, const KafkaMessage &message,
+                                      DeliveryCallback onDelivery)
+  {
+    return publish(topic, message, std::move(onDelivery));
+  }
+
+  bool LoopbackTransport::sendJob(const std::string &topic, const JobInfo &job, const std::string &executorId)
+  {
+    KafkaMessage message(MessageType::JOB_SUBMIT, WireCodec::encodeJob(job), job.job_id);
+    message.format = WireFormat::BINARY;
+    if (!executorId.empty())
+    {
+      message.headers[kExecutorIdHeader] = executorId;
+    }
+    return publish(topic, std::move(message), nullptr);
+  }
+
+  bool LoopbackTransport::sendJobResult(const std::string &topic, const JobResult &result,
+                                        DeliveryCallback onDelivery)
+  {
+    KafkaMessage message(MessageType::JOB_RESULT, WireCodec::encodeResult(result), result.job_id);
+    message.format = WireFormat::BINARY;
+    return publish(topic, std::move(message), std::move(onDelivery));
+  }
+
+  bool LoopbackTransport::sendJobResults(const std::string &topic, const std::vector<JobResult> &results,
+                                         DeliveryCallback onDelivery)
+  {
+    if (results.empty())
+    {
+      if (onDelivery)
+      {
+        onDelivery(true);
+      }
+      return true;
+    }
+
+    if (results.size() == 1)
+    {
+      return sendJobResult(topic, results[0], std::move(onDelivery));
+    }
+
+    KafkaMessage message(MessageType::JOB_RESULT_BATCH, WireCodec::encodeResults(results), results[0].job_id);
+    message.format = WireFormat::BINARY;
+    return publish(topic, std::move(message), std::move(onDelivery));
+  }
+
+  bool LoopbackTransport::startConsume()
+  {
+    if (running_)
+    {
+      return true;
+    }
+
+    // 先加入全部消费组再启动线程，之后发布的消息不会丢失
+    for (const auto &topic : topics_)
+    {
+      broker_.subscribe(topic, groupId_, fromEarliest_);
+    }
+
+    running_ = true;
+    for (const auto &topic : topics_)
+    {
+      consumeThreads_.emplace_back(&LoopbackTransport::consumeThread, this, topic);
+    }
+
+    spdlog::info("Started loopback consuming from {} topics, group: {}", topics_.size(), groupId_);
+    return true;
+  }
+
+  void LoopbackTransport::stopConsume()
+  {
+    if (running_)
+    {
+      running_ = false;
+      for (auto &thread : consumeThreads_)
+      {
+        if (thread.joinable())
+        {
+          thread.join();
+        }
+      }
+      consumeThreads_.clear();
+
+      spdlog::info("Stopped loopback consuming, group: {}", groupId_);
+    }
+  }
+
+  bool LoopbackTransport::waitForAssignment(int)
+  {
+    return true;
+  }
+
+  bool LoopbackTransport::isProducerReady() const
+  {
+    return producerReady_;
+  }
+
+  bool LoopbackTransport::isConsumerReady() const
+  {
+    return !groupId_.empty();
+  }
+
+  void LoopbackTransport::consumeThread(const std::string &topic)
+  {
+    std::vector<KafkaMessage> messages;
+    while (running_)
+    {
+      messages.clear();
+      broker_.poll(topic, groupId_, 100, kConsumeBatchSize, messages);
+
+      for (const auto &message : messages)
+      {
+        try
+        {
+          if (messageCallback_)
+          {
+            messageCallback_(message);
+          }
+        }
+        catch (const std::exception &e)
+        {
+          spdlog::error("Failed to handle message: {}", e.what());
+        }
+      }
+    }
+  }
+
+} // namespace scheduler
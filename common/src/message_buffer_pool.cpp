@@ -0,0 +1,52 @@
+#include "message_buffer_pool.h"
+
+namespace scheduler
+{
+
+  MessageBufferPool::MessageBufferPool(size_t max_buffers, size_t max_buffer_bytes)
+      : max_buffers_(max_buffers), max_buffer_bytes_(max_buffer_bytes)
+  {
+    buffers_.reserve(max_buffers_);
+  }
+
+  ProduceBuffer *MessageBufferPool::acquire()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!buffers_.empty())
+      {
+        ProduceBuffer *buffer = buffers_.back().release();
+        buffers_.pop_back();
+        return buffer;
+      }
+    }
+
+    auto *buffer = new ProduceBuffer();
+    buffer->pool = this;
+    return buffer;
+  }
+
+  void MessageBufferPool::release(ProduceBuffer *buffer)
+  {
+    std::unique_ptr<ProduceBuffer> owned(buffer);
+    owned->onDelivery = nullptr;
+    if (owned->data.capacity() > max_buffer_bytes_)
+    {
+      return;
+    }
+    owned->data.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (buffers_.size() < max_buffers_)
+    {
+      buffers_.push_back(std::move(owned));
+    }
+  }
+
+  size_t MessageBufferPool::idle() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return buffers_.size();
+  }
+
+} // namespace scheduler
@@ -0,0 +1,84 @@
+#include "message_transport.h"
+#include "kafka_message_queue.h"
+#include "loopback_transport.h"
+#include <spdlog/spdlog.h>
+#include <nlohmann/json.hpp>
+
+namespace scheduler
+{
+
+  bool MessageTransport::parseJob(const KafkaMessage &message, JobInfo &job)
+  {
+    if (message.format == WireFormat::BINARY)
+    {
+      return WireCodec::decodeJob(message.payload, job);
+    }
+
+    try
+    {
+      job = JobInfo::from_json(nlohmann::json::parse(message.payload));
+      return true;
+    }
+    catch (const std::exception &e)
+    {
+      spdlog::error("Failed to parse job: {}", e.what());
+      return false;
+    }
+  }
+
+  bool MessageTransport::parseJobResults(const KafkaMessage &message, std::vector<JobResult> &results)
+  {
+    results.clear();
+    if (message.format == WireFormat::BINARY)
+    {
+      if (message.type == MessageType::JOB_RESULT_BATCH)
+      {
+        return WireCodec::decodeResults(message.payload, results);
+      }
+      results.emplace_back();
+      return WireCodec::decodeResult(message.payload, results.back());
+    }
+
+    try
+    {
+      nlohmann::json j = nlohmann::json::parse(message.payload);
+      if (message.type == MessageType::JOB_RESULT_BATCH)
+      {
+        results.reserve(j.size());
+        for (const auto &item : j)
+        {
+          results.push_back(JobResult::from_json(item));
+        }
+      }
+      else
+      {
+        results.push_back(JobResult::from_json(j));
+      }
+      return true;
+    }
+    catch (const std::exception &e)
+    {
+      spdlog::error("Failed to parse job result: {}", e.what());
+      return false;
+    }
+  }
+
+  std::string MessageTransport::executorTopic(const std::string &baseTopic, const std::string &executorId)
+  {
+    return baseTopic + "." + executorId;
+  }
+
+  std::unique_ptr<MessageTransport> MessageTransportFactory::create(const std::string &type)
+  {
+    if (type == "loopback")
+    {
+      return std::make_unique<LoopbackTransport>();
+    }
+    if (type != "kafka")
+    {
+      spdlog::warn("Unknown transport type: {}, using kafka", type);
+    }
+    return std::make_unique<KafkaMessageQueue>();
+  }
+
+} // namespace scheduler
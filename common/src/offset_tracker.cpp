@@ -0,0 +1,68 @@
+#include "offset_tracker.h"
+
+namespace scheduler
+{
+
+  void OffsetTracker::track(const std::string &topic, int32_t partition, int64_t offset)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PartitionState &state = partitions_[{topic, partition}];
+    state.inFlight.insert(offset);
+    if (offset + 1 > state.next)
+    {
+      state.next = offset + 1;
+    }
+  }
+
+  void OffsetTracker::complete(const std::string &topic, int32_t partition, int64_t offset)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = partitions_.find({topic, partition});
+    if (it != partitions_.end() && it->second.inFlight.erase(offset) > 0)
+    {
+      ++completed_;
+    }
+  }
+
+  std::vector<PartitionOffset> OffsetTracker::takeCommittable()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<PartitionOffset> offsets;
+    for (auto &item : partitions_)
+    {
+      int64_t watermark = item.second.watermark();
+      if (watermark > item.second.committed)
+      {
+        offsets.push_back({item.first.first, item.first.second, watermark});
+        item.second.committed = watermark;
+      }
+    }
+    completed_ = 0;
+    return offsets;
+  }
+
+  std::vector<PartitionOffset> OffsetTracker::watermarks() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<PartitionOffset> offsets;
+    for (const auto &item : partitions_)
+    {
+      offsets.push_back({item.first.first, item.first.second, item.second.watermark()});
+    }
+    return offsets;
+  }
+
+  size_t OffsetTracker::completedSinceTake() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return completed_;
+  }
+
+  void OffsetTracker::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    partitions_.clear();
+    completed_ = 0;
+  }
+
+} // namespace scheduler
@@ -0,0 +1,345 @@
+#include "payload_codec.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <lz4.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace scheduler
+{
+
+  namespace
+  {
+    // 解压后的长度上限，防止损坏的长度头导致分配过大内存
+    const size_t kMaxPayloadBytes = 1u << 30;
+
+    const size_t kHeaderBytes = 4;
+
+    void writeHeader(std::string &output, size_t size)
+    {
+      for (size_t i = 0; i < kHeaderBytes; ++i)
+      {
+        output[i] = static_cast<char>((size >> (8 * i)) & 0xff);
+      }
+    }
+
+    size_t readHeader(const std::string &input)
+    {
+      size_t size = 0;
+      for (size_t i = 0; i < kHeaderBytes; ++i)
+      {
+        size |= static_cast<size_t>(static_cast<unsigned char>(input[i])) << (8 * i);
+      }
+      return size;
+    }
+
+    const char kBase64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    int base64Value(char c)
+    {
+      if (c >= 'A' && c <= 'Z')
+        return c - 'A';
+      if (c >= 'a' && c <= 'z')
+        return c - 'a' + 26;
+      if (c >= '0' && c <= '9')
+        return c - '0' + 52;
+      if (c == '+')
+        return 62;
+      if (c == '/')
+        return 63;
+      return -1;
+    }
+  } // namespace
+
+  std::string PayloadCompressor::codecToString(PayloadCodec codec)
+  {
+    switch (codec)
+    {
+    case PayloadCodec::LZ4:
+      return "LZ4";
+    case PayloadCodec::ZSTD:
+      return "ZSTD";
+    default:
+      return "NONE";
+    }
+  }
+
+  bool PayloadCompressor::codecFromString(const std::string &name, PayloadCodec &codec)
+  {
+    std::string upper = name;
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c)
+                   { return std::toupper(c); });
+
+    if (upper == "NONE" || upper.empty())
+    {
+      codec = PayloadCodec::NONE;
+    }
+    else if (upper == "LZ4")
+    {
+      codec = PayloadCodec::LZ4;
+    }
+    else if (upper == "ZSTD")
+    {
+      codec = PayloadCodec::ZSTD;
+    }
+    else
+    {
+      return false;
+    }
+    return true;
+  }
+
+  bool PayloadCompressor::isSupported(PayloadCodec codec)
+  {
+#ifdef HAVE_ZSTD
+    (void)codec;
+    return true;
+#else
+    return codec != PayloadCodec::ZSTD;
+#endif
+  }
+
+  bool PayloadCompressor::compress(PayloadCodec codec, const std::string &input, std::string &output)
+  {
+    if (input.size() > kMaxPayloadBytes)
+    {
+      return false;
+    }
+
+    if (codec == PayloadCodec::NONE)
+    {
+      output = input;
+      return true;
+    }
+
+    if (input.empty())
+    {
+      output.clear();
+      return true;
+    }
+
+    if (codec == PayloadCodec::LZ4)
+    {
+      int bound = LZ4_compressBound(static_cast<int>(input.size()));
+      output.resize(kHeaderBytes + bound);
+      int n = LZ4_compress_default(input.data(), &output[kHeaderBytes], static_cast<int>(input.size()), bound);
+      if (n <= 0)
+      {
+        return false;
+      }
+      output.resize(kHeaderBytes + n);
+      writeHeader(output, input.size());
+      return true;
+    }
+
+#ifdef HAVE_ZSTD
+    if (codec == PayloadCodec::ZSTD)
+    {
+      size_t bound = ZSTD_compressBound(input.size());
+      output.resize(kHeaderBytes + bound);
+      size_t n = ZSTD_compress(&output[kHeaderBytes], bound, input.data(), input.size(), 3);
+      if (ZSTD_isError(n))
+      {
+        return false;
+      }
+      output.resize(kHeaderBytes + n);
+      writeHeader(output, input.size());
+      return true;
+    }
+#endif
+
+    return false;
+  }
+
+  bool PayloadCompressor::decompress(PayloadCodec codec, const std::string &input, std::string &output)
+  {
+    if (codec == PayloadCodec::NONE)
+    {
+      output = input;
+      return true;
+    }
+
+    if (input.empty())
+    {
+      output.clear();
+      return true;
+    }
+
+    if (input.size() < kHeaderBytes)
+    {
+      return false;
+    }
+    size_t size = readHeader(input);
+    if (size > kMaxPayloadBytes)
+    {
+      return false;
+    }
+    const char *data = input.data() + kHeaderBytes;
+    size_t data_size = input.size() - kHeaderBytes;
+
+    if (codec == PayloadCodec::LZ4)
+    {
+      std::string decoded(size, '\0');
+      int n = LZ4_decompress_safe(data, &decoded[0], static_cast<int>(data_size), static_cast<int>(size));
+      if (n < 0 || static_cast<size_t>(n) != size)
+      {
+        return false;
+      }
+      output.swap(decoded);
+      return true;
+    }
+
+#ifdef HAVE_ZSTD
+    if (codec == PayloadCodec::ZSTD)
+    {
+      std::string decoded(size, '\0');
+      size_t n = ZSTD_decompress(&decoded[0], size, data, data_size);
+      if (ZSTD_isError(n) || n != size)
+      {
+        return false;
+      }
+      output.swap(decoded);
+      return true;
+    }
+#endif
+
+    return false;
+  }
+
+  bool PayloadCompressor::compressResult(JobResult &result, PayloadCodec codec, size_t min_bytes)
+  {
+    if (codec == PayloadCodec::NONE || result.payload_codec != PayloadCodec::NONE)
+    {
+      return false;
+    }
+    if (result.output.size() + result.error.size() < min_bytes)
+    {
+      return false;
+    }
+
+    std::string output;
+    std::string error;
+    if (!compress(codec, result.output, output) || !compress(codec, result.error, error))
+    {
+      spdlog::warn("压缩任务输出失败: {}, 格式: {}", result.job_id, codecToString(codec));
+      return false;
+    }
+
+    // 压缩收益不明显时保持原样，省去读取时的解压
+    if (output.size() + error.size() >= result.output.size() + result.error.size())
+    {
+      return false;
+    }
+
+    result.output.swap(output);
+    result.error.swap(error);
+    result.payload_codec = codec;
+    return true;
+  }
+
+  bool PayloadCompressor::decompressResult(JobResult &result)
+  {
+    if (result.payload_codec == PayloadCodec::NONE)
+    {
+      return true;
+    }
+
+    std::string output;
+    std::string error;
+    if (!decompress(result.payload_codec, result.output, output) ||
+        !decompress(result.payload_codec, result.error, error))
+    {
+      spdlog::error("解压任务输出失败: {}, 格式: {}", result.job_id, codecToString(result.payload_codec));
+      return false;
+    }
+
+    result.output.swap(output);
+    result.error.swap(error);
+    result.payload_codec = PayloadCodec::NONE;
+    return true;
+  }
+
+  std::string PayloadCompressor::base64Encode(const std::string &input)
+  {
+    std::string output;
+    output.reserve((input.size() + 2) / 3 * 4);
+
+    size_t i = 0;
+    for (; i + 2 < input.size(); i += 3)
+    {
+      uint32_t n = (static_cast<unsigned char>(input[i]) << 16) |
+                   (static_cast<unsigned char>(input[i + 1]) << 8) |
+                   static_cast<unsigned char>(input[i + 2]);
+      output.push_back(kBase64Chars[(n >> 18) & 0x3f]);
+      output.push_back(kBase64Chars[(n >> 12) & 0x3f]);
+      output.push_back(kBase64Chars[(n >> 6) & 0x3f]);
+      output.push_back(kBase64Chars[n & 0x3f]);
+    }
+
+    size_t rest = input.size() - i;
+    if (rest > 0)
+    {
+      uint32_t n = static_cast<unsigned char>(input[i]) << 16;
+      if (rest == 2)
+      {
+        n |= static_cast<unsigned char>(input[i + 1]) << 8;
+      }
+      output.push_back(kBase64Chars[(n >> 18) & 0x3f]);
+      output.push_back(kBase64Chars[(n >> 12) & 0x3f]);
+      output.push_back(rest == 2 ? kBase64Chars[(n >> 6) & 0x3f] : '=');
+      output.push_back('=');
+    }
+
+    return output;
+  }
+
+  bool PayloadCompressor::base64Decode(const std::string &input, std::string &output)
+  {
+    if (input.size() % 4 != 0)
+    {
+      return false;
+    }
+
+    std::string decoded;
+    decoded.reserve(input.size() / 4 * 3);
+
+    for (size_t i = 0; i < input.size(); i += 4)
+    {
+      int pad = 0;
+      uint32_t n = 0;
+      for (size_t k = 0; k < 4; ++k)
+      {
+        char c = input[i + k];
+        int value = 0;
+        // 只允许最后一组末尾出现填充
+        if (c == '=' && i + 4 == input.size() && k >= 2 && (k == 3 || input[i + 3] == '='))
+        {
+          value = 0;
+          ++pad;
+        }
+        else if (pad > 0 || (value = base64Value(c)) < 0)
+        {
+          return false;
+        }
+        n = (n << 6) | static_cast<uint32_t>(value);
+      }
+
+      decoded.push_back(static_cast<char>((n >> 16) & 0xff));
+      if (pad < 2)
+      {
+        decoded.push_back(static_cast<char>((n >> 8) & 0xff));
+      }
+      if (pad < 1)
+      {
+        decoded.push_back(static_cast<char>(n & 0xff));
+      }
+    }
+
+    output.swap(decoded);
+    return true;
+  }
+
+} // namespace scheduler
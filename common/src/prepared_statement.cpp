@@ -0,0 +1,440 @@
+#include "prepared_statement.h"
+#include "stats_manager.h"
+#include <spdlog/spdlog.h>
+#include <cstring>
+#include <ctime>
+
+namespace scheduler
+{
+
+  namespace
+  {
+    // 字节串列的初始缓冲区大小，更长的值读取时再扩大
+    constexpr size_t kInitialColumnBuffer = 256;
+
+    // 服务端已不认识该语句句柄（连接重建后）
+    constexpr unsigned int kUnknownStmtHandler = 1243;
+
+    bool isIntegerType(enum_field_types type)
+    {
+      return type == MYSQL_TYPE_TINY || type == MYSQL_TYPE_SHORT || type == MYSQL_TYPE_LONG ||
+             type == MYSQL_TYPE_INT24 || type == MYSQL_TYPE_LONGLONG || type == MYSQL_TYPE_YEAR;
+    }
+
+    bool isTimeType(enum_field_types type)
+    {
+      return type == MYSQL_TYPE_DATETIME || type == MYSQL_TYPE_TIMESTAMP || type == MYSQL_TYPE_DATE;
+    }
+  }
+
+  PreparedStatement::PreparedStatement(MYSQL *mysql, const std::string &sql)
+      : stmt_(mysql_stmt_init(mysql)), sql_(sql), broken_(false), hasResult_(false)
+  {
+    if (!stmt_)
+    {
+      spdlog::error("Failed to initialize statement: {}", mysql_error(mysql));
+      return;
+    }
+
+    if (mysql_stmt_prepare(stmt_, sql_.c_str(), sql_.length()) != 0)
+    {
+      spdlog::error("Failed to prepare statement: {}, sql: {}", mysql_stmt_error(stmt_), sql_);
+      mysql_stmt_close(stmt_);
+      stmt_ = nullptr;
+      return;
+    }
+
+    params_.resize(mysql_stmt_param_count(stmt_));
+    paramBinds_.resize(params_.size());
+    prepareColumns();
+  }
+
+  PreparedStatement::~PreparedStatement()
+  {
+    if (stmt_)
+    {
+      mysql_stmt_close(stmt_);
+    }
+  }
+
+  void PreparedStatement::prepareColumns()
+  {
+    MYSQL_RES *meta = mysql_stmt_result_metadata(stmt_);
+    if (!meta)
+    {
+      return;
+    }
+
+    unsigned int count = mysql_num_fields(meta);
+    MYSQL_FIELD *fields = mysql_fetch_fields(meta);
+    columns_.resize(count);
+    columnBinds_.resize(count);
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      Column &column = columns_[i];
+      MYSQL_BIND &bind = columnBinds_[i];
+      std::memset(&bind, 0, sizeof(bind));
+      bind.length = &column.length;
+      bind.is_null = &column.isNull;
+      bind.error = &column.error;
+
+      if (isIntegerType(fields[i].type))
+      {
+        column.type = MYSQL_TYPE_LONGLONG;
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &column.number;
+        bind.is_unsigned = (fields[i].flags & UNSIGNED_FLAG) != 0;
+      }
+      else if (isTimeType(fields[i].type))
+      {
+        column.type = MYSQL_TYPE_DATETIME;
+        bind.buffer_type = MYSQL_TYPE_DATETIME;
+        bind.buffer = &column.time;
+      }
+      else
+      {
+        column.type = MYSQL_TYPE_STRING;
+        column.buffer.resize(kInitialColumnBuffer);
+        bind.buffer_type = MYSQL_TYPE_STRING;
+        bind.buffer = column.buffer.data();
+        bind.buffer_length = column.buffer.size();
+      }
+    }
+
+    mysql_free_result(meta);
+  }
+
+  void PreparedStatement::bindColumns()
+  {
+    for (size_t i = 0; i < columns_.size(); ++i)
+    {
+      if (columns_[i].type == MYSQL_TYPE_STRING)
+      {
+        columnBinds_[i].buffer = columns_[i].buffer.data();
+        columnBinds_[i].buffer_length = columns_[i].buffer.size();
+      }
+    }
+    mysql_stmt_bind_result(stmt_, columnBinds_.data());
+  }
+
+  void PreparedStatement::bindString(size_t index, const std::string &value)
+  {
+    Param &param = params_.at(index);
+    param.type = MYSQL_TYPE_STRING;
+    param.text.assign(value);
+    param.length = param.text.length();
+    param.isNull = 0;
+  }
+
+  void PreparedStatement::bindBlob(size_t index, const std::string &value)
+  {
+    bindString(index, value);
+    params_.at(index).type = MYSQL_TYPE_BLOB;
+  }
+
+  void PreparedStatement::bindInt(size_t index, int64_t value)
+  {
+    Param &param = params_.at(index);
+    param.type = MYSQL_TYPE_LONGLONG;
+    param.number = value;
+    param.isUnsigned = false;
+    param.isNull = 0;
+  }
+
+  void PreparedStatement::bindUInt(size_t index, uint64_t value)
+  {
+    Param &param = params_.at(index);
+    param.type = MYSQL_TYPE_LONGLONG;
+    param.number = static_cast<int64_t>(value);
+    param.isUnsigned = true;
+    param.isNull = 0;
+  }
+
+  void PreparedStatement::bindTime(size_t index, const std::chrono::system_clock::time_point &value)
+  {
+    Param &param = params_.at(index);
+    param.type = MYSQL_TYPE_DATETIME;
+    param.time = toMysqlTime(value);
+    param.isNull = 0;
+  }
+
+  void PreparedStatement::bindNull(size_t index)
+  {
+    Param &param = params_.at(index);
+    param.type = MYSQL_TYPE_NULL;
+    param.isNull = 1;
+  }
+
+  void PreparedStatement::bindOptionalString(size_t index, const std::string &value)
+  {
+    if (value.empty())
+    {
+      bindNull(index);
+    }
+    else
+    {
+      bindString(index, value);
+    }
+  }
+
+  bool PreparedStatement::execute()
+  {
+    if (!isValid())
+    {
+      return false;
+    }
+
+    // 丢弃上次执行未读完的结果集
+    if (hasResult_)
+    {
+      mysql_stmt_free_result(stmt_);
+      hasResult_ = false;
+    }
+
+    for (size_t i = 0; i < params_.size(); ++i)
+    {
+      Param &param = params_[i];
+      MYSQL_BIND &bind = paramBinds_[i];
+      std::memset(&bind, 0, sizeof(bind));
+      bind.buffer_type = param.type;
+      bind.is_null = &param.isNull;
+      bind.is_unsigned = param.isUnsigned;
+      if (param.type == MYSQL_TYPE_STRING || param.type == MYSQL_TYPE_BLOB)
+      {
+        bind.buffer = const_cast<char *>(param.text.data());
+        bind.buffer_length = param.length;
+        bind.length = &param.length;
+      }
+      else if (param.type == MYSQL_TYPE_LONGLONG)
+      {
+        bind.buffer = &param.number;
+      }
+      else if (param.type == MYSQL_TYPE_DATETIME)
+      {
+        bind.buffer = &param.time;
+      }
+    }
+
+    if (!params_.empty() && mysql_stmt_bind_param(stmt_, paramBinds_.data()))
+    {
+      spdlog::error("Failed to bind parameters: {}, sql: {}", mysql_stmt_error(stmt_), sql_);
+      return false;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    bool ok = mysql_stmt_execute(stmt_) == 0;
+    if (ok && !columns_.empty())
+    {
+      ok = mysql_stmt_store_result(stmt_) == 0;
+      hasResult_ = ok;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    StatsManager::getInstance().addDbQuery(
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+
+    if (!ok)
+    {
+      spdlog::error("Statement execution failed: {}, sql: {}", mysql_stmt_error(stmt_), sql_);
+      checkBroken();
+      return false;
+    }
+
+    if (!columns_.empty())
+    {
+      bindColumns();
+    }
+    return true;
+  }
+
+  bool PreparedStatement::fetch()
+  {
+    if (!hasResult_)
+    {
+      return false;
+    }
+
+    int rc = mysql_stmt_fetch(stmt_);
+    if (rc == MYSQL_NO_DATA)
+    {
+      return false;
+    }
+    if (rc != 0 && rc != MYSQL_DATA_TRUNCATED)
+    {
+      spdlog::error("Failed to fetch row: {}, sql: {}", mysql_stmt_error(stmt_), sql_);
+      return false;
+    }
+
+    // 超出缓冲区的列扩大缓冲区后重新读取，之后的行直接使用更大的缓冲区
+    bool grown = false;
+    for (size_t i = 0; i < columns_.size(); ++i)
+    {
+      Column &column = columns_[i];
+      if (column.type != MYSQL_TYPE_STRING || column.isNull || column.length <= column.buffer.size())
+      {
+        continue;
+      }
+
+      column.buffer.resize(column.length);
+      columnBinds_[i].buffer = column.buffer.data();
+      columnBinds_[i].buffer_length = column.buffer.size();
+      if (mysql_stmt_fetch_column(stmt_, &columnBinds_[i], static_cast<unsigned int>(i), 0) != 0)
+      {
+        spdlog::error("Failed to fetch column {}: {}", i, mysql_stmt_error(stmt_));
+        return false;
+      }
+      grown = true;
+    }
+
+    if (grown)
+    {
+      bindColumns();
+    }
+    return true;
+  }
+
+  uint64_t PreparedStatement::rowCount() const
+  {
+    return hasResult_ ? mysql_stmt_num_rows(stmt_) : 0;
+  }
+
+  uint64_t PreparedStatement::affectedRows() const
+  {
+    return stmt_ ? mysql_stmt_affected_rows(stmt_) : 0;
+  }
+
+  uint64_t PreparedStatement::insertId() const
+  {
+    return stmt_ ? mysql_stmt_insert_id(stmt_) : 0;
+  }
+
+  bool PreparedStatement::isNull(size_t column) const
+  {
+    return columns_.at(column).isNull;
+  }
+
+  std::string PreparedStatement::getString(size_t column) const
+  {
+    const Column &c = columns_.at(column);
+    if (c.isNull)
+    {
+      return "";
+    }
+    if (c.type == MYSQL_TYPE_LONGLONG)
+    {
+      return std::to_string(c.number);
+    }
+    if (c.type == MYSQL_TYPE_DATETIME)
+    {
+      char buf[32];
+      snprintf(buf, sizeof(buf), "%04u-%02u-%02u %02u:%02u:%02u",
+               c.time.year, c.time.month, c.time.day, c.time.hour, c.time.minute, c.time.second);
+      return buf;
+    }
+    return std::string(c.buffer.data(), c.length);
+  }
+
+  int64_t PreparedStatement::getInt(size_t column) const
+  {
+    const Column &c = columns_.at(column);
+    if (c.isNull)
+    {
+      return 0;
+    }
+    if (c.type == MYSQL_TYPE_LONGLONG)
+    {
+      return c.number;
+    }
+    return std::strtoll(getString(column).c_str(), nullptr, 10);
+  }
+
+  uint64_t PreparedStatement::getUInt(size_t column) const
+  {
+    const Column &c = columns_.at(column);
+    if (c.isNull)
+    {
+      return 0;
+    }
+    if (c.type == MYSQL_TYPE_LONGLONG)
+    {
+      return static_cast<uint64_t>(c.number);
+    }
+    return std::strtoull(getString(column).c_str(), nullptr, 10);
+  }
+
+  std::chrono::system_clock::time_point PreparedStatement::getTime(size_t column) const
+  {
+    const Column &c = columns_.at(column);
+    if (c.isNull || c.type != MYSQL_TYPE_DATETIME)
+    {
+      return std::chrono::system_clock::time_point();
+    }
+    return fromMysqlTime(c.time);
+  }
+
+  void PreparedStatement::checkBroken()
+  {
+    // 2000-2999为客户端错误（连接断开等），连接重建后服务端的语句句柄不再有效
+    unsigned int code = mysql_stmt_errno(stmt_);
+    if ((code >= 2000 && code < 3000) || code == kUnknownStmtHandler)
+    {
+      broken_ = true;
+    }
+  }
+
+  MYSQL_TIME PreparedStatement::toMysqlTime(const std::chrono::system_clock::time_point &timePoint)
+  {
+    auto time_t = std::chrono::system_clock::to_time_t(timePoint);
+    // to_time_t可能向上取整，微秒部分以截断后的秒为基准计算
+    if (std::chrono::system_clock::from_time_t(time_t) > timePoint)
+    {
+      --time_t;
+    }
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+                      timePoint - std::chrono::system_clock::from_time_t(time_t))
+                      .count();
+
+    std::tm tm = {};
+    localtime_r(&time_t, &tm);
+
+    MYSQL_TIME time;
+    std::memset(&time, 0, sizeof(time));
+    time.year = tm.tm_year + 1900;
+    time.month = tm.tm_mon + 1;
+    time.day = tm.tm_mday;
+    time.hour = tm.tm_hour;
+    time.minute = tm.tm_min;
+    time.second = tm.tm_sec;
+    time.second_part = static_cast<unsigned long>(micros);
+    time.time_type = MYSQL_TIMESTAMP_DATETIME;
+    return time;
+  }
+
+  std::chrono::system_clock::time_point PreparedStatement::fromMysqlTime(const MYSQL_TIME &time)
+  {
+    std::tm tm = {};
+    tm.tm_year = static_cast<int>(time.year) - 1900;
+    tm.tm_mon = static_cast<int>(time.month) - 1;
+    tm.tm_mday = static_cast<int>(time.day);
+    tm.tm_hour = static_cast<int>(time.hour);
+    tm.tm_min = static_cast<int>(time.minute);
+    tm.tm_sec = static_cast<int>(time.second);
+    tm.tm_isdst = -1;
+
+    auto timePoint = std::chrono::system_clock::from_time_t(std::mktime(&tm));
+    return timePoint + std::chrono::microseconds(time.second_part);
+  }
+
+  std::string PreparedStatement::placeholders(size_t count)
+  {
+    std::string result;
+    for (size_t i = 0; i < count; ++i)
+    {
+      result += i > 0 ? ", ?" : "?";
+    }
+    return result;
+  }
+
+} // namespace scheduler
@@ -0,0 +1,150 @@
+#include "priority_lanes.h"
+#include "message_transport.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <set>
+#include <sstream>
+
+namespace scheduler
+{
+
+  PriorityLanes::PriorityLanes()
+      : lanes_{{"normal", INT_MIN, 1}}
+  {
+  }
+
+  bool PriorityLanes::parse(const std::string &spec)
+  {
+    if (spec.empty())
+    {
+      lanes_ = {{"normal", INT_MIN, 1}};
+      return true;
+    }
+
+    std::vector<PriorityLane> lanes;
+    std::set<std::string> names;
+    std::set<int> minPriorities;
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+      auto first = item.find(':');
+      auto second = first == std::string::npos ? std::string::npos : item.find(':', first + 1);
+      if (second == std::string::npos)
+      {
+        spdlog::error("优先级通道配置格式错误: {}", item);
+        return false;
+      }
+
+      PriorityLane lane;
+      lane.name = item.substr(0, first);
+      try
+      {
+        lane.min_priority = std::stoi(item.substr(first + 1, second - first - 1));
+        lane.weight = std::stoi(item.substr(second + 1));
+      }
+      catch (const std::exception &e)
+      {
+        spdlog::error("优先级通道配置格式错误: {}, {}", item, e.what());
+        return false;
+      }
+
+      // 通道名会成为主题名的一部分
+      bool validName = !lane.name.empty() &&
+                       std::all_of(lane.name.begin(), lane.name.end(), [](char c)
+                                   { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; });
+      if (!validName || lane.weight <= 0)
+      {
+        spdlog::error("优先级通道配置无效: {}, 名称只能包含字母数字和下划线，权重需大于0", item);
+        return false;
+      }
+      if (!names.insert(lane.name).second || !minPriorities.insert(lane.min_priority).second)
+      {
+        spdlog::error("优先级通道名称或最低优先级重复: {}", item);
+        return false;
+      }
+      lanes.push_back(lane);
+    }
+
+    if (lanes.empty())
+    {
+      spdlog::error("优先级通道配置为空: {}", spec);
+      return false;
+    }
+
+    std::sort(lanes.begin(), lanes.end(), [](const PriorityLane &a, const PriorityLane &b)
+              { return a.min_priority > b.min_priority; });
+    lanes_ = std::move(lanes);
+    return true;
+  }
+
+  size_t PriorityLanes::laneFor(int priority) const
+  {
+    for (size_t i = 0; i < lanes_.size(); ++i)
+    {
+      if (priority >= lanes_[i].min_priority)
+      {
+        return i;
+      }
+    }
+    return lanes_.size() - 1;
+  }
+
+  std::string PriorityLanes::topic(const std::string &baseTopic, size_t lane, const std::string &executorId) const
+  {
+    // 默认优先级所在的通道沿用原主题，升级期间旧版本执行器仍能收到普通任务
+    if (lane == laneFor(0))
+    {
+      return MessageTransport::executorTopic(baseTopic, executorId);
+    }
+    return MessageTransport::executorTopic(baseTopic + "-" + lanes_[lane].name, executorId);
+  }
+
+  std::vector<std::string> PriorityLanes::topics(const std::string &baseTopic, const std::string &executorId) const
+  {
+    std::vector<std::string> result;
+    for (size_t i = 0; i < lanes_.size(); ++i)
+    {
+      result.push_back(topic(baseTopic, i, executorId));
+    }
+    return result;
+  }
+
+  LaneSelector::LaneSelector(const std::vector<PriorityLane> &lanes)
+      : current_(lanes.size(), 0)
+  {
+    for (const auto &lane : lanes)
+    {
+      weights_.push_back(lane.weight);
+    }
+  }
+
+  int LaneSelector::next(const std::vector<size_t> &backlog)
+  {
+    // 每轮有任务的通道加上各自权重，选中当前值最大的通道并减去本轮总权重
+    int selected = -1;
+    int64_t total = 0;
+    for (size_t i = 0; i < weights_.size() && i < backlog.size(); ++i)
+    {
+      if (backlog[i] == 0)
+      {
+        continue;
+      }
+      current_[i] += weights_[i];
+      total += weights_[i];
+      if (selected < 0 || current_[i] > current_[selected])
+      {
+        selected = static_cast<int>(i);
+      }
+    }
+
+    if (selected >= 0)
+    {
+      current_[selected] -= total;
+    }
+    return selected;
+  }
+
+} // namespace scheduler
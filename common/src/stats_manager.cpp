@@ -106,6 +106,16 @@ namespace scheduler
       // 自旋直到成功更新或者不再需要更新
     }
 
+    // 更新资源使用统计
+    jobStats_.total_cpu_time += result.cpu_time_ms;
+    jobStats_.total_io_read += result.io_read_bytes;
+    jobStats_.total_io_write += result.io_write_bytes;
+    uint64_t currentPeak = jobStats_.max_peak_rss.load();
+    while (result.peak_rss_kb > currentPeak &&
+           !jobStats_.max_peak_rss.compare_exchange_weak(currentPeak, result.peak_rss_kb))
+    {
+    }
+
     spdlog::debug("任务执行结果统计已更新: 任务ID={}, 状态={}, 执行时间={}ms",
                   result.job_id, static_cast<int>(result.status), executionTime);
   }
@@ -153,6 +163,10 @@ namespace scheduler
     {
       systemStats_.kafka_msg_received = value;
     }
+    else if (metric == "kafka_delivery_failed")
+    {
+      systemStats_.kafka_delivery_failed = value;
+    }
     else if (metric == "scheduler_cycles")
     {
       systemStats_.scheduler_cycles = value;
@@ -177,6 +191,43 @@ namespace scheduler
     }
   }
 
+  void StatsManager::addKafkaDeliveryFailure()
+  {
+    systemStats_.kafka_delivery_failed++;
+  }
+
+  void StatsManager::addKafkaDeliveryLatency(uint64_t latencyUs)
+  {
+    systemStats_.kafka_delivered++;
+    systemStats_.kafka_delivery_latency_us += latencyUs;
+    uint64_t currentMax = systemStats_.kafka_delivery_latency_max_us.load();
+    while (latencyUs > currentMax &&
+           !systemStats_.kafka_delivery_latency_max_us.compare_exchange_weak(currentMax, latencyUs))
+    {
+    }
+  }
+
+  void StatsManager::addKafkaError()
+  {
+    systemStats_.kafka_errors++;
+  }
+
+  void StatsManager::updateTransportStats(const TransportStats &stats)
+  {
+    std::lock_guard<std::mutex> lock(transportStatsMutex_);
+    transportStats_[stats.name] = stats;
+  }
+
+  void StatsManager::updateExecutorConsumerLag(const std::string &executorId, int64_t lag)
+  {
+    std::lock_guard<std::mutex> lock(executorStatsMutex_);
+    auto it = executorStats_.find(executorId);
+    if (it != executorStats_.end())
+    {
+      it->second.consumer_lag = lag;
+    }
+  }
+
   void StatsManager::addSchedulerCycle()
   {
     systemStats_.scheduler_cycles++;
@@ -209,6 +260,10 @@ namespace scheduler
     stats.min_execution_time = jobStats_.min_execution_time.load();
     stats.max_execution_time = jobStats_.max_execution_time.load();
     stats.retry_count = jobStats_.retry_count.load();
+    stats.total_cpu_time = jobStats_.total_cpu_time.load();
+    stats.max_peak_rss = jobStats_.max_peak_rss.load();
+    stats.total_io_read = jobStats_.total_io_read.load();
+    stats.total_io_write = jobStats_.total_io_write.load();
     return stats;
   }
 
@@ -235,10 +290,28 @@ namespace scheduler
     stats.db_query_time = systemStats_.db_query_time.load();
     stats.kafka_msg_sent = systemStats_.kafka_msg_sent.load();
     stats.kafka_msg_received = systemStats_.kafka_msg_received.load();
+    stats.kafka_delivery_failed = systemStats_.kafka_delivery_failed.load();
+    stats.kafka_delivered = systemStats_.kafka_delivered.load();
+    stats.kafka_delivery_latency_us = systemStats_.kafka_delivery_latency_us.load();
+    stats.kafka_delivery_latency_max_us = systemStats_.kafka_delivery_latency_max_us.load();
+    stats.kafka_errors = systemStats_.kafka_errors.load();
     stats.scheduler_cycles = systemStats_.scheduler_cycles.load();
     return stats;
   }
 
+  std::vector<TransportStats> StatsManager::getTransportStats() const
+  {
+    std::lock_guard<std::mutex> lock(transportStatsMutex_);
+
+    std::vector<TransportStats> result;
+    result.reserve(transportStats_.size());
+    for (const auto &pair : transportStats_)
+    {
+      result.push_back(pair.second);
+    }
+    return result;
+  }
+
   void StatsManager::resetAllStats()
   {
     // 重置任务统计
@@ -252,6 +325,10 @@ namespace scheduler
 
     // 重置系统性能统计
     systemStats_.reset();
+    {
+      std::lock_guard<std::mutex> lock(transportStatsMutex_);
+      transportStats_.clear();
+    }
 
     // 重置启动时间
     startTime_ = std::chrono::system_clock::now();
@@ -294,6 +371,10 @@ namespace scheduler
       ss << "最大执行时间: " << jobStats_.max_execution_time.load() << " 毫秒" << std::endl;
     }
     ss << "重试次数: " << jobStats_.retry_count.load() << std::endl;
+    ss << "总CPU时间: " << jobStats_.total_cpu_time.load() << " 毫秒" << std::endl;
+    ss << "最大峰值内存: " << jobStats_.max_peak_rss.load() << " KB" << std::endl;
+    ss << "总IO读取: " << jobStats_.total_io_read.load() << " 字节" << std::endl;
+    ss << "总IO写入: " << jobStats_.total_io_write.load() << " 字节" << std::endl;
     ss << std::endl;
 
     // 执行器统计
@@ -329,6 +410,19 @@ namespace scheduler
     }
     ss << "Kafka消息发送数: " << systemStats_.kafka_msg_sent.load() << std::endl;
     ss << "Kafka消息接收数: " << systemStats_.kafka_msg_received.load() << std::endl;
+    ss << "Kafka消息传递失败数: " << systemStats_.kafka_delivery_failed.load() << std::endl;
+    ss << "Kafka平均传递延迟: " << systemStats_.getAvgDeliveryLatency() << " 微秒" << std::endl;
+    ss << "Kafka客户端错误数: " << systemStats_.kafka_errors.load() << std::endl;
+    {
+      std::lock_guard<std::mutex> lock(transportStatsMutex_);
+      for (const auto &pair : transportStats_)
+      {
+        if (pair.second.type == "consumer")
+        {
+          ss << "Kafka消费积压(" << pair.first << "): " << pair.second.totalLag() << std::endl;
+        }
+      }
+    }
     ss << "调度周期数: " << systemStats_.scheduler_cycles.load() << std::endl;
 
     return ss.str();
@@ -358,6 +452,10 @@ namespace scheduler
     j["jobs"]["min_execution_time"] = jobStats_.min_execution_time.load();
     j["jobs"]["max_execution_time"] = jobStats_.max_execution_time.load();
     j["jobs"]["retry_count"] = jobStats_.retry_count.load();
+    j["jobs"]["total_cpu_time"] = jobStats_.total_cpu_time.load();
+    j["jobs"]["max_peak_rss"] = jobStats_.max_peak_rss.load();
+    j["jobs"]["total_io_read"] = jobStats_.total_io_read.load();
+    j["jobs"]["total_io_write"] = jobStats_.total_io_write.load();
 
     // 执行器统计
     j["executors"] = nlohmann::json::array();
@@ -377,6 +475,7 @@ namespace scheduler
                                          stats.last_heartbeat.time_since_epoch())
                                          .count();
         executor["online"] = stats.is_online;
+        executor["consumer_lag"] = stats.consumer_lag;
         j["executors"].push_back(executor);
       }
     }
@@ -386,8 +485,22 @@ namespace scheduler
     j["performance"]["db_query_avg_time"] = systemStats_.getAvgDbQueryTime();
     j["performance"]["kafka_msg_sent"] = systemStats_.kafka_msg_sent.load();
     j["performance"]["kafka_msg_received"] = systemStats_.kafka_msg_received.load();
+    j["performance"]["kafka_delivery_failed"] = systemStats_.kafka_delivery_failed.load();
+    j["performance"]["kafka_delivery_latency_avg_us"] = systemStats_.getAvgDeliveryLatency();
+    j["performance"]["kafka_delivery_latency_max_us"] = systemStats_.kafka_delivery_latency_max_us.load();
+    j["performance"]["kafka_errors"] = systemStats_.kafka_errors.load();
     j["performance"]["scheduler_cycles"] = systemStats_.scheduler_cycles.load();
 
+    // Kafka客户端运行状态
+    j["transport"] = nlohmann::json::array();
+    {
+      std::lock_guard<std::mutex> lock(transportStatsMutex_);
+      for (const auto &pair : transportStats_)
+      {
+        j["transport"].push_back(pair.second.to_json());
+      }
+    }
+
     return j.dump(2); // 缩进2个空格
   }
 
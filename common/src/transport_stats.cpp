@@ -0,0 +1,124 @@
+#include "transport_stats.h"
+#include <spdlog/spdlog.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+
+namespace scheduler
+{
+
+  int64_t TransportStats::totalLag() const
+  {
+    int64_t total = 0;
+    for (const auto &partition : partitions)
+    {
+      if (partition.lag > 0)
+      {
+        total += partition.lag;
+      }
+    }
+    return total;
+  }
+
+  nlohmann::json TransportStats::to_json() const
+  {
+    nlohmann::json j;
+    j["name"] = name;
+    j["type"] = type;
+    j["produce_queue_depth"] = produce_queue_depth;
+    j["produce_queue_bytes"] = produce_queue_bytes;
+    j["broker_errors"] = broker_errors;
+    j["broker_rtt_avg_us"] = broker_rtt_avg_us;
+    j["updated_at"] = std::chrono::duration_cast<std::chrono::seconds>(updated_at.time_since_epoch()).count();
+    if (type == "consumer")
+    {
+      j["total_lag"] = totalLag();
+      j["partitions"] = nlohmann::json::array();
+      for (const auto &partition : partitions)
+      {
+        nlohmann::json p;
+        p["topic"] = partition.topic;
+        p["partition"] = partition.partition;
+        p["committed_offset"] = partition.committed_offset;
+        p["high_watermark"] = partition.high_watermark;
+        p["lag"] = partition.lag;
+        j["partitions"].push_back(p);
+      }
+    }
+    return j;
+  }
+
+  bool parseKafkaStatistics(const std::string &json, TransportStats &stats)
+  {
+    try
+    {
+      nlohmann::json j = nlohmann::json::parse(json);
+
+      stats.name = j.value("name", "");
+      stats.type = j.value("type", "");
+      stats.produce_queue_depth = j.value("msg_cnt", static_cast<uint64_t>(0));
+      stats.produce_queue_bytes = j.value("msg_size", static_cast<uint64_t>(0));
+      stats.broker_errors = 0;
+      stats.broker_rtt_avg_us = 0;
+      stats.partitions.clear();
+      stats.updated_at = std::chrono::system_clock::now();
+
+      // 引导地址等内部broker没有nodeid，不计入
+      if (j.contains("brokers"))
+      {
+        for (const auto &broker : j["brokers"])
+        {
+          if (broker.value("nodeid", -1) < 0)
+          {
+            continue;
+          }
+          stats.broker_errors += broker.value("txerrs", static_cast<uint64_t>(0)) +
+                                 broker.value("rxerrs", static_cast<uint64_t>(0)) +
+                                 broker.value("req_timeouts", static_cast<uint64_t>(0));
+          if (broker.contains("rtt"))
+          {
+            stats.broker_rtt_avg_us = std::max(stats.broker_rtt_avg_us,
+                                               broker["rtt"].value("avg", static_cast<uint64_t>(0)));
+          }
+        }
+      }
+
+      // 消费者只统计分配给自己的分区，-1为内部的未分配分区
+      if (stats.type == "consumer" && j.contains("topics"))
+      {
+        for (const auto &topic : j["topics"].items())
+        {
+          if (!topic.value().contains("partitions"))
+          {
+            continue;
+          }
+          for (const auto &item : topic.value()["partitions"].items())
+          {
+            const auto &p = item.value();
+            int32_t id = p.value("partition", -1);
+            if (id < 0 || !p.value("desired", false))
+            {
+              continue;
+            }
+
+            PartitionLag lag;
+            lag.topic = topic.key();
+            lag.partition = id;
+            lag.committed_offset = p.value("committed_offset", static_cast<int64_t>(-1));
+            lag.high_watermark = p.value("hi_offset", static_cast<int64_t>(-1));
+            lag.lag = p.value("consumer_lag", static_cast<int64_t>(-1));
+            stats.partitions.push_back(lag);
+          }
+        }
+        std::sort(stats.partitions.begin(), stats.partitions.end(), [](const PartitionLag &a, const PartitionLag &b)
+                  { return a.topic != b.topic ? a.topic < b.topic : a.partition < b.partition; });
+      }
+      return true;
+    }
+    catch (const std::exception &e)
+    {
+      spdlog::error("Failed to parse kafka statistics: {}", e.what());
+      return false;
+    }
+  }
+
+} // namespace scheduler
@@ -0,0 +1,384 @@
+#include "wire_codec.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cctype>
+
+namespace scheduler
+{
+
+  namespace
+  {
+    class Writer
+    {
+    public:
+      explicit Writer(std::string &out) : out_(out) {}
+
+      void u8(uint8_t value)
+      {
+        out_.push_back(static_cast<char>(value));
+      }
+
+      void varint(uint64_t value)
+      {
+        while (value >= 0x80)
+        {
+          out_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+          value >>= 7;
+        }
+        out_.push_back(static_cast<char>(value));
+      }
+
+      void svarint(int64_t value)
+      {
+        varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+      }
+
+      void str(const std::string &value)
+      {
+        varint(value.size());
+        out_.append(value);
+      }
+
+      void time(const std::chrono::system_clock::time_point &tp)
+      {
+        svarint(std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count());
+      }
+
+    private:
+      std::string &out_;
+    };
+
+    class Reader
+    {
+    public:
+      Reader(const char *data, size_t size) : data_(data), size_(size), pos_(0) {}
+
+      // 是否已读完，用于读取旧版本消息中不存在的末尾字段
+      bool done() const { return pos_ >= size_; }
+
+      bool u8(uint8_t &value)
+      {
+        if (pos_ >= size_)
+        {
+          return false;
+        }
+        value = static_cast<uint8_t>(data_[pos_++]);
+        return true;
+      }
+
+      bool varint(uint64_t &value)
+      {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+          uint8_t byte;
+          if (!u8(byte))
+          {
+            return false;
+          }
+          value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+          if (!(byte & 0x80))
+          {
+            return true;
+          }
+        }
+        return false;
+      }
+
+      bool svarint(int64_t &value)
+      {
+        uint64_t raw;
+        if (!varint(raw))
+        {
+          return false;
+        }
+        value = static_cast<int64_t>((raw >> 1) ^ (~(raw & 1) + 1));
+        return true;
+      }
+
+      template <typename T>
+      bool integer(T &value)
+      {
+        int64_t raw;
+        if (!svarint(raw))
+        {
+          return false;
+        }
+        value = static_cast<T>(raw);
+        return true;
+      }
+
+      bool str(std::string &value)
+      {
+        uint64_t len;
+        if (!varint(len) || len > size_ - pos_)
+        {
+          return false;
+        }
+        value.assign(data_ + pos_, len);
+        pos_ += len;
+        return true;
+      }
+
+      // 读取带长度前缀的子记录
+      bool record(Reader &sub)
+      {
+        uint64_t len;
+        if (!varint(len) || len > size_ - pos_)
+        {
+          return false;
+        }
+        sub = Reader(data_ + pos_, len);
+        pos_ += len;
+        return true;
+      }
+
+      bool time(std::chrono::system_clock::time_point &tp)
+      {
+        int64_t ms;
+        if (!svarint(ms))
+        {
+          return false;
+        }
+        tp = std::chrono::system_clock::time_point(std::chrono::milliseconds(ms));
+        return true;
+      }
+
+      // 读取枚举，超出范围返回false
+      template <typename E>
+      bool enumeration(E &value, E max)
+      {
+        uint64_t raw;
+        if (!varint(raw) || raw > static_cast<uint64_t>(max))
+        {
+          return false;
+        }
+        value = static_cast<E>(raw);
+        return true;
+      }
+
+    private:
+      const char *data_;
+      size_t size_;
+      size_t pos_;
+    };
+
+    // 批量结果中每条记录的长度前缀字节数，最大支持32GB的记录
+    const size_t kRecordPrefixBytes = 5;
+
+    bool readVersion(Reader &reader)
+    {
+      uint8_t version;
+      if (!reader.u8(version))
+      {
+        return false;
+      }
+      if (version != WireCodec::kVersion)
+      {
+        spdlog::error("Unsupported wire format version: {}", version);
+        return false;
+      }
+      return true;
+    }
+
+    void writeResultFields(Writer &writer, const JobResult &result)
+    {
+      writer.str(result.job_id);
+      writer.varint(result.execution_id);
+      writer.varint(static_cast<uint64_t>(result.status));
+      writer.varint(static_cast<uint64_t>(result.payload_codec));
+      writer.str(result.output);
+      writer.str(result.error);
+      writer.time(result.start_time);
+      writer.time(result.end_time);
+      writer.varint(result.cpu_time_ms);
+      writer.varint(result.peak_rss_kb);
+      writer.varint(result.io_read_bytes);
+      writer.varint(result.io_write_bytes);
+      writer.str(result.executor_id);
+    }
+
+    bool readResultFields(Reader &reader, JobResult &result)
+    {
+      return reader.str(result.job_id) &&
+             reader.varint(result.execution_id) &&
+             reader.enumeration(result.status, JobStatus::TIMEOUT) &&
+             reader.enumeration(result.payload_codec, PayloadCodec::ZSTD) &&
+             reader.str(result.output) &&
+             reader.str(result.error) &&
+             reader.time(result.start_time) &&
+             reader.time(result.end_time) &&
+             reader.varint(result.cpu_time_ms) &&
+             reader.varint(result.peak_rss_kb) &&
+             reader.varint(result.io_read_bytes) &&
+             reader.varint(result.io_write_bytes) &&
+             (reader.done() || reader.str(result.executor_id));
+    }
+  } // namespace
+
+  std::string WireCodec::encodeJob(const JobInfo &job)
+  {
+    std::string out;
+    encodeJob(job, out);
+    return out;
+  }
+
+  void WireCodec::encodeJob(const JobInfo &job, std::string &out)
+  {
+    out.reserve(out.size() + 64 + job.job_id.size() + job.name.size() + job.command.size() +
+                job.cron_expression.size() + job.library_path.size() + job.entry_symbol.size());
+
+    Writer writer(out);
+    writer.u8(kVersion);
+    writer.str(job.job_id);
+    writer.str(job.name);
+    writer.str(job.command);
+    writer.varint(static_cast<uint64_t>(job.type));
+    writer.svarint(job.priority);
+    writer.str(job.cron_expression);
+    writer.svarint(job.timeout);
+    writer.svarint(job.retry_count);
+    writer.svarint(job.retry_interval);
+    writer.svarint(job.cpu_weight);
+    writer.svarint(job.memory_limit_mb);
+    writer.u8(job.use_warm_pool ? 1 : 0);
+    writer.varint(static_cast<uint64_t>(job.exec_type));
+    writer.str(job.library_path);
+    writer.str(job.entry_symbol);
+    writer.varint(job.execution_id);
+  }
+
+  bool WireCodec::decodeJob(const std::string &data, JobInfo &job)
+  {
+    Reader reader(data.data(), data.size());
+    uint8_t use_warm_pool = 0;
+    bool ok = readVersion(reader) &&
+              reader.str(job.job_id) &&
+              reader.str(job.name) &&
+              reader.str(job.command) &&
+              reader.enumeration(job.type, JobType::PERIODIC) &&
+              reader.integer(job.priority) &&
+              reader.str(job.cron_expression) &&
+              reader.integer(job.timeout) &&
+              reader.integer(job.retry_count) &&
+              reader.integer(job.retry_interval) &&
+              reader.integer(job.cpu_weight) &&
+              reader.integer(job.memory_limit_mb) &&
+              reader.u8(use_warm_pool) &&
+              reader.enumeration(job.exec_type, JobExecType::SHARED_LIBRARY) &&
+              reader.str(job.library_path) &&
+              reader.str(job.entry_symbol) &&
+              (reader.done() || reader.varint(job.execution_id));
+    job.use_warm_pool = use_warm_pool != 0;
+    return ok;
+  }
+
+  std::string WireCodec::encodeResult(const JobResult &result)
+  {
+    std::string out;
+    encodeResult(result, out);
+    return out;
+  }
+
+  void WireCodec::encodeResult(const JobResult &result, std::string &out)
+  {
+    out.reserve(out.size() + 96 + result.job_id.size() + result.output.size() + result.error.size());
+
+    Writer writer(out);
+    writer.u8(kVersion);
+    writeResultFields(writer, result);
+  }
+
+  bool WireCodec::decodeResult(const std::string &data, JobResult &result)
+  {
+    Reader reader(data.data(), data.size());
+    return readVersion(reader) && readResultFields(reader, result);
+  }
+
+  std::string WireCodec::encodeResults(const std::vector<JobResult> &results)
+  {
+    std::string out;
+    encodeResults(results, out);
+    return out;
+  }
+
+  void WireCodec::encodeResults(const std::vector<JobResult> &results, std::string &out)
+  {
+    size_t estimate = out.size() + 16;
+    for (const auto &result : results)
+    {
+      estimate += 96 + result.job_id.size() + result.output.size() + result.error.size();
+    }
+    out.reserve(estimate);
+
+    Writer writer(out);
+    writer.u8(kVersion);
+    writer.varint(results.size());
+
+    // 每条结果带长度前缀，便于以后在记录末尾追加字段。
+    // 长度前缀固定占kRecordPrefixBytes字节（补齐的varint），写完记录后回填，不经过临时缓冲区
+    for (const auto &result : results)
+    {
+      size_t prefix = out.size();
+      out.append(kRecordPrefixBytes, '\0');
+      writeResultFields(writer, result);
+
+      uint64_t length = out.size() - prefix - kRecordPrefixBytes;
+      for (size_t i = 0; i < kRecordPrefixBytes; ++i)
+      {
+        uint8_t byte = (length >> (7 * i)) & 0x7f;
+        out[prefix + i] = static_cast<char>(i + 1 < kRecordPrefixBytes ? byte | 0x80 : byte);
+      }
+    }
+  }
+
+  bool WireCodec::decodeResults(const std::string &data, std::vector<JobResult> &results)
+  {
+    Reader reader(data.data(), data.size());
+    uint64_t count;
+    if (!readVersion(reader) || !reader.varint(count) || count > data.size())
+    {
+      return false;
+    }
+
+    results.clear();
+    results.reserve(count);
+    for (uint64_t i = 0; i < count; ++i)
+    {
+      Reader record(nullptr, 0);
+      results.emplace_back();
+      if (!reader.record(record) || !readResultFields(record, results.back()))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::string WireCodec::formatToString(WireFormat format)
+  {
+    return format == WireFormat::BINARY ? "binary" : "json";
+  }
+
+  bool WireCodec::formatFromString(const std::string &name, WireFormat &format)
+  {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c)
+                   { return std::tolower(c); });
+
+    if (lower == "binary")
+    {
+      format = WireFormat::BINARY;
+    }
+    else if (lower == "json")
+    {
+      format = WireFormat::JSON;
+    }
+    else
+    {
+      return false;
+    }
+    return true;
+  }
+
+} // namespace scheduler
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include "async_query_engine.h"
+
+using namespace scheduler;
+using namespace testing;
+
+// 测试参数按类型代入占位符，字符串转义，二进制按十六进制字面量
+TEST(AsyncQueryEngineTest, RenderStatement)
+{
+  MYSQL *mysql = mysql_init(nullptr);
+  ASSERT_NE(mysql, nullptr);
+
+  AsyncStatement stmt("UPDATE t SET a = ?, b = ?, c = ?, d = ? WHERE e = ?");
+  stmt.bindString(0, "it's");
+  stmt.bindBlob(1, std::string("\x00\xff", 2));
+  stmt.bindInt(2, -42);
+  stmt.bindOptionalString(3, "");
+  stmt.bindUInt(4, 7);
+  EXPECT_EQ(stmt.render(mysql), "UPDATE t SET a = 'it\\'s', b = X'00FF', c = -42, d = NULL WHERE e = 7");
+
+  // 引号内的问号不是占位符
+  AsyncStatement quoted("SELECT '?', ?");
+  quoted.bindInt(0, 1);
+  EXPECT_EQ(quoted.render(mysql), "SELECT '?', 1");
+
+  // 时间按本地时间代入，精确到微秒
+  AsyncStatement timed("SELECT ?");
+  timed.bindTime(0, std::chrono::system_clock::from_time_t(1700000000));
+  std::string rendered = timed.render(mysql);
+  EXPECT_EQ(rendered.size(), std::string("SELECT 'YYYY-MM-DD HH:MM:SS.000000'").size());
+  EXPECT_NE(rendered.find(".000000'"), std::string::npos);
+
+  mysql_close(mysql);
+}
+
+// 测试参数个数与占位符不一致
+TEST(AsyncQueryEngineTest, RenderParamMismatch)
+{
+  MYSQL *mysql = mysql_init(nullptr);
+  ASSERT_NE(mysql, nullptr);
+
+  AsyncStatement missing("SELECT ?, ?");
+  missing.bindInt(0, 1);
+  EXPECT_EQ(missing.render(mysql), "");
+
+  AsyncStatement extra("SELECT ?");
+  extra.bindInt(0, 1);
+  extra.bindInt(1, 2);
+  EXPECT_EQ(extra.render(mysql), "");
+
+  mysql_close(mysql);
+}
+
+// 测试引擎未启动时提交立即失败
+TEST(AsyncQueryEngineTest, SubmitWhenStopped)
+{
+  auto &engine = AsyncQueryEngine::getInstance();
+  ASSERT_FALSE(engine.isRunning());
+
+  bool called = false;
+  EXPECT_FALSE(engine.submit(AsyncStatement("SELECT 1"), [&called](const AsyncQueryResult &result)
+                             {
+    called = true;
+    EXPECT_FALSE(result.success); }));
+  EXPECT_TRUE(called);
+
+  auto future = engine.submit(AsyncStatement("SELECT 1"));
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+  EXPECT_FALSE(future.get().success);
+}
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include "consumer_worker_pool.h"
+
+using namespace scheduler;
+using namespace testing;
+
+// 阻塞工作线程直到放行
+class Gate
+{
+public:
+  void wait()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this]
+                    { return open_; });
+  }
+
+  void open()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_ = true;
+    condition_.notify_all();
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool open_ = false;
+};
+
+class ConsumerWorkerPoolTest : public Test
+{
+protected:
+  ConsumerWorkerPool::PartitionCallback recordTo(std::vector<TopicPartitionKey> &calls)
+  {
+    return [&calls](const std::vector<TopicPartitionKey> &partitions)
+    {
+      calls.insert(calls.end(), partitions.begin(), partitions.end());
+    };
+  }
+
+  std::vector<TopicPartitionKey> paused;
+  std::vector<TopicPartitionKey> resumed;
+};
+
+// 测试同一键的消息由同一线程按提交顺序处理
+TEST_F(ConsumerWorkerPoolTest, SameKeyRunsInOrderOnOneThread)
+{
+  ConsumerWorkerPool pool(4, 1000, recordTo(paused), recordTo(resumed));
+
+  std::mutex mutex;
+  std::map<std::string, std::vector<int>> order;
+  std::map<std::string, std::set<std::thread::id>> threads;
+  for (int i = 0; i < 200; ++i)
+  {
+    std::string key = "executor-" + std::to_string(i % 5);
+    pool.submit(key, "job-result", 0, [&, key, i]
+                {
+      std::lock_guard<std::mutex> lock(mutex);
+      order[key].push_back(i);
+      threads[key].insert(std::this_thread::get_id()); });
+  }
+  pool.waitIdle();
+
+  ASSERT_EQ(order.size(), 5u);
+  for (const auto &item : order)
+  {
+    EXPECT_EQ(item.second.size(), 40u);
+    EXPECT_TRUE(std::is_sorted(item.second.begin(), item.second.end())) << item.first;
+    EXPECT_EQ(threads[item.first].size(), 1u) << item.first;
+  }
+  EXPECT_TRUE(paused.empty());
+}
+
+// 测试无键的消息按主题和分区分配，键相同则分配到同一线程
+TEST_F(ConsumerWorkerPoolTest, WorkerIndexIsStable)
+{
+  EXPECT_EQ(ConsumerWorkerPool::workerIndex("executor-1", "job-result", 0, 8),
+            ConsumerWorkerPool::workerIndex("executor-1", "job-result", 3, 8));
+  EXPECT_EQ(ConsumerWorkerPool::workerIndex("", "job-result", 2, 8),
+            ConsumerWorkerPool::workerIndex("", "job-result", 2, 8));
+  EXPECT_LT(ConsumerWorkerPool::workerIndex("", "job-result", 2, 8), 8u);
+  EXPECT_EQ(ConsumerWorkerPool::workerIndex("executor-1", "job-result", 0, 1), 0u);
+}
+
+// 测试没有工作线程时在调用线程中直接处理
+TEST_F(ConsumerWorkerPoolTest, RunsInlineWithoutWorkers)
+{
+  ConsumerWorkerPool pool(0, 10, recordTo(paused), recordTo(resumed));
+  std::thread::id ran;
+  pool.submit("executor-1", "job-result", 0, [&ran]
+              { ran = std::this_thread::get_id(); });
+  EXPECT_EQ(ran, std::this_thread::get_id());
+  EXPECT_EQ(pool.pending(), 0u);
+  pool.waitIdle();
+}
+
+// 测试队列达到容量时暂停分区且只暂停一次，队列回落到一半以下后恢复
+TEST_F(ConsumerWorkerPoolTest, PausesFullQueueAndResumesAfterDrain)
+{
+  ConsumerWorkerPool pool(1, 4, recordTo(paused), recordTo(resumed));
+  Gate gate;
+  std::atomic<int> done{0};
+  std::atomic<bool> started{false};
+
+  // 第一条阻塞工作线程，其余留在队列中
+  pool.submit("executor-1", "job-result", 2, [&]
+              { started = true; gate.wait(); done++; });
+  while (!started)
+  {
+    std::this_thread::yield();
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    pool.submit("executor-1", "job-result", 2, [&]
+                { done++; });
+  }
+  EXPECT_TRUE(paused.empty());
+
+  pool.submit("executor-1", "job-result", 2, [&]
+              { done++; });
+  ASSERT_EQ(paused.size(), 1u);
+  EXPECT_EQ(paused[0], TopicPartitionKey("job-result", 2));
+  EXPECT_TRUE(pool.hasPaused());
+
+  // 已暂停的分区不重复暂停，其他分区的消息照常暂停
+  pool.submit("executor-1", "job-result", 2, [&]
+              { done++; });
+  pool.submit("executor-1", "job-result", 5, [&]
+              { done++; });
+  ASSERT_EQ(paused.size(), 2u);
+  EXPECT_EQ(paused[1], TopicPartitionKey("job-result", 5));
+
+  // 队列未回落时不恢复
+  pool.resumePaused();
+  EXPECT_TRUE(resumed.empty());
+
+  gate.open();
+  pool.waitIdle();
+  EXPECT_EQ(done.load(), 7);
+  EXPECT_EQ(pool.pending(), 0u);
+
+  pool.resumePaused();
+  ASSERT_EQ(resumed.size(), 2u);
+  EXPECT_FALSE(pool.hasPaused());
+
+  // 没有暂停的分区时不再回调
+  pool.resumePaused();
+  EXPECT_EQ(resumed.size(), 2u);
+}
+
+// 测试分区收回后丢弃暂停记录
+TEST_F(ConsumerWorkerPoolTest, ClearPausedDropsPartitions)
+{
+  ConsumerWorkerPool pool(1, 1, recordTo(paused), recordTo(resumed));
+  Gate gate;
+  pool.submit("executor-1", "job-result", 0, [&gate]
+              { gate.wait(); });
+  EXPECT_EQ(paused.size(), 1u);
+
+  pool.clearPaused();
+  EXPECT_FALSE(pool.hasPaused());
+  gate.open();
+  pool.waitIdle();
+  pool.resumePaused();
+  EXPECT_TRUE(resumed.empty());
+}
+
+// 测试waitIdle阻塞到处理完已分发的消息
+TEST_F(ConsumerWorkerPoolTest, WaitIdleBlocksUntilProcessed)
+{
+  ConsumerWorkerPool pool(2, 100, recordTo(paused), recordTo(resumed));
+  Gate gate;
+  std::atomic<bool> finished{false};
+  pool.submit("executor-1", "job-result", 0, [&]
+              { gate.wait(); finished = true; });
+
+  std::atomic<bool> idle{false};
+  std::thread waiter([&]
+                     { pool.waitIdle(); idle = true; });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(idle.load());
+
+  gate.open();
+  waiter.join();
+  EXPECT_TRUE(finished.load());
+  EXPECT_TRUE(idle.load());
+}
+
+// 测试处理抛出异常时继续处理后续消息，计数照常减少
+TEST_F(ConsumerWorkerPoolTest, ExceptionDoesNotStopWorker)
+{
+  ConsumerWorkerPool pool(1, 100, recordTo(paused), recordTo(resumed));
+  std::atomic<int> done{0};
+  pool.submit("executor-1", "job-result", 0, []
+              { throw std::runtime_error("bad message"); });
+  pool.submit("executor-1", "job-result", 0, [&done]
+              { done++; });
+  pool.waitIdle();
+  EXPECT_EQ(done.load(), 1);
+}
+
+// 测试停止时先处理完队列中的消息
+TEST_F(ConsumerWorkerPoolTest, StopDrainsQueues)
+{
+  std::atomic<int> done{0};
+  {
+    ConsumerWorkerPool pool(3, 100, recordTo(paused), recordTo(resumed));
+    for (int i = 0; i < 50; ++i)
+    {
+      pool.submit("executor-" + std::to_string(i % 7), "job-result", 0, [&done]
+                  {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        done++; });
+    }
+    pool.stop();
+    EXPECT_EQ(done.load(), 50);
+    EXPECT_EQ(pool.workerCount(), 0u);
+  }
+  EXPECT_EQ(done.load(), 50);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "job_cache.h"
+
+using namespace scheduler;
+using namespace std::chrono_literals;
+
+namespace
+{
+  JobInfo makeJob(const std::string &id, const std::string &command = "echo hello")
+  {
+    JobInfo job;
+    job.job_id = id;
+    job.name = id;
+    job.command = command;
+    return job;
+  }
+} // namespace
+
+// 未命中后写入，再次读取命中
+TEST(JobCacheTest, ReadThrough)
+{
+  JobCache cache(16, 4, 60s);
+  EXPECT_FALSE(cache.get("a").has_value());
+
+  cache.put(makeJob("a"), cache.version("a"));
+  auto job = cache.get("a");
+  ASSERT_TRUE(job.has_value());
+  EXPECT_EQ(job->command, "echo hello");
+
+  auto stats = cache.getStats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.size, 1u);
+  EXPECT_DOUBLE_EQ(stats.getHitRate(), 0.5);
+}
+
+// 分片满时淘汰最久未访问的条目
+TEST(JobCacheTest, EvictsLeastRecentlyUsed)
+{
+  JobCache cache(2, 1, 60s);
+  cache.put(makeJob("a"), cache.version("a"));
+  cache.put(makeJob("b"), cache.version("b"));
+  ASSERT_TRUE(cache.get("a").has_value());
+
+  cache.put(makeJob("c"), cache.version("c"));
+  EXPECT_TRUE(cache.get("a").has_value());
+  EXPECT_FALSE(cache.get("b").has_value());
+  EXPECT_TRUE(cache.get("c").has_value());
+  EXPECT_EQ(cache.getStats().evictions, 1u);
+  EXPECT_EQ(cache.getStats().size, 2u);
+}
+
+// 失效后不再命中，失效前取到的版本不能写回旧定义
+TEST(JobCacheTest, InvalidateRejectsStaleLoad)
+{
+  JobCache cache(16, 4, 60s);
+  cache.put(makeJob("a", "v1"), cache.version("a"));
+
+  uint64_t version = cache.version("a");
+  cache.invalidate("a");
+  EXPECT_FALSE(cache.get("a").has_value());
+
+  cache.put(makeJob("a", "v1"), version);
+  EXPECT_FALSE(cache.get("a").has_value());
+
+  cache.put(makeJob("a", "v2"), cache.version("a"));
+  auto job = cache.get("a");
+  ASSERT_TRUE(job.has_value());
+  EXPECT_EQ(job->command, "v2");
+  EXPECT_EQ(cache.getStats().invalidations, 1u);
+}
+
+// 超过ttl的条目视为未命中，容量为0时不缓存
+TEST(JobCacheTest, ExpiryAndDisabled)
+{
+  JobCache cache(16, 4, 20ms);
+  cache.put(makeJob("a"), cache.version("a"));
+  std::this_thread::sleep_for(50ms);
+  EXPECT_FALSE(cache.get("a").has_value());
+  EXPECT_EQ(cache.getStats().size, 0u);
+
+  JobCache disabled(0, 4, 60s);
+  EXPECT_FALSE(disabled.enabled());
+  disabled.put(makeJob("a"), disabled.version("a"));
+  EXPECT_FALSE(disabled.get("a").has_value());
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "loopback_transport.h"
+
+using namespace scheduler;
+using namespace testing;
+
+namespace
+{
+  // 等待条件成立，最多等待2秒
+  template <typename Pred>
+  bool waitUntil(Pred pred)
+  {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!pred())
+    {
+      if (std::chrono::steady_clock::now() >= deadline)
+      {
+        return false;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+  }
+}
+
+// 测试不同消费组各自收到全部消息，同一消费组内的消费者不重复消费
+TEST(LoopbackTransportTest, ConsumerGroups)
+{
+  LoopbackBroker broker;
+  std::atomic<int> groupA{0}, groupB{0};
+
+  LoopbackTransport a1(broker), a2(broker), b(broker);
+  a1.initConsumer("", "group-a", {"events"}, [&groupA](const KafkaMessage &)
+                  { groupA++; });
+  a2.initConsumer("", "group-a", {"events"}, [&groupA](const KafkaMessage &)
+                  { groupA++; });
+  b.initConsumer("", "group-b", {"events"}, [&groupB](const KafkaMessage &)
+                 { groupB++; });
+  a1.startConsume();
+  a2.startConsume();
+  b.startConsume();
+
+  LoopbackTransport producer(broker);
+  ASSERT_TRUE(producer.initProducer(""));
+  for (int i = 0; i < 100; ++i)
+  {
+    ASSERT_TRUE(producer.sendMessage("events", KafkaMessage(MessageType::EXECUTOR_HEARTBEAT, "executor-1")));
+  }
+
+  EXPECT_TRUE(waitUntil([&]
+                        { return groupA == 100 && groupB == 100; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(groupA, 100);
+  EXPECT_EQ(groupB, 100);
+}
+
+// 测试latest消费组只收到订阅之后的消息，earliest消费组收到保留的历史消息
+TEST(LoopbackTransportTest, OffsetReset)
+{
+  LoopbackBroker broker;
+  LoopbackTransport producer(broker);
+  producer.initProducer("");
+  producer.sendMessage("job-cancel", KafkaMessage(MessageType::JOB_CANCEL, "old"));
+
+  std::mutex mutex;
+  std::vector<std::string> latest, earliest;
+  LoopbackTransport latestConsumer(broker), earliestConsumer(broker);
+  latestConsumer.initConsumer("", "latest", {"job-cancel"}, [&](const KafkaMessage &message)
+                              { std::lock_guard<std::mutex> lock(mutex); latest.push_back(message.payload); },
+                              "latest");
+  earliestConsumer.initConsumer("", "earliest", {"job-cancel"}, [&](const KafkaMessage &message)
+                                { std::lock_guard<std::mutex> lock(mutex); earliest.push_back(message.payload); },
+                                "earliest");
+  latestConsumer.startConsume();
+  earliestConsumer.startConsume();
+  EXPECT_TRUE(latestConsumer.waitForAssignment(1000));
+
+  producer.sendMessage("job-cancel", KafkaMessage(MessageType::JOB_CANCEL, "new"));
+
+  EXPECT_TRUE(waitUntil([&]
+                        { std::lock_guard<std::mutex> lock(mutex); return latest.size() == 1 && earliest.size() == 2; }));
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_EQ(latest, std::vector<std::string>({"new"}));
+  EXPECT_EQ(earliest, std::vector<std::string>({"old", "new"}));
+}
+
+// 测试任务和批量结果经回环传输后按原样解析
+TEST(LoopbackTransportTest, JobAndResultRoundTrip)
+{
+  LoopbackBroker broker;
+  std::mutex mutex;
+  std::vector<KafkaMessage> received;
+
+  LoopbackTransport consumer(broker);
+  consumer.initConsumer("", "scheduler-group", {"job-submit.executor-1", "job-result"},
+                        [&](const KafkaMessage &message)
+                        { std::lock_guard<std::mutex> lock(mutex); received.push_back(message); });
+  consumer.startConsume();
+
+  LoopbackTransport producer(broker);
+  producer.initProducer("");
+
+  JobInfo job;
+  job.job_id = "job-1";
+  job.name = "echo";
+  job.command = "echo hello";
+  ASSERT_TRUE(producer.sendJob(MessageTransport::executorTopic("job-submit", "executor-1"), job, "executor-1"));
+
+  std::vector<JobResult> results(2);
+  results[0].job_id = "job-1";
+  results[0].status = JobStatus::SUCCESS;
+  results[0].output = "hello";
+  results[1].job_id = "job-2";
+  results[1].status = JobStatus::FAILED;
+  bool delivered = false;
+  ASSERT_TRUE(producer.sendJobResults("job-result", results, [&delivered](bool ok)
+                                      { delivered = ok; }));
+  EXPECT_TRUE(delivered);
+
+  ASSERT_TRUE(waitUntil([&]
+                        { std::lock_guard<std::mutex> lock(mutex); return received.size() == 2; }));
+  consumer.stopConsume();
+
+  for (const auto &message : received)
+  {
+    if (message.type == MessageType::JOB_SUBMIT)
+    {
+      JobInfo parsed;
+      ASSERT_TRUE(MessageTransport::parseJob(message, parsed));
+      EXPECT_EQ(parsed.job_id, "job-1");
+      EXPECT_EQ(parsed.command, "echo hello");
+      EXPECT_EQ(message.headers.at(kExecutorIdHeader), "executor-1");
+    }
+    else
+    {
+      std::vector<JobResult> parsed;
+      ASSERT_TRUE(MessageTransport::parseJobResults(message, parsed));
+      ASSERT_EQ(parsed.size(), 2u);
+      EXPECT_EQ(parsed[0].output, "hello");
+      EXPECT_EQ(parsed[1].status, JobStatus::FAILED);
+    }
+  }
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "message_buffer_pool.h"
+
+using namespace scheduler;
+using namespace testing;
+
+// 测试归还的缓冲区被清空后复用，并保留容量
+TEST(MessageBufferPoolTest, ReusesReleasedBuffer)
+{
+  MessageBufferPool pool(4, 1 << 20);
+
+  ProduceBuffer *buffer = pool.acquire();
+  EXPECT_EQ(buffer->pool, &pool);
+  buffer->data.assign(4096, 'x');
+  bool called = false;
+  buffer->onDelivery = [&called](bool)
+  { called = true; };
+  const char *storage = buffer->data.data();
+  pool.release(buffer);
+  EXPECT_EQ(pool.idle(), 1u);
+
+  ProduceBuffer *reused = pool.acquire();
+  EXPECT_EQ(reused, buffer);
+  EXPECT_TRUE(reused->data.empty());
+  EXPECT_GE(reused->data.capacity(), 4096u);
+  EXPECT_EQ(reused->data.data(), storage);
+  EXPECT_FALSE(reused->onDelivery);
+  EXPECT_FALSE(called);
+  EXPECT_EQ(pool.idle(), 0u);
+  pool.release(reused);
+}
+
+// 测试过大的缓冲区和超出上限的缓冲区不保留
+TEST(MessageBufferPoolTest, DropsOversizedAndExcessBuffers)
+{
+  MessageBufferPool pool(2, 1024);
+
+  ProduceBuffer *large = pool.acquire();
+  large->data.assign(4096, 'x');
+  pool.release(large);
+  EXPECT_EQ(pool.idle(), 0u);
+
+  std::vector<ProduceBuffer *> buffers;
+  for (int i = 0; i < 3; ++i)
+  {
+    buffers.push_back(pool.acquire());
+  }
+  for (auto *buffer : buffers)
+  {
+    pool.release(buffer);
+  }
+  EXPECT_EQ(pool.idle(), 2u);
+}
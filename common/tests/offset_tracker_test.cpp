@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include "offset_tracker.h"
+
+using namespace scheduler;
+using namespace testing;
+
+// 测试乱序完成时提交位置停在最小的未完成偏移量
+TEST(OffsetTrackerTest, WatermarkWaitsForOldestInFlight)
+{
+  OffsetTracker tracker;
+  for (int64_t offset = 10; offset < 14; ++offset)
+  {
+    tracker.track("job-result", 0, offset);
+  }
+
+  tracker.complete("job-result", 0, 11);
+  tracker.complete("job-result", 0, 12);
+  auto offsets = tracker.takeCommittable();
+  ASSERT_EQ(offsets.size(), 1u);
+  EXPECT_EQ(offsets[0].offset, 10);
+
+  // 位置未前进时不重复提交
+  EXPECT_TRUE(tracker.takeCommittable().empty());
+
+  tracker.complete("job-result", 0, 10);
+  offsets = tracker.takeCommittable();
+  ASSERT_EQ(offsets.size(), 1u);
+  EXPECT_EQ(offsets[0].offset, 13);
+
+  tracker.complete("job-result", 0, 13);
+  offsets = tracker.takeCommittable();
+  ASSERT_EQ(offsets.size(), 1u);
+  EXPECT_EQ(offsets[0].offset, 14);
+}
+
+// 测试各分区独立跟踪，完成计数在取出后清零
+TEST(OffsetTrackerTest, TracksPartitionsIndependently)
+{
+  OffsetTracker tracker;
+  tracker.track("job-result", 0, 5);
+  tracker.track("job-result", 1, 100);
+  tracker.complete("job-result", 1, 100);
+  EXPECT_EQ(tracker.completedSinceTake(), 1u);
+
+  auto offsets = tracker.takeCommittable();
+  ASSERT_EQ(offsets.size(), 2u);
+  EXPECT_EQ(offsets[0].partition, 0);
+  EXPECT_EQ(offsets[0].offset, 5);
+  EXPECT_EQ(offsets[1].partition, 1);
+  EXPECT_EQ(offsets[1].offset, 101);
+  EXPECT_EQ(tracker.completedSinceTake(), 0u);
+
+  // 重复完成或未登记的偏移量不计数
+  tracker.complete("job-result", 1, 100);
+  tracker.complete("job-result", 2, 1);
+  EXPECT_EQ(tracker.completedSinceTake(), 0u);
+
+  EXPECT_EQ(tracker.watermarks().size(), 2u);
+  tracker.clear();
+  EXPECT_TRUE(tracker.watermarks().empty());
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "payload_codec.h"
+
+using namespace scheduler;
+using namespace testing;
+
+namespace
+{
+  // 构造重复度较高的日志文本
+  std::string makeLog(size_t lines)
+  {
+    std::string log;
+    for (size_t i = 0; i < lines; ++i)
+    {
+      log += "2024-01-01 12:00:00 INFO processing record " + std::to_string(i % 17) + " ok\n";
+    }
+    return log;
+  }
+}
+
+// 测试LZ4压缩解压
+TEST(PayloadCodecTest, Lz4RoundTrip)
+{
+  std::string input = makeLog(1000);
+  std::string compressed;
+  ASSERT_TRUE(PayloadCompressor::compress(PayloadCodec::LZ4, input, compressed));
+  EXPECT_LT(compressed.size(), input.size() / 4);
+
+  std::string output;
+  ASSERT_TRUE(PayloadCompressor::decompress(PayloadCodec::LZ4, compressed, output));
+  EXPECT_EQ(output, input);
+}
+
+#ifdef HAVE_ZSTD
+// 测试ZSTD压缩解压
+TEST(PayloadCodecTest, ZstdRoundTrip)
+{
+  std::string input = makeLog(1000);
+  std::string compressed;
+  ASSERT_TRUE(PayloadCompressor::compress(PayloadCodec::ZSTD, input, compressed));
+
+  std::string output;
+  ASSERT_TRUE(PayloadCompressor::decompress(PayloadCodec::ZSTD, compressed, output));
+  EXPECT_EQ(output, input);
+}
+#endif
+
+// 测试损坏数据解压失败
+TEST(PayloadCodecTest, CorruptInputFails)
+{
+  std::string compressed;
+  ASSERT_TRUE(PayloadCompressor::compress(PayloadCodec::LZ4, makeLog(100), compressed));
+
+  std::string output;
+  EXPECT_FALSE(PayloadCompressor::decompress(PayloadCodec::LZ4, compressed.substr(0, compressed.size() / 2), output));
+  EXPECT_FALSE(PayloadCompressor::decompress(PayloadCodec::LZ4, "ab", output));
+}
+
+// 测试短输出不压缩
+TEST(PayloadCodecTest, SmallResultNotCompressed)
+{
+  JobResult result;
+  result.output = "hello";
+  EXPECT_FALSE(PayloadCompressor::compressResult(result, PayloadCodec::LZ4, 1024));
+  EXPECT_EQ(result.payload_codec, PayloadCodec::NONE);
+  EXPECT_EQ(result.output, "hello");
+}
+
+// 测试压缩后的结果经过JSON传输后可以还原
+TEST(PayloadCodecTest, CompressedResultJsonRoundTrip)
+{
+  JobResult result;
+  result.job_id = "job-1";
+  result.status = JobStatus::FAILED;
+  result.output = makeLog(500);
+  result.error = "exit status 1";
+  ASSERT_TRUE(PayloadCompressor::compressResult(result, PayloadCodec::LZ4, 1024));
+  EXPECT_EQ(result.payload_codec, PayloadCodec::LZ4);
+
+  nlohmann::json j = result.to_json();
+  EXPECT_EQ(j["payload_codec"], "LZ4");
+
+  JobResult decoded = JobResult::from_json(nlohmann::json::parse(j.dump()));
+  EXPECT_EQ(decoded.payload_codec, PayloadCodec::LZ4);
+  EXPECT_EQ(decoded.output, result.output);
+
+  ASSERT_TRUE(PayloadCompressor::decompressResult(decoded));
+  EXPECT_EQ(decoded.payload_codec, PayloadCodec::NONE);
+  EXPECT_EQ(decoded.output, makeLog(500));
+  EXPECT_EQ(decoded.error, "exit status 1");
+}
+
+// 测试base64编解码
+TEST(PayloadCodecTest, Base64)
+{
+  std::string decoded;
+  std::vector<std::string> inputs = {"", "f", "fo", "foo", "foob", "fooba", "foobar", std::string("\0\xff\x10", 3)};
+  for (const auto &input : inputs)
+  {
+    std::string encoded = PayloadCompressor::base64Encode(input);
+    ASSERT_TRUE(PayloadCompressor::base64Decode(encoded, decoded));
+    EXPECT_EQ(decoded, input);
+  }
+  EXPECT_EQ(PayloadCompressor::base64Encode("foobar"), "Zm9vYmFy");
+  EXPECT_EQ(PayloadCompressor::base64Encode("fo"), "Zm8=");
+  EXPECT_FALSE(PayloadCompressor::base64Decode("Zm8", decoded));
+  EXPECT_FALSE(PayloadCompressor::base64Decode("Z=8=", decoded));
+  EXPECT_FALSE(PayloadCompressor::base64Decode("Zm!=", decoded));
+}
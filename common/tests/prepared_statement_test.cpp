@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include "prepared_statement.h"
+
+using namespace scheduler;
+using namespace testing;
+
+// 测试时间点与MYSQL_TIME之间按本地时间往返转换，保留微秒
+TEST(PreparedStatementTest, TimeRoundTrip)
+{
+  auto now = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now());
+  MYSQL_TIME time = PreparedStatement::toMysqlTime(now);
+  EXPECT_GE(time.year, 2024u);
+  EXPECT_LT(time.second_part, 1000000u);
+  EXPECT_EQ(PreparedStatement::fromMysqlTime(time), now);
+
+  // 整秒时间点的微秒部分为0
+  auto whole = std::chrono::system_clock::from_time_t(1700000000);
+  MYSQL_TIME wholeTime = PreparedStatement::toMysqlTime(whole);
+  EXPECT_EQ(wholeTime.second_part, 0u);
+  EXPECT_EQ(PreparedStatement::fromMysqlTime(wholeTime), whole);
+}
+
+// 测试IN列表占位符
+TEST(PreparedStatementTest, Placeholders)
+{
+  EXPECT_EQ(PreparedStatement::placeholders(0), "");
+  EXPECT_EQ(PreparedStatement::placeholders(1), "?");
+  EXPECT_EQ(PreparedStatement::placeholders(3), "?, ?, ?");
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "priority_lanes.h"
+
+using namespace scheduler;
+using namespace testing;
+
+// 测试按优先级选择通道，默认优先级所在通道沿用原主题
+TEST(PriorityLanesTest, LaneForPriority)
+{
+  PriorityLanes lanes;
+  EXPECT_EQ(lanes.lanes().size(), 1u);
+  EXPECT_EQ(lanes.topic("job-submit", lanes.laneFor(100), "executor-1"), "job-submit.executor-1");
+
+  ASSERT_TRUE(lanes.parse("bulk:-100:1,high:50:8,normal:0:4"));
+  ASSERT_EQ(lanes.lanes().size(), 3u);
+  EXPECT_EQ(lanes.lanes()[0].name, "high");
+  EXPECT_EQ(lanes.lanes()[2].name, "bulk");
+
+  EXPECT_EQ(lanes.laneFor(100), 0u);
+  EXPECT_EQ(lanes.laneFor(50), 0u);
+  EXPECT_EQ(lanes.laneFor(0), 1u);
+  EXPECT_EQ(lanes.laneFor(-1), 2u);
+  EXPECT_EQ(lanes.laneFor(-1000), 2u);
+
+  EXPECT_EQ(lanes.topics("job-submit", "executor-1"),
+            std::vector<std::string>({"job-submit-high.executor-1", "job-submit.executor-1", "job-submit-bulk.executor-1"}));
+}
+
+// 测试格式错误的配置被拒绝，并保留原配置
+TEST(PriorityLanesTest, RejectsInvalidSpec)
+{
+  PriorityLanes lanes;
+  ASSERT_TRUE(lanes.parse("high:50:8,normal:0:4"));
+  EXPECT_FALSE(lanes.parse("high:50"));
+  EXPECT_FALSE(lanes.parse("high:abc:1"));
+  EXPECT_FALSE(lanes.parse("high:50:0"));
+  EXPECT_FALSE(lanes.parse("job.high:50:1"));
+  EXPECT_FALSE(lanes.parse("high:50:1,urgent:50:2"));
+  EXPECT_FALSE(lanes.parse("high:50:1,high:10:2"));
+  EXPECT_EQ(lanes.lanes().size(), 2u);
+
+  ASSERT_TRUE(lanes.parse(""));
+  EXPECT_EQ(lanes.lanes().size(), 1u);
+}
+
+// 测试按权重交错选择通道，空通道不占份额
+TEST(PriorityLanesTest, WeightedSelection)
+{
+  PriorityLanes lanes;
+  ASSERT_TRUE(lanes.parse("high:50:8,normal:0:4,bulk:-100:1"));
+  LaneSelector selector(lanes.lanes());
+
+  std::vector<int> counts(3, 0);
+  std::vector<size_t> backlog = {100, 100, 100};
+  for (int i = 0; i < 130; ++i)
+  {
+    counts[selector.next(backlog)]++;
+  }
+  EXPECT_EQ(counts, std::vector<int>({80, 40, 10}));
+
+  // 只有批量通道有任务时每次都选中它
+  for (int i = 0; i < 5; ++i)
+  {
+    EXPECT_EQ(selector.next({0, 0, 3}), 2);
+  }
+  EXPECT_EQ(selector.next({0, 0, 0}), -1);
+
+  // 高优先级任务到达后立即被选中
+  EXPECT_EQ(selector.next({1, 0, 100}), 0);
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "transport_stats.h"
+
+using namespace scheduler;
+using namespace testing;
+
+// 测试解析消费者统计：只统计分配给自己的分区，忽略引导broker
+TEST(TransportStatsTest, ParsesConsumerLag)
+{
+  const std::string json = R"({
+    "name": "scheduler-group#consumer-2",
+    "type": "consumer",
+    "msg_cnt": 0,
+    "msg_size": 0,
+    "brokers": {
+      "localhost:9092/bootstrap": {"nodeid": -1, "txerrs": 7, "rxerrs": 0, "req_timeouts": 0, "rtt": {"avg": 0}},
+      "kafka:9092/1": {"nodeid": 1, "txerrs": 1, "rxerrs": 2, "req_timeouts": 3, "rtt": {"avg": 1500}}
+    },
+    "topics": {
+      "job-result": {
+        "partitions": {
+          "1": {"partition": 1, "desired": true, "committed_offset": 90, "hi_offset": 120, "consumer_lag": 30},
+          "0": {"partition": 0, "desired": true, "committed_offset": 200, "hi_offset": 205, "consumer_lag": 5},
+          "2": {"partition": 2, "desired": false, "committed_offset": -1001, "hi_offset": 50, "consumer_lag": -1},
+          "-1": {"partition": -1, "desired": false}
+        }
+      }
+    }
+  })";
+
+  TransportStats stats;
+  ASSERT_TRUE(parseKafkaStatistics(json, stats));
+  EXPECT_EQ(stats.name, "scheduler-group#consumer-2");
+  EXPECT_EQ(stats.type, "consumer");
+  EXPECT_EQ(stats.broker_errors, 6u);
+  EXPECT_EQ(stats.broker_rtt_avg_us, 1500u);
+
+  ASSERT_EQ(stats.partitions.size(), 2u);
+  EXPECT_EQ(stats.partitions[0].partition, 0);
+  EXPECT_EQ(stats.partitions[0].committed_offset, 200);
+  EXPECT_EQ(stats.partitions[0].high_watermark, 205);
+  EXPECT_EQ(stats.partitions[1].partition, 1);
+  EXPECT_EQ(stats.partitions[1].lag, 30);
+  EXPECT_EQ(stats.totalLag(), 35);
+
+  nlohmann::json j = stats.to_json();
+  EXPECT_EQ(j["total_lag"], 35);
+  EXPECT_EQ(j["partitions"].size(), 2u);
+}
+
+// 测试解析生产者统计中的发送队列深度，无效JSON返回false
+TEST(TransportStatsTest, ParsesProducerQueue)
+{
+  TransportStats stats;
+  ASSERT_TRUE(parseKafkaStatistics(R"({"name": "rdkafka#producer-1", "type": "producer", "msg_cnt": 42, "msg_size": 4096})", stats));
+  EXPECT_EQ(stats.type, "producer");
+  EXPECT_EQ(stats.produce_queue_depth, 42u);
+  EXPECT_EQ(stats.produce_queue_bytes, 4096u);
+  EXPECT_TRUE(stats.partitions.empty());
+  EXPECT_FALSE(stats.to_json().contains("partitions"));
+
+  EXPECT_FALSE(parseKafkaStatistics("not json", stats));
+}
@@ -0,0 +1,183 @@
+// 比较JSON和二进制编码的任务/结果消息大小与编解码耗时
+// 用法: wire_codec_benchmark [迭代次数]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "wire_codec.h"
+
+using namespace scheduler;
+
+namespace
+{
+  JobInfo makeJob()
+  {
+    JobInfo job;
+    job.job_id = "8f14e45f-ceea-467f-a8f5-1d2c3b4a5e6f";
+    job.name = "nightly-report";
+    job.command = "/usr/local/bin/report --date=yesterday --format=csv --output=/data/reports";
+    job.type = JobType::PERIODIC;
+    job.priority = 5;
+    job.cron_expression = "0 30 2 * * *";
+    job.timeout = 3600;
+    job.retry_count = 3;
+    job.retry_interval = 60;
+    return job;
+  }
+
+  JobResult makeResult(size_t outputBytes)
+  {
+    JobResult result;
+    result.job_id = "8f14e45f-ceea-467f-a8f5-1d2c3b4a5e6f";
+    result.execution_id = 123456789;
+    result.status = JobStatus::SUCCESS;
+    result.output.reserve(outputBytes);
+    while (result.output.size() < outputBytes)
+    {
+      result.output += "2024-01-01 02:30:00 INFO wrote 1000 rows to report.csv\n";
+    }
+    result.output.resize(outputBytes);
+    result.start_time = std::chrono::system_clock::now();
+    result.end_time = result.start_time + std::chrono::seconds(42);
+    result.cpu_time_ms = 41000;
+    result.peak_rss_kb = 204800;
+    return result;
+  }
+
+  template <typename F>
+  double measureNs(int iterations, F &&f)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+      f();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+  }
+
+  void report(const char *name, size_t jsonBytes, size_t binaryBytes, double jsonEncode, double binaryEncode,
+              double jsonDecode, double binaryDecode)
+  {
+    printf("%-18s size %8zu -> %8zu B   encode %9.0f -> %9.0f ns   decode %9.0f -> %9.0f ns\n",
+           name, jsonBytes, binaryBytes, jsonEncode, binaryEncode, jsonDecode, binaryDecode);
+  }
+
+  // 防止编译器优化掉结果
+  volatile size_t g_sink = 0;
+}
+
+int main(int argc, char *argv[])
+{
+  int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+  printf("iterations: %d (JSON -> binary)\n", iterations);
+
+  // 任务：JSON格式下消息体还要再包一层{type, payload}
+  {
+    JobInfo job = makeJob();
+    auto jsonEncode = [&]
+    {
+      nlohmann::json envelope;
+      envelope["type"] = "JOB_SUBMIT";
+      envelope["payload"] = job.to_json().dump();
+      return envelope.dump();
+    };
+    std::string json = jsonEncode();
+    std::string binary = WireCodec::encodeJob(job);
+
+    double je = measureNs(iterations, [&]
+                          { g_sink = g_sink + jsonEncode().size(); });
+    double be = measureNs(iterations, [&]
+                          { g_sink = g_sink + WireCodec::encodeJob(job).size(); });
+    double jd = measureNs(iterations, [&]
+                          {
+      nlohmann::json envelope = nlohmann::json::parse(json);
+      JobInfo decoded = JobInfo::from_json(nlohmann::json::parse(envelope["payload"].get<std::string>()));
+      g_sink = g_sink + decoded.command.size(); });
+    double bd = measureNs(iterations, [&]
+                          {
+      JobInfo decoded;
+      WireCodec::decodeJob(binary, decoded);
+      g_sink = g_sink + decoded.command.size(); });
+    report("JobInfo", json.size(), binary.size(), je, be, jd, bd);
+  }
+
+  // 任务结果：不同输出长度
+  for (size_t outputBytes : {0, 1024, 64 * 1024})
+  {
+    JobResult result = makeResult(outputBytes);
+    auto jsonEncode = [&]
+    {
+      nlohmann::json envelope;
+      envelope["type"] = "JOB_RESULT";
+      envelope["payload"] = result.to_json().dump();
+      return envelope.dump();
+    };
+    std::string json = jsonEncode();
+    std::string binary = WireCodec::encodeResult(result);
+
+    int n = outputBytes > 4096 ? iterations / 20 + 1 : iterations;
+    double je = measureNs(n, [&]
+                          { g_sink = g_sink + jsonEncode().size(); });
+    double be = measureNs(n, [&]
+                          { g_sink = g_sink + WireCodec::encodeResult(result).size(); });
+    double jd = measureNs(n, [&]
+                          {
+      nlohmann::json envelope = nlohmann::json::parse(json);
+      JobResult decoded = JobResult::from_json(nlohmann::json::parse(envelope["payload"].get<std::string>()));
+      g_sink = g_sink + decoded.output.size(); });
+    double bd = measureNs(n, [&]
+                          {
+      JobResult decoded;
+      WireCodec::decodeResult(binary, decoded);
+      g_sink = g_sink + decoded.output.size(); });
+
+    std::string name = "JobResult " + std::to_string(outputBytes / 1024) + "KB";
+    report(name.c_str(), json.size(), binary.size(), je, be, jd, bd);
+  }
+
+  // 批量结果
+  {
+    std::vector<JobResult> results(100, makeResult(256));
+    auto jsonEncode = [&]
+    {
+      nlohmann::json array = nlohmann::json::array();
+      for (const auto &result : results)
+      {
+        array.push_back(result.to_json());
+      }
+      nlohmann::json envelope;
+      envelope["type"] = "JOB_RESULT_BATCH";
+      envelope["payload"] = array.dump();
+      return envelope.dump();
+    };
+    std::string json = jsonEncode();
+    std::string binary = WireCodec::encodeResults(results);
+
+    int n = iterations / 100 + 1;
+    double je = measureNs(n, [&]
+                          { g_sink = g_sink + jsonEncode().size(); });
+    double be = measureNs(n, [&]
+                          { g_sink = g_sink + WireCodec::encodeResults(results).size(); });
+    double jd = measureNs(n, [&]
+                          {
+      nlohmann::json envelope = nlohmann::json::parse(json);
+      nlohmann::json array = nlohmann::json::parse(envelope["payload"].get<std::string>());
+      std::vector<JobResult> decoded;
+      for (const auto &item : array)
+      {
+        decoded.push_back(JobResult::from_json(item));
+      }
+      g_sink = g_sink + decoded.size(); });
+    double bd = measureNs(n, [&]
+                          {
+      std::vector<JobResult> decoded;
+      WireCodec::decodeResults(binary, decoded);
+      g_sink = g_sink + decoded.size(); });
+    report("JobResult x100", json.size(), binary.size(), je, be, jd, bd);
+  }
+
+  return 0;
+}
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "wire_codec.h"
+
+using namespace scheduler;
+using namespace testing;
+
+namespace
+{
+  JobInfo makeJob()
+  {
+    JobInfo job;
+    job.job_id = "job-1";
+    job.name = "backup";
+    job.command = "tar czf /tmp/backup.tgz /data";
+    job.type = JobType::PERIODIC;
+    job.priority = -3;
+    job.cron_expression = "0 0 * * * *";
+    job.timeout = 3600;
+    job.retry_count = 2;
+    job.retry_interval = 30;
+    job.cpu_weight = 500;
+    job.memory_limit_mb = 8LL * 1024 * 1024;
+    job.use_warm_pool = true;
+    job.exec_type = JobExecType::SHARED_LIBRARY;
+    job.library_path = "/opt/plugins/libbackup.so";
+    job.entry_symbol = "run_backup";
+    job.execution_id = 987654321;
+    return job;
+  }
+
+  JobResult makeResult(const std::string &jobId)
+  {
+    JobResult result;
+    result.job_id = jobId;
+    result.execution_id = 1234567890123ULL;
+    result.executor_id = "executor-1";
+    result.status = JobStatus::FAILED;
+    result.output = std::string("binary\0output\xff", 14);
+    result.error = "exit status 2";
+    result.payload_codec = PayloadCodec::LZ4;
+    result.start_time = std::chrono::system_clock::time_point(std::chrono::milliseconds(1700000000123LL));
+    result.end_time = std::chrono::system_clock::time_point(std::chrono::milliseconds(1700000004567LL));
+    result.cpu_time_ms = 250;
+    result.peak_rss_kb = 1 << 20;
+    result.io_read_bytes = 1ULL << 40;
+    result.io_write_bytes = 42;
+    return result;
+  }
+
+  void expectResultEq(const JobResult &a, const JobResult &b)
+  {
+    EXPECT_EQ(a.job_id, b.job_id);
+    EXPECT_EQ(a.execution_id, b.execution_id);
+    EXPECT_EQ(a.executor_id, b.executor_id);
+    EXPECT_EQ(a.status, b.status);
+    EXPECT_EQ(a.output, b.output);
+    EXPECT_EQ(a.error, b.error);
+    EXPECT_EQ(a.payload_codec, b.payload_codec);
+    EXPECT_EQ(a.start_time, b.start_time);
+    EXPECT_EQ(a.end_time, b.end_time);
+    EXPECT_EQ(a.cpu_time_ms, b.cpu_time_ms);
+    EXPECT_EQ(a.peak_rss_kb, b.peak_rss_kb);
+    EXPECT_EQ(a.io_read_bytes, b.io_read_bytes);
+    EXPECT_EQ(a.io_write_bytes, b.io_write_bytes);
+  }
+}
+
+// 测试任务编解码
+TEST(WireCodecTest, JobRoundTrip)
+{
+  JobInfo job = makeJob();
+  std::string data = WireCodec::encodeJob(job);
+  EXPECT_EQ(static_cast<uint8_t>(data[0]), WireCodec::kVersion);
+  EXPECT_LT(data.size(), job.to_json().dump().size());
+
+  JobInfo decoded;
+  ASSERT_TRUE(WireCodec::decodeJob(data, decoded));
+  EXPECT_EQ(decoded.job_id, job.job_id);
+  EXPECT_EQ(decoded.name, job.name);
+  EXPECT_EQ(decoded.command, job.command);
+  EXPECT_EQ(decoded.type, job.type);
+  EXPECT_EQ(decoded.priority, job.priority);
+  EXPECT_EQ(decoded.cron_expression, job.cron_expression);
+  EXPECT_EQ(decoded.timeout, job.timeout);
+  EXPECT_EQ(decoded.retry_count, job.retry_count);
+  EXPECT_EQ(decoded.retry_interval, job.retry_interval);
+  EXPECT_EQ(decoded.cpu_weight, job.cpu_weight);
+  EXPECT_EQ(decoded.memory_limit_mb, job.memory_limit_mb);
+  EXPECT_EQ(decoded.use_warm_pool, job.use_warm_pool);
+  EXPECT_EQ(decoded.exec_type, job.exec_type);
+  EXPECT_EQ(decoded.library_path, job.library_path);
+  EXPECT_EQ(decoded.entry_symbol, job.entry_symbol);
+  EXPECT_EQ(decoded.execution_id, job.execution_id);
+}
+
+// 测试任务结果编解码，输出中的二进制数据原样保留
+TEST(WireCodecTest, ResultRoundTrip)
+{
+  JobResult result = makeResult("job-1");
+  JobResult decoded;
+  ASSERT_TRUE(WireCodec::decodeResult(WireCodec::encodeResult(result), decoded));
+  expectResultEq(decoded, result);
+}
+
+// 测试批量结果编解码
+TEST(WireCodecTest, ResultBatchRoundTrip)
+{
+  std::vector<JobResult> results;
+  for (int i = 0; i < 5; ++i)
+  {
+    results.push_back(makeResult("job-" + std::to_string(i)));
+  }
+
+  std::vector<JobResult> decoded;
+  ASSERT_TRUE(WireCodec::decodeResults(WireCodec::encodeResults(results), decoded));
+  ASSERT_EQ(decoded.size(), results.size());
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    expectResultEq(decoded[i], results[i]);
+  }
+}
+
+// 测试截断、版本不符和非法枚举值
+TEST(WireCodecTest, RejectsMalformedInput)
+{
+  std::string data = WireCodec::encodeJob(makeJob());
+  // 恰好去掉末尾追加的execution_id（5字节varint）时是合法的旧版本消息
+  size_t legacySize = data.size() - 5;
+  JobInfo job;
+  for (size_t len = 0; len < data.size(); ++len)
+  {
+    if (len != legacySize)
+    {
+      EXPECT_FALSE(WireCodec::decodeJob(data.substr(0, len), job)) << "length " << len;
+    }
+  }
+
+  std::string wrongVersion = data;
+  wrongVersion[0] = static_cast<char>(WireCodec::kVersion + 1);
+  EXPECT_FALSE(WireCodec::decodeJob(wrongVersion, job));
+
+  std::string result = WireCodec::encodeResult(makeResult("j"));
+  // 版本(1) + job_id(2) + execution_id(6) 之后是状态
+  result[9] = 0x7f;
+  JobResult decoded;
+  EXPECT_FALSE(WireCodec::decodeResult(result, decoded));
+
+  std::vector<JobResult> results;
+  EXPECT_FALSE(WireCodec::decodeResults(std::string("\x01\x05", 2), results));
+}
+
+// 测试读取没有追加字段的旧版本消息
+TEST(WireCodecTest, DecodesMessagesWithoutAppendedFields)
+{
+  JobInfo job = makeJob();
+  std::string data = WireCodec::encodeJob(job);
+  JobInfo decoded;
+  ASSERT_TRUE(WireCodec::decodeJob(data.substr(0, data.size() - 5), decoded));
+  EXPECT_EQ(decoded.entry_symbol, job.entry_symbol);
+  EXPECT_EQ(decoded.execution_id, 0u);
+
+  // 旧版本结果的末尾没有executor_id（1字节长度 + 10字节内容）
+  std::string result = WireCodec::encodeResult(makeResult("job-1"));
+  JobResult decodedResult;
+  ASSERT_TRUE(WireCodec::decodeResult(result.substr(0, result.size() - 11), decodedResult));
+  EXPECT_EQ(decodedResult.io_write_bytes, 42u);
+  EXPECT_EQ(decodedResult.executor_id, "");
+}
+
+// 测试末尾追加的未知字段被忽略
+TEST(WireCodecTest, IgnoresTrailingFields)
+{
+  JobInfo job = makeJob();
+  std::string data = WireCodec::encodeJob(job) + std::string("\x03xyz", 4);
+  JobInfo decoded;
+  ASSERT_TRUE(WireCodec::decodeJob(data, decoded));
+  EXPECT_EQ(decoded.entry_symbol, job.entry_symbol);
+}
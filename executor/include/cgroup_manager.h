@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <atomic>
+#include <sys/types.h>
+#include "job.h"
+
+namespace scheduler
+{
+
+  // 任务资源使用情况
+  struct ResourceUsage
+  {
+    uint64_t cpu_time_ms = 0;    // CPU时间（毫秒）
+    uint64_t peak_rss_kb = 0;    // 峰值内存（KB）
+    uint64_t io_read_bytes = 0;  // 读取字节数
+    uint64_t io_write_bytes = 0; // 写入字节数
+  };
+
+  /**
+   * @brief cgroup v2 管理类
+   *
+   * 每次执行在根目录下拥有独立的子cgroup，按JobInfo中的cpu_weight和
+   * memory_limit_mb设置cpu.weight与memory.max，任务结束后读取统计并删除。
+   */
+  class CgroupManager
+  {
+  public:
+    /**
+     * @brief 构造函数
+     * @param root 任务cgroup的根目录，例如 /sys/fs/cgroup/job-scheduler
+     */
+    explicit CgroupManager(const std::string &root);
+
+    /**
+     * @brief 检查cgroup v2并创建根目录、开启cpu/memory/io控制器
+     * @return 是否可用
+     */
+    bool init();
+
+    /**
+     * @brief 是否已启用
+     */
+    bool isEnabled() const { return enabled_; }
+
+    /**
+     * @brief 为一次执行创建子cgroup并写入资源限制
+     *
+     * 按执行ID命名（exec_<execution_id>），同一任务的多次执行互不影响；
+     * 没有执行ID时按任务ID加进程内序号命名。子cgroup已存在视为失败，不与其他执行共用。
+     * @param job 任务信息
+     * @return 子cgroup路径，失败返回空字符串
+     */
+    std::string createJobGroup(const JobInfo &job);
+
+    /**
+     * @brief 打开子cgroup的cgroup.procs文件
+     *
+     * 在fork之前打开，子进程在exec之前写入"0"即可把自己移入该cgroup，
+     * 避免任务在加入cgroup之前已经开始运行。
+     * @return 文件描述符，失败返回-1
+     */
+    int openProcsFile(const std::string &path) const;
+
+    /**
+     * @brief 读取子cgroup的资源统计
+     */
+    ResourceUsage readUsage(const std::string &path) const;
+
+    /**
+     * @brief 杀死子cgroup中残留的进程并删除子cgroup
+     */
+    void removeJobGroup(const std::string &path);
+
+  private:
+    // 写入cgroup接口文件
+    bool writeFile(const std::string &path, const std::string &value) const;
+
+    // 读取cgroup接口文件
+    std::string readFile(const std::string &path) const;
+
+    std::string root_;
+    bool enabled_;
+    std::atomic<uint64_t> sequence_{0}; // 没有执行ID时区分同一任务的多次执行
+  };
+
+} // namespace scheduler
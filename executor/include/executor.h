@@ -4,12 +4,22 @@
 #include <string>
 #include <thread>
 #include <atomic>
-#include <queue>
+#include <list>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
+#include <unordered_map>
 #include <unordered_set>
+#include <sys/types.h>
 #include "job.h"
-#include "kafka_message_queue.h"
+#include "message_transport.h"
+#include "priority_lanes.h"
+#include "cgroup_manager.h"
+#include "result_batcher.h"
+#include "result_spool.h"
+#include "expiring_id_set.h"
+#include "warm_worker_pool.h"
+#include "shared_library_runner.h"
 
 namespace scheduler
 {
@@ -24,12 +34,27 @@ namespace scheduler
     void start();
     // 停止执行器
     void stop();
+    /**
+     * @brief 排空执行器：标记为DRAINING，退回排队任务，等待正在执行的任务完成
+     *
+     * 超过executor.drain_timeout后终止仍在执行的任务并退回调度器。
+     * 返回后调用stop()退出。
+     */
+    void drain();
+    // 请求排空（收到调度器的排空指令时调用），由主线程调用drain()完成
+    void request_drain();
+    // 是否收到排空请求
+    bool drain_requested() const;
 
   protected:
     // 执行线程函数
     void execute_loop();
     // 执行具体任务
     JobResult execute_job(const JobInfo &job);
+    // 在预热工作进程中执行任务
+    void execute_in_warm_pool(const JobInfo &job, JobResult &result);
+    // 在进程内执行共享库任务
+    void execute_shared_library(const JobInfo &job, JobResult &result);
     // 向调度中心注册
     virtual void register_executor();
     // 向调度中心注销
@@ -40,20 +65,70 @@ namespace scheduler
     void cancel_job(const std::string &job_id);
     // 检查任务是否被取消
     bool is_job_cancelled(const std::string &job_id);
+    // 任务按优先级通道入队，调用方需持有mutex_
+    void enqueue_job(const JobInfo &job);
+    // 按通道权重取出下一个任务，调用方需持有mutex_且队列非空
+    JobInfo dequeue_job();
+    // 排队中的任务数，调用方需持有mutex_
+    size_t queued_jobs() const;
+    // 拉取模式：按空闲槽位向调度器申请任务
+    void credit_loop();
+    // 当前空闲槽位数
+    int available_credits();
+    // 任务结束后释放执行槽位，通知申请线程和排空等待
+    void release_slot();
+    // 上报任务结果：先写入预写日志，不可用时直接批量发送
+    void report_result(const JobResult &result);
+    // 把任务退回调度器重新派发
+    void return_jobs(const std::vector<std::string> &job_ids);
 
     std::string executor_id_;
-    std::unique_ptr<KafkaMessageQueue> kafka_client_;
+    std::unique_ptr<MessageTransport> kafka_client_;
+    std::unique_ptr<CgroupManager> cgroup_manager_;
+    std::unique_ptr<ResultBatcher> result_batcher_;
+    std::unique_ptr<ResultSpool> result_spool_;
+    std::unique_ptr<WarmWorkerPool> warm_pool_;
+    std::unique_ptr<SharedLibraryRunner> plugin_runner_;
 
     std::atomic<bool> running_;
-    std::thread execute_thread_;
+    std::vector<std::thread> execute_threads_;
     std::thread heartbeat_thread_;
-    std::queue<JobInfo> job_queue_;
+    std::thread credit_thread_;
+    // 每个优先级通道一个任务队列，按通道权重轮流取任务
+    PriorityLanes priority_lanes_;
+    std::vector<std::list<JobInfo>> job_queues_;
+    std::unique_ptr<LaneSelector> lane_selector_;
+    // job_id到所在通道和队列节点的索引，取消时O(1)定位
+    std::unordered_multimap<std::string, std::pair<size_t, std::list<JobInfo>::iterator>> queued_index_;
     std::mutex mutex_;
     std::condition_variable cv_;
 
-    // 取消任务列表
-    std::unordered_set<std::string> cancelled_jobs_;
+    // 并发执行线程数
+    int worker_threads_;
+
+    // 任务输出压缩格式，以及触发压缩的最小长度
+    PayloadCodec payload_codec_;
+    size_t payload_min_bytes_;
+
+    // 拉取模式
+    bool pull_mode_;
+    int lease_wait_ms_;                  // 工作请求有效时长（长轮询）
+    std::atomic<int> running_jobs_;      // 正在执行的任务数
+    std::atomic<uint64_t> received_jobs_; // 累计收到的任务数
+    std::condition_variable credit_cv_;
+
+    // 已取消的任务，超过TTL后自动过期
+    ExpiringIdSet cancelled_jobs_;
+    // 正在执行的任务进程，取消时直接向进程组发送信号；同一任务可能有多次执行同时运行
+    std::unordered_multimap<std::string, pid_t> running_pids_;
+    // 正在执行的任务，以及排空超时后已退回、不再上报结果的任务，每次执行各占一项
+    std::unordered_multiset<std::string> running_job_ids_;
+    std::unordered_multiset<std::string> returned_jobs_;
     std::mutex cancel_mutex_;
+
+    // 排空状态
+    std::atomic<bool> draining_;
+    std::atomic<bool> drain_requested_;
   };
 
 } // namespace scheduler
\ No newline at end of file
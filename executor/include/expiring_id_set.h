@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <deque>
+#include <unordered_set>
+#include <chrono>
+
+namespace scheduler
+{
+
+  /**
+   * @brief 按时间分桶、自动过期的ID集合
+   *
+   * 将TTL划分为bucket_count个时间桶，新ID写入当前桶，时间每推进一个桶宽度
+   * 就丢弃最旧的桶，因此ID在TTL到TTL+桶宽度之间过期，内存只与TTL内的ID数量有关。
+   * 非线程安全，由调用方加锁。
+   */
+  class ExpiringIdSet
+  {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    ExpiringIdSet(std::chrono::seconds ttl, size_t bucket_count = 8);
+
+    // 添加ID
+    void insert(const std::string &id, Clock::time_point now = Clock::now());
+
+    // 检查ID是否存在且未过期
+    bool contains(const std::string &id, Clock::time_point now = Clock::now());
+
+    // 未过期的ID数量
+    size_t size(Clock::time_point now = Clock::now());
+
+  private:
+    // 丢弃过期的桶
+    void rotate(Clock::time_point now);
+
+    Clock::duration bucket_width_;
+    size_t bucket_count_;
+    Clock::time_point current_bucket_start_;
+    std::deque<std::unordered_set<std::string>> buckets_; // 最新的桶在前
+  };
+
+} // namespace scheduler
@@ -0,0 +1,50 @@
+#pragma once
+
+/**
+ * 共享库任务的C ABI
+ *
+ * 共享库导出一个入口函数，签名为 job_plugin_entry：
+ *
+ *   extern "C" int my_job(job_plugin_context *ctx)
+ *   {
+ *     const char *msg = "hello";
+ *     ctx->write_output(ctx, msg, strlen(msg));
+ *     return ctx->is_cancelled(ctx) ? 1 : 0;
+ *   }
+ *
+ * 返回0表示成功，其他值作为退出码。执行器在独立线程中调用入口函数，
+ * 超时或取消后不会强制终止线程，长时间运行的函数应定期检查is_cancelled。
+ * ctx及其中的指针只在入口函数返回前有效。
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define JOB_PLUGIN_ABI_VERSION 1
+
+  typedef struct job_plugin_context job_plugin_context;
+
+  struct job_plugin_context
+  {
+    int abi_version;      // JOB_PLUGIN_ABI_VERSION
+    const char *job_id;   // 任务ID
+    const char *args;     // 参数（任务的command字段）
+    size_t args_len;      // 参数长度
+    void *host_data;      // 执行器内部数据，插件不应访问
+
+    // 追加输出，可多次调用
+    void (*write_output)(job_plugin_context *ctx, const char *data, size_t len);
+
+    // 任务是否已被取消或超时，返回非0表示应尽快返回
+    int (*is_cancelled)(job_plugin_context *ctx);
+  };
+
+  typedef int (*job_plugin_entry)(job_plugin_context *ctx);
+
+#ifdef __cplusplus
+}
+#endif
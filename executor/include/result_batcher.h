@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include "job.h"
+
+namespace scheduler
+{
+
+  /**
+   * @brief 任务结果批量发送器
+   *
+   * 执行线程调用add()缓存结果，达到batch_size条、估算大小达到max_batch_bytes
+   * 或最早一条结果等待超过linger_ms时由发送线程合并为一条批量消息发送，
+   * 每批不超过batch_size条和max_batch_bytes字节（单条超过时单独发送），
+   * 避免合并后的消息超过broker的message.max.bytes。缓存上限为
+   * max_pending条，超过时add()阻塞，避免Kafka不可用时内存无限增长。
+   */
+  class ResultBatcher
+  {
+  public:
+    // 发送函数，返回是否发送成功
+    using SendFunction = std::function<bool(const std::vector<JobResult> &)>;
+
+    ResultBatcher(SendFunction sender, size_t batch_size, int linger_ms, size_t max_pending,
+                  size_t max_batch_bytes = kDefaultMaxBatchBytes);
+    ~ResultBatcher();
+
+    // 启动发送线程
+    void start();
+
+    // 停止发送线程并发送剩余结果
+    void stop();
+
+    // 添加一条结果
+    void add(const JobResult &result);
+
+    // 结果编码后的估算大小，按JSON编码中base64和转义的膨胀留出余量
+    static size_t estimateBytes(const JobResult &result);
+
+    // 从results开头取出一批，不超过batchSize条和maxBytes字节，至少一条
+    static size_t batchPrefix(const std::vector<JobResult> &results, size_t batchSize, size_t maxBytes);
+
+    static constexpr size_t kDefaultMaxBatchBytes = 512 * 1024;
+
+  private:
+    // 发送线程函数
+    void flush_loop();
+
+    // 已攒够一批，调用方需持有mutex_
+    bool batch_ready() const;
+
+    SendFunction sender_;
+    size_t batch_size_;
+    int linger_ms_;
+    size_t max_pending_;
+    size_t max_batch_bytes_;
+
+    std::vector<JobResult> pending_;
+    size_t pending_bytes_;
+    std::chrono::steady_clock::time_point first_pending_time_;
+
+    std::atomic<bool> running_;
+    std::thread flush_thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;      // 通知发送线程
+    std::condition_variable space_cv_; // 通知等待缓存空间的执行线程
+  };
+
+} // namespace scheduler
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include "job.h"
+
+namespace scheduler
+{
+
+  /**
+   * @brief 任务结果的本地预写日志
+   *
+   * add()把结果追加到当前段文件（每行一条JSON），等待fsync完成后返回。
+   * fsync由同步线程统一执行，等待fsync_interval_ms收集并发写入后一次落盘。
+   * 段文件超过segment_bytes后切换到新段。
+   *
+   * 发送线程按顺序读取已落盘的记录，每次最多batch_size条、max_batch_bytes字节，
+   * 调用sender发送，sender返回true表示broker已确认写入。发送失败时按retry_ms重试，
+   * 多条的批次每次失败后减半重试、成功后逐步恢复，避免合并后的消息超过broker上限时一直失败；
+   * 单条记录本身超过max_batch_bytes且连续失败max_attempts次后，截断输出再发送。
+   * 不超过上限的记录视为暂时失败，一直重试。
+   * 一个段全部确认后删除该段。重启后从最早的段重新发送，可能产生重复结果。
+   */
+  class ResultSpool
+  {
+  public:
+    // 发送函数，返回broker是否已确认写入
+    using SendFunction = std::function<bool(const std::vector<JobResult> &)>;
+
+    ResultSpool(const std::string &dir, SendFunction sender, size_t batch_size,
+                size_t segment_bytes, int fsync_interval_ms, int retry_ms,
+                size_t max_batch_bytes = 512 * 1024, int max_attempts = 10);
+    ~ResultSpool();
+
+    // 打开目录并恢复未发送的段，启动同步和发送线程
+    bool start();
+
+    /**
+     * @brief 停止
+     * @param drain_timeout_ms 等待发送剩余记录的最长时间，未发送的记录留在段文件中
+     */
+    void stop(int drain_timeout_ms);
+
+    // 追加一条结果并等待落盘，失败返回false
+    bool add(const JobResult &result);
+
+    /**
+     * @brief 截断编码后超过max_bytes的结果，输出和错误末尾注明原始大小
+     *
+     * 压缩过的输出无法部分保留，整体替换为说明。
+     * @return 是否超过上限并做了截断
+     */
+    static bool truncateResult(JobResult &result, size_t max_bytes);
+
+  private:
+    // 段文件路径
+    std::string segmentPath(uint64_t seq) const;
+
+    // 创建新段，调用方需持有mutex_
+    bool openSegment(uint64_t seq);
+
+    // 同步线程函数
+    void sync_loop();
+
+    // 发送线程函数
+    void send_loop();
+
+    // 从段文件offset处读取最多limit条、max_batch_bytes_字节的完整记录（至少一条），返回读取的字节数
+    size_t readBatch(uint64_t seq, uint64_t offset, uint64_t end, size_t limit, std::vector<JobResult> &batch);
+
+    std::string dir_;
+    SendFunction sender_;
+    size_t batch_size_;
+    size_t segment_bytes_;
+    int fsync_interval_ms_;
+    int retry_ms_;
+    size_t max_batch_bytes_;
+    int max_attempts_;
+
+    // 写入状态
+    int fd_;
+    int lock_fd_;            // 目录锁，防止多个执行器共用同一目录
+    uint64_t write_seq_;     // 当前写入段
+    uint64_t written_bytes_; // 当前段已写入字节数
+    uint64_t synced_bytes_;  // 当前段已落盘字节数
+    uint64_t appended_;      // 累计写入记录数
+    uint64_t synced_;        // 累计落盘记录数
+
+    // 发送状态
+    std::deque<uint64_t> segments_; // 未删除的段，队首为正在发送的段
+    uint64_t send_offset_;          // 队首段已确认的字节数
+
+    bool running_;
+    std::chrono::steady_clock::time_point drain_deadline_;
+    std::thread sync_thread_;
+    std::thread send_thread_;
+    std::mutex mutex_;
+    std::condition_variable sync_cv_;   // 通知同步线程
+    std::condition_variable synced_cv_; // 通知等待落盘的写入方
+    std::condition_variable send_cv_;   // 通知发送线程
+  };
+
+} // namespace scheduler
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+#include "job.h"
+#include "job_plugin.h"
+
+namespace scheduler
+{
+
+  // 共享库任务的执行结果
+  struct LibraryJobOutcome
+  {
+    bool completed = false; // 入口函数是否已返回
+    bool timed_out = false; // 是否超时
+    bool cancelled = false; // 是否被取消
+    int exit_status = -1;   // 入口函数返回值
+    std::string output;     // 入口函数写出的输出
+    std::string error;      // 执行失败原因
+  };
+
+  /**
+   * @brief 共享库任务执行器
+   *
+   * 只加载plugin_dir目录下的共享库，dlopen句柄和入口函数地址按路径缓存，
+   * 进程退出前不会dlclose。入口函数在独立线程中执行，超时或取消时设置
+   * 取消标志并放弃等待，线程在入口函数返回后自行结束。
+   */
+  class SharedLibraryRunner
+  {
+  public:
+    SharedLibraryRunner(const std::string &plugin_dir, size_t max_output_bytes);
+
+    /**
+     * @brief 执行共享库任务
+     * @param job 任务信息，library_path和entry_symbol指定入口，command作为参数
+     * @param timeout_sec 超时时间（秒）
+     * @param is_cancelled 取消检查函数
+     */
+    LibraryJobOutcome run(const JobInfo &job, int timeout_sec,
+                          const std::function<bool()> &is_cancelled);
+
+  private:
+    // 加载共享库并查找入口函数
+    job_plugin_entry resolve(const std::string &library_path, const std::string &symbol,
+                             std::string &error);
+
+    std::string plugin_dir_;
+    size_t max_output_bytes_;
+
+    std::unordered_map<std::string, void *> handles_;           // 路径 -> dlopen句柄
+    std::unordered_map<std::string, job_plugin_entry> entries_; // 路径:函数名 -> 入口函数
+    std::mutex mutex_;
+  };
+
+} // namespace scheduler
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <sys/types.h>
+
+namespace scheduler
+{
+
+  // 预热进程中执行任务的结果
+  struct WarmJobOutcome
+  {
+    bool completed = false;   // 命令是否正常执行完毕
+    bool timed_out = false;   // 是否超时
+    bool cancelled = false;   // 是否被取消
+    int exit_status = -1;     // 命令退出码
+    uint64_t cpu_time_ms = 0; // 子shell及其已回收子进程的CPU时间（毫秒）
+    std::string output;       // 标准输出和标准错误
+    std::string error;        // 执行失败原因
+  };
+
+  /**
+   * @brief 预热的shell工作进程池
+   *
+   * 预先启动size个常驻bash进程，通过socket上的帧协议下发命令：
+   *   请求：<命令字节数> <cgroup.procs路径字节数>\n<命令><cgroup.procs路径>
+   *   响应：<退出码> <输出字节数> <用户态> <内核态> <子进程用户态> <子进程内核态>\n<输出>
+   * 时间为bash times的格式（如0m0.012s）。每个命令在工作进程的子shell中执行，
+   * 省去fork执行器进程（耗时随执行器内存增长）和启动bash的开销；
+   * 每个命令仍需从很小的bash进程fork一次子shell，约1毫秒以内，
+   * 更低开销的任务应使用共享库任务。
+   * 请求带cgroup.procs路径时，子shell在执行命令前先把自己移入该cgroup，
+   * 命令及其子进程受该cgroup的资源限制。
+   * 工作进程执行max_jobs_per_worker个任务后，或者超时、取消、协议错误后，
+   * 会被销毁并重新启动。
+   */
+  class WarmWorkerPool
+  {
+  public:
+    WarmWorkerPool(size_t size, int max_jobs_per_worker);
+    ~WarmWorkerPool();
+
+    // 启动所有工作进程
+    bool start();
+
+    // 停止所有工作进程
+    void stop();
+
+    /**
+     * @brief 在空闲工作进程中执行命令
+     * @param command shell命令
+     * @param timeout_sec 超时时间（秒）
+     * @param is_cancelled 取消检查函数，执行期间定期调用
+     * @param cgroup_procs 任务cgroup的cgroup.procs路径，为空时不加入cgroup
+     */
+    WarmJobOutcome run(const std::string &command, int timeout_sec,
+                       const std::function<bool()> &is_cancelled,
+                       const std::string &cgroup_procs = "");
+
+    /**
+     * @brief 解析响应头（不含结尾换行）
+     * @param output_bytes 输出字节数
+     * @return 格式是否正确
+     */
+    static bool parseResponseHeader(const std::string &header, WarmJobOutcome &outcome, size_t &output_bytes);
+
+  private:
+    struct Worker
+    {
+      pid_t pid = -1;
+      int fd = -1;   // 与工作进程标准输入输出相连的socket
+      int jobs = 0;  // 已执行任务数
+    };
+
+    // 启动工作进程
+    bool spawn(Worker &worker);
+
+    // 杀死工作进程及其子进程
+    void destroy(Worker &worker);
+
+    std::vector<Worker> workers_;
+    std::vector<size_t> idle_; // 空闲工作进程下标
+    int max_jobs_per_worker_;
+    bool running_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+  };
+
+} // namespace scheduler
@@ -2,8 +2,10 @@
 #include "config_manager.h"
 #include <spdlog/spdlog.h>
 #include <iostream>
+#include <atomic>
 #include <csignal>
 #include <filesystem>
+#include <fstream>
 #include <uuid/uuid.h>
 
 using namespace scheduler;
@@ -11,6 +13,9 @@ using namespace scheduler;
 // 全局执行器实例
 std::unique_ptr<JobExecutor> g_executor;
 
+// 收到的退出信号，由主线程处理
+std::atomic<int> g_signal(0);
+
 // 生成UUID
 std::string generate_uuid()
 {
@@ -23,15 +28,47 @@ std::string generate_uuid()
   return std::string(uuid_str);
 }
 
-// 信号处理函数
-void signalHandler(int signal)
+// 读取上次保存的执行器ID，不存在时生成并保存。
+// 重启后沿用同一ID，继续使用原有的专属任务主题，不会每次启动都留下一组新主题
+std::string load_executor_id()
 {
-  spdlog::info("接收到信号: {}, 正在停止执行器...", signal);
-  if (g_executor)
+  std::string executor_id = ConfigManager::getInstance().getString("executor.id", "");
+  if (!executor_id.empty())
   {
-    g_executor->stop();
+    return executor_id;
   }
-  exit(0);
+
+  std::string idFile = ConfigManager::getInstance().getString("executor.id_file", "data/executor.id");
+  if (idFile.empty())
+  {
+    return generate_uuid();
+  }
+
+  std::ifstream in(idFile);
+  if (in >> executor_id && !executor_id.empty())
+  {
+    return executor_id;
+  }
+
+  executor_id = generate_uuid();
+  std::error_code ec;
+  std::filesystem::path parent = std::filesystem::path(idFile).parent_path();
+  if (!parent.empty())
+  {
+    std::filesystem::create_directories(parent, ec);
+  }
+  std::ofstream out(idFile, std::ios::trunc);
+  if (!(out << executor_id << std::endl))
+  {
+    spdlog::warn("保存执行器ID失败: {}，重启后将使用新的ID", idFile);
+  }
+  return executor_id;
+}
+
+// 信号处理函数：只记录信号，停止流程在主线程中执行
+void signalHandler(int signal)
+{
+  g_signal = signal;
 }
 
 int main(int argc, char *argv[])
@@ -90,20 +127,32 @@ int main(int argc, char *argv[])
       }
     }
 
-    // 生成执行器ID
-    std::string executor_id = generate_uuid();
+    // 读取或生成执行器ID
+    std::string executor_id = load_executor_id();
     spdlog::info("执行器ID: {}", executor_id);
 
     // 创建并启动执行器
     g_executor = std::make_unique<JobExecutor>(executor_id);
     g_executor->start();
 
-    // 主线程等待
-    spdlog::info("执行器已启动，按Ctrl+C停止");
-    while (true)
+    // 主线程等待退出信号或调度器的排空请求
+    spdlog::info("执行器已启动，按Ctrl+C停止，SIGTERM排空后退出");
+    while (g_signal == 0 && !g_executor->drain_requested())
     {
       std::this_thread::sleep_for(std::chrono::seconds(1));
     }
+
+    // SIGINT立即停止；SIGTERM和排空请求等待任务完成后退出
+    if (g_signal == SIGINT)
+    {
+      spdlog::info("接收到信号: {}, 正在停止执行器...", g_signal.load());
+    }
+    else
+    {
+      spdlog::info("正在排空执行器...");
+      g_executor->drain();
+    }
+    g_executor->stop();
   }
   catch (const std::exception &e)
   {
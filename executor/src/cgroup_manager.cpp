@@ -0,0 +1,183 @@
+#include "cgroup_manager.h"
+#include <spdlog/spdlog.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <linux/magic.h>
+
+namespace scheduler
+{
+
+  CgroupManager::CgroupManager(const std::string &root)
+      : root_(root), enabled_(false)
+  {
+  }
+
+  bool CgroupManager::init()
+  {
+    // 根目录的父目录必须位于cgroup2文件系统上
+    std::string parent = root_.substr(0, root_.find_last_of('/'));
+    struct statfs fs;
+    if (parent.empty() || statfs(parent.c_str(), &fs) != 0 || fs.f_type != CGROUP2_SUPER_MAGIC)
+    {
+      spdlog::warn("cgroup v2 不可用: {}", parent);
+      return false;
+    }
+
+    // 在父目录开启控制器，子目录才能使用cpu.weight/memory.max/io.stat
+    writeFile(parent + "/cgroup.subtree_control", "+cpu +memory +io");
+
+    if (mkdir(root_.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+      spdlog::warn("创建cgroup根目录失败: {}, {}", root_, std::strerror(errno));
+      return false;
+    }
+
+    if (!writeFile(root_ + "/cgroup.subtree_control", "+cpu +memory +io"))
+    {
+      spdlog::warn("开启cgroup控制器失败: {}", root_);
+      return false;
+    }
+
+    enabled_ = true;
+    spdlog::info("cgroup v2 隔离已启用: {}", root_);
+    return true;
+  }
+
+  std::string CgroupManager::createJobGroup(const JobInfo &job)
+  {
+    if (!enabled_)
+    {
+      return "";
+    }
+
+    // 删除cgroup时写入cgroup.kill会杀死其中的全部进程，不能与其他执行共用
+    std::string path = job.execution_id != 0
+                           ? root_ + "/exec_" + std::to_string(job.execution_id)
+                           : root_ + "/job_" + job.job_id + "_" + std::to_string(++sequence_);
+    if (mkdir(path.c_str(), 0755) != 0)
+    {
+      spdlog::error("创建任务cgroup失败: {}, {}", path, std::strerror(errno));
+      return "";
+    }
+
+    // CPU权重，合法范围为1-10000
+    if (job.cpu_weight > 0)
+    {
+      int weight = std::min(std::max(job.cpu_weight, 1), 10000);
+      writeFile(path + "/cpu.weight", std::to_string(weight));
+    }
+
+    // 内存上限，同时关闭swap，避免任务把主机推入swap
+    if (job.memory_limit_mb > 0)
+    {
+      writeFile(path + "/memory.max", std::to_string(job.memory_limit_mb * 1024 * 1024));
+      writeFile(path + "/memory.swap.max", "0");
+    }
+
+    return path;
+  }
+
+  int CgroupManager::openProcsFile(const std::string &path) const
+  {
+    return open((path + "/cgroup.procs").c_str(), O_WRONLY | O_CLOEXEC);
+  }
+
+  ResourceUsage CgroupManager::readUsage(const std::string &path) const
+  {
+    ResourceUsage usage;
+
+    // cpu.stat: usage_usec <n>
+    std::istringstream cpu(readFile(path + "/cpu.stat"));
+    std::string key;
+    uint64_t value = 0;
+    while (cpu >> key >> value)
+    {
+      if (key == "usage_usec")
+      {
+        usage.cpu_time_ms = value / 1000;
+        break;
+      }
+    }
+
+    // memory.peak 需要5.19以上内核
+    std::string peak = readFile(path + "/memory.peak");
+    if (!peak.empty())
+    {
+      usage.peak_rss_kb = std::stoull(peak) / 1024;
+    }
+
+    // io.stat: <major>:<minor> rbytes=<n> wbytes=<n> ...
+    std::istringstream io(readFile(path + "/io.stat"));
+    std::string token;
+    while (io >> token)
+    {
+      if (token.rfind("rbytes=", 0) == 0)
+      {
+        usage.io_read_bytes += std::stoull(token.substr(7));
+      }
+      else if (token.rfind("wbytes=", 0) == 0)
+      {
+        usage.io_write_bytes += std::stoull(token.substr(7));
+      }
+    }
+
+    return usage;
+  }
+
+  void CgroupManager::removeJobGroup(const std::string &path)
+  {
+    if (path.empty())
+    {
+      return;
+    }
+
+    // 杀死任务遗留的后台进程（cgroup.kill需要5.14以上内核）
+    writeFile(path + "/cgroup.kill", "1");
+
+    // 进程退出后cgroup才能删除，短暂重试
+    for (int i = 0; i < 10; ++i)
+    {
+      if (rmdir(path.c_str()) == 0 || errno == ENOENT)
+      {
+        return;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    spdlog::warn("删除任务cgroup失败: {}, {}", path, std::strerror(errno));
+  }
+
+  bool CgroupManager::writeFile(const std::string &path, const std::string &value) const
+  {
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+      return false;
+    }
+    file << value;
+    file.flush();
+    return static_cast<bool>(file);
+  }
+
+  std::string CgroupManager::readFile(const std::string &path) const
+  {
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+      return "";
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+  }
+
+} // namespace scheduler
@@ -6,40 +6,176 @@
 #include <cstdlib>
 #include <array>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <thread>
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
 #include "config_manager.h"
 #include "stats_manager.h"
+#include "payload_codec.h"
 
 namespace scheduler
 {
 
   JobExecutor::JobExecutor(const std::string &executor_id)
-      : executor_id_(executor_id), running_(false)
+      : executor_id_(executor_id), running_(false), running_jobs_(0), received_jobs_(0),
+        cancelled_jobs_(std::chrono::seconds(ConfigManager::getInstance().getInt("executor.cancel_ttl_seconds", 3600))),
+        draining_(false), drain_requested_(false)
   {
     // 初始化数据库连接池
     auto &dbPool = DBConnectionPool::getInstance();
     dbPool.initialize();
 
-    // 创建Kafka客户端
-    kafka_client_ = std::make_unique<KafkaMessageQueue>();
+    // 执行线程数与分发模式
+    worker_threads_ = std::max(1, ConfigManager::getInstance().getInt("executor.worker_threads", 1));
+    pull_mode_ = ConfigManager::getInstance().getString("executor.dispatch_mode", "push") == "pull";
+    lease_wait_ms_ = ConfigManager::getInstance().getInt("executor.lease_wait_ms", 30000);
+
+    // 初始化cgroup隔离
+    if (ConfigManager::getInstance().getBool("executor.cgroup.enabled", false))
+    {
+      cgroup_manager_ = std::make_unique<CgroupManager>(
+          ConfigManager::getInstance().getString("executor.cgroup.root", "/sys/fs/cgroup/job-scheduler"));
+      if (!cgroup_manager_->init())
+      {
+        spdlog::warn("cgroup隔离初始化失败，任务将不受资源限制");
+      }
+    }
+
+    // 初始化预热工作进程池
+    int warmPoolSize = ConfigManager::getInstance().getInt("executor.warm_pool.size", 0);
+    if (warmPoolSize > 0)
+    {
+      warm_pool_ = std::make_unique<WarmWorkerPool>(
+          warmPoolSize, ConfigManager::getInstance().getInt("executor.warm_pool.max_jobs_per_worker", 100));
+    }
+
+    // 初始化共享库任务执行器，未配置插件目录时不支持共享库任务
+    std::string pluginDir = ConfigManager::getInstance().getString("executor.plugin.dir", "");
+    if (!pluginDir.empty())
+    {
+      plugin_runner_ = std::make_unique<SharedLibraryRunner>(
+          pluginDir, ConfigManager::getInstance().getInt("executor.plugin.max_output_kb", 4096) * 1024);
+    }
+
+    // 任务输出压缩，未知或当前构建不支持的格式不压缩
+    std::string codecName = ConfigManager::getInstance().getString("executor.payload.codec", "lz4");
+    if (!PayloadCompressor::codecFromString(codecName, payload_codec_) || !PayloadCompressor::isSupported(payload_codec_))
+    {
+      spdlog::warn("不支持的输出压缩格式: {}，任务输出将不压缩", codecName);
+      payload_codec_ = PayloadCodec::NONE;
+    }
+    payload_min_bytes_ = std::max(0, ConfigManager::getInstance().getInt("executor.payload.min_bytes", 1024));
+
+    // 优先级通道，需与调度器的配置一致
+    if (!priority_lanes_.parse(ConfigManager::getInstance().getString("kafka.priority_lanes", "")))
+    {
+      spdlog::warn("优先级通道配置无效，所有任务使用同一个通道");
+    }
+    job_queues_.resize(priority_lanes_.lanes().size());
+    lane_selector_ = std::make_unique<LaneSelector>(priority_lanes_.lanes());
+
+    // 创建消息传输客户端，loopback用于与调度器运行在同一进程
+    kafka_client_ = MessageTransportFactory::create(ConfigManager::getInstance().getString("transport.type", "kafka"));
 
     // 初始化Kafka
     std::string kafkaBrokers = ConfigManager::getInstance().getKafkaBrokers();
     kafka_client_->initProducer(kafkaBrokers);
-    kafka_client_->initConsumer(kafkaBrokers, "executor-" + executor_id_, {"job-submit", "job-cancel"}, [this](const KafkaMessage &message)
+
+    // 任务结果批量发送
+    result_batcher_ = std::make_unique<ResultBatcher>(
+        [this](const std::vector<JobResult> &results)
+        { return kafka_client_->sendJobResults("job-result", results); },
+        ConfigManager::getInstance().getInt("executor.result_batch.size", 100),
+        ConfigManager::getInstance().getInt("executor.result_batch.linger_ms", 20),
+        ConfigManager::getInstance().getInt("executor.result_batch.max_pending", 10000),
+        ConfigManager::getInstance().getInt("executor.result_batch.max_bytes", ResultBatcher::kDefaultMaxBatchBytes));
+
+    // 结果预写日志：先落盘再由后台线程发送，broker确认后删除
+    std::string spoolDir = ConfigManager::getInstance().getString("executor.spool.dir", "");
+    if (!spoolDir.empty())
+    {
+      // 段文件在broker确认后删除，只有leader确认时leader故障会丢失已删除的结果
+      std::string acks = ConfigManager::getInstance().getString(
+          "kafka.producer.acks",
+          ConfigManager::getInstance().getString("kafka.producer_profile", "throughput") == "latency" ? "1" : "all");
+      if (acks != "all" && acks != "-1")
+      {
+        spdlog::warn("结果预写日志要求生产者acks=all，当前为acks={}，leader故障时可能丢失结果", acks);
+      }
+
+      int deliveryTimeout = ConfigManager::getInstance().getInt("executor.spool.delivery_timeout_ms", 30000);
+      result_spool_ = std::make_unique<ResultSpool>(
+          spoolDir,
+          [this, deliveryTimeout](const std::vector<JobResult> &results)
+          {
+            // 发送并等待传递报告（由生产者轮询线程回调）
+            auto delivered = std::make_shared<std::promise<bool>>();
+            auto future = delivered->get_future();
+            if (!kafka_client_->sendJobResults("job-result", results, [delivered](bool ok)
+                                               { delivered->set_value(ok); }))
+            {
+              return false;
+            }
+
+            if (future.wait_for(std::chrono::milliseconds(deliveryTimeout)) != std::future_status::ready)
+            {
+              return false;
+            }
+            return future.get();
+          },
+          ConfigManager::getInstance().getInt("executor.result_batch.size", 100),
+          ConfigManager::getInstance().getInt("executor.spool.segment_kb", 4096) * 1024,
+          ConfigManager::getInstance().getInt("executor.spool.fsync_interval_ms", 2),
+          ConfigManager::getInstance().getInt("executor.spool.retry_ms", 1000),
+          ConfigManager::getInstance().getInt("executor.result_batch.max_bytes", ResultBatcher::kDefaultMaxBatchBytes),
+          ConfigManager::getInstance().getInt("executor.spool.max_attempts", 10));
+    }
+    // 只订阅本执行器专属的各优先级通道任务主题；新执行器从最新位置开始，不回放历史任务
+    std::vector<std::string> topics = priority_lanes_.topics("job-submit", executor_id_);
+    topics.push_back("job-cancel");
+    kafka_client_->setConsumerWorkers(ConfigManager::getInstance().getInt("executor.intake_workers", 2),
+                                      ConfigManager::getInstance().getInt("kafka.consumer_queue_size", 1000));
+    kafka_client_->initConsumer(kafkaBrokers, "executor-" + executor_id_, topics, [this](const KafkaMessage &message)
                                 {
           if (message.type == MessageType::JOB_SUBMIT)
           {
+            // 忽略分配给其他执行器的任务
+            auto it = message.headers.find(kExecutorIdHeader);
+            if (it != message.headers.end() && it->second != executor_id_)
+            {
+              spdlog::debug("忽略分配给其他执行器的任务: {}, 目标执行器: {}", message.key, it->second);
+              return;
+            }
+
             try
             {
               // 解析任务信息
-              nlohmann::json j = nlohmann::json::parse(message.payload);
-              JobInfo job = JobInfo::from_json(j);
-
-              // 添加到任务队列
-              std::lock_guard<std::mutex> lock(mutex_);
-              job_queue_.push(job);
+              JobInfo job;
+              if (!MessageTransport::parseJob(message, job))
+              {
+                spdlog::error("解析任务失败: {}", message.key);
+                return;
+              }
+
+              // 添加到任务队列；排空期间收到的任务直接退回
+              std::unique_lock<std::mutex> lock(mutex_);
+              received_jobs_++;
+              if (draining_)
+              {
+                lock.unlock();
+                spdlog::info("执行器正在排空，退回任务: {}", job.job_id);
+                return_jobs({job.job_id});
+                return;
+              }
+              enqueue_job(job);
               cv_.notify_one();
 
               spdlog::info("接收到任务: {}", job.job_id);
@@ -55,7 +191,17 @@ namespace scheduler
             std::string job_id = message.payload;
             spdlog::info("接收到取消任务请求: {}", job_id);
             cancel_job(job_id);
-          } });
+          }
+          else if (message.type == MessageType::EXECUTOR_DRAIN)
+          {
+            auto it = message.headers.find(kExecutorIdHeader);
+            if (it != message.headers.end() && it->second != executor_id_)
+            {
+              return;
+            }
+            spdlog::info("接收到排空请求");
+            request_drain();
+          } }, "latest");
 
     spdlog::info("执行器初始化完成: {}", executor_id_);
   }
@@ -75,17 +221,43 @@ namespace scheduler
 
     running_ = true;
 
+    // 先启动Kafka消费并等待分区分配，注册后调度器立即派发的任务才不会丢失
+    kafka_client_->startConsume();
+    kafka_client_->waitForAssignment(
+        ConfigManager::getInstance().getInt("executor.assignment_timeout_ms", 10000));
+
     // 向调度中心注册
     register_executor();
 
+    // 启动结果批量发送线程
+    result_batcher_->start();
+    if (result_spool_ && !result_spool_->start())
+    {
+      spdlog::warn("结果预写日志启动失败，任务结果将直接发送");
+      result_spool_.reset();
+    }
+
+    // 启动预热工作进程
+    if (warm_pool_ && !warm_pool_->start())
+    {
+      spdlog::warn("预热工作进程池启动失败，任务将直接启动bash执行");
+      warm_pool_.reset();
+    }
+
     // 启动执行线程
-    execute_thread_ = std::thread(&JobExecutor::execute_loop, this);
+    for (int i = 0; i < worker_threads_; ++i)
+    {
+      execute_threads_.emplace_back(&JobExecutor::execute_loop, this);
+    }
 
     // 启动心跳线程
     heartbeat_thread_ = std::thread(&JobExecutor::heartbeat_loop, this);
 
-    // 启动Kafka消费
-    kafka_client_->startConsume();
+    // 拉取模式下启动任务申请线程
+    if (pull_mode_)
+    {
+      credit_thread_ = std::thread(&JobExecutor::credit_loop, this);
+    }
 
     spdlog::info("执行器已启动: {}", executor_id_);
   }
@@ -101,22 +273,45 @@ namespace scheduler
 
       running_ = false;
       cv_.notify_all();
+      credit_cv_.notify_all();
     }
 
     // 等待线程结束
-    if (execute_thread_.joinable())
+    for (auto &thread : execute_threads_)
     {
-      execute_thread_.join();
+      if (thread.joinable())
+      {
+        thread.join();
+      }
     }
+    execute_threads_.clear();
 
     if (heartbeat_thread_.joinable())
     {
       heartbeat_thread_.join();
     }
 
+    if (credit_thread_.joinable())
+    {
+      credit_thread_.join();
+    }
+
     // 停止Kafka消费
     kafka_client_->stopConsume();
 
+    // 发送剩余的任务结果
+    if (result_spool_)
+    {
+      result_spool_->stop(ConfigManager::getInstance().getInt("executor.spool.drain_timeout_ms", 5000));
+    }
+    result_batcher_->stop();
+
+    // 停止预热工作进程
+    if (warm_pool_)
+    {
+      warm_pool_->stop();
+    }
+
     // 向调度中心注销
     unregister_executor();
 
@@ -135,20 +330,23 @@ namespace scheduler
       {
         std::unique_lock<std::mutex> lock(mutex_);
         cv_.wait_for(lock, std::chrono::seconds(1), [this]
-                     { return !running_ || !job_queue_.empty(); });
+                     { return !running_ || queued_jobs() > 0; });
 
         if (!running_)
         {
           break;
         }
 
-        if (job_queue_.empty())
+        if (queued_jobs() == 0)
         {
           continue;
         }
 
-        job = job_queue_.front();
-        job_queue_.pop();
+        job = dequeue_job();
+        running_jobs_++;
+
+        std::lock_guard<std::mutex> cancel_lock(cancel_mutex_);
+        running_job_ids_.insert(job.job_id);
       }
 
       // 检查任务是否被取消
@@ -159,12 +357,20 @@ namespace scheduler
         // 发送取消结果
         JobResult result;
         result.job_id = job.job_id;
+        result.execution_id = job.execution_id;
+        result.executor_id = executor_id_;
         result.status = JobStatus::FAILED;
         result.error = "任务被取消";
         result.start_time = std::chrono::system_clock::now();
         result.end_time = std::chrono::system_clock::now();
 
-        kafka_client_->sendJobResult("job-result", result);
+        {
+          std::lock_guard<std::mutex> cancel_lock(cancel_mutex_);
+          running_job_ids_.erase(running_job_ids_.find(job.job_id));
+        }
+
+        report_result(result);
+        release_slot();
         continue;
       }
 
@@ -173,17 +379,44 @@ namespace scheduler
       JobResult result = execute_job(job);
       spdlog::info("任务执行完成: {}, 状态: {}", job.job_id, static_cast<int>(result.status));
 
-      // 发送结果
-      kafka_client_->sendJobResult("job-result", result);
+      // 发送结果；排空超时后已退回调度器的任务不再上报
+      bool returned;
+      {
+        std::lock_guard<std::mutex> cancel_lock(cancel_mutex_);
+        running_job_ids_.erase(running_job_ids_.find(job.job_id));
+        // 只消耗本次执行的退回标记，同一任务的其他执行照常上报
+        auto it = returned_jobs_.find(job.job_id);
+        returned = it != returned_jobs_.end();
+        if (returned)
+        {
+          returned_jobs_.erase(it);
+        }
+      }
+      if (!returned)
+      {
+        report_result(result);
+      }
+
+      release_slot();
     }
 
     spdlog::info("执行线程退出");
   }
 
+  void JobExecutor::release_slot()
+  {
+    // 持有mutex_修改并通知，排空和申请线程检查条件后、进入等待前不会错过通知
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_jobs_--;
+    credit_cv_.notify_all();
+  }
+
   JobResult JobExecutor::execute_job(const JobInfo &job)
   {
     JobResult result;
     result.job_id = job.job_id;
+    result.execution_id = job.execution_id;
+    result.executor_id = executor_id_;
     result.start_time = std::chrono::system_clock::now();
 
     // 定义输出和错误变量
@@ -193,70 +426,217 @@ namespace scheduler
     // 更新统计信息
     StatsManager::getInstance().updateJobStats(job, JobStatus::RUNNING);
 
+    // 共享库任务在执行器进程内调用
+    if (job.exec_type == JobExecType::SHARED_LIBRARY)
+    {
+      execute_shared_library(job, result);
+      result.end_time = std::chrono::system_clock::now();
+      StatsManager::getInstance().updateJobResultStats(result);
+      return result;
+    }
+
+    // 短任务在预热工作进程中执行，启用cgroup时执行命令的子shell同样加入任务cgroup
+    if (job.use_warm_pool && warm_pool_)
+    {
+      execute_in_warm_pool(job, result);
+      result.end_time = std::chrono::system_clock::now();
+      StatsManager::getInstance().updateJobResultStats(result);
+      return result;
+    }
+
+    // 为任务创建独立的cgroup
+    std::string cgroup_path;
+    if (cgroup_manager_ && cgroup_manager_->isEnabled())
+    {
+      cgroup_path = cgroup_manager_->createJobGroup(job);
+    }
+
     try
     {
-      // 创建临时文件存储命令
-      std::string script_file = "/tmp/job_" + job.job_id + ".sh";
-      std::ofstream script(script_file);
-      script << "#!/bin/bash\n";
-      script << job.command << "\n";
-      script.close();
+      // 创建管道，子进程的stdout和stderr都写入管道
+      int pipefd[2];
+      if (pipe2(pipefd, O_CLOEXEC) != 0)
+      {
+        throw std::runtime_error("Failed to create pipe");
+      }
 
-      // 设置执行权限
-      std::string chmod_cmd = "chmod +x " + script_file;
-      std::system(chmod_cmd.c_str());
+      // 在fork之前打开cgroup.procs，子进程在exec之前把自己移入cgroup
+      int procs_fd = cgroup_path.empty() ? -1 : cgroup_manager_->openProcsFile(cgroup_path);
 
-      // 执行命令
-      std::string cmd = script_file + " 2>&1";
-      std::array<char, 128> buffer;
+      pid_t pid = fork();
+      if (pid < 0)
+      {
+        close(pipefd[0]);
+        close(pipefd[1]);
+        if (procs_fd >= 0)
+        {
+          close(procs_fd);
+        }
+        throw std::runtime_error("Failed to fork process");
+      }
 
-      // 设置超时
-      int timeout = job.timeout > 0 ? job.timeout : 60; // 默认60秒
-      auto start_time = std::chrono::system_clock::now();
+      if (pid == 0)
+      {
+        // 子进程：只能调用async-signal-safe函数
+        if (procs_fd >= 0 && write(procs_fd, "0", 1) < 0)
+        {
+          _exit(126);
+        }
+        setpgid(0, 0);
+        dup2(pipefd[1], STDOUT_FILENO);
+        dup2(pipefd[1], STDERR_FILENO);
+        execl("/bin/bash", "bash", "-c", job.command.c_str(), static_cast<char *>(nullptr));
+        _exit(127);
+      }
 
-      // 创建管道
-      FILE *pipe = popen(cmd.c_str(), "r");
-      if (!pipe)
+      // 父进程
+      setpgid(pid, pid);
+
+      // 登记运行中的进程，取消时直接发送信号
       {
-        throw std::runtime_error("Failed to create pipe");
+        std::lock_guard<std::mutex> lock(cancel_mutex_);
+        running_pids_.emplace(job.job_id, pid);
       }
+      close(pipefd[1]);
+      if (procs_fd >= 0)
+      {
+        close(procs_fd);
+      }
+
+      // 设置超时
+      int timeout = job.timeout > 0 ? job.timeout : 60; // 默认60秒
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout);
+      bool timed_out = false;
+      bool cancelled = false;
+      std::array<char, 4096> buffer;
 
-      // 读取输出
-      while (fgets(buffer.data(), buffer.size(), pipe) != nullptr)
+      // 读取输出，同时检查超时和取消
+      while (true)
       {
-        output += buffer.data();
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             deadline - std::chrono::steady_clock::now())
+                             .count();
+        if (remaining <= 0)
+        {
+          timed_out = true;
+          break;
+        }
 
-        // 检查是否超时
-        auto now = std::chrono::system_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - start_time).count();
-        if (elapsed > timeout)
+        struct pollfd pfd = {pipefd[0], POLLIN, 0};
+        int ret = poll(&pfd, 1, static_cast<int>(std::min<long long>(remaining, 200)));
+        if (ret > 0)
         {
-          pclose(pipe);
-          throw std::runtime_error("Execution timeout");
+          ssize_t n = read(pipefd[0], buffer.data(), buffer.size());
+          if (n > 0)
+          {
+            output.append(buffer.data(), n);
+          }
+          else if (n == 0 || (errno != EINTR && errno != EAGAIN))
+          {
+            break; // 管道关闭
+          }
+        }
+        else if (ret < 0 && errno != EINTR)
+        {
+          break;
         }
 
         // 检查任务是否被取消
         if (is_job_cancelled(job.job_id))
         {
-          pclose(pipe);
-          throw std::runtime_error("Job cancelled during execution");
+          cancelled = true;
+          break;
         }
       }
+      close(pipefd[0]);
+
+      // 超时或取消时杀死整个进程组
+      if (timed_out || cancelled)
+      {
+        kill(-pid, SIGKILL);
+      }
 
-      // 获取返回值
-      int status = pclose(pipe);
-      if (status == 0)
+      // 等待子进程退出；任务关闭输出后仍在运行时同样受超时和取消限制。
+      // WNOWAIT只观察不回收，子进程保持僵尸状态，pid在移出running_pids_前不会被复用
+      while (true)
+      {
+        siginfo_t info = {};
+        int ret = waitid(P_PID, pid, &info, WEXITED | WNOHANG | WNOWAIT);
+        if ((ret == 0 && info.si_pid == pid) || (ret < 0 && errno != EINTR))
+        {
+          break;
+        }
+        if (ret == 0 && !timed_out && !cancelled)
+        {
+          if (std::chrono::steady_clock::now() >= deadline)
+          {
+            timed_out = true;
+            kill(-pid, SIGKILL);
+          }
+          else if (is_job_cancelled(job.job_id))
+          {
+            cancelled = true;
+            kill(-pid, SIGKILL);
+          }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+
+      // 先移出running_pids_，cancel_job之后不会再向该进程组发信号，再回收并获取rusage
+      {
+        std::lock_guard<std::mutex> lock(cancel_mutex_);
+        auto range = running_pids_.equal_range(job.job_id);
+        auto it = std::find_if(range.first, range.second, [pid](const auto &entry)
+                               { return entry.second == pid; });
+        if (it != range.second)
+        {
+          running_pids_.erase(it);
+        }
+      }
+      int status = 0;
+      struct rusage usage = {};
+      while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR)
+      {
+      }
+
+      // 进程可能已被cancel_job直接杀死
+      if (!timed_out && !cancelled && is_job_cancelled(job.job_id))
+      {
+        cancelled = true;
+      }
+
+      result.cpu_time_ms = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000ULL +
+                           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+      result.peak_rss_kb = usage.ru_maxrss;
+      result.io_read_bytes = usage.ru_inblock * 512ULL;
+      result.io_write_bytes = usage.ru_oublock * 512ULL;
+
+      if (timed_out)
+      {
+        result.status = JobStatus::FAILED;
+        error = "Execution timeout";
+      }
+      else if (cancelled)
+      {
+        result.status = JobStatus::FAILED;
+        error = "Job cancelled during execution";
+      }
+      else if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
       {
         result.status = JobStatus::SUCCESS;
       }
       else
       {
         result.status = JobStatus::FAILED;
-        error = "Command exited with status " + std::to_string(status);
+        if (WIFSIGNALED(status))
+        {
+          error = "Command killed by signal " + std::to_string(WTERMSIG(status));
+        }
+        else
+        {
+          error = "Command exited with status " + std::to_string(WEXITSTATUS(status));
+        }
       }
-
-      // 删除临时文件
-      std::remove(script_file.c_str());
     }
     catch (const std::exception &e)
     {
@@ -264,6 +644,23 @@ namespace scheduler
       error = e.what();
     }
 
+    // cgroup统计包含任务派生的所有进程，优先使用
+    if (!cgroup_path.empty())
+    {
+      ResourceUsage usage = cgroup_manager_->readUsage(cgroup_path);
+      if (usage.cpu_time_ms > 0)
+      {
+        result.cpu_time_ms = usage.cpu_time_ms;
+      }
+      if (usage.peak_rss_kb > 0)
+      {
+        result.peak_rss_kb = usage.peak_rss_kb;
+      }
+      result.io_read_bytes = std::max(result.io_read_bytes, usage.io_read_bytes);
+      result.io_write_bytes = std::max(result.io_write_bytes, usage.io_write_bytes);
+      cgroup_manager_->removeJobGroup(cgroup_path);
+    }
+
     result.output = output;
     result.error = error;
     result.end_time = std::chrono::system_clock::now();
@@ -274,6 +671,212 @@ namespace scheduler
     return result;
   }
 
+  void JobExecutor::execute_in_warm_pool(const JobInfo &job, JobResult &result)
+  {
+    std::string cgroup_path;
+    if (cgroup_manager_ && cgroup_manager_->isEnabled())
+    {
+      cgroup_path = cgroup_manager_->createJobGroup(job);
+    }
+
+    int timeout = job.timeout > 0 ? job.timeout : 60; // 默认60秒
+    WarmJobOutcome outcome = warm_pool_->run(
+        job.command, timeout, [this, &job]
+        { return is_job_cancelled(job.job_id); },
+        cgroup_path.empty() ? "" : cgroup_path + "/cgroup.procs");
+
+    // 没有cgroup时只有子shell统计的CPU时间
+    result.cpu_time_ms = outcome.cpu_time_ms;
+    if (!cgroup_path.empty())
+    {
+      ResourceUsage usage = cgroup_manager_->readUsage(cgroup_path);
+      result.cpu_time_ms = std::max(result.cpu_time_ms, usage.cpu_time_ms);
+      result.peak_rss_kb = usage.peak_rss_kb;
+      result.io_read_bytes = usage.io_read_bytes;
+      result.io_write_bytes = usage.io_write_bytes;
+      cgroup_manager_->removeJobGroup(cgroup_path);
+    }
+
+    result.output = outcome.output;
+    if (outcome.timed_out)
+    {
+      result.status = JobStatus::FAILED;
+      result.error = "Execution timeout";
+    }
+    else if (outcome.cancelled)
+    {
+      result.status = JobStatus::FAILED;
+      result.error = "Job cancelled during execution";
+    }
+    else if (!outcome.completed)
+    {
+      result.status = JobStatus::FAILED;
+      result.error = outcome.error;
+    }
+    else if (outcome.exit_status == 0)
+    {
+      result.status = JobStatus::SUCCESS;
+    }
+    else
+    {
+      result.status = JobStatus::FAILED;
+      result.error = "Command exited with status " + std::to_string(outcome.exit_status);
+    }
+  }
+
+  void JobExecutor::execute_shared_library(const JobInfo &job, JobResult &result)
+  {
+    if (!plugin_runner_)
+    {
+      result.status = JobStatus::FAILED;
+      result.error = "Shared library jobs are not enabled on this executor";
+      return;
+    }
+
+    int timeout = job.timeout > 0 ? job.timeout : 60; // 默认60秒
+    LibraryJobOutcome outcome = plugin_runner_->run(job, timeout, [this, &job]
+                                                    { return is_job_cancelled(job.job_id); });
+
+    result.output = outcome.output;
+    if (outcome.timed_out)
+    {
+      result.status = JobStatus::FAILED;
+      result.error = "Execution timeout";
+    }
+    else if (outcome.cancelled)
+    {
+      result.status = JobStatus::FAILED;
+      result.error = "Job cancelled during execution";
+    }
+    else if (!outcome.completed)
+    {
+      result.status = JobStatus::FAILED;
+      result.error = outcome.error;
+    }
+    else if (outcome.exit_status == 0)
+    {
+      result.status = JobStatus::SUCCESS;
+    }
+    else
+    {
+      result.status = JobStatus::FAILED;
+      result.error = "Command exited with status " + std::to_string(outcome.exit_status);
+    }
+  }
+
+  void JobExecutor::request_drain()
+  {
+    drain_requested_ = true;
+  }
+
+  bool JobExecutor::drain_requested() const
+  {
+    return drain_requested_;
+  }
+
+  void JobExecutor::drain()
+  {
+    int drainTimeout = ConfigManager::getInstance().getInt("executor.drain_timeout", 300);
+
+    // 停止接收新任务，取出排队中的任务
+    std::vector<std::string> queued;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!running_ || draining_)
+      {
+        return;
+      }
+      draining_ = true;
+
+      for (auto &queue : job_queues_)
+      {
+        for (const auto &job : queue)
+        {
+          queued.push_back(job.job_id);
+        }
+        queue.clear();
+      }
+      queued_index_.clear();
+    }
+    credit_cv_.notify_all();
+
+    spdlog::info("执行器开始排空: {}, 退回排队任务: {}, 正在执行: {}",
+                 executor_id_, queued.size(), running_jobs_.load());
+
+    // 标记为DRAINING，调度器不再选择本执行器
+    JobDAO dao;
+    dao.markExecutorDraining(executor_id_);
+
+    return_jobs(queued);
+
+    // 等待正在执行的任务完成
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(drainTimeout);
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      credit_cv_.wait_until(lock, deadline, [this]
+                            { return running_jobs_ == 0; });
+    }
+
+    if (running_jobs_ > 0)
+    {
+      // 超时：终止剩余任务并退回调度器，它们的结果不再上报
+      std::vector<std::string> unfinished;
+      {
+        std::lock_guard<std::mutex> lock(cancel_mutex_);
+        returned_jobs_.insert(running_job_ids_.begin(), running_job_ids_.end());
+        std::unordered_set<std::string> ids(running_job_ids_.begin(), running_job_ids_.end());
+        unfinished.assign(ids.begin(), ids.end());
+      }
+
+      spdlog::warn("排空超时，终止并退回 {} 个正在执行的任务", unfinished.size());
+      return_jobs(unfinished);
+      for (const auto &job_id : unfinished)
+      {
+        cancel_job(job_id);
+      }
+
+      std::unique_lock<std::mutex> lock(mutex_);
+      credit_cv_.wait_for(lock, std::chrono::seconds(10), [this]
+                          { return running_jobs_ == 0; });
+    }
+
+    spdlog::info("执行器排空完成: {}", executor_id_);
+  }
+
+  void JobExecutor::report_result(const JobResult &result)
+  {
+    // 较大的输出在上报前压缩，之后经预写日志、Kafka到数据库都保持压缩
+    JobResult encoded = result;
+    PayloadCompressor::compressResult(encoded, payload_codec_, payload_min_bytes_);
+
+    // 预写日志不可用时直接批量发送
+    if (!result_spool_ || !result_spool_->add(encoded))
+    {
+      result_batcher_->add(encoded);
+    }
+  }
+
+  // 退回消息不经过结果预写日志：丢失时调度器在执行器心跳超时后仍会重新派发这些任务，
+  // 执行器沿用同一ID重启时注册阶段也会再次退回未完成的执行
+  void JobExecutor::return_jobs(const std::vector<std::string> &job_ids)
+  {
+    if (job_ids.empty())
+    {
+      return;
+    }
+
+    nlohmann::json j;
+    j["executor_id"] = executor_id_;
+    j["job_ids"] = job_ids;
+    j["draining"] = draining_.load();
+
+    KafkaMessage message(MessageType::JOB_RETURN, j.dump(), executor_id_);
+    if (!kafka_client_->sendMessage("job-result", message))
+    {
+      spdlog::error("退回任务失败: {} 个任务", job_ids.size());
+    }
+  }
+
   void JobExecutor::register_executor()
   {
     // 从配置获取默认最大负载
@@ -283,6 +886,18 @@ namespace scheduler
     JobDAO dao;
     dao.registerExecutor(executor_id_, "localhost", 0, maxLoad);
     spdlog::info("执行器已注册: {}, 最大负载: {}", executor_id_, maxLoad);
+
+    // 沿用上次的ID重启时，上一次运行中未完成的任务不会再有结果，退回调度器重新派发
+    std::vector<std::string> unfinished;
+    for (const auto &execution : dao.getInFlightExecutions(executor_id_))
+    {
+      unfinished.push_back(execution.job_id);
+    }
+    if (!unfinished.empty())
+    {
+      spdlog::warn("退回上次运行中未完成的 {} 个任务", unfinished.size());
+      return_jobs(unfinished);
+    }
   }
 
   void JobExecutor::unregister_executor()
@@ -305,12 +920,24 @@ namespace scheduler
     {
       try
       {
-        // 更新心跳时间
-        JobDAO dao;
-        dao.updateExecutorHeartbeat(executor_id_);
+        // 发送心跳消息，调度器在内存中跟踪存活状态并定期批量写入数据库
+        KafkaMessage message(MessageType::EXECUTOR_HEARTBEAT, executor_id_, executor_id_);
 
-        // 发送心跳消息
-        KafkaMessage message(MessageType::EXECUTOR_HEARTBEAT, executor_id_);
+        // 附带本进程所有消费者的积压之和，调度器通过统计接口展示
+        int64_t consumerLag = 0;
+        bool hasConsumer = false;
+        for (const auto &stats : StatsManager::getInstance().getTransportStats())
+        {
+          if (stats.type == "consumer")
+          {
+            consumerLag += stats.totalLag();
+            hasConsumer = true;
+          }
+        }
+        if (hasConsumer)
+        {
+          message.headers[kConsumerLagHeader] = std::to_string(consumerLag);
+        }
         kafka_client_->sendMessage("executor-heartbeat", message);
 
         // 等待下一次心跳
@@ -326,48 +953,103 @@ namespace scheduler
     spdlog::info("心跳线程退出");
   }
 
-  void JobExecutor::cancel_job(const std::string &job_id)
+  int JobExecutor::available_credits()
   {
-    // 将任务添加到取消列表
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (draining_)
     {
-      std::lock_guard<std::mutex> lock(cancel_mutex_);
-      cancelled_jobs_.insert(job_id);
+      return 0;
     }
+    return std::max(0, worker_threads_ - running_jobs_.load() - static_cast<int>(queued_jobs()));
+  }
 
-    // 尝试从队列中移除任务
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
+  void JobExecutor::credit_loop()
+  {
+    spdlog::info("任务申请线程启动, 执行线程数: {}", worker_threads_);
 
-      // 创建临时队列
-      std::queue<JobInfo> temp_queue;
-      bool found = false;
+    int last_credits = -1;
+    auto last_request = std::chrono::steady_clock::time_point();
 
-      // 遍历当前队列
-      while (!job_queue_.empty())
-      {
-        JobInfo job = job_queue_.front();
-        job_queue_.pop();
+    while (running_)
+    {
+      int credits = available_credits();
+      auto now = std::chrono::steady_clock::now();
 
-        // 如果不是要取消的任务，则保留
-        if (job.job_id != job_id)
+      // 空闲槽位变化或上一次请求即将过期时重新申请
+      bool expiring = now - last_request >= std::chrono::milliseconds(lease_wait_ms_ * 3 / 4);
+      if (credits > 0 && (credits != last_credits || expiring))
+      {
+        nlohmann::json j;
+        j["executor_id"] = executor_id_;
+        j["credits"] = credits;
+        j["received"] = received_jobs_.load();
+        j["wait_ms"] = lease_wait_ms_;
+
+        KafkaMessage message(MessageType::WORK_REQUEST, j.dump(), executor_id_);
+        if (kafka_client_->sendMessage("executor-credit", message))
         {
-          temp_queue.push(job);
+          last_credits = credits;
+          last_request = now;
+          spdlog::debug("申请任务: credits={}", credits);
         }
-        else
+      }
+      else if (credits == 0)
+      {
+        last_credits = 0;
+      }
+
+      // 等待槽位释放或请求到期
+      std::unique_lock<std::mutex> lock(mutex_);
+      credit_cv_.wait_for(lock, std::chrono::milliseconds(std::max(100, lease_wait_ms_ / 4)));
+    }
+
+    spdlog::info("任务申请线程退出");
+  }
+
+  void JobExecutor::cancel_job(const std::string &job_id)
+  {
+    // 将任务添加到取消列表；任务正在执行时直接杀死其进程组
+    {
+      std::lock_guard<std::mutex> lock(cancel_mutex_);
+      cancelled_jobs_.insert(job_id);
+
+      auto range = running_pids_.equal_range(job_id);
+      if (range.first != range.second)
+      {
+        // 同一任务同时运行的各次执行都终止
+        for (auto it = range.first; it != range.second; ++it)
         {
-          found = true;
-          spdlog::info("从队列中移除已取消的任务: {}", job_id);
+          kill(-it->second, SIGKILL);
+          spdlog::info("已终止正在执行的任务: {}, pid: {}", job_id, it->second);
         }
+        return;
+      }
+    }
+
+    // 通过索引从队列中移除任务，记下各次执行的ID
+    std::vector<uint64_t> execution_ids;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto range = queued_index_.equal_range(job_id);
+      for (auto it = range.first; it != range.second; ++it)
+      {
+        execution_ids.push_back(it->second.second->execution_id);
+        job_queues_[it->second.first].erase(it->second.second);
       }
+      queued_index_.erase(range.first, range.second);
+    }
 
-      // 恢复队列
-      job_queue_ = std::move(temp_queue);
+    if (!execution_ids.empty())
+    {
+      spdlog::info("从队列中移除已取消的任务: {}", job_id);
 
-      if (found)
+      // 每次执行发送一条取消结果
+      for (uint64_t execution_id : execution_ids)
       {
-        // 发送取消结果
         JobResult result;
         result.job_id = job_id;
+        result.execution_id = execution_id;
+        result.executor_id = executor_id_;
         result.status = JobStatus::FAILED;
         result.error = "任务被取消";
         result.start_time = std::chrono::system_clock::now();
@@ -376,19 +1058,63 @@ namespace scheduler
         // 更新统计信息
         StatsManager::getInstance().incrementCancelledJobs();
 
-        kafka_client_->sendJobResult("job-result", result);
+        report_result(result);
       }
-      else
+      credit_cv_.notify_one();
+    }
+    else
+    {
+      spdlog::info("任务不在队列中，可能正在执行或已完成: {}", job_id);
+    }
+  }
+
+  void JobExecutor::enqueue_job(const JobInfo &job)
+  {
+    size_t lane = priority_lanes_.laneFor(job.priority);
+    auto it = job_queues_[lane].insert(job_queues_[lane].end(), job);
+    queued_index_.emplace(job.job_id, std::make_pair(lane, it));
+  }
+
+  JobInfo JobExecutor::dequeue_job()
+  {
+    // 按通道权重选择，高优先级通道有任务时不会被批量通道的积压挡住
+    std::vector<size_t> backlog;
+    for (const auto &queue : job_queues_)
+    {
+      backlog.push_back(queue.size());
+    }
+    size_t lane = static_cast<size_t>(lane_selector_->next(backlog));
+
+    auto front = job_queues_[lane].begin();
+    auto range = queued_index_.equal_range(front->job_id);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      if (it->second.second == front)
       {
-        spdlog::info("任务不在队列中，可能正在执行或已完成: {}", job_id);
+        queued_index_.erase(it);
+        break;
       }
     }
+
+    JobInfo job = std::move(*front);
+    job_queues_[lane].erase(front);
+    return job;
+  }
+
+  size_t JobExecutor::queued_jobs() const
+  {
+    size_t count = 0;
+    for (const auto &queue : job_queues_)
+    {
+      count += queue.size();
+    }
+    return count;
   }
 
   bool JobExecutor::is_job_cancelled(const std::string &job_id)
   {
     std::lock_guard<std::mutex> lock(cancel_mutex_);
-    return cancelled_jobs_.find(job_id) != cancelled_jobs_.end();
+    return cancelled_jobs_.contains(job_id);
   }
 
 } // namespace scheduler
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "expiring_id_set.h"
+#include <algorithm>
+
+namespace scheduler
+{
+
+  ExpiringIdSet::ExpiringIdSet(std::chrono::seconds ttl, size_t bucket_count)
+      : bucket_width_(std::max<Clock::duration>(ttl / std::max<size_t>(1, bucket_count), std::chrono::milliseconds(1))),
+        bucket_count_(std::max<size_t>(1, bucket_count)),
+        current_bucket_start_(Clock::now())
+  {
+    buckets_.emplace_front();
+  }
+
+  void ExpiringIdSet::insert(const std::string &id, Clock::time_point now)
+  {
+    rotate(now);
+    buckets_.front().insert(id);
+  }
+
+  bool ExpiringIdSet::contains(const std::string &id, Clock::time_point now)
+  {
+    rotate(now);
+    for (const auto &bucket : buckets_)
+    {
+      if (bucket.count(id) > 0)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t ExpiringIdSet::size(Clock::time_point now)
+  {
+    rotate(now);
+    size_t total = 0;
+    for (const auto &bucket : buckets_)
+    {
+      total += bucket.size();
+    }
+    return total;
+  }
+
+  void ExpiringIdSet::rotate(Clock::time_point now)
+  {
+    // 长时间没有访问时直接清空，避免逐桶推进
+    if (now - current_bucket_start_ >= bucket_width_ * static_cast<int>(bucket_count_ + 1))
+    {
+      buckets_.clear();
+      buckets_.emplace_front();
+      current_bucket_start_ = now;
+      return;
+    }
+
+    while (now - current_bucket_start_ >= bucket_width_)
+    {
+      current_bucket_start_ += bucket_width_;
+      buckets_.emplace_front();
+      if (buckets_.size() > bucket_count_ + 1)
+      {
+        buckets_.pop_back();
+      }
+    }
+  }
+
+} // namespace scheduler
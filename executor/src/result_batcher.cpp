@@ -0,0 +1,177 @@
+#include "result_batcher.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+
+namespace scheduler
+{
+
+  ResultBatcher::ResultBatcher(SendFunction sender, size_t batch_size, int linger_ms, size_t max_pending,
+                               size_t max_batch_bytes)
+      : sender_(std::move(sender)),
+        batch_size_(std::max<size_t>(1, batch_size)),
+        linger_ms_(std::max(0, linger_ms)),
+        max_pending_(std::max(max_pending, batch_size_)),
+        max_batch_bytes_(std::max<size_t>(1, max_batch_bytes)),
+        pending_bytes_(0),
+        running_(false)
+  {
+  }
+
+  size_t ResultBatcher::estimateBytes(const JobResult &result)
+  {
+    // 固定字段约128字节；输出和错误在JSON中可能经base64或转义，按4/3估算
+    return 128 + result.job_id.size() + (result.output.size() + result.error.size()) * 4 / 3;
+  }
+
+  size_t ResultBatcher::batchPrefix(const std::vector<JobResult> &results, size_t batchSize, size_t maxBytes)
+  {
+    size_t count = 0;
+    size_t bytes = 0;
+    while (count < results.size() && count < batchSize)
+    {
+      size_t size = estimateBytes(results[count]);
+      if (count > 0 && bytes + size > maxBytes)
+      {
+        break;
+      }
+      bytes += size;
+      count++;
+    }
+    return count;
+  }
+
+  bool ResultBatcher::batch_ready() const
+  {
+    return pending_.size() >= batch_size_ || pending_bytes_ >= max_batch_bytes_;
+  }
+
+  ResultBatcher::~ResultBatcher()
+  {
+    stop();
+  }
+
+  void ResultBatcher::start()
+  {
+    if (running_)
+    {
+      return;
+    }
+
+    running_ = true;
+    flush_thread_ = std::thread(&ResultBatcher::flush_loop, this);
+  }
+
+  void ResultBatcher::stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!running_)
+      {
+        return;
+      }
+      running_ = false;
+    }
+    cv_.notify_all();
+    space_cv_.notify_all();
+
+    if (flush_thread_.joinable())
+    {
+      flush_thread_.join();
+    }
+  }
+
+  void ResultBatcher::add(const JobResult &result)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // 缓存已满时等待发送线程腾出空间
+    space_cv_.wait(lock, [this]
+                   { return !running_ || pending_.size() < max_pending_; });
+
+    if (!running_)
+    {
+      // 已停止时直接同步发送，保证结果不丢失
+      lock.unlock();
+      sender_({result});
+      return;
+    }
+
+    if (pending_.empty())
+    {
+      first_pending_time_ = std::chrono::steady_clock::now();
+    }
+    pending_.push_back(result);
+    pending_bytes_ += estimateBytes(result);
+
+    // 第一条结果开始计时，攒够一批立即发送
+    if (pending_.size() == 1 || batch_ready())
+    {
+      cv_.notify_one();
+    }
+  }
+
+  void ResultBatcher::flush_loop()
+  {
+    spdlog::info("结果批量发送线程启动, 批量大小: {}, 等待时间: {}ms", batch_size_, linger_ms_);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+      // 等待结果到达、攒够一批或最早一条结果超过等待时间
+      if (pending_.empty())
+      {
+        cv_.wait(lock, [this]
+                 { return !running_ || !pending_.empty(); });
+      }
+      else if (!batch_ready() && running_)
+      {
+        cv_.wait_until(lock, first_pending_time_ + std::chrono::milliseconds(linger_ms_), [this]
+                       { return !running_ || batch_ready(); });
+      }
+
+      if (pending_.empty())
+      {
+        if (!running_)
+        {
+          break;
+        }
+        continue;
+      }
+
+      bool linger_expired = std::chrono::steady_clock::now() >= first_pending_time_ + std::chrono::milliseconds(linger_ms_);
+      if (!batch_ready() && !linger_expired && running_)
+      {
+        continue;
+      }
+
+      // 取出一批结果，发送时不持有锁
+      size_t count = batchPrefix(pending_, batch_size_, max_batch_bytes_);
+      for (size_t i = 0; i < count; ++i)
+      {
+        pending_bytes_ -= estimateBytes(pending_[i]);
+      }
+      std::vector<JobResult> batch(std::make_move_iterator(pending_.begin()),
+                                   std::make_move_iterator(pending_.begin() + count));
+      pending_.erase(pending_.begin(), pending_.begin() + count);
+      if (!pending_.empty())
+      {
+        first_pending_time_ = std::chrono::steady_clock::now();
+      }
+      space_cv_.notify_all();
+
+      lock.unlock();
+      if (!sender_(batch))
+      {
+        spdlog::error("批量发送任务结果失败, 数量: {}", batch.size());
+      }
+      else
+      {
+        spdlog::debug("批量发送任务结果: {}", batch.size());
+      }
+      lock.lock();
+    }
+
+    spdlog::info("结果批量发送线程退出");
+  }
+
+} // namespace scheduler
@@ -0,0 +1,442 @@
+#include "result_spool.h"
+#include <spdlog/spdlog.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+
+namespace scheduler
+{
+
+  ResultSpool::ResultSpool(const std::string &dir, SendFunction sender, size_t batch_size,
+                           size_t segment_bytes, int fsync_interval_ms, int retry_ms,
+                           size_t max_batch_bytes, int max_attempts)
+      : dir_(dir),
+        sender_(std::move(sender)),
+        batch_size_(std::max<size_t>(1, batch_size)),
+        segment_bytes_(std::max<size_t>(4096, segment_bytes)),
+        fsync_interval_ms_(std::max(0, fsync_interval_ms)),
+        retry_ms_(std::max(10, retry_ms)),
+        max_batch_bytes_(std::max<size_t>(1024, max_batch_bytes)),
+        max_attempts_(std::max(1, max_attempts)),
+        fd_(-1),
+        lock_fd_(-1),
+        write_seq_(0),
+        written_bytes_(0),
+        synced_bytes_(0),
+        appended_(0),
+        synced_(0),
+        send_offset_(0),
+        running_(false)
+  {
+  }
+
+  ResultSpool::~ResultSpool()
+  {
+    stop(0);
+  }
+
+  std::string ResultSpool::segmentPath(uint64_t seq) const
+  {
+    char name[32];
+    snprintf(name, sizeof(name), "%020llu.seg", static_cast<unsigned long long>(seq));
+    return dir_ + "/" + name;
+  }
+
+  bool ResultSpool::start()
+  {
+    std::error_code ec;
+    std::filesystem::create_directories(dir_, ec);
+    if (ec)
+    {
+      spdlog::error("创建结果预写日志目录失败: {}, {}", dir_, ec.message());
+      return false;
+    }
+
+    // 同一目录只允许一个执行器使用
+    lock_fd_ = open((dir_ + "/LOCK").c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+    if (lock_fd_ < 0 || flock(lock_fd_, LOCK_EX | LOCK_NB) != 0)
+    {
+      spdlog::error("结果预写日志目录已被占用: {}", dir_);
+      if (lock_fd_ >= 0)
+      {
+        close(lock_fd_);
+        lock_fd_ = -1;
+      }
+      return false;
+    }
+
+    // 恢复上次未发送完的段
+    std::vector<uint64_t> existing;
+    for (const auto &entry : std::filesystem::directory_iterator(dir_, ec))
+    {
+      if (entry.path().extension() == ".seg")
+      {
+        try
+        {
+          existing.push_back(std::stoull(entry.path().stem().string()));
+        }
+        catch (const std::exception &)
+        {
+          spdlog::warn("忽略无法识别的段文件: {}", entry.path().string());
+        }
+      }
+    }
+    std::sort(existing.begin(), existing.end());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    segments_.assign(existing.begin(), existing.end());
+    send_offset_ = 0;
+    if (!openSegment(existing.empty() ? 1 : existing.back() + 1))
+    {
+      return false;
+    }
+
+    running_ = true;
+    sync_thread_ = std::thread(&ResultSpool::sync_loop, this);
+    send_thread_ = std::thread(&ResultSpool::send_loop, this);
+
+    spdlog::info("结果预写日志已启动: {}, 待发送段数: {}", dir_, existing.size());
+    return true;
+  }
+
+  void ResultSpool::stop(int drain_timeout_ms)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!running_)
+      {
+        return;
+      }
+      running_ = false;
+      drain_deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(drain_timeout_ms);
+    }
+    sync_cv_.notify_all();
+    send_cv_.notify_all();
+
+    if (sync_thread_.joinable())
+    {
+      sync_thread_.join();
+    }
+    if (send_thread_.joinable())
+    {
+      send_thread_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ >= 0)
+    {
+      close(fd_);
+      fd_ = -1;
+    }
+    synced_cv_.notify_all();
+
+    // 当前段已全部发送时删除
+    if (segments_.size() == 1 && send_offset_ >= written_bytes_)
+    {
+      unlink(segmentPath(segments_.front()).c_str());
+      segments_.clear();
+    }
+    if (!segments_.empty())
+    {
+      spdlog::warn("结果预写日志中仍有 {} 个段未发送，下次启动时重新发送", segments_.size());
+    }
+
+    if (lock_fd_ >= 0)
+    {
+      close(lock_fd_);
+      lock_fd_ = -1;
+    }
+
+    spdlog::info("结果预写日志已停止");
+  }
+
+  bool ResultSpool::openSegment(uint64_t seq)
+  {
+    std::string path = segmentPath(seq);
+    fd_ = open(path.c_str(), O_CREAT | O_WRONLY | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0)
+    {
+      spdlog::error("创建段文件失败: {}, {}", path, std::strerror(errno));
+      return false;
+    }
+
+    // 目录项落盘，保证崩溃后能找到新段
+    int dir_fd = open(dir_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd >= 0)
+    {
+      fsync(dir_fd);
+      close(dir_fd);
+    }
+
+    write_seq_ = seq;
+    written_bytes_ = 0;
+    synced_bytes_ = 0;
+    segments_.push_back(seq);
+    return true;
+  }
+
+  bool ResultSpool::add(const JobResult &result)
+  {
+    std::string line = result.to_json().dump();
+    line.push_back('\n');
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!running_ || fd_ < 0)
+    {
+      return false;
+    }
+
+    // 当前段已满：落盘后切换到新段
+    if (written_bytes_ > 0 && written_bytes_ + line.size() > segment_bytes_)
+    {
+      if (fdatasync(fd_) != 0)
+      {
+        spdlog::error("段文件落盘失败: {}", std::strerror(errno));
+      }
+      close(fd_);
+      fd_ = -1;
+      synced_ = appended_;
+      synced_cv_.notify_all();
+
+      if (!openSegment(write_seq_ + 1))
+      {
+        return false;
+      }
+      send_cv_.notify_one();
+    }
+
+    size_t written = 0;
+    while (written < line.size())
+    {
+      ssize_t n = write(fd_, line.data() + written, line.size() - written);
+      if (n < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+        // 截掉写了一半的记录，避免和下一条记录拼接
+        spdlog::error("写入段文件失败: {}", std::strerror(errno));
+        if (ftruncate(fd_, static_cast<off_t>(written_bytes_)) != 0)
+        {
+          spdlog::error("截断段文件失败: {}", std::strerror(errno));
+        }
+        return false;
+      }
+      written += static_cast<size_t>(n);
+    }
+    written_bytes_ += line.size();
+    uint64_t seq = ++appended_;
+
+    // 等待同步线程落盘
+    sync_cv_.notify_one();
+    synced_cv_.wait(lock, [this, seq]
+                    { return synced_ >= seq || fd_ < 0; });
+    return synced_ >= seq;
+  }
+
+  void ResultSpool::sync_loop()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+      sync_cv_.wait(lock, [this]
+                    { return !running_ || synced_ < appended_; });
+      if (synced_ >= appended_)
+      {
+        if (!running_)
+        {
+          break;
+        }
+        continue;
+      }
+
+      // 等待一段时间收集并发写入，一次fsync覆盖多条记录
+      if (fsync_interval_ms_ > 0 && running_)
+      {
+        sync_cv_.wait_for(lock, std::chrono::milliseconds(fsync_interval_ms_), [this]
+                          { return !running_; });
+      }
+
+      uint64_t target = appended_;
+      if (fd_ >= 0 && fdatasync(fd_) != 0)
+      {
+        spdlog::error("段文件落盘失败: {}", std::strerror(errno));
+      }
+      synced_ = target;
+      synced_bytes_ = written_bytes_;
+
+      synced_cv_.notify_all();
+      send_cv_.notify_one();
+    }
+  }
+
+  bool ResultSpool::truncateResult(JobResult &result, size_t max_bytes)
+  {
+    size_t size = result.to_json().dump().size();
+    if (size <= max_bytes)
+    {
+      return false;
+    }
+
+    std::string note = "[result truncated: " + std::to_string(result.output.size()) + " bytes of output, " +
+                       std::to_string(result.error.size()) + " bytes of error exceeded the message size limit]";
+    if (result.payload_codec != PayloadCodec::NONE)
+    {
+      result.payload_codec = PayloadCodec::NONE;
+      result.output.clear();
+      result.error = note;
+      return true;
+    }
+
+    // 输出和错误各保留一部分，留出其他字段和JSON转义的余量；截断点退到UTF-8字符边界
+    size_t keep = max_bytes > 1024 ? (max_bytes - 1024) / 4 : 0;
+    for (std::string *text : {&result.output, &result.error})
+    {
+      if (text->size() > keep)
+      {
+        size_t cut = keep;
+        while (cut > 0 && (static_cast<unsigned char>((*text)[cut]) & 0xC0) == 0x80)
+        {
+          cut--;
+        }
+        text->resize(cut);
+      }
+    }
+    result.error += result.error.empty() ? note : "\n" + note;
+    return true;
+  }
+
+  void ResultSpool::send_loop()
+  {
+    spdlog::info("结果发送线程启动, 批量大小: {}", batch_size_);
+
+    size_t limit = batch_size_; // 本次最多读取的记录数，失败后减半
+    int attempts = 0;           // 当前位置连续失败的次数
+
+    while (true)
+    {
+      uint64_t seq;
+      uint64_t offset;
+      uint64_t end;
+      bool sealed;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto pending = [this]
+        { return segments_.size() > 1 || send_offset_ < synced_bytes_; };
+        send_cv_.wait(lock, [this, &pending]
+                      { return !running_ || pending(); });
+
+        // 停止时在截止时间内继续发送剩余记录
+        if (!pending() || (!running_ && std::chrono::steady_clock::now() >= drain_deadline_))
+        {
+          break;
+        }
+
+        seq = segments_.front();
+        offset = send_offset_;
+        sealed = segments_.size() > 1;
+        end = sealed ? std::numeric_limits<uint64_t>::max() : synced_bytes_;
+      }
+
+      std::vector<JobResult> batch;
+      size_t consumed = readBatch(seq, offset, end, limit, batch);
+
+      // 已封存的段全部确认后删除
+      if (consumed == 0)
+      {
+        if (sealed)
+        {
+          unlink(segmentPath(seq).c_str());
+          std::lock_guard<std::mutex> lock(mutex_);
+          segments_.pop_front();
+          send_offset_ = 0;
+          spdlog::debug("段已发送完成: {}", seq);
+        }
+        continue;
+      }
+
+      // 单条记录超过上限且多次发送失败，截断后发送；段文件中仍是原记录
+      if (batch.size() == 1 && attempts >= max_attempts_ && truncateResult(batch[0], max_batch_bytes_))
+      {
+        spdlog::error("任务结果超过消息大小上限且发送失败 {} 次，截断后发送: {}", attempts, batch[0].job_id);
+      }
+
+      if (!batch.empty() && !sender_(batch))
+      {
+        attempts++;
+        if (batch.size() > 1)
+        {
+          limit = std::max<size_t>(1, batch.size() / 2);
+        }
+        spdlog::warn("发送任务结果失败, {}ms后重试, 数量: {}, 连续失败: {}", retry_ms_, batch.size(), attempts);
+        std::unique_lock<std::mutex> lock(mutex_);
+        send_cv_.wait_for(lock, std::chrono::milliseconds(retry_ms_));
+        continue;
+      }
+      // 成功后逐步恢复批量大小
+      attempts = 0;
+      limit = std::min(batch_size_, limit * 2);
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      send_offset_ = offset + consumed;
+    }
+
+    spdlog::info("结果发送线程退出");
+  }
+
+  size_t ResultSpool::readBatch(uint64_t seq, uint64_t offset, uint64_t end, size_t limit, std::vector<JobResult> &batch)
+  {
+    std::ifstream in(segmentPath(seq), std::ios::binary);
+    if (!in)
+    {
+      return 0;
+    }
+    in.seekg(static_cast<std::streamoff>(offset));
+
+    size_t consumed = 0;
+    std::string line;
+    while (batch.size() < limit && offset + consumed < end && std::getline(in, line))
+    {
+      // 崩溃时写了一半的最后一条记录没有换行符，丢弃
+      if (in.eof())
+      {
+        spdlog::warn("丢弃段 {} 末尾不完整的记录", seq);
+        break;
+      }
+      if (offset + consumed + line.size() + 1 > end)
+      {
+        break;
+      }
+      if (!batch.empty() && consumed + line.size() + 1 > max_batch_bytes_)
+      {
+        break;
+      }
+      consumed += line.size() + 1;
+
+      if (line.empty())
+      {
+        continue;
+      }
+      try
+      {
+        batch.push_back(JobResult::from_json(nlohmann::json::parse(line)));
+      }
+      catch (const std::exception &e)
+      {
+        spdlog::error("跳过损坏的结果记录, 段: {}, 错误: {}", seq, e.what());
+      }
+    }
+
+    return consumed;
+  }
+
+} // namespace scheduler
@@ -0,0 +1,201 @@
+#include "shared_library_runner.h"
+#include <spdlog/spdlog.h>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <dlfcn.h>
+
+namespace scheduler
+{
+
+  namespace
+  {
+    // 一次调用的共享状态，执行线程和等待线程共同持有
+    struct CallState
+    {
+      std::mutex mutex;
+      std::condition_variable cv;
+      bool done = false;
+      int exit_status = -1;
+      std::string output;
+      bool truncated = false;
+      size_t max_output_bytes = 0;
+      std::atomic<bool> stop{false};
+      std::string job_id;
+      std::string args;
+    };
+
+    void writeOutput(job_plugin_context *ctx, const char *data, size_t len)
+    {
+      auto *state = static_cast<CallState *>(ctx->host_data);
+      if (!data || len == 0)
+      {
+        return;
+      }
+
+      std::lock_guard<std::mutex> lock(state->mutex);
+      size_t room = state->max_output_bytes > state->output.size() ? state->max_output_bytes - state->output.size() : 0;
+      if (len > room)
+      {
+        len = room;
+        state->truncated = true;
+      }
+      state->output.append(data, len);
+    }
+
+    int isCancelled(job_plugin_context *ctx)
+    {
+      return static_cast<CallState *>(ctx->host_data)->stop.load() ? 1 : 0;
+    }
+
+    // 规范化路径，失败返回空字符串
+    std::string canonicalPath(const std::string &path)
+    {
+      char resolved[PATH_MAX];
+      if (path.empty() || realpath(path.c_str(), resolved) == nullptr)
+      {
+        return "";
+      }
+      return resolved;
+    }
+  } // namespace
+
+  SharedLibraryRunner::SharedLibraryRunner(const std::string &plugin_dir, size_t max_output_bytes)
+      : plugin_dir_(canonicalPath(plugin_dir)), max_output_bytes_(max_output_bytes)
+  {
+  }
+
+  job_plugin_entry SharedLibraryRunner::resolve(const std::string &library_path, const std::string &symbol,
+                                                std::string &error)
+  {
+    // 只允许加载插件目录下的共享库
+    std::string path = canonicalPath(library_path);
+    if (plugin_dir_.empty() || path.empty() || path.compare(0, plugin_dir_.size() + 1, plugin_dir_ + "/") != 0)
+    {
+      error = "Shared library not allowed: " + library_path;
+      return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::string key = path + ":" + symbol;
+    auto entry_it = entries_.find(key);
+    if (entry_it != entries_.end())
+    {
+      return entry_it->second;
+    }
+
+    void *&handle = handles_[path];
+    if (!handle)
+    {
+      handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+      if (!handle)
+      {
+        handles_.erase(path);
+        const char *dl_error = dlerror();
+        error = std::string("Failed to load shared library: ") + (dl_error ? dl_error : path);
+        return nullptr;
+      }
+      spdlog::info("共享库已加载: {}", path);
+    }
+
+    dlerror();
+    auto entry = reinterpret_cast<job_plugin_entry>(dlsym(handle, symbol.c_str()));
+    if (!entry)
+    {
+      const char *dl_error = dlerror();
+      error = std::string("Entry symbol not found: ") + (dl_error ? dl_error : symbol);
+      return nullptr;
+    }
+
+    entries_[key] = entry;
+    return entry;
+  }
+
+  LibraryJobOutcome SharedLibraryRunner::run(const JobInfo &job, int timeout_sec,
+                                             const std::function<bool()> &is_cancelled)
+  {
+    LibraryJobOutcome outcome;
+
+    job_plugin_entry entry = resolve(job.library_path, job.entry_symbol, outcome.error);
+    if (!entry)
+    {
+      return outcome;
+    }
+
+    auto state = std::make_shared<CallState>();
+    state->max_output_bytes = max_output_bytes_;
+    state->job_id = job.job_id;
+    state->args = job.command;
+
+    // 在独立线程中调用入口函数，线程持有state直到函数返回
+    std::thread([state, entry]()
+                {
+      job_plugin_context ctx = {};
+      ctx.abi_version = JOB_PLUGIN_ABI_VERSION;
+      ctx.job_id = state->job_id.c_str();
+      ctx.args = state->args.data();
+      ctx.args_len = state->args.size();
+      ctx.host_data = state.get();
+      ctx.write_output = &writeOutput;
+      ctx.is_cancelled = &isCancelled;
+
+      int exit_status = -1;
+      try
+      {
+        exit_status = entry(&ctx);
+      }
+      catch (...)
+      {
+        spdlog::error("共享库任务抛出异常: {}", state->job_id);
+      }
+
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->exit_status = exit_status;
+      state->done = true;
+      state->cv.notify_all(); })
+        .detach();
+
+    // 等待完成，同时检查超时和取消
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout_sec);
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (!state->done)
+    {
+      if (std::chrono::steady_clock::now() >= deadline)
+      {
+        outcome.timed_out = true;
+        break;
+      }
+      if (is_cancelled && is_cancelled())
+      {
+        outcome.cancelled = true;
+        break;
+      }
+      state->cv.wait_until(lock, std::min(deadline, std::chrono::steady_clock::now() + std::chrono::milliseconds(200)));
+    }
+
+    if (!state->done)
+    {
+      // 通知入口函数尽快返回，不再等待
+      state->stop = true;
+      spdlog::warn("共享库任务未在限定时间内返回: {}", job.job_id);
+    }
+    else
+    {
+      outcome.completed = true;
+      outcome.exit_status = state->exit_status;
+    }
+
+    outcome.output = state->output;
+    if (state->truncated)
+    {
+      outcome.output += "\n[output truncated]";
+    }
+    return outcome;
+  }
+
+} // namespace scheduler
@@ -0,0 +1,337 @@
+#include "warm_worker_pool.h"
+#include <spdlog/spdlog.h>
+#include <array>
+#include <chrono>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+namespace scheduler
+{
+
+  namespace
+  {
+    // 工作进程脚本：读取一帧命令，在子shell中执行，返回退出码、CPU时间和输出。
+    // 协议部分使用LC_ALL=C，保证read -N和${#out}按字节计数；子shell中恢复原始LC_ALL。
+    // 命令替换本身在子shell中执行，EXIT trap在输出末尾追加x<退出码>和times的结果，
+    // 既能拿到exit命令的退出码，也避免命令替换吞掉结尾换行；times不含字符x。
+    // 子shell向cgroup.procs写入0即把自己移入任务cgroup，失败时不执行命令。
+    const char *kWorkerScript = R"(
+orig_lc_all=${LC_ALL-__unset__}
+export LC_ALL=C
+while IFS=' ' read -r len procs_len; do
+  IFS= read -r -N "$len" cmd || exit 1
+  procs=
+  if [ "$procs_len" -gt 0 ]; then IFS= read -r -N "$procs_len" procs || exit 1; fi
+  out=$( trap 's=$?; export LC_ALL=C; printf "x%d " "$s"; times' EXIT
+         if [ -n "$procs" ] && ! { echo 0 > "$procs"; } 2>&1; then echo "Failed to join cgroup"; exit 125; fi
+         if [ "$orig_lc_all" = __unset__ ]; then unset LC_ALL; else export LC_ALL="$orig_lc_all"; fi
+         eval "$cmd" </dev/null 2>&1 )
+  tail=${out##*x}
+  out=${out%x*}
+  usage=${tail#* }
+  printf '%d %d %s\n' "${tail%% *}" "${#out}" "${usage//$'\n'/ }"
+  printf '%s' "$out"
+done
+)";
+
+    // 写入全部数据，工作进程退出时不触发SIGPIPE
+    bool sendAll(int fd, const std::string &data)
+    {
+      size_t sent = 0;
+      while (sent < data.size())
+      {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+          if (errno == EINTR)
+          {
+            continue;
+          }
+          return false;
+        }
+        sent += static_cast<size_t>(n);
+      }
+      return true;
+    }
+  } // namespace
+
+  bool WarmWorkerPool::parseResponseHeader(const std::string &header, WarmJobOutcome &outcome, size_t &output_bytes)
+  {
+    int consumed = 0;
+    if (sscanf(header.c_str(), "%d %zu%n", &outcome.exit_status, &output_bytes, &consumed) != 2)
+    {
+      return false;
+    }
+
+    // 子shell自身和子进程的用户态、内核态时间，格式为<分>m<秒>.<毫秒>s
+    uint64_t cpu_ms = 0;
+    const char *p = header.c_str() + consumed;
+    for (int i = 0; i < 4; ++i)
+    {
+      unsigned long long minutes = 0, seconds = 0, millis = 0;
+      int n = 0;
+      if (sscanf(p, " %llum%llu.%llus%n", &minutes, &seconds, &millis, &n) != 3)
+      {
+        return false;
+      }
+      cpu_ms += minutes * 60000 + seconds * 1000 + millis;
+      p += n;
+    }
+
+    outcome.cpu_time_ms = cpu_ms;
+    return true;
+  }
+
+  WarmWorkerPool::WarmWorkerPool(size_t size, int max_jobs_per_worker)
+      : workers_(std::max<size_t>(1, size)),
+        max_jobs_per_worker_(std::max(1, max_jobs_per_worker)),
+        running_(false)
+  {
+  }
+
+  WarmWorkerPool::~WarmWorkerPool()
+  {
+    stop();
+  }
+
+  bool WarmWorkerPool::start()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_)
+    {
+      return true;
+    }
+
+    for (size_t i = 0; i < workers_.size(); ++i)
+    {
+      if (!spawn(workers_[i]))
+      {
+        for (auto &worker : workers_)
+        {
+          destroy(worker);
+        }
+        idle_.clear();
+        return false;
+      }
+      idle_.push_back(i);
+    }
+
+    running_ = true;
+    spdlog::info("预热工作进程池已启动, 进程数: {}, 单进程最大任务数: {}", workers_.size(), max_jobs_per_worker_);
+    return true;
+  }
+
+  void WarmWorkerPool::stop()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_)
+    {
+      return;
+    }
+
+    // 正在执行任务的工作进程在任务结束后销毁
+    running_ = false;
+    for (size_t index : idle_)
+    {
+      destroy(workers_[index]);
+    }
+    idle_.clear();
+    cv_.notify_all();
+
+    spdlog::info("预热工作进程池已停止");
+  }
+
+  WarmJobOutcome WarmWorkerPool::run(const std::string &command, int timeout_sec,
+                                     const std::function<bool()> &is_cancelled,
+                                     const std::string &cgroup_procs)
+  {
+    WarmJobOutcome outcome;
+
+    // 获取空闲工作进程
+    size_t index;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]
+               { return !running_ || !idle_.empty(); });
+      if (!running_)
+      {
+        outcome.error = "Warm worker pool stopped";
+        return outcome;
+      }
+      index = idle_.back();
+      idle_.pop_back();
+    }
+
+    Worker &worker = workers_[index];
+    bool healthy = worker.pid > 0 || spawn(worker);
+
+    if (!healthy)
+    {
+      outcome.error = "Failed to start warm worker";
+    }
+    else if (!sendAll(worker.fd, std::to_string(command.size()) + " " + std::to_string(cgroup_procs.size()) + "\n" +
+                                     command + cgroup_procs))
+    {
+      healthy = false;
+      outcome.error = "Failed to send command to warm worker";
+    }
+    else
+    {
+      // 读取响应：<响应头>\n<输出>
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout_sec);
+      std::string buffer;
+      std::array<char, 4096> chunk;
+      size_t header_end = std::string::npos;
+      size_t expected = 0;
+
+      while (true)
+      {
+        if (header_end != std::string::npos && buffer.size() >= header_end + 1 + expected)
+        {
+          outcome.completed = true;
+          outcome.output = buffer.substr(header_end + 1, expected);
+          break;
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             deadline - std::chrono::steady_clock::now())
+                             .count();
+        if (remaining <= 0)
+        {
+          outcome.timed_out = true;
+          break;
+        }
+        if (is_cancelled && is_cancelled())
+        {
+          outcome.cancelled = true;
+          break;
+        }
+
+        struct pollfd pfd = {worker.fd, POLLIN, 0};
+        int ret = poll(&pfd, 1, static_cast<int>(std::min<long long>(remaining, 200)));
+        if (ret < 0 && errno != EINTR)
+        {
+          outcome.error = "Failed to poll warm worker";
+          break;
+        }
+        if (ret <= 0)
+        {
+          continue;
+        }
+
+        ssize_t n = read(worker.fd, chunk.data(), chunk.size());
+        if (n < 0 && errno == EINTR)
+        {
+          continue;
+        }
+        if (n <= 0)
+        {
+          outcome.error = "Warm worker exited unexpectedly";
+          break;
+        }
+        buffer.append(chunk.data(), static_cast<size_t>(n));
+
+        // 解析响应头
+        if (header_end == std::string::npos)
+        {
+          header_end = buffer.find('\n');
+          if (header_end != std::string::npos &&
+              !parseResponseHeader(buffer.substr(0, header_end), outcome, expected))
+          {
+            outcome.error = "Malformed response from warm worker";
+            break;
+          }
+        }
+      }
+
+      healthy = outcome.completed;
+      if (healthy)
+      {
+        worker.jobs++;
+      }
+    }
+
+    // 归还工作进程；异常或达到任务上限时重启
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!healthy || worker.jobs >= max_jobs_per_worker_ || !running_)
+    {
+      destroy(worker);
+      if (running_ && !spawn(worker))
+      {
+        spdlog::error("重启预热工作进程失败");
+      }
+    }
+    if (running_)
+    {
+      idle_.push_back(index);
+      cv_.notify_one();
+    }
+
+    return outcome;
+  }
+
+  bool WarmWorkerPool::spawn(Worker &worker)
+  {
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0)
+    {
+      spdlog::error("创建工作进程管道失败: {}", std::strerror(errno));
+      return false;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+      spdlog::error("启动工作进程失败: {}", std::strerror(errno));
+      close(sv[0]);
+      close(sv[1]);
+      return false;
+    }
+
+    if (pid == 0)
+    {
+      // 子进程：标准输入输出都连接到socket，独立进程组便于整体终止
+      setpgid(0, 0);
+      dup2(sv[1], STDIN_FILENO);
+      dup2(sv[1], STDOUT_FILENO);
+      execl("/bin/bash", "bash", "--noprofile", "--norc", "-c", kWorkerScript, static_cast<char *>(nullptr));
+      _exit(127);
+    }
+
+    setpgid(pid, pid);
+    close(sv[1]);
+
+    worker.pid = pid;
+    worker.fd = sv[0];
+    worker.jobs = 0;
+    spdlog::debug("预热工作进程已启动: {}", pid);
+    return true;
+  }
+
+  void WarmWorkerPool::destroy(Worker &worker)
+  {
+    if (worker.pid > 0)
+    {
+      kill(-worker.pid, SIGKILL);
+      while (waitpid(worker.pid, nullptr, 0) < 0 && errno == EINTR)
+      {
+      }
+    }
+    if (worker.fd >= 0)
+    {
+      close(worker.fd);
+    }
+
+    worker.pid = -1;
+    worker.fd = -1;
+    worker.jobs = 0;
+  }
+
+} // namespace scheduler
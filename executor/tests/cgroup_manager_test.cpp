@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "cgroup_manager.h"
+
+using namespace scheduler;
+
+class CgroupManagerTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    dir = (std::filesystem::temp_directory_path() / ("cgroup_manager_test_" + std::to_string(getpid()))).string();
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+  }
+
+  void TearDown() override
+  {
+    std::filesystem::remove_all(dir);
+  }
+
+  void writeFile(const std::string &path, const std::string &content)
+  {
+    std::ofstream file(path);
+    file << content;
+  }
+
+  std::string readFile(const std::string &path)
+  {
+    std::ifstream file(path);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+  }
+
+  JobInfo makeJob(const std::string &id)
+  {
+    JobInfo job;
+    job.job_id = id;
+    job.command = "true";
+    job.cpu_weight = 200;
+    job.memory_limit_mb = 64;
+    return job;
+  }
+
+  std::string dir;
+};
+
+// 父目录不是cgroup2文件系统时不启用，也不创建任务cgroup
+TEST_F(CgroupManagerTest, DisabledOutsideCgroup2)
+{
+  CgroupManager manager(dir + "/jobs");
+  EXPECT_FALSE(manager.init());
+  EXPECT_FALSE(manager.isEnabled());
+  EXPECT_EQ(manager.createJobGroup(makeJob("job-1")), "");
+  EXPECT_FALSE(std::filesystem::exists(dir + "/jobs"));
+}
+
+// 按cgroup v2接口文件的格式解析CPU时间、峰值内存和各设备的IO字节数
+TEST_F(CgroupManagerTest, ReadsUsageFiles)
+{
+  writeFile(dir + "/cpu.stat", "usage_usec 2500000\nuser_usec 2000000\nsystem_usec 500000\n");
+  writeFile(dir + "/memory.peak", "10485760\n");
+  writeFile(dir + "/io.stat",
+            "8:0 rbytes=4096 wbytes=8192 rios=1 wios=2 dbytes=0 dios=0\n"
+            "8:16 rbytes=1024 wbytes=0 rios=1 wios=0 dbytes=0 dios=0\n");
+
+  CgroupManager manager(dir + "/jobs");
+  ResourceUsage usage = manager.readUsage(dir);
+  EXPECT_EQ(usage.cpu_time_ms, 2500u);
+  EXPECT_EQ(usage.peak_rss_kb, 10240u);
+  EXPECT_EQ(usage.io_read_bytes, 5120u);
+  EXPECT_EQ(usage.io_write_bytes, 8192u);
+}
+
+// 旧内核没有memory.peak和io.stat时对应字段为0
+TEST_F(CgroupManagerTest, MissingUsageFilesReadAsZero)
+{
+  writeFile(dir + "/cpu.stat", "usage_usec 1000\n");
+
+  CgroupManager manager(dir + "/jobs");
+  ResourceUsage usage = manager.readUsage(dir);
+  EXPECT_EQ(usage.cpu_time_ms, 1u);
+  EXPECT_EQ(usage.peak_rss_kb, 0u);
+  EXPECT_EQ(usage.io_read_bytes, 0u);
+  EXPECT_EQ(usage.io_write_bytes, 0u);
+}
+
+// 在可写的cgroup2上创建任务cgroup、写入限制并删除，没有权限时跳过
+TEST_F(CgroupManagerTest, CreatesAndRemovesJobGroup)
+{
+  std::string root = "/sys/fs/cgroup/cgroup_manager_test_" + std::to_string(getpid());
+  CgroupManager manager(root);
+  if (!manager.init())
+  {
+    GTEST_SKIP() << "cgroup v2 is not writable here";
+  }
+
+  JobInfo job = makeJob("job-1");
+  job.execution_id = 42;
+  std::string path = manager.createJobGroup(job);
+  ASSERT_EQ(path, root + "/exec_42");
+  EXPECT_EQ(readFile(path + "/cpu.weight"), "200\n");
+  EXPECT_EQ(readFile(path + "/memory.max"), std::to_string(64 * 1024 * 1024) + "\n");
+
+  int fd = manager.openProcsFile(path);
+  EXPECT_GE(fd, 0);
+  if (fd >= 0)
+  {
+    close(fd);
+  }
+
+  // 同一执行ID不能重复创建，同一任务的另一次执行使用独立的cgroup
+  EXPECT_EQ(manager.createJobGroup(job), "");
+  job.execution_id = 43;
+  std::string sibling = manager.createJobGroup(job);
+  ASSERT_EQ(sibling, root + "/exec_43");
+
+  manager.removeJobGroup(path);
+  EXPECT_FALSE(std::filesystem::exists(path));
+  EXPECT_TRUE(std::filesystem::exists(sibling));
+  manager.removeJobGroup(sibling);
+
+  // 没有执行ID时每次创建的路径不同
+  std::string first = manager.createJobGroup(makeJob("job-1"));
+  std::string second = manager.createJobGroup(makeJob("job-1"));
+  EXPECT_FALSE(first.empty());
+  EXPECT_FALSE(second.empty());
+  EXPECT_NE(first, second);
+  manager.removeJobGroup(first);
+  manager.removeJobGroup(second);
+  std::filesystem::remove(root);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "executor.h"
+#include "job.h"
+#include "mock_executor.h"
+
+using namespace scheduler;
+using namespace testing;
+using namespace std::chrono_literals;
+
+class ExecutorDrainTest : public Test
+{
+protected:
+  void SetUp() override
+  {
+    executor = std::make_unique<MockExecutor>("test-executor-drain");
+    EXPECT_CALL(*executor, register_executor()).Times(0);
+    EXPECT_CALL(*executor, unregister_executor()).Times(0);
+    executor->mark_running();
+  }
+
+  void TearDown() override
+  {
+    executor.reset();
+  }
+
+  JobInfo create_test_job(const std::string &job_id)
+  {
+    JobInfo job;
+    job.job_id = job_id;
+    job.name = "Test Job " + job_id;
+    job.command = "true";
+    job.type = JobType::ONCE;
+    job.priority = 0;
+    job.timeout = 10;
+    return job;
+  }
+
+  std::unique_ptr<MockExecutor> executor;
+};
+
+// 没有正在执行的任务时立即返回，排队中的任务被取出退回
+TEST_F(ExecutorDrainTest, DrainsQueuedJobsWithoutWaiting)
+{
+  executor->add_job_to_queue(create_test_job("queued-1"));
+  executor->add_job_to_queue(create_test_job("queued-2"));
+
+  auto start = std::chrono::steady_clock::now();
+  executor->drain();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+  EXPECT_EQ(executor->get_queue_size(), 0u);
+}
+
+// 正在执行的任务结束时唤醒排空等待，不会等到drain_timeout
+TEST_F(ExecutorDrainTest, WakesWhenRunningJobsFinish)
+{
+  const int jobs = 8;
+  for (int i = 0; i < jobs; ++i)
+  {
+    executor->occupy_slot();
+  }
+
+  // 任务几乎同时结束，释放槽位与drain检查条件交错
+  std::vector<std::thread> finishers;
+  for (int i = 0; i < jobs; ++i)
+  {
+    finishers.emplace_back([this, i]
+                           {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50 + i % 2));
+      executor->release_slot(); });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  executor->drain();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  for (auto &finisher : finishers)
+  {
+    finisher.join();
+  }
+  EXPECT_EQ(executor->running_job_count(), 0);
+  EXPECT_LT(elapsed, 5s);
+}
+
+// 重复调用drain不会再次等待
+TEST_F(ExecutorDrainTest, SecondDrainReturnsImmediately)
+{
+  executor->drain();
+  executor->occupy_slot();
+
+  auto start = std::chrono::steady_clock::now();
+  executor->drain();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+  executor->release_slot();
+}
@@ -5,7 +5,11 @@
 #include <chrono>
 #include <string>
 #include <vector>
+#include <csignal>
+#include <unistd.h>
+#include <sys/wait.h>
 #include "executor.h"
+#include "expiring_id_set.h"
 #include "job.h"
 #include "kafka_message_queue.h"
 #include "mock_executor.h"
@@ -122,6 +126,86 @@ TEST_F(JobCancelTest, CancelAlreadyCancelledJob)
   EXPECT_TRUE(executor->is_job_cancelled(job_id));
 }
 
+// 测试取消正在执行的任务会终止其进程组
+TEST_F(JobCancelTest, CancelRunningJobKillsProcess)
+{
+  std::string job_id = "running-job-001";
+
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0)
+  {
+    setpgid(0, 0);
+    execl("/bin/sleep", "sleep", "30", static_cast<char *>(nullptr));
+    _exit(127);
+  }
+  setpgid(pid, pid);
+
+  executor->add_running_job(job_id, pid);
+  executor->cancel_job(job_id);
+
+  int status = 0;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  EXPECT_TRUE(WIFSIGNALED(status));
+  EXPECT_EQ(WTERMSIG(status), SIGKILL);
+  EXPECT_TRUE(executor->is_job_cancelled(job_id));
+
+  executor->remove_running_job(job_id);
+}
+
+// 测试同一任务同时运行的多次执行都会被终止
+TEST_F(JobCancelTest, CancelKillsEveryConcurrentExecution)
+{
+  std::string job_id = "running-job-002";
+
+  std::vector<pid_t> pids;
+  for (int i = 0; i < 2; ++i)
+  {
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+    {
+      setpgid(0, 0);
+      execl("/bin/sleep", "sleep", "30", static_cast<char *>(nullptr));
+      _exit(127);
+    }
+    setpgid(pid, pid);
+    executor->add_running_job(job_id, pid);
+    pids.push_back(pid);
+  }
+
+  executor->cancel_job(job_id);
+
+  for (pid_t pid : pids)
+  {
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFSIGNALED(status));
+    EXPECT_EQ(WTERMSIG(status), SIGKILL);
+  }
+
+  executor->remove_running_job(job_id);
+}
+
+// 测试已取消任务ID超过TTL后过期
+TEST(ExpiringIdSetTest, ExpiresAfterTtl)
+{
+  ExpiringIdSet ids(std::chrono::seconds(8), 4);
+  auto now = ExpiringIdSet::Clock::now();
+
+  ids.insert("job-001", now);
+  ids.insert("job-002", now + 5s);
+  EXPECT_TRUE(ids.contains("job-001", now + 1s));
+  EXPECT_EQ(ids.size(now + 5s), 2u);
+
+  // 超过TTL加一个桶宽度后，第一个ID过期，第二个仍存在
+  EXPECT_FALSE(ids.contains("job-001", now + 11s));
+  EXPECT_TRUE(ids.contains("job-002", now + 11s));
+
+  // 长时间无访问后全部过期
+  EXPECT_EQ(ids.size(now + 60s), 0u);
+}
+
 // 主函数
 int main(int argc, char **argv)
 {
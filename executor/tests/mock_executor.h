@@ -18,12 +18,46 @@ namespace scheduler
     // 暴露protected方法供测试使用
     using JobExecutor::cancel_job;
     using JobExecutor::is_job_cancelled;
+    using JobExecutor::release_slot;
+
+    // 标记为已启动，不启动执行、心跳和消费线程
+    void mark_running()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_ = true;
+    }
+
+    // 模拟开始执行一个任务，占用一个执行槽位
+    void occupy_slot()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_jobs_++;
+    }
+
+    int running_job_count() const
+    {
+      return running_jobs_;
+    }
+
+    // 模拟正在执行的任务进程
+    void add_running_job(const std::string &job_id, pid_t pid)
+    {
+      std::lock_guard<std::mutex> lock(cancel_mutex_);
+      running_pids_.emplace(job_id, pid);
+    }
+
+    // 移除正在执行的任务的全部执行
+    void remove_running_job(const std::string &job_id)
+    {
+      std::lock_guard<std::mutex> lock(cancel_mutex_);
+      running_pids_.erase(job_id);
+    }
 
     // 添加任务到队列
     void add_job_to_queue(const JobInfo &job)
     {
       std::lock_guard<std::mutex> lock(mutex_);
-      job_queue_.push(job);
+      enqueue_job(job);
       cv_.notify_one();
     }
 
@@ -31,24 +65,14 @@ namespace scheduler
     size_t get_queue_size()
     {
       std::lock_guard<std::mutex> lock(mutex_);
-      return job_queue_.size();
+      return queued_jobs();
     }
 
     // 检查队列中是否包含指定ID的任务
     bool queue_contains_job(const std::string &job_id)
     {
       std::lock_guard<std::mutex> lock(mutex_);
-
-      std::queue<JobInfo> temp_queue = job_queue_;
-      while (!temp_queue.empty())
-      {
-        if (temp_queue.front().job_id == job_id)
-        {
-          return true;
-        }
-        temp_queue.pop();
-      }
-      return false;
+      return queued_index_.count(job_id) > 0;
     }
   };
 
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "result_batcher.h"
+
+using namespace scheduler;
+
+class ResultBatcherTest : public ::testing::Test
+{
+protected:
+  ResultBatcher::SendFunction sender()
+  {
+    return [this](const std::vector<JobResult> &results)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      batches.push_back(results);
+      cv.notify_all();
+      return true;
+    };
+  }
+
+  bool waitForResults(size_t count, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000))
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    return cv.wait_for(lock, timeout, [this, count]
+                       { return sentResults() >= count; });
+  }
+
+  size_t sentResults() const
+  {
+    size_t total = 0;
+    for (const auto &batch : batches)
+    {
+      total += batch.size();
+    }
+    return total;
+  }
+
+  JobResult makeResult(const std::string &id, size_t outputSize = 0)
+  {
+    JobResult result;
+    result.job_id = id;
+    result.status = JobStatus::SUCCESS;
+    result.output = std::string(outputSize, 'x');
+    return result;
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<std::vector<JobResult>> batches;
+};
+
+// 攒够batch_size条时不等linger超时立即发送
+TEST_F(ResultBatcherTest, FlushesFullBatchByCount)
+{
+  ResultBatcher batcher(sender(), 3, 60000, 100);
+  batcher.start();
+  for (int i = 0; i < 3; ++i)
+  {
+    batcher.add(makeResult("job-" + std::to_string(i)));
+  }
+
+  ASSERT_TRUE(waitForResults(3));
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(batches.size(), 1u);
+  EXPECT_EQ(batches[0][0].job_id, "job-0");
+  EXPECT_EQ(batches[0][2].job_id, "job-2");
+}
+
+// 不足一批时等到linger超时后发送
+TEST_F(ResultBatcherTest, FlushesPartialBatchAfterLinger)
+{
+  ResultBatcher batcher(sender(), 100, 20, 1000);
+  batcher.start();
+  auto start = std::chrono::steady_clock::now();
+  batcher.add(makeResult("job-1"));
+
+  ASSERT_TRUE(waitForResults(1));
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_EQ(batches.size(), 1u);
+}
+
+// 每批估算大小不超过max_batch_bytes，超过上限的单条结果单独发送
+TEST_F(ResultBatcherTest, SplitsBatchesByBytes)
+{
+  JobResult large = makeResult("job-large", 3000);
+  size_t maxBytes = ResultBatcher::estimateBytes(large) * 2;
+  ResultBatcher batcher(sender(), 100, 20, 1000, maxBytes);
+  batcher.start();
+  for (int i = 0; i < 5; ++i)
+  {
+    batcher.add(makeResult("job-" + std::to_string(i), 3000));
+  }
+  batcher.add(makeResult("job-huge", 30000));
+
+  ASSERT_TRUE(waitForResults(6));
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const auto &batch : batches)
+  {
+    size_t bytes = 0;
+    for (const auto &result : batch)
+    {
+      bytes += ResultBatcher::estimateBytes(result);
+    }
+    EXPECT_TRUE(batch.size() == 1 || bytes <= maxBytes) << "batch of " << batch.size() << " is " << bytes << " bytes";
+  }
+  EXPECT_EQ(batches.back().size(), 1u);
+  EXPECT_EQ(batches.back()[0].job_id, "job-huge");
+}
+
+TEST_F(ResultBatcherTest, BatchPrefixTakesAtLeastOneResult)
+{
+  std::vector<JobResult> results = {makeResult("job-1", 1000), makeResult("job-2")};
+  EXPECT_EQ(ResultBatcher::batchPrefix(results, 10, 1), 1u);
+  EXPECT_EQ(ResultBatcher::batchPrefix(results, 10, 1 << 20), 2u);
+  EXPECT_EQ(ResultBatcher::batchPrefix(results, 1, 1 << 20), 1u);
+}
+
+// 停止时发送剩余结果，停止后add()直接同步发送
+TEST_F(ResultBatcherTest, StopFlushesPendingResults)
+{
+  ResultBatcher batcher(sender(), 100, 60000, 1000);
+  batcher.start();
+  batcher.add(makeResult("job-1"));
+  batcher.add(makeResult("job-2"));
+  batcher.stop();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(sentResults(), 2u);
+  }
+
+  batcher.add(makeResult("job-3"));
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_EQ(sentResults(), 3u);
+  EXPECT_EQ(batches.back()[0].job_id, "job-3");
+}
@@ -0,0 +1,282 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "result_spool.h"
+
+using namespace scheduler;
+using namespace std::chrono_literals;
+
+class ResultSpoolTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    dir = (std::filesystem::temp_directory_path() / ("result_spool_test_" + std::to_string(getpid()))).string();
+    std::filesystem::remove_all(dir);
+  }
+
+  void TearDown() override
+  {
+    std::filesystem::remove_all(dir);
+  }
+
+  JobResult makeResult(int i)
+  {
+    JobResult result;
+    result.job_id = "job-" + std::to_string(i);
+    result.status = JobStatus::SUCCESS;
+    result.output = "output\nwith newline " + std::to_string(i);
+    result.start_time = std::chrono::system_clock::now();
+    result.end_time = result.start_time;
+    return result;
+  }
+
+  size_t segmentCount()
+  {
+    size_t count = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(dir))
+    {
+      count += entry.path().extension() == ".seg" ? 1 : 0;
+    }
+    return count;
+  }
+
+  std::string dir;
+};
+
+// 发送失败时重试，所有结果最终发送且段文件被删除
+TEST_F(ResultSpoolTest, RetriesUntilDelivered)
+{
+  std::mutex mutex;
+  std::set<std::string> delivered;
+  std::atomic<int> failures{3};
+
+  ResultSpool spool(
+      dir, [&](const std::vector<JobResult> &results)
+      {
+        if (failures-- > 0)
+        {
+          return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto &result : results)
+        {
+          delivered.insert(result.job_id);
+        }
+        return true; },
+      10, 4096, 1, 10);
+  ASSERT_TRUE(spool.start());
+
+  for (int i = 0; i < 200; ++i)
+  {
+    ASSERT_TRUE(spool.add(makeResult(i)));
+  }
+  spool.stop(5000);
+
+  EXPECT_EQ(delivered.size(), 200u);
+  EXPECT_EQ(segmentCount(), 0u);
+}
+
+// broker不可用时结果保留在磁盘上，重启后重新发送
+TEST_F(ResultSpoolTest, RecoversUnsentSegments)
+{
+  {
+    ResultSpool spool(
+        dir, [](const std::vector<JobResult> &)
+        { return false; },
+        10, 4096, 1, 10);
+    ASSERT_TRUE(spool.start());
+    for (int i = 0; i < 50; ++i)
+    {
+      ASSERT_TRUE(spool.add(makeResult(i)));
+    }
+    spool.stop(0);
+  }
+  EXPECT_GT(segmentCount(), 0u);
+
+  std::set<std::string> delivered;
+  ResultSpool spool(
+      dir, [&](const std::vector<JobResult> &results)
+      {
+        for (const auto &result : results)
+        {
+          delivered.insert(result.job_id);
+        }
+        return true; },
+      10, 4096, 1, 10);
+  ASSERT_TRUE(spool.start());
+  spool.stop(5000);
+
+  EXPECT_EQ(delivered.size(), 50u);
+  EXPECT_EQ(segmentCount(), 0u);
+}
+
+// 同一目录不能被两个实例同时使用
+TEST_F(ResultSpoolTest, DirectoryIsExclusive)
+{
+  auto sender = [](const std::vector<JobResult> &)
+  { return true; };
+  ResultSpool first(dir, sender, 10, 4096, 1, 10);
+  ResultSpool second(dir, sender, 10, 4096, 1, 10);
+
+  ASSERT_TRUE(first.start());
+  EXPECT_FALSE(second.start());
+  first.stop(1000);
+}
+
+// 多条合并后一直发送失败时拆小批次，所有结果最终发送
+TEST_F(ResultSpoolTest, SplitsBatchesThatKeepFailing)
+{
+  // 先在broker不可用时积压结果，重启后按完整批次读取
+  {
+    ResultSpool spool(
+        dir, [](const std::vector<JobResult> &)
+        { return false; },
+        16, 1 << 20, 1, 10);
+    ASSERT_TRUE(spool.start());
+    for (int i = 0; i < 40; ++i)
+    {
+      ASSERT_TRUE(spool.add(makeResult(i)));
+    }
+    spool.stop(0);
+  }
+
+  std::mutex mutex;
+  std::set<std::string> delivered;
+  std::atomic<size_t> largest{0};
+  std::atomic<int> rejected{0};
+
+  // 模拟broker的消息大小上限：超过2条的批次总是被拒绝
+  ResultSpool spool(
+      dir, [&](const std::vector<JobResult> &results)
+      {
+        if (results.size() > 2)
+        {
+          rejected++;
+          return false;
+        }
+        largest = std::max(largest.load(), results.size());
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto &result : results)
+        {
+          delivered.insert(result.job_id);
+        }
+        return true; },
+      16, 1 << 20, 1, 10);
+  ASSERT_TRUE(spool.start());
+  spool.stop(5000);
+
+  EXPECT_EQ(delivered.size(), 40u);
+  EXPECT_GT(rejected.load(), 0);
+  EXPECT_EQ(largest.load(), 2u);
+  EXPECT_EQ(segmentCount(), 0u);
+}
+
+// 每批的记录总字节数不超过max_batch_bytes
+TEST_F(ResultSpoolTest, CapsBatchesByBytes)
+{
+  std::mutex mutex;
+  size_t delivered = 0;
+  size_t largest = 0;
+
+  ResultSpool spool(
+      dir, [&](const std::vector<JobResult> &results)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        delivered += results.size();
+        largest = std::max(largest, results.size());
+        return true; },
+      100, 1 << 20, 1, 10, 8192);
+  ASSERT_TRUE(spool.start());
+  for (int i = 0; i < 20; ++i)
+  {
+    JobResult result = makeResult(i);
+    result.output = std::string(3000, 'o');
+    ASSERT_TRUE(spool.add(result));
+  }
+  spool.stop(5000);
+
+  EXPECT_EQ(delivered, 20u);
+  EXPECT_LE(largest, 2u);
+}
+
+// 超过上限的单条结果多次失败后截断发送，不阻塞后面的结果
+TEST_F(ResultSpoolTest, TruncatesOversizedResultAfterRetries)
+{
+  std::mutex mutex;
+  std::vector<JobResult> delivered;
+  std::atomic<int> rejected{0};
+
+  ResultSpool spool(
+      dir, [&](const std::vector<JobResult> &results)
+      {
+        for (const auto &result : results)
+        {
+          if (result.output.size() > 4096)
+          {
+            rejected++;
+            return false;
+          }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        delivered.insert(delivered.end(), results.begin(), results.end());
+        return true; },
+      10, 1 << 20, 1, 10, 8192, 3);
+  ASSERT_TRUE(spool.start());
+
+  JobResult large = makeResult(0);
+  large.output = std::string(100000, 'x');
+  ASSERT_TRUE(spool.add(large));
+  ASSERT_TRUE(spool.add(makeResult(1)));
+  spool.stop(5000);
+
+  ASSERT_EQ(delivered.size(), 2u);
+  EXPECT_EQ(rejected.load(), 3);
+  EXPECT_EQ(delivered[0].job_id, "job-0");
+  EXPECT_LT(delivered[0].output.size(), 8192u);
+  EXPECT_NE(delivered[0].error.find("100000 bytes of output"), std::string::npos) << delivered[0].error;
+  EXPECT_EQ(delivered[1].job_id, "job-1");
+  EXPECT_EQ(segmentCount(), 0u);
+}
+
+TEST_F(ResultSpoolTest, TruncateResultKeepsSmallResultsAndUtf8)
+{
+  JobResult small = makeResult(0);
+  JobResult copy = small;
+  EXPECT_FALSE(ResultSpool::truncateResult(copy, 8192));
+  EXPECT_EQ(copy.output, small.output);
+
+  // 截断点落在多字节字符中间时退到字符开头
+  JobResult text = makeResult(1);
+  text.output.clear();
+  for (int i = 0; i < 5000; ++i)
+  {
+    text.output += "\xe4\xb8\xad";
+  }
+  ASSERT_TRUE(ResultSpool::truncateResult(text, 4096));
+  EXPECT_EQ(text.output.size() % 3, 0u);
+  EXPECT_NO_THROW(text.to_json().dump());
+  EXPECT_LE(text.to_json().dump().size(), 4096u);
+
+  // 压缩的输出不能部分保留
+  JobResult compressed = makeResult(2);
+  compressed.payload_codec = PayloadCodec::ZSTD;
+  compressed.output = std::string(10000, '\x01');
+  ASSERT_TRUE(ResultSpool::truncateResult(compressed, 4096));
+  EXPECT_EQ(compressed.payload_codec, PayloadCodec::NONE);
+  EXPECT_TRUE(compressed.output.empty());
+  EXPECT_NE(compressed.error.find("10000 bytes of output"), std::string::npos);
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "shared_library_runner.h"
+
+using namespace scheduler;
+
+// 测试插件由CMake构建，路径通过TEST_PLUGIN_PATH传入
+class SharedLibraryRunnerTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    dir = std::filesystem::temp_directory_path() / ("shared_library_runner_test_" + std::to_string(getpid()));
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "plugins");
+    plugin = (dir / "plugins" / "test_job_plugin.so").string();
+    std::filesystem::copy_file(TEST_PLUGIN_PATH, plugin);
+    runner = std::make_unique<SharedLibraryRunner>((dir / "plugins").string(), 4096);
+  }
+
+  void TearDown() override
+  {
+    std::filesystem::remove_all(dir);
+  }
+
+  JobInfo makeJob(const std::string &symbol, const std::string &args, const std::string &library = "")
+  {
+    JobInfo job;
+    job.job_id = "plugin-job";
+    job.exec_type = JobExecType::SHARED_LIBRARY;
+    job.library_path = library.empty() ? plugin : library;
+    job.entry_symbol = symbol;
+    job.command = args;
+    return job;
+  }
+
+  LibraryJobOutcome run(const JobInfo &job, int timeout_sec = 10)
+  {
+    return runner->run(job, timeout_sec, []
+                       { return false; });
+  }
+
+  std::filesystem::path dir;
+  std::string plugin;
+  std::unique_ptr<SharedLibraryRunner> runner;
+};
+
+TEST_F(SharedLibraryRunnerTest, RunsEntryAndCollectsOutput)
+{
+  LibraryJobOutcome outcome = run(makeJob("echo_args", std::string("hello\0world", 11)));
+  ASSERT_TRUE(outcome.completed) << outcome.error;
+  EXPECT_EQ(outcome.exit_status, 0);
+  EXPECT_EQ(outcome.output, std::string("hello\0world", 11));
+
+  // 再次执行使用缓存的入口函数
+  outcome = run(makeJob("echo_args", "again"));
+  ASSERT_TRUE(outcome.completed) << outcome.error;
+  EXPECT_EQ(outcome.output, "again");
+}
+
+TEST_F(SharedLibraryRunnerTest, ReturnsExitStatus)
+{
+  LibraryJobOutcome outcome = run(makeJob("exit_with", "7"));
+  ASSERT_TRUE(outcome.completed) << outcome.error;
+  EXPECT_EQ(outcome.exit_status, 7);
+}
+
+// 输出超过上限时截断并标记
+TEST_F(SharedLibraryRunnerTest, TruncatesOutput)
+{
+  LibraryJobOutcome outcome = run(makeJob("write_bytes", "10000"));
+  ASSERT_TRUE(outcome.completed) << outcome.error;
+  EXPECT_EQ(outcome.output, std::string(4096, 'z') + "\n[output truncated]");
+}
+
+// 超时后设置取消标志，入口函数检查到后返回
+TEST_F(SharedLibraryRunnerTest, TimesOutAndSignalsEntry)
+{
+  LibraryJobOutcome outcome = run(makeJob("wait_for_cancel", ""), 1);
+  EXPECT_TRUE(outcome.timed_out);
+  EXPECT_FALSE(outcome.completed);
+}
+
+TEST_F(SharedLibraryRunnerTest, CancelsRunningEntry)
+{
+  std::atomic<bool> cancelled{false};
+  std::thread canceller([&cancelled]
+                        {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    cancelled = true; });
+
+  LibraryJobOutcome outcome = runner->run(makeJob("wait_for_cancel", ""), 10, [&cancelled]
+                                          { return cancelled.load(); });
+  canceller.join();
+  EXPECT_TRUE(outcome.cancelled);
+  EXPECT_FALSE(outcome.completed);
+}
+
+// 入口函数抛出异常时按失败处理，不影响执行器
+TEST_F(SharedLibraryRunnerTest, EntryExceptionIsFailure)
+{
+  LibraryJobOutcome outcome = run(makeJob("throw_error", ""));
+  ASSERT_TRUE(outcome.completed);
+  EXPECT_EQ(outcome.exit_status, -1);
+}
+
+TEST_F(SharedLibraryRunnerTest, RejectsMissingSymbol)
+{
+  LibraryJobOutcome outcome = run(makeJob("no_such_entry", ""));
+  EXPECT_FALSE(outcome.completed);
+  EXPECT_NE(outcome.error.find("Entry symbol not found"), std::string::npos) << outcome.error;
+}
+
+TEST_F(SharedLibraryRunnerTest, RejectsInvalidLibrary)
+{
+  std::string bogus = (dir / "plugins" / "bogus.so").string();
+  std::ofstream(bogus) << "not a shared library";
+
+  LibraryJobOutcome outcome = run(makeJob("echo_args", "", bogus));
+  EXPECT_FALSE(outcome.completed);
+  EXPECT_NE(outcome.error.find("Failed to load shared library"), std::string::npos) << outcome.error;
+
+  outcome = run(makeJob("echo_args", "", (dir / "plugins" / "missing.so").string()));
+  EXPECT_FALSE(outcome.completed);
+  EXPECT_NE(outcome.error.find("not allowed"), std::string::npos) << outcome.error;
+}
+
+// 插件目录之外的共享库不允许加载，包括指向目录外的符号链接
+TEST_F(SharedLibraryRunnerTest, RejectsLibraryOutsidePluginDir)
+{
+  std::string outside = (dir / "outside.so").string();
+  std::filesystem::copy_file(plugin, outside);
+  std::filesystem::create_symlink(outside, dir / "plugins" / "link.so");
+
+  LibraryJobOutcome outcome = run(makeJob("echo_args", "x", outside));
+  EXPECT_FALSE(outcome.completed);
+  EXPECT_NE(outcome.error.find("not allowed"), std::string::npos) << outcome.error;
+
+  outcome = run(makeJob("echo_args", "x", (dir / "plugins" / "link.so").string()));
+  EXPECT_FALSE(outcome.completed);
+  EXPECT_NE(outcome.error.find("not allowed"), std::string::npos) << outcome.error;
+
+  outcome = run(makeJob("echo_args", "x", (dir / "plugins" / ".." / "outside.so").string()));
+  EXPECT_FALSE(outcome.completed);
+}
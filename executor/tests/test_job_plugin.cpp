@@ -0,0 +1,54 @@
+// 共享库任务测试用插件
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "job_plugin.h"
+
+extern "C"
+{
+
+  // 原样输出参数
+  int echo_args(job_plugin_context *ctx)
+  {
+    ctx->write_output(ctx, ctx->args, ctx->args_len);
+    return 0;
+  }
+
+  // 以参数作为退出码
+  int exit_with(job_plugin_context *ctx)
+  {
+    std::string args(ctx->args, ctx->args_len);
+    return std::atoi(args.c_str());
+  }
+
+  // 输出参数指定的字节数，分多次写入
+  int write_bytes(job_plugin_context *ctx)
+  {
+    size_t total = std::strtoul(std::string(ctx->args, ctx->args_len).c_str(), nullptr, 10);
+    std::string chunk(1000, 'z');
+    for (size_t written = 0; written < total; written += chunk.size())
+    {
+      ctx->write_output(ctx, chunk.data(), std::min(chunk.size(), total - written));
+    }
+    return 0;
+  }
+
+  // 一直运行到被取消
+  int wait_for_cancel(job_plugin_context *ctx)
+  {
+    while (!ctx->is_cancelled(ctx))
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return 1;
+  }
+
+  int throw_error(job_plugin_context *)
+  {
+    throw std::runtime_error("plugin failure");
+  }
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "cgroup_manager.h"
+#include "warm_worker_pool.h"
+
+using namespace scheduler;
+
+class WarmWorkerPoolTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    pool = std::make_unique<WarmWorkerPool>(2, 100);
+    ASSERT_TRUE(pool->start());
+  }
+
+  void TearDown() override
+  {
+    pool->stop();
+  }
+
+  WarmJobOutcome run(const std::string &command, int timeout_sec = 10)
+  {
+    return pool->run(command, timeout_sec, []
+                     { return false; });
+  }
+
+  std::unique_ptr<WarmWorkerPool> pool;
+};
+
+TEST(WarmWorkerPoolProtocolTest, ParsesResponseHeader)
+{
+  WarmJobOutcome outcome;
+  size_t bytes = 0;
+  ASSERT_TRUE(WarmWorkerPool::parseResponseHeader("3 42 0m0.010s 0m0.002s 1m2.500s 0m0.001s", outcome, bytes));
+  EXPECT_EQ(outcome.exit_status, 3);
+  EXPECT_EQ(bytes, 42u);
+  EXPECT_EQ(outcome.cpu_time_ms, 10u + 2u + 62500u + 1u);
+}
+
+TEST(WarmWorkerPoolProtocolTest, RejectsMalformedHeader)
+{
+  WarmJobOutcome outcome;
+  size_t bytes = 0;
+  EXPECT_FALSE(WarmWorkerPool::parseResponseHeader("", outcome, bytes));
+  EXPECT_FALSE(WarmWorkerPool::parseResponseHeader("0 5", outcome, bytes));
+  EXPECT_FALSE(WarmWorkerPool::parseResponseHeader("0 5 0m0.000s 0m0.000s 0m0.000s", outcome, bytes));
+  EXPECT_FALSE(WarmWorkerPool::parseResponseHeader("abc 5 0m0.000s 0m0.000s 0m0.000s 0m0.000s", outcome, bytes));
+}
+
+// 输出按字节原样返回，包括结尾换行、多字节字符和标准错误
+TEST_F(WarmWorkerPoolTest, ReturnsOutputVerbatim)
+{
+  WarmJobOutcome outcome = run("printf 'a\\n\\n'; printf '\\xc3\\xa9x'; echo err >&2");
+  ASSERT_TRUE(outcome.completed) << outcome.error;
+  EXPECT_EQ(outcome.exit_status, 0);
+  EXPECT_EQ(outcome.output, "a\n\n\xc3\xa9xerr\n");
+}
+
+// 大于一次读取的输出需要多次读取拼接
+TEST_F(WarmWorkerPoolTest, ReturnsLargeOutput)
+{
+  WarmJobOutcome outcome = run("head -c 100000 /dev/zero | tr '\\0' 'y'");
+  ASSERT_TRUE(outcome.completed) << outcome.error;
+  EXPECT_EQ(outcome.output, std::string(100000, 'y'));
+}
+
+// exit命令只退出子shell，工作进程继续处理后续任务
+TEST_F(WarmWorkerPoolTest, ReportsExitStatus)
+{
+  for (int i = 0; i < 4; ++i)
+  {
+    WarmJobOutcome outcome = run("echo before; exit 3");
+    ASSERT_TRUE(outcome.completed) << outcome.error;
+    EXPECT_EQ(outcome.exit_status, 3);
+    EXPECT_EQ(outcome.output, "before\n");
+  }
+
+  WarmJobOutcome outcome = run("false");
+  ASSERT_TRUE(outcome.completed);
+  EXPECT_EQ(outcome.exit_status, 1);
+}
+
+// 报告执行命令消耗的CPU时间
+TEST_F(WarmWorkerPoolTest, ReportsCpuTime)
+{
+  WarmJobOutcome outcome = run("i=0; while [ $i -lt 200000 ]; do i=$((i+1)); done");
+  ASSERT_TRUE(outcome.completed) << outcome.error;
+  EXPECT_GT(outcome.cpu_time_ms, 0u);
+}
+
+// 超时后工作进程被重启，后续任务不受影响
+TEST_F(WarmWorkerPoolTest, TimesOutAndRecyclesWorker)
+{
+  auto start = std::chrono::steady_clock::now();
+  WarmJobOutcome outcome = run("sleep 30", 1);
+  EXPECT_TRUE(outcome.timed_out);
+  EXPECT_FALSE(outcome.completed);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+
+  for (int i = 0; i < 3; ++i)
+  {
+    WarmJobOutcome next = run("echo ok");
+    ASSERT_TRUE(next.completed) << next.error;
+    EXPECT_EQ(next.output, "ok\n");
+  }
+}
+
+TEST_F(WarmWorkerPoolTest, CancelsRunningCommand)
+{
+  std::atomic<bool> cancelled{false};
+  std::thread canceller([&cancelled]
+                        {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    cancelled = true; });
+
+  WarmJobOutcome outcome = pool->run("sleep 30", 10, [&cancelled]
+                                     { return cancelled.load(); });
+  canceller.join();
+  EXPECT_TRUE(outcome.cancelled);
+
+  WarmJobOutcome next = run("echo ok");
+  ASSERT_TRUE(next.completed) << next.error;
+  EXPECT_EQ(next.output, "ok\n");
+}
+
+// 每个工作进程执行max_jobs_per_worker个任务后重启
+TEST(WarmWorkerPoolRecycleTest, RecyclesAfterMaxJobs)
+{
+  WarmWorkerPool pool(1, 2);
+  ASSERT_TRUE(pool.start());
+
+  std::vector<std::string> pids;
+  for (int i = 0; i < 4; ++i)
+  {
+    WarmJobOutcome outcome = pool.run("echo $$", 10, []
+                                      { return false; });
+    ASSERT_TRUE(outcome.completed) << outcome.error;
+    pids.push_back(outcome.output);
+  }
+  pool.stop();
+
+  EXPECT_EQ(pids[0], pids[1]);
+  EXPECT_NE(pids[1], pids[2]);
+  EXPECT_EQ(pids[2], pids[3]);
+}
+
+TEST(WarmWorkerPoolRecycleTest, RunAfterStopFails)
+{
+  WarmWorkerPool pool(1, 10);
+  ASSERT_TRUE(pool.start());
+  pool.stop();
+
+  WarmJobOutcome outcome = pool.run("echo ok", 10, []
+                                    { return false; });
+  EXPECT_FALSE(outcome.completed);
+  EXPECT_EQ(outcome.error, "Warm worker pool stopped");
+}
+
+// 子shell无法加入cgroup时不执行命令
+TEST_F(WarmWorkerPoolTest, FailsWhenCgroupCannotBeJoined)
+{
+  WarmJobOutcome outcome = pool->run("echo ran", 10, []
+                                     { return false; },
+                                     "/nonexistent/cgroup.procs");
+  ASSERT_TRUE(outcome.completed) << outcome.error;
+  EXPECT_EQ(outcome.exit_status, 125);
+  EXPECT_EQ(outcome.output.find("ran"), std::string::npos);
+}
+
+// 在可写的cgroup2上命令运行在任务cgroup中，没有权限时跳过
+TEST_F(WarmWorkerPoolTest, JoinsJobCgroup)
+{
+  std::string root = "/sys/fs/cgroup/warm_worker_pool_test_" + std::to_string(getpid());
+  CgroupManager manager(root);
+  if (!manager.init())
+  {
+    GTEST_SKIP() << "cgroup v2 is not writable here";
+  }
+
+  JobInfo job;
+  job.job_id = "warm-job";
+  job.memory_limit_mb = 64;
+  std::string path = manager.createJobGroup(job);
+  ASSERT_FALSE(path.empty());
+
+  WarmJobOutcome outcome = pool->run("cat /proc/self/cgroup", 10, []
+                                     { return false; },
+                                     path + "/cgroup.procs");
+  ASSERT_TRUE(outcome.completed) << outcome.error;
+  EXPECT_EQ(outcome.exit_status, 0);
+  EXPECT_NE(outcome.output.find("warm_worker_pool_test_"), std::string::npos) << outcome.output;
+
+  manager.removeJobGroup(path);
+  std::filesystem::remove(root);
+}
@@ -5,6 +5,7 @@
 #include <functional>
 #include <map>
 #include "job_dao.h"
+#include "scheduler.h"
 
 // 前向声明
 namespace httplib
@@ -22,8 +23,9 @@ namespace scheduler
   public:
     /**
      * @brief 构造函数
+     * @param scheduler 调度器实例的引用
      */
-    ExecutorApiHandler();
+    ExecutorApiHandler(JobScheduler &scheduler);
 
     /**
      * @brief 处理执行器API请求
@@ -54,6 +56,12 @@ namespace scheduler
     // 获取执行器任务列表
     std::string getExecutorTasks(const std::string &executorId, const httplib::Params &params);
 
+    // 排空执行器
+    std::string drainExecutor(const std::string &executorId);
+
+    // 调度器实例
+    JobScheduler &scheduler_;
+
     // 数据访问对象
     std::unique_ptr<JobDAO> jobDao_;
   };
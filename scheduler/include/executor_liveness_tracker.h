@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+
+namespace scheduler
+{
+
+  // 执行器健康状态
+  enum class ExecutorHealth
+  {
+    ALIVE,   // 正常
+    SUSPECT, // 疑似故障，不再分配新任务
+    DEAD     // 判定故障，重新派发其上的任务
+  };
+
+  /**
+   * @brief 执行器存活状态跟踪（phi accrual故障检测）
+   *
+   * 调度器从executor-heartbeat主题接收心跳，按执行器记录最近window_size个
+   * 心跳间隔的均值和标准差。距上次心跳的时间越超出历史间隔，phi越大：
+   *   phi = -log10(P(间隔 > 已等待时间))
+   * phi超过suspect_threshold判定为疑似故障，超过dead_threshold判定为故障。
+   * 没有足够历史时按expected_interval估计。
+   *
+   * 数据库中的executor_node只由主节点更新：takeHeartbeats()返回上次调用以来
+   * 收到过心跳的执行器，用于批量刷新last_heartbeat；detect()返回状态变化。
+   */
+  class ExecutorLivenessTracker
+  {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+      std::chrono::milliseconds expected_interval{30000}; // 心跳间隔的初始估计
+      std::chrono::milliseconds min_std_deviation{2000};  // 标准差下限，避免间隔过于稳定时误判
+      std::chrono::milliseconds acceptable_pause{5000};   // 额外容忍的停顿
+      double suspect_threshold = 3.0;
+      double dead_threshold = 8.0;
+      size_t window_size = 100;
+    };
+
+    // 一次检测的状态变化
+    struct Changes
+    {
+      std::vector<std::string> dead;      // 新判定为故障
+      std::vector<std::string> recovered; // 故障后恢复心跳
+    };
+
+    explicit ExecutorLivenessTracker(const Options &options);
+
+    // 记录心跳
+    void heartbeat(const std::string &executorId, Clock::time_point now = Clock::now());
+
+    // 当前phi值；没有收到过心跳的执行器返回0
+    double phi(const std::string &executorId, Clock::time_point now = Clock::now()) const;
+
+    // 当前健康状态；没有收到过心跳的执行器视为正常
+    ExecutorHealth health(const std::string &executorId, Clock::time_point now = Clock::now()) const;
+
+    // 是否疑似故障或已故障，选择执行器时跳过
+    bool isSuspect(const std::string &executorId, Clock::time_point now = Clock::now()) const;
+
+    // 检测状态变化，每个变化只返回一次
+    Changes detect(Clock::time_point now = Clock::now());
+
+    // 取出上次调用以来收到过心跳的执行器
+    std::vector<std::string> takeHeartbeats();
+
+    // 移除执行器（注销时调用）
+    void remove(const std::string &executorId);
+
+  private:
+    struct Entry
+    {
+      Clock::time_point last_seen;
+      std::deque<double> intervals; // 心跳间隔（毫秒）
+      double sum = 0;
+      double sum_squares = 0;
+      bool dirty = false; // 上次takeHeartbeats后收到过心跳
+      bool dead = false;  // 已通过detect上报为故障
+    };
+
+    double phiOf(const Entry &entry, Clock::time_point now) const;
+
+    Options options_;
+    std::unordered_map<std::string, Entry> entries_;
+    mutable std::mutex mutex_;
+  };
+
+} // namespace scheduler
@@ -9,8 +9,12 @@
 #include <condition_variable>
 #include "job.h"
 #include "job_dao.h"
-#include "kafka_message_queue.h"
+#include "message_transport.h"
+#include "priority_lanes.h"
 #include "zk_registry.h"
+#include "work_lease_manager.h"
+#include "executor_liveness_tracker.h"
+#include "write_behind_buffer.h"
 
 namespace scheduler
 {
@@ -26,6 +30,13 @@ namespace scheduler
     LEAST_LOAD   // 最少负载
   };
 
+  // 任务分发模式
+  enum class DispatchMode
+  {
+    PUSH, // 调度器选择执行器并推送任务
+    PULL  // 执行器按空闲槽位申请任务
+  };
+
   class JobScheduler
   {
   public:
@@ -52,6 +63,9 @@ namespace scheduler
     // 获取当前执行器选择策略
     ExecutorSelectionStrategy get_executor_selection_strategy() const;
 
+    // 排空执行器：不再向其派发任务，并通知执行器退回排队任务后退出
+    bool drain_executor(const std::string &executor_id);
+
     // 获取节点状态
     bool is_leader() const;
     std::string get_node_id() const;
@@ -61,10 +75,36 @@ namespace scheduler
     void schedule_loop();
     // 检查任务是否需要执行
     bool should_execute(const JobInfo &job);
-    // 分发任务到执行器
-    void dispatch_job(const JobInfo &job);
-    // 处理执行结果
-    void handle_result(const JobResult &result);
+    // 分发任务到执行器，返回是否已选定执行器；执行记录异步写入，写入完成后再发送任务
+    bool dispatch_job(const JobInfo &job);
+    // 执行记录写入后发送任务，写入或发送失败时撤销派发
+    void send_dispatched_job(const JobInfo &job, const std::string &executor_id, uint64_t execution_id);
+    // 撤销未发出的派发，拉取模式下退还credit并把任务放回队列
+    void abort_dispatch(const JobInfo &job, const std::string &executor_id);
+    // 批量处理执行结果：带执行ID和执行器ID的结果异步写入，其余的查询执行记录后在一个事务中写入
+    void handle_results(const std::vector<JobResult> &results);
+    // 执行结果入库后更新执行器负载和统计，result.executor_id为执行记录上的执行器；
+    // 可能在异步引擎的事件循环线程中调用，不访问数据库
+    void finish_execution(const JobResult &result);
+    // 处理执行器的工作请求（拉取模式）
+    void handle_work_request(const std::string &payload);
+    // 是否有可派发的任务
+    bool has_dispatchable_jobs();
+    // 存活检测线程函数：主节点检测执行器故障，并定期批量写入心跳时间
+    void liveness_loop();
+    // 重新派发故障执行器上未完成的任务
+    void redispatch_in_flight(const std::string &executor_id);
+    // 结束执行记录并把任务放回待派发队列
+    void requeue_executions(const std::string &executor_id, const std::vector<JobResult> &executions,
+                            const std::string &reason);
+    // 处理排空执行器退回的任务
+    void handle_job_return(const std::string &payload);
+    // 写缓冲线程函数：定期或缓冲满时写入合并后的执行状态和执行器计数
+    void write_behind_loop();
+    // 同步写入缓冲的更新，失败的部分放回缓冲区
+    bool flush_write_behind();
+    // 调用方需持有write_behind_mutex_
+    bool flush_write_behind_locked();
 
     // 主备切换相关
     void leader_election_loop();
@@ -76,18 +116,31 @@ namespace scheduler
     std::unique_ptr<JobQueue> job_queue_;
     std::unique_ptr<ExecutorRegistry> executor_registry_;
     std::unique_ptr<JobDAO> job_storage_;
-    std::unique_ptr<KafkaMessageQueue> kafka_client_;
+    std::unique_ptr<MessageTransport> kafka_client_;
+    PriorityLanes priority_lanes_; // 按任务优先级选择执行器任务主题
     std::shared_ptr<ZkRegistry> zk_registry_;
+    std::unique_ptr<WorkLeaseManager> work_leases_;
+    std::unique_ptr<ExecutorLivenessTracker> liveness_;
+    std::unique_ptr<MessageTransport> heartbeat_client_; // 每个节点独立消费组，接收全部心跳
+    std::unique_ptr<MessageTransport> credit_client_;    // 拉取模式下每个节点独立消费组，接收全部工作请求
+    std::unique_ptr<WriteBehindBuffer> write_behind_;    // 执行器计数的延迟写
 
     bool running_;
     std::thread schedule_thread_;
     std::thread election_thread_;
+    std::thread liveness_thread_;
+    std::thread write_behind_thread_;
+    std::mutex write_behind_mutex_; // 串行化刷新，保证批次按取出顺序写入
     mutable std::mutex mutex_;
     std::condition_variable cv_;
+    std::condition_variable liveness_cv_; // 存活检测线程单独等待，不占用调度线程的唤醒
 
     // 执行器选择策略
     ExecutorSelectionStrategy executor_selection_strategy_;
 
+    // 任务分发模式
+    DispatchMode dispatch_mode_;
+
     // 节点标识
     std::string node_id_;
     bool is_leader_;
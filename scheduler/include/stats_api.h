@@ -49,6 +49,9 @@ namespace scheduler
     // 获取系统性能统计信息
     static std::string getSystemStats();
 
+    // 获取Kafka客户端运行状态（消费积压、发送队列深度等）
+    static std::string getTransportStats();
+
     // 重置统计信息
     static std::string resetStats();
   };
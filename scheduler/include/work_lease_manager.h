@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+namespace scheduler
+{
+
+  /**
+   * @brief 拉取模式下的任务租约管理
+   *
+   * 执行器通过WORK_REQUEST上报空闲槽位数（credits）和累计已接收任务数，
+   * 请求在wait_ms内有效（长轮询），调度器最多向其派发credits个任务。
+   * 上报的credits是绝对值，已派发但执行器尚未收到的任务通过
+   * granted - received 扣除，避免重复计算。
+   */
+  class WorkLeaseManager
+  {
+  public:
+    WorkLeaseManager() = default;
+
+    /**
+     * @brief 记录执行器的工作请求
+     * @param executorId 执行器ID
+     * @param credits 执行器当前空闲槽位数
+     * @param received 执行器累计收到的任务数
+     * @param waitMs 请求有效时长（毫秒）
+     */
+    void offer(const std::string &executorId, int credits, uint64_t received, int waitMs);
+
+    /**
+     * @brief 解析WORK_REQUEST消息体并记录
+     * @return 消息体格式错误时返回false
+     */
+    bool offer(const std::string &payload);
+
+    /**
+     * @brief 获取一个可派发任务的执行器，并扣除一个credit
+     * @return 执行器ID，没有可用credit时返回空
+     */
+    std::optional<std::string> acquire();
+
+    /**
+     * @brief 派发失败时归还credit
+     */
+    void release(const std::string &executorId);
+
+    /**
+     * @brief 移除执行器（下线时调用）
+     */
+    void remove(const std::string &executorId);
+
+    /**
+     * @brief 当前所有未过期请求的可用credit总数
+     */
+    int availableCredits();
+
+    /**
+     * @brief 节点消费WORK_REQUEST使用的消费组
+     *
+     * 每个调度器节点使用独立的消费组，都能收到全部执行器的请求；
+     * 共用消费组时请求可能分到从节点，主节点看不到这些credit，拉取模式停滞
+     */
+    static std::string consumerGroup(const std::string &nodeId);
+
+  private:
+    struct Lease
+    {
+      int credits = 0;       // 执行器上报的空闲槽位
+      uint64_t received = 0; // 执行器上报的累计接收数
+      uint64_t granted = 0;  // 调度器累计派发数
+      std::chrono::steady_clock::time_point expire_time;
+
+      // 扣除在途任务后的可用credit
+      int available() const
+      {
+        int64_t in_flight = granted > received ? static_cast<int64_t>(granted - received) : 0;
+        return static_cast<int>(std::max<int64_t>(0, credits - in_flight));
+      }
+    };
+
+    std::unordered_map<std::string, Lease> leases_;
+    std::mutex mutex_;
+  };
+
+} // namespace scheduler
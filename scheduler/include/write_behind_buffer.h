@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "job.h"
+#include "job_dao.h"
+
+namespace scheduler
+{
+
+  /**
+   * @brief 执行状态和执行器计数的延迟写缓冲
+   *
+   * 执行状态和执行器负载、任务计数的更新先在内存中按键合并：
+   * 同一执行记录只保留最后的状态，执行器计数的增量相加。
+   * 主节点的写缓冲线程每隔flush_interval或缓冲的键数达到max_pending时取出，
+   * 按类型批量写入；停止或失去主节点身份时同步写入。
+   * 状态带status IN ('WAITING','RUNNING')条件写入，不会覆盖已同步写入的执行结果；
+   * 执行结果本身不经过缓冲，结果写入和重新派发需要同步得知写入是否生效，以决定由哪一方释放负载。
+   * 读到的current_load等字段最多落后一个刷新周期。进程崩溃时缓冲中未写入的增量丢失，
+   * 由新的主节点按未结束的执行记录重新计算current_load。
+   */
+  class WriteBehindBuffer
+  {
+  public:
+    struct Options
+    {
+      std::chrono::milliseconds flush_interval{200};
+      size_t max_pending = 1000; // 缓冲的键数达到后提前刷新
+    };
+
+    // 一次取出的全部更新，执行记录按ID、执行器按ID排序
+    struct Batch
+    {
+      std::vector<std::pair<uint64_t, JobStatus>> statuses;
+      std::vector<ExecutorCounterDelta> counters;
+
+      bool empty() const { return statuses.empty() && counters.empty(); }
+    };
+
+    explicit WriteBehindBuffer(const Options &options);
+
+    void updateExecutionStatus(uint64_t executionId, JobStatus status);
+    void addExecutorLoad(const std::string &executorId, int delta);
+    void incrementExecutorTaskCount(const std::string &executorId);
+
+    // 等到刷新周期结束或缓冲的键数达到max_pending，wakeUp()可提前唤醒
+    void waitForFlush();
+    void wakeUp();
+
+    // 取出并清空缓冲的更新，增减相抵的计数不取出
+    Batch take();
+
+    // 写入失败的更新合并回缓冲区：缓冲区中之后的状态优先，计数增量相加
+    void restore(const Batch &batch);
+
+    size_t pendingKeys() const;
+
+    // 累计缓冲的更新次数
+    uint64_t bufferedUpdates() const;
+
+  private:
+    struct PendingCounter
+    {
+      int load_delta = 0;
+      uint64_t tasks_executed = 0;
+    };
+
+    // 调用方需持有mutex_
+    size_t pendingKeysLocked() const { return statuses_.size() + counters_.size(); }
+    void notifyIfFull();
+
+    Options options_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool woken_ = false;
+    std::unordered_map<uint64_t, JobStatus> statuses_;
+    std::unordered_map<std::string, PendingCounter> counters_;
+    uint64_t buffered_ = 0;
+  };
+
+} // namespace scheduler
@@ -6,7 +6,7 @@
 namespace scheduler
 {
 
-  ExecutorApiHandler::ExecutorApiHandler()
+  ExecutorApiHandler::ExecutorApiHandler(JobScheduler &scheduler) : scheduler_(scheduler)
   {
     jobDao_ = std::make_unique<JobDAO>();
   }
@@ -21,6 +21,7 @@ namespace scheduler
     std::regex executor_load_regex("/api/executors/([^/]+)/load");
     std::regex executor_status_regex("/api/executors/([^/]+)/status");
     std::regex executor_tasks_regex("/api/executors/([^/]+)/tasks");
+    std::regex executor_drain_regex("/api/executors/([^/]+)/drain");
     std::smatch matches;
 
     try
@@ -47,6 +48,13 @@ namespace scheduler
           return updateExecutorStatus(matches[1].str(), content);
         }
       }
+      else if (std::regex_match(path, matches, executor_drain_regex))
+      {
+        if (method == "PUT")
+        {
+          return drainExecutor(matches[1].str());
+        }
+      }
       else if (std::regex_match(path, matches, executor_tasks_regex))
       {
         if (method == "GET")
@@ -232,6 +240,35 @@ namespace scheduler
     }
   }
 
+  std::string ExecutorApiHandler::drainExecutor(const std::string &executorId)
+  {
+    // 检查执行器是否存在
+    auto executor = jobDao_->getExecutorInfo(executorId);
+    if (!executor)
+    {
+      nlohmann::json error;
+      error["error"] = "Executor not found";
+      error["status"] = 404;
+      return error.dump();
+    }
+
+    if (!scheduler_.drain_executor(executorId))
+    {
+      nlohmann::json error;
+      error["error"] = "Failed to drain executor";
+      error["status"] = 500;
+      return error.dump();
+    }
+
+    // 构建响应
+    nlohmann::json response;
+    response["executor_id"] = executorId;
+    response["status"] = "success";
+    response["message"] = "Executor draining";
+
+    return response.dump();
+  }
+
   std::string ExecutorApiHandler::getExecutorTasks(const std::string &executorId, const httplib::Params &params)
   {
     // 检查执行器是否存在
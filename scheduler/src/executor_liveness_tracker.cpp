@@ -0,0 +1,154 @@
+#include "executor_liveness_tracker.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cmath>
+
+namespace scheduler
+{
+
+  ExecutorLivenessTracker::ExecutorLivenessTracker(const Options &options)
+      : options_(options)
+  {
+    options_.window_size = std::max<size_t>(1, options_.window_size);
+  }
+
+  void ExecutorLivenessTracker::heartbeat(const std::string &executorId, Clock::time_point now)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(executorId);
+    if (it == entries_.end())
+    {
+      Entry &entry = entries_[executorId];
+      entry.last_seen = now;
+      entry.dirty = true;
+      return;
+    }
+
+    Entry &entry = it->second;
+
+    // 故障期间的长间隔不计入历史，避免恢复后检测变迟钝
+    if (!entry.dead)
+    {
+      double interval = std::chrono::duration<double, std::milli>(now - entry.last_seen).count();
+      entry.intervals.push_back(interval);
+      entry.sum += interval;
+      entry.sum_squares += interval * interval;
+      if (entry.intervals.size() > options_.window_size)
+      {
+        double oldest = entry.intervals.front();
+        entry.intervals.pop_front();
+        entry.sum -= oldest;
+        entry.sum_squares -= oldest * oldest;
+      }
+    }
+
+    entry.last_seen = now;
+    entry.dirty = true;
+  }
+
+  double ExecutorLivenessTracker::phiOf(const Entry &entry, Clock::time_point now) const
+  {
+    double mean;
+    double std_deviation;
+    if (entry.intervals.empty())
+    {
+      mean = static_cast<double>(options_.expected_interval.count());
+      std_deviation = mean / 4;
+    }
+    else
+    {
+      double n = static_cast<double>(entry.intervals.size());
+      mean = entry.sum / n;
+      std_deviation = std::sqrt(std::max(0.0, entry.sum_squares / n - mean * mean));
+    }
+    mean += static_cast<double>(options_.acceptable_pause.count());
+    std_deviation = std::max(std_deviation, static_cast<double>(options_.min_std_deviation.count()));
+
+    // 正态分布尾部概率的logistic近似
+    double elapsed = std::chrono::duration<double, std::milli>(now - entry.last_seen).count();
+    double y = (elapsed - mean) / std_deviation;
+    double e = std::exp(-y * (1.5976 + 0.070566 * y * y));
+    if (elapsed > mean)
+    {
+      return -std::log10(e / (1.0 + e));
+    }
+    return -std::log10(1.0 - 1.0 / (1.0 + e));
+  }
+
+  double ExecutorLivenessTracker::phi(const std::string &executorId, Clock::time_point now) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(executorId);
+    return it == entries_.end() ? 0.0 : phiOf(it->second, now);
+  }
+
+  ExecutorHealth ExecutorLivenessTracker::health(const std::string &executorId, Clock::time_point now) const
+  {
+    double value = phi(executorId, now);
+    if (value >= options_.dead_threshold)
+    {
+      return ExecutorHealth::DEAD;
+    }
+    if (value >= options_.suspect_threshold)
+    {
+      return ExecutorHealth::SUSPECT;
+    }
+    return ExecutorHealth::ALIVE;
+  }
+
+  bool ExecutorLivenessTracker::isSuspect(const std::string &executorId, Clock::time_point now) const
+  {
+    return health(executorId, now) != ExecutorHealth::ALIVE;
+  }
+
+  ExecutorLivenessTracker::Changes ExecutorLivenessTracker::detect(Clock::time_point now)
+  {
+    Changes changes;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &item : entries_)
+    {
+      Entry &entry = item.second;
+      double value = phiOf(entry, now);
+
+      if (!entry.dead && value >= options_.dead_threshold)
+      {
+        entry.dead = true;
+        changes.dead.push_back(item.first);
+        spdlog::warn("Executor considered dead: {}, phi: {:.2f}", item.first, value);
+      }
+      else if (entry.dead && value < options_.suspect_threshold)
+      {
+        entry.dead = false;
+        changes.recovered.push_back(item.first);
+        spdlog::info("Executor recovered: {}, phi: {:.2f}", item.first, value);
+      }
+    }
+
+    return changes;
+  }
+
+  std::vector<std::string> ExecutorLivenessTracker::takeHeartbeats()
+  {
+    std::vector<std::string> executors;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &item : entries_)
+    {
+      if (item.second.dirty)
+      {
+        executors.push_back(item.first);
+        item.second.dirty = false;
+      }
+    }
+
+    return executors;
+  }
+
+  void ExecutorLivenessTracker::remove(const std::string &executorId)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(executorId);
+  }
+
+} // namespace scheduler
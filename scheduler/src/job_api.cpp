@@ -1,4 +1,5 @@
 #include "job_api.h"
+#include "payload_codec.h"
 #include <spdlog/spdlog.h>
 #include <nlohmann/json.hpp>
 #include <regex>
@@ -322,8 +323,10 @@ namespace scheduler
 
     // 构建响应
     nlohmann::json response = nlohmann::json::array();
-    for (const auto &execution : executions)
+    for (auto &execution : executions)
     {
+      // 数据库中的输出可能是压缩的，返回前解压
+      PayloadCompressor::decompressResult(execution);
       response.push_back(execution.to_json());
     }
 
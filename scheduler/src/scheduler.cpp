@@ -1,10 +1,13 @@
 #include "scheduler.h"
 #include "job_dao.h"
+#include "async_query_engine.h"
 #include "kafka_message_queue.h"
 #include <spdlog/spdlog.h>
 #include <chrono>
 #include <random>
+#include <cstdlib>
 #include <algorithm>
+#include <unordered_set>
 #include "cron_parser.h"
 #include "config_manager.h"
 #include "stats_manager.h"
@@ -98,12 +101,25 @@ namespace scheduler
   class ExecutorRegistry
   {
   public:
-    ExecutorRegistry(JobDAO &dao, ZkRegistry &zk_registry) : dao_(dao), zk_registry_(zk_registry), current_index_(0) {}
+    ExecutorRegistry(JobDAO &dao, ZkRegistry &zk_registry, const ExecutorLivenessTracker &liveness,
+                     WriteBehindBuffer &write_behind)
+        : dao_(dao), zk_registry_(zk_registry), liveness_(liveness), write_behind_(write_behind), current_index_(0) {}
+
+    // 获取在线执行器，排除疑似故障的执行器
+    std::vector<std::pair<std::string, std::string>> getLiveExecutors()
+    {
+      auto executors = dao_.getOnlineExecutors();
+      executors.erase(std::remove_if(executors.begin(), executors.end(),
+                                     [this](const std::pair<std::string, std::string> &executor)
+                                     { return liveness_.isSuspect(executor.first); }),
+                      executors.end());
+      return executors;
+    }
 
     // 获取可用执行器 - 随机策略
     std::optional<std::pair<std::string, std::string>> getRandomExecutor()
     {
-      auto executors = dao_.getOnlineExecutors();
+      auto executors = getLiveExecutors();
       if (executors.empty())
       {
         return std::nullopt;
@@ -121,7 +137,7 @@ namespace scheduler
     // 获取可用执行器 - 轮询策略
     std::optional<std::pair<std::string, std::string>> getRoundRobinExecutor()
     {
-      auto executors = dao_.getOnlineExecutors();
+      auto executors = getLiveExecutors();
       if (executors.empty())
       {
         return std::nullopt;
@@ -143,6 +159,10 @@ namespace scheduler
     std::optional<std::pair<std::string, std::string>> getLeastLoadExecutor()
     {
       auto executors = dao_.getOnlineExecutorsWithLoad();
+      executors.erase(std::remove_if(executors.begin(), executors.end(),
+                                     [this](const ExecutorInfo &executor)
+                                     { return liveness_.isSuspect(executor.executor_id); }),
+                      executors.end());
       if (executors.empty())
       {
         return std::nullopt;
@@ -189,28 +209,23 @@ namespace scheduler
       return getRandomExecutor();
     }
 
-    // 更新执行器负载
-    bool updateExecutorLoad(const std::string &executorId, bool increment)
+    // 更新执行器负载，先在写缓冲中累加，按刷新周期批量写入
+    void updateExecutorLoad(const std::string &executorId, bool increment)
     {
-      if (increment)
-      {
-        return dao_.incrementExecutorLoad(executorId);
-      }
-      else
-      {
-        return dao_.decrementExecutorLoad(executorId);
-      }
+      write_behind_.addExecutorLoad(executorId, increment ? 1 : -1);
     }
 
     // 增加执行器任务计数
-    bool incrementExecutorTaskCount(const std::string &executorId)
+    void incrementExecutorTaskCount(const std::string &executorId)
     {
-      return dao_.incrementExecutorTaskCount(executorId);
+      write_behind_.incrementExecutorTaskCount(executorId);
     }
 
   private:
     JobDAO &dao_;
     ZkRegistry &zk_registry_;
+    const ExecutorLivenessTracker &liveness_;
+    WriteBehindBuffer &write_behind_;
     size_t current_index_; // 用于轮询策略
     std::mutex mutex_;     // 保护current_index_
   };
@@ -219,6 +234,7 @@ namespace scheduler
   JobScheduler::JobScheduler(const std::string &node_id, const std::string &zk_hosts)
       : running_(false),
         executor_selection_strategy_(ExecutorSelectionStrategy::RANDOM),
+        dispatch_mode_(DispatchMode::PUSH),
         node_id_(node_id),
         is_leader_(false)
   {
@@ -226,6 +242,9 @@ namespace scheduler
     auto &dbPool = DBConnectionPool::getInstance();
     dbPool.initialize();
 
+    // 初始化异步执行引擎，派发路径上的写操作不占用调度线程
+    AsyncQueryEngine::getInstance().initialize();
+
     // 初始化ZooKeeper客户端
     auto zk_client = std::make_shared<ZkClient>(zk_hosts);
     if (!zk_client->connect())
@@ -243,8 +262,32 @@ namespace scheduler
     // 创建组件
     job_storage_ = std::make_unique<JobDAO>();
     job_queue_ = std::make_unique<JobQueue>();
-    executor_registry_ = std::make_unique<ExecutorRegistry>(*job_storage_, *zk_registry_);
-    kafka_client_ = std::make_unique<KafkaMessageQueue>();
+
+    // 初始化执行器故障检测
+    auto &config = ConfigManager::getInstance();
+    ExecutorLivenessTracker::Options livenessOptions;
+    livenessOptions.expected_interval = std::chrono::seconds(config.getInt("executor.heartbeat_interval", 30));
+    livenessOptions.min_std_deviation = std::chrono::milliseconds(config.getInt("scheduler.phi.min_std_deviation_ms", 2000));
+    livenessOptions.acceptable_pause = std::chrono::milliseconds(config.getInt("scheduler.phi.acceptable_pause_ms", 5000));
+    livenessOptions.suspect_threshold = config.getInt("scheduler.phi.suspect_threshold", 3);
+    livenessOptions.dead_threshold = config.getInt("scheduler.phi.dead_threshold", 8);
+    liveness_ = std::make_unique<ExecutorLivenessTracker>(livenessOptions);
+
+    // 执行状态和执行器计数的延迟写
+    WriteBehindBuffer::Options writeBehindOptions;
+    writeBehindOptions.flush_interval = std::chrono::milliseconds(config.getInt("scheduler.write_behind.flush_interval_ms", 200));
+    writeBehindOptions.max_pending = std::max(1, config.getInt("scheduler.write_behind.max_pending", 1000));
+    write_behind_ = std::make_unique<WriteBehindBuffer>(writeBehindOptions);
+
+    executor_registry_ = std::make_unique<ExecutorRegistry>(*job_storage_, *zk_registry_, *liveness_, *write_behind_);
+    // 消息传输，loopback用于同一进程内的调度器和执行器
+    std::string transportType = ConfigManager::getInstance().getString("transport.type", "kafka");
+    kafka_client_ = MessageTransportFactory::create(transportType);
+    if (!priority_lanes_.parse(ConfigManager::getInstance().getString("kafka.priority_lanes", "")))
+    {
+      spdlog::warn("Invalid kafka.priority_lanes, all jobs use a single lane");
+    }
+    work_leases_ = std::make_unique<WorkLeaseManager>();
 
     // 从配置中获取执行器选择策略
     std::string strategyStr = ConfigManager::getInstance().getString(
@@ -262,26 +305,74 @@ namespace scheduler
       executor_selection_strategy_ = ExecutorSelectionStrategy::RANDOM;
     }
 
+    // 从配置中获取任务分发模式
+    if (ConfigManager::getInstance().getString("scheduler.dispatch_mode", "push") == "pull")
+    {
+      dispatch_mode_ = DispatchMode::PULL;
+    }
+    spdlog::info("Dispatch mode: {}", dispatch_mode_ == DispatchMode::PULL ? "pull" : "push");
+
     // 初始化Kafka
     std::string kafkaBrokers = ConfigManager::getInstance().getKafkaBrokers();
     kafka_client_->initProducer(kafkaBrokers);
+    // 结果按执行器ID分配到多个工作线程并行写库，同一执行器的结果保持顺序
+    kafka_client_->setConsumerWorkers(ConfigManager::getInstance().getInt("scheduler.result_workers", 4),
+                                      ConfigManager::getInstance().getInt("kafka.consumer_queue_size", 1000));
     kafka_client_->initConsumer(kafkaBrokers, "scheduler-group", {"job-result"},
                                 [this](const KafkaMessage &message)
                                 {
-                                  if (message.type == MessageType::JOB_RESULT)
+                                  if (message.type == MessageType::JOB_RETURN)
+                                  {
+                                    handle_job_return(message.payload);
+                                  }
+                                  else if (message.type == MessageType::JOB_RESULT ||
+                                           message.type == MessageType::JOB_RESULT_BATCH)
                                   {
-                                    try
+                                    std::vector<JobResult> results;
+                                    if (!MessageTransport::parseJobResults(message, results))
                                     {
-                                      nlohmann::json j = nlohmann::json::parse(message.payload);
-                                      JobResult result = JobResult::from_json(j);
-                                      handle_result(result);
+                                      spdlog::error("Failed to parse job result message: {}", message.key);
                                     }
-                                    catch (const std::exception &e)
+                                    else
                                     {
-                                      spdlog::error("Failed to parse job result: {}", e.what());
+                                      handle_results(results);
                                     }
                                   }
                                 });
+
+    // 心跳只用于存活检测，不写数据库；每个节点使用独立消费组，切换主节点后状态已就绪
+    heartbeat_client_ = MessageTransportFactory::create(transportType);
+    heartbeat_client_->initConsumer(kafkaBrokers, "scheduler-heartbeat-" + node_id_, {"executor-heartbeat"},
+                                    [this](const KafkaMessage &message)
+                                    {
+                                      if (message.type == MessageType::EXECUTOR_HEARTBEAT)
+                                      {
+                                        liveness_->heartbeat(message.payload);
+
+                                        auto lag = message.headers.find(kConsumerLagHeader);
+                                        if (lag != message.headers.end())
+                                        {
+                                          StatsManager::getInstance().updateExecutorConsumerLag(
+                                              message.payload, std::strtoll(lag->second.c_str(), nullptr, 10));
+                                        }
+                                      }
+                                    },
+                                    "latest");
+
+    // 拉取模式的工作请求同样每个节点独立消费，从节点也记录credit，主节点总能看到全部执行器的请求
+    if (dispatch_mode_ == DispatchMode::PULL)
+    {
+      credit_client_ = MessageTransportFactory::create(transportType);
+      credit_client_->initConsumer(kafkaBrokers, WorkLeaseManager::consumerGroup(node_id_), {"executor-credit"},
+                                   [this](const KafkaMessage &message)
+                                   {
+                                     if (message.type == MessageType::WORK_REQUEST)
+                                     {
+                                       handle_work_request(message.payload);
+                                     }
+                                   },
+                                   "latest");
+    }
   }
 
   JobScheduler::~JobScheduler()
@@ -305,8 +396,19 @@ namespace scheduler
     // 启动调度线程
     schedule_thread_ = std::thread(&JobScheduler::schedule_loop, this);
 
+    // 启动存活检测线程
+    liveness_thread_ = std::thread(&JobScheduler::liveness_loop, this);
+
+    // 启动写缓冲线程
+    write_behind_thread_ = std::thread(&JobScheduler::write_behind_loop, this);
+
     // 启动Kafka消费
     kafka_client_->startConsume();
+    heartbeat_client_->startConsume();
+    if (credit_client_)
+    {
+      credit_client_->startConsume();
+    }
 
     spdlog::info("Job scheduler started, node_id: {}", node_id_);
   }
@@ -322,6 +424,7 @@ namespace scheduler
 
       running_ = false;
       cv_.notify_all();
+      liveness_cv_.notify_all();
     }
 
     // 等待线程结束
@@ -333,9 +436,29 @@ namespace scheduler
     {
       election_thread_.join();
     }
+    if (liveness_thread_.joinable())
+    {
+      liveness_thread_.join();
+    }
 
     // 停止Kafka消费
     kafka_client_->stopConsume();
+    heartbeat_client_->stopConsume();
+    if (credit_client_)
+    {
+      credit_client_->stopConsume();
+    }
+
+    // 执行完已提交的异步写操作，其中派发的回调还会更新执行器负载
+    AsyncQueryEngine::getInstance().shutdown();
+
+    // 不再产生新的更新后，同步写入缓冲的执行状态和执行器计数
+    write_behind_->wakeUp();
+    if (write_behind_thread_.joinable())
+    {
+      write_behind_thread_.join();
+    }
+    flush_write_behind();
 
     spdlog::info("Job scheduler stopped");
   }
@@ -382,8 +505,8 @@ namespace scheduler
 
   bool JobScheduler::cancel_job(const std::string &job_id)
   {
-    // 从数据库获取任务
-    auto job_opt = job_storage_->getJob(job_id);
+    // 绕过缓存从数据库获取任务，缓存中可能是其他节点修改前的定义
+    auto job_opt = job_storage_->getJob(job_id, false);
     if (!job_opt)
     {
       spdlog::error("Job not found: {}", job_id);
@@ -393,17 +516,13 @@ namespace scheduler
     // 如果任务正在执行，发送取消消息
     if (job_opt->type == JobType::ONCE)
     {
-      KafkaMessage message(MessageType::JOB_CANCEL, job_id);
+      KafkaMessage message(MessageType::JOB_CANCEL, job_id, job_id);
       kafka_client_->sendMessage("job-cancel", message);
     }
 
     // 从队列中移除任务
     job_queue_->remove(job_id);
 
-    // 更新任务状态
-    JobInfo job = *job_opt;
-    job_storage_->updateJob(job);
-
     // 更新统计信息
     StatsManager::getInstance().incrementCancelledJobs();
 
@@ -462,7 +581,7 @@ namespace scheduler
       // 如果不是主节点，等待成为主节点
       cv_.wait_for(lock, std::chrono::seconds(checkInterval),
                    [this]
-                   { return !running_ || (is_leader_ && job_queue_->size() > 0); });
+                   { return !running_ || (is_leader_ && has_dispatchable_jobs()); });
 
       if (!running_)
       {
@@ -508,10 +627,17 @@ namespace scheduler
           lock.unlock();
 
           // 分发任务到执行器
-          dispatch_job(*job_opt);
+          bool dispatched = dispatch_job(*job_opt);
 
           // 重新获取锁
           lock.lock();
+
+          // 拉取模式下没有可用credit，任务留在调度器队列等待执行器申请
+          if (!dispatched && dispatch_mode_ == DispatchMode::PULL)
+          {
+            job_queue_->push(*job_opt);
+            break;
+          }
         }
       }
     }
@@ -594,12 +720,83 @@ namespace scheduler
   void JobScheduler::on_become_leader()
   {
     spdlog::info("Became leader node");
+    // 原主节点崩溃时缓冲中的负载增量已丢失，先写入本节点缓冲的更新，再按未结束的执行记录重新计算负载
+    {
+      std::lock_guard<std::mutex> lock(write_behind_mutex_);
+      flush_write_behind_locked();
+      job_storage_->recomputeExecutorLoads();
+    }
     cv_.notify_all(); // 唤醒调度线程
   }
 
   void JobScheduler::on_become_follower()
   {
     spdlog::info("Became follower node");
+    // 写入缓冲的更新，新的主节点读到的执行器负载是完整的
+    flush_write_behind();
+  }
+
+  void JobScheduler::write_behind_loop()
+  {
+    spdlog::info("Write-behind loop started");
+
+    while (running_)
+    {
+      write_behind_->waitForFlush();
+      flush_write_behind();
+    }
+
+    spdlog::info("Write-behind loop stopped");
+  }
+
+  bool JobScheduler::flush_write_behind()
+  {
+    std::lock_guard<std::mutex> lock(write_behind_mutex_);
+    return flush_write_behind_locked();
+  }
+
+  bool JobScheduler::flush_write_behind_locked()
+  {
+    auto batch = write_behind_->take();
+    if (batch.empty())
+    {
+      return true;
+    }
+
+    // 状态和计数分别写入，只把失败的部分放回缓冲区重试
+    WriteBehindBuffer::Batch failed;
+    if (!job_storage_->updateExecutionStatuses(batch.statuses))
+    {
+      failed.statuses = std::move(batch.statuses);
+    }
+    // 所有增量在一个事务中写入，失败时整体回滚，重试时不会重复累加
+    if (!job_storage_->updateExecutorCounters(batch.counters))
+    {
+      failed.counters = std::move(batch.counters);
+    }
+    else
+    {
+      // 计数写入后刷新执行器统计信息
+      for (const auto &delta : batch.counters)
+      {
+        auto executor_info = job_storage_->getExecutorInfo(delta.executor_id);
+        if (executor_info)
+        {
+          StatsManager::getInstance().updateExecutorStats(*executor_info);
+        }
+      }
+    }
+
+    if (!failed.empty())
+    {
+      spdlog::warn("Write-behind flush failed, keeping {} statuses and {} counters for retry",
+                   failed.statuses.size(), failed.counters.size());
+      write_behind_->restore(failed);
+      return false;
+    }
+
+    spdlog::debug("Write-behind flushed {} statuses and {} counters", batch.statuses.size(), batch.counters.size());
+    return true;
   }
 
   bool JobScheduler::should_execute(const JobInfo &job)
@@ -643,6 +840,12 @@ namespace scheduler
       }
     }
 
+    // 拉取模式下由dispatch_job检查credit
+    if (dispatch_mode_ == DispatchMode::PULL)
+    {
+      return true;
+    }
+
     // 检查是否有可用执行器
     auto executor_opt = executor_registry_->getAvailableExecutor(executor_selection_strategy_);
     if (!executor_opt)
@@ -654,85 +857,416 @@ namespace scheduler
     return true;
   }
 
-  void JobScheduler::dispatch_job(const JobInfo &job)
+  bool JobScheduler::dispatch_job(const JobInfo &job)
   {
-    // 获取可用执行器
-    auto executor_opt = executor_registry_->getAvailableExecutor(executor_selection_strategy_);
-    if (!executor_opt)
+    // 获取可用执行器：拉取模式使用执行器申请的credit，推送模式按策略选择
+    std::string executor_id;
+    if (dispatch_mode_ == DispatchMode::PULL)
+    {
+      auto lease_opt = work_leases_->acquire();
+      if (!lease_opt)
+      {
+        spdlog::debug("No work credit available for job: {}", job.job_id);
+        return false;
+      }
+      executor_id = *lease_opt;
+    }
+    else
+    {
+      auto executor_opt = executor_registry_->getAvailableExecutor(executor_selection_strategy_);
+      if (!executor_opt)
+      {
+        spdlog::error("No available executor for job: {}", job.job_id);
+        return false;
+      }
+      executor_id = executor_opt->first;
+    }
+
+    // 执行记录写入后再发送任务，执行结果回来时一定能找到对应的记录。
+    // 写入在异步执行引擎上进行，调度线程不等待数据库往返，发送在写入完成的回调中进行
+    job_storage_->saveExecutionAsync(job.job_id, executor_id, [this, job, executor_id](uint64_t execution_id)
+                                     { send_dispatched_job(job, executor_id, execution_id); });
+    return true;
+  }
+
+  void JobScheduler::send_dispatched_job(const JobInfo &job, const std::string &executor_id, uint64_t execution_id)
+  {
+    if (execution_id == 0)
     {
-      spdlog::error("No available executor for job: {}", job.job_id);
+      abort_dispatch(job, executor_id);
       return;
     }
 
-    // 记录执行信息
-    job_storage_->saveExecution(job.job_id, executor_opt->first);
+    // 负载写入时按GREATEST(0, ...)截断，增减的写入顺序有关：减量先于增量写入会被截断，
+    // 之后的增量使负载一直偏高。因此增量在任务发出前进入写缓冲，早于执行结果带来的减量
+    executor_registry_->updateExecutorLoad(executor_id, true);
+
+    // 任务消息带上执行记录ID，结果按此ID回写，不会误写同一任务的其他执行
+    JobInfo dispatched = job;
+    dispatched.execution_id = execution_id;
+
+    // 按优先级发送到选中执行器对应通道的专属主题，高优先级任务不排在批量任务的积压之后
+    std::string topic = priority_lanes_.topic("job-submit", priority_lanes_.laneFor(job.priority), executor_id);
+    if (!kafka_client_->sendJob(topic, dispatched, executor_id))
+    {
+      // 任务没有发出，不会有执行结果：删除执行记录并撤销负载，任务重新派发时不留下孤立的WAITING记录
+      job_storage_->deleteExecutionAsync(execution_id);
+      executor_registry_->updateExecutorLoad(executor_id, false);
+      abort_dispatch(job, executor_id);
+      return;
+    }
 
-    // 更新执行器负载
-    executor_registry_->updateExecutorLoad(executor_opt->first, true);
+    // 任务已发出，执行记录延迟标记为RUNNING；结果先写入时带条件的状态更新不生效
+    write_behind_->updateExecutionStatus(execution_id, JobStatus::RUNNING);
 
     // 更新统计信息
     StatsManager::getInstance().updateJobStats(job, JobStatus::RUNNING);
 
-    // 发送任务到执行器
-    kafka_client_->sendJob("job-submit", job);
+    spdlog::info("Job dispatched: {} to executor: {}", job.job_id, executor_id);
+  }
+
+  void JobScheduler::abort_dispatch(const JobInfo &job, const std::string &executor_id)
+  {
+    spdlog::warn("Dispatch of job {} to executor {} aborted", job.job_id, executor_id);
+
+    // 推送模式下任务在下一轮从数据库重新取出；拉取模式下任务留在调度器队列等待执行器申请
+    if (dispatch_mode_ == DispatchMode::PULL)
+    {
+      work_leases_->release(executor_id);
+      job_queue_->push(job);
+      cv_.notify_one();
+    }
+  }
+
+  bool JobScheduler::has_dispatchable_jobs()
+  {
+    if (job_queue_->size() == 0)
+    {
+      return false;
+    }
+    return dispatch_mode_ == DispatchMode::PUSH || work_leases_->availableCredits() > 0;
+  }
+
+  void JobScheduler::liveness_loop()
+  {
+    spdlog::info("Liveness loop started");
+
+    int flushInterval = ConfigManager::getInstance().getInt("scheduler.heartbeat_flush_interval", 30);
+    int checkInterval = ConfigManager::getInstance().getInt("scheduler.failure_check_interval_ms", 1000);
+    auto next_flush = std::chrono::steady_clock::now() + std::chrono::seconds(flushInterval);
+
+    while (running_)
+    {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        liveness_cv_.wait_for(lock, std::chrono::milliseconds(checkInterval), [this]
+                              { return !running_; });
+        if (!running_)
+        {
+          break;
+        }
+        // 从节点也接收心跳，但只有主节点处理故障和写数据库
+        if (!is_leader_)
+        {
+          continue;
+        }
+      }
+
+      try
+      {
+        // 故障检测：下线故障执行器并重新派发其上的任务
+        auto changes = liveness_->detect();
+        for (const auto &executor_id : changes.dead)
+        {
+          job_storage_->updateExecutorStatus(executor_id, false);
+          work_leases_->remove(executor_id);
+          redispatch_in_flight(executor_id);
+        }
+        for (const auto &executor_id : changes.recovered)
+        {
+          job_storage_->updateExecutorStatus(executor_id, true);
+        }
 
-    spdlog::info("Job dispatched: {} to executor: {}", job.job_id, executor_opt->first);
+        // 定期批量刷新心跳时间
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_flush)
+        {
+          job_storage_->updateExecutorHeartbeats(liveness_->takeHeartbeats());
+          next_flush = now + std::chrono::seconds(flushInterval);
+        }
+      }
+      catch (const std::exception &e)
+      {
+        spdlog::error("Failed to flush executor liveness: {}", e.what());
+      }
+    }
+
+    spdlog::info("Liveness loop stopped");
   }
 
-  // 处理任务结果
-  void JobScheduler::handle_result(const JobResult &result)
+  void JobScheduler::redispatch_in_flight(const std::string &executor_id)
   {
-    // 查询执行记录
-    auto executions = job_storage_->getJobExecutions(result.job_id, 0, 1);
+    auto executions = job_storage_->getInFlightExecutions(executor_id);
     if (executions.empty())
     {
-      spdlog::error("No execution found for job: {}", result.job_id);
       return;
     }
 
-    // 更新执行结果
-    uint64_t execution_id = executions[0].execution_id;
-    if (execution_id == 0)
+    spdlog::warn("Re-dispatching {} in-flight jobs from dead executor: {}", executions.size(), executor_id);
+    requeue_executions(executor_id, executions, "Executor lost: " + executor_id);
+  }
+
+  void JobScheduler::requeue_executions(const std::string &executor_id, const std::vector<JobResult> &executions,
+                                        const std::string &reason)
+  {
+    // 同步结束原执行记录，写入带状态条件：与迟到的原执行结果只有一方生效。
+    // 结果已先写入的执行已经完成并释放了负载，不再撤销负载和重新派发
+    std::vector<std::pair<uint64_t, JobResult>> failures;
+    for (const auto &execution : executions)
+    {
+      JobResult failure;
+      failure.job_id = execution.job_id;
+      failure.execution_id = execution.execution_id;
+      failure.executor_id = executor_id;
+      failure.status = JobStatus::FAILED;
+      failure.error = reason;
+      failures.emplace_back(execution.execution_id, std::move(failure));
+    }
+
+    std::vector<uint64_t> applied;
+    if (!job_storage_->updateExecutionResults(failures, &applied))
     {
-      spdlog::error("Invalid execution_id (0) for job: {}", result.job_id);
+      spdlog::error("Failed to end {} executions of executor: {}", failures.size(), executor_id);
       return;
     }
 
-    job_storage_->updateExecutionResult(execution_id, result.status, result.output, result.error);
+    for (const auto &execution : executions)
+    {
+      if (std::find(applied.begin(), applied.end(), execution.execution_id) == applied.end())
+      {
+        spdlog::debug("Execution finished before requeue: {}, job: {}", execution.execution_id, execution.job_id);
+        continue;
+      }
 
-    // 更新任务状态
-    auto job_opt = job_storage_->getJob(result.job_id);
-    if (!job_opt)
+      // 任务重新进入待派发队列
+      executor_registry_->updateExecutorLoad(executor_id, false);
+      auto job_opt = job_storage_->getJob(execution.job_id, false);
+      if (job_opt)
+      {
+        job_queue_->push(*job_opt);
+      }
+    }
+
+    cv_.notify_all();
+  }
+
+  bool JobScheduler::drain_executor(const std::string &executor_id)
+  {
+    // 先标记为DRAINING，选择执行器时立即跳过
+    if (!job_storage_->markExecutorDraining(executor_id))
+    {
+      return false;
+    }
+    work_leases_->remove(executor_id);
+
+    KafkaMessage message(MessageType::EXECUTOR_DRAIN, executor_id, executor_id);
+    message.headers[kExecutorIdHeader] = executor_id;
+    if (!kafka_client_->sendMessage(MessageTransport::executorTopic("job-submit", executor_id), message))
+    {
+      spdlog::error("Failed to send drain request to executor: {}", executor_id);
+      return false;
+    }
+
+    spdlog::info("Drain requested for executor: {}", executor_id);
+    return true;
+  }
+
+  void JobScheduler::handle_job_return(const std::string &payload)
+  {
+    std::string executor_id;
+    std::unordered_set<std::string> job_ids;
+    bool draining = true;
+    try
+    {
+      nlohmann::json j = nlohmann::json::parse(payload);
+      executor_id = j["executor_id"].get<std::string>();
+      draining = j.value("draining", true);
+      for (const auto &job_id : j["job_ids"])
+      {
+        job_ids.insert(job_id.get<std::string>());
+      }
+    }
+    catch (const std::exception &e)
     {
-      spdlog::error("Job not found: {}", result.job_id);
+      spdlog::error("Failed to parse job return: {}", e.what());
       return;
     }
 
-    JobInfo job = *job_opt;
-    job_storage_->updateJob(job);
+    // 排空的执行器不再接收任务；重启后退回上次未完成任务的执行器照常接收
+    if (draining)
+    {
+      work_leases_->remove(executor_id);
+    }
 
-    // 更新执行器负载和任务计数
-    auto executions_with_executor = job_storage_->getJobExecutions(result.job_id, 0, 1);
-    if (!executions_with_executor.empty())
+    std::vector<JobResult> returned;
+    for (const auto &execution : job_storage_->getInFlightExecutions(executor_id))
     {
-      // 获取执行器ID
-      auto execution_opt = job_storage_->getExecution(execution_id);
-      if (execution_opt)
+      if (job_ids.count(execution.job_id) > 0)
       {
-        // 从数据库中获取执行器ID
-        auto executor_info = job_storage_->getExecutorInfo(execution_opt->job_id);
-        if (executor_info)
+        returned.push_back(execution);
+      }
+    }
+
+    spdlog::info("Executor {} returned {} jobs", executor_id, returned.size());
+    requeue_executions(executor_id, returned, "Returned by draining executor: " + executor_id);
+  }
+
+  void JobScheduler::handle_work_request(const std::string &payload)
+  {
+    if (!work_leases_->offer(payload))
+    {
+      return;
+    }
+
+    // 唤醒调度线程派发排队的任务
+    cv_.notify_one();
+  }
+
+  void JobScheduler::handle_results(const std::vector<JobResult> &results)
+  {
+    // 带执行ID和执行器ID的结果不先查询执行记录，直接在异步引擎上按条件写入，同一批结果的写入同时进行；
+    // 写入生效后在回调中释放负载
+    bool async = AsyncQueryEngine::getInstance().isRunning();
+    std::vector<std::future<void>> written;
+
+    // 其余结果查询对应的执行记录后同步写入
+    std::vector<std::pair<uint64_t, JobResult>> updates;
+    updates.reserve(results.size());
+    for (const auto &result : results)
+    {
+      if (async && result.execution_id != 0 && !result.executor_id.empty())
+      {
+        auto done = std::make_shared<std::promise<void>>();
+        written.push_back(done->get_future());
+        job_storage_->updateExecutionResultAsync(result, [this, result, done](bool applied)
+                                                 {
+          if (applied)
+          {
+            finish_execution(result);
+          }
+          else
+          {
+            spdlog::debug("Execution already finished, result ignored: {}, job: {}", result.execution_id, result.job_id);
+          }
+          done->set_value(); });
+        continue;
+      }
+
+      // 结果带执行ID时按ID匹配；旧版本执行器的结果不带，退回到该任务最近一次执行
+      std::optional<JobResult> execution;
+      if (result.execution_id != 0)
+      {
+        execution = job_storage_->getExecution(result.execution_id);
+      }
+      else
+      {
+        auto executions = job_storage_->getJobExecutions(result.job_id, 0, 1);
+        if (!executions.empty())
         {
-          // 减少执行器负载
-          executor_registry_->updateExecutorLoad(executor_info->executor_id, false);
-          // 增加执行器任务计数
-          executor_registry_->incrementExecutorTaskCount(executor_info->executor_id);
+          execution = executions[0];
+        }
+      }
 
-          // 更新执行器统计信息
-          StatsManager::getInstance().updateExecutorStats(*executor_info);
+      if (!execution || execution->job_id != result.job_id)
+      {
+        spdlog::error("No execution found for job: {}, execution: {}", result.job_id, result.execution_id);
+        continue;
+      }
+
+      uint64_t execution_id = execution->execution_id;
+      if (execution_id == 0)
+      {
+        spdlog::error("Invalid execution_id (0) for job: {}", result.job_id);
+        continue;
+      }
+
+      // 执行记录已结束说明结果已处理过（偏移量提交前重启导致的重放），
+      // 或者执行已被判定失败并重新派发、这是原执行迟到的结果，跳过以免覆盖和重复计数。
+      // 这里只是提前过滤，并发处理同一执行的结果时以写入语句中的状态条件为准
+      if (execution->status != JobStatus::WAITING && execution->status != JobStatus::RUNNING)
+      {
+        spdlog::debug("Duplicate result ignored for job: {}, execution: {}", result.job_id, execution_id);
+        continue;
+      }
+
+      // 负载按执行记录上的执行器释放
+      JobResult update = result;
+      update.executor_id = execution->executor_id;
+      updates.emplace_back(execution_id, std::move(update));
+    }
+
+    // 等异步写入完成后才返回，消息的偏移量在处理完成后提交，进程崩溃时结果不会丢失
+    for (auto &write : written)
+    {
+      write.wait();
+    }
+
+    if (updates.empty())
+    {
+      return;
+    }
+
+    // 在一个事务中更新执行结果；事务失败时逐条重试，一条结果写入失败不影响同批的其他结果。
+    // 只有实际写入的结果才释放执行器负载，执行记录已被其他结果或重新派发结束的不再计数
+    std::vector<uint64_t> applied;
+    bool updated = job_storage_->updateExecutionResults(updates, &applied);
+    if (!updated && updates.size() > 1)
+    {
+      spdlog::warn("Batch update of {} execution results failed, retrying one by one", updates.size());
+      for (const auto &update : updates)
+      {
+        if (!job_storage_->updateExecutionResults({update}, &applied))
+        {
+          spdlog::error("Failed to update execution result: {}, job: {}", update.first, update.second.job_id);
         }
       }
     }
+    else if (!updated)
+    {
+      spdlog::error("Failed to update execution result: {}, job: {}", updates[0].first, updates[0].second.job_id);
+    }
+
+    // 同一执行的结果在一批中出现多次时只有第一条写入
+    size_t finished = 0;
+    for (const auto &update : updates)
+    {
+      auto it = std::find(applied.begin(), applied.end(), update.first);
+      if (it == applied.end())
+      {
+        spdlog::debug("Execution already finished, result ignored: {}, job: {}", update.first, update.second.job_id);
+        continue;
+      }
+      applied.erase(it);
+      finish_execution(update.second);
+      finished++;
+    }
+
+    if (results.size() > 1)
+    {
+      spdlog::info("Job result batch processed: {} results", finished);
+    }
+  }
+
+  void JobScheduler::finish_execution(const JobResult &result)
+  {
+    // 更新执行该次任务的执行器的负载和任务计数，只写入写缓冲，不访问数据库
+    if (!result.executor_id.empty())
+    {
+      // 减少执行器负载
+      executor_registry_->updateExecutorLoad(result.executor_id, false);
+      // 增加执行器任务计数
+      executor_registry_->incrementExecutorTaskCount(result.executor_id);
+    }
 
     // 更新任务结果统计
     StatsManager::getInstance().updateJobResultStats(result);
@@ -3,6 +3,9 @@
 #include "job_api.h"
 #include "executor_api.h"
 #include "scheduler.h"
+#include "db_connection_pool.h"
+#include "async_query_engine.h"
+#include "job_dao.h"
 #include <spdlog/spdlog.h>
 #include <nlohmann/json.hpp>
 #include <httplib.h>
@@ -42,6 +45,10 @@ namespace scheduler
     {
       return getSystemStats();
     }
+    else if (path == "/api/stats/transport")
+    {
+      return getTransportStats();
+    }
     else if (path == "/api/stats/reset")
     {
       return resetStats();
@@ -99,6 +106,7 @@ namespace scheduler
                                    executor.last_heartbeat.time_since_epoch())
                                    .count();
       exec["online"] = executor.is_online;
+      exec["consumer_lag"] = executor.consumer_lag;
       j.push_back(exec);
     }
 
@@ -115,8 +123,60 @@ namespace scheduler
     j["db_query_avg_time"] = stats.getAvgDbQueryTime();
     j["kafka_msg_sent"] = stats.kafka_msg_sent;
     j["kafka_msg_received"] = stats.kafka_msg_received;
+    j["kafka_delivery_failed"] = stats.kafka_delivery_failed;
+    j["kafka_delivery_latency_avg_us"] = stats.getAvgDeliveryLatency();
+    j["kafka_delivery_latency_max_us"] = stats.kafka_delivery_latency_max_us;
+    j["kafka_errors"] = stats.kafka_errors;
     j["scheduler_cycles"] = stats.scheduler_cycles;
 
+    auto pool = DBConnectionPool::getInstance().getStats();
+    j["db_pool"] = {
+        {"total", pool.total},
+        {"in_use", pool.in_use},
+        {"idle", pool.idle},
+        {"max_size", pool.max_size},
+        {"utilization", pool.getUtilization()},
+        {"acquisitions", pool.acquisitions},
+        {"timeouts", pool.timeouts},
+        {"wait_time_avg_us", pool.getAvgWaitTime()},
+        {"wait_time_max_us", pool.wait_time_max_us},
+        {"validations", pool.validations},
+        {"recycled", pool.recycled}};
+
+    auto async = AsyncQueryEngine::getInstance().getStats();
+    j["db_async"] = {
+        {"running", async.running},
+        {"non_blocking", async.non_blocking},
+        {"threads", async.threads},
+        {"connections", async.connections},
+        {"queued", async.queued},
+        {"in_flight", async.in_flight},
+        {"submitted", async.submitted},
+        {"completed", async.completed},
+        {"failed", async.failed}};
+
+    auto cache = JobDAO::jobCache().getStats();
+    j["job_cache"] = {
+        {"size", cache.size},
+        {"capacity", cache.capacity},
+        {"shards", cache.shards},
+        {"hits", cache.hits},
+        {"misses", cache.misses},
+        {"hit_rate", cache.getHitRate()},
+        {"evictions", cache.evictions},
+        {"invalidations", cache.invalidations}};
+
+    return j.dump(2);
+  }
+
+  std::string StatsApiHandler::getTransportStats()
+  {
+    nlohmann::json j = nlohmann::json::array();
+    for (const auto &stats : StatsManager::getInstance().getTransportStats())
+    {
+      j.push_back(stats.to_json());
+    }
+
     return j.dump(2);
   }
 
@@ -138,7 +198,7 @@ namespace scheduler
     Impl(int port, JobScheduler &scheduler)
         : port_(port), running_(false),
           jobApiHandler_(scheduler),
-          executorApiHandler_()
+          executorApiHandler_(scheduler)
     {
     }
 
@@ -171,6 +231,10 @@ namespace scheduler
           res.set_content(StatsApiHandler::handleRequest("/api/stats/system", "GET", req.params), "application/json");
         });
         
+        svr.Get("/api/stats/transport", [](const httplib::Request& req, httplib::Response& res) {
+          res.set_content(StatsApiHandler::handleRequest("/api/stats/transport", "GET", req.params), "application/json");
+        });
+        
         svr.Get("/api/stats/reset", [](const httplib::Request& req, httplib::Response& res) {
           res.set_content(StatsApiHandler::handleRequest("/api/stats/reset", "GET", req.params), "application/json");
         });
@@ -229,6 +293,11 @@ namespace scheduler
           res.set_content(executorApiHandler_.handleRequest(path, "PUT", req.params, req.body), "application/json");
         });
         
+        svr.Put(R"(/api/executors/([^/]+)/drain)", [this](const httplib::Request& req, httplib::Response& res) {
+          std::string path = "/api/executors/" + req.matches[1].str() + "/drain";
+          res.set_content(executorApiHandler_.handleRequest(path, "PUT", req.params, req.body), "application/json");
+        });
+        
         svr.Get(R"(/api/executors/([^/]+)/tasks)", [this](const httplib::Request& req, httplib::Response& res) {
           std::string path = "/api/executors/" + req.matches[1].str() + "/tasks";
           res.set_content(executorApiHandler_.handleRequest(path, "GET", req.params, ""), "application/json");
@@ -0,0 +1,114 @@
+#include "work_lease_manager.h"
+#include <spdlog/spdlog.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+
+namespace scheduler
+{
+
+  void WorkLeaseManager::offer(const std::string &executorId, int credits, uint64_t received, int waitMs)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Lease &lease = leases_[executorId];
+    lease.credits = std::max(0, credits);
+    lease.received = received;
+    lease.expire_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(waitMs);
+
+    // 调度器切换后累计派发数从0开始，以执行器上报为准
+    if (lease.granted < received)
+    {
+      lease.granted = received;
+    }
+
+    spdlog::debug("Work request from executor {}: credits={}, available={}",
+                  executorId, lease.credits, lease.available());
+  }
+
+  bool WorkLeaseManager::offer(const std::string &payload)
+  {
+    try
+    {
+      nlohmann::json j = nlohmann::json::parse(payload);
+      offer(j["executor_id"].get<std::string>(),
+            j["credits"].get<int>(),
+            j.value("received", static_cast<uint64_t>(0)),
+            j.value("wait_ms", 30000));
+    }
+    catch (const std::exception &e)
+    {
+      spdlog::error("Failed to parse work request: {}", e.what());
+      return false;
+    }
+    return true;
+  }
+
+  std::string WorkLeaseManager::consumerGroup(const std::string &nodeId)
+  {
+    return "scheduler-credit-" + nodeId;
+  }
+
+  std::optional<std::string> WorkLeaseManager::acquire()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+
+    // 选择可用credit最多的执行器
+    Lease *best = nullptr;
+    const std::string *best_id = nullptr;
+    for (auto &entry : leases_)
+    {
+      // 过期请求保留累计派发数，等待执行器下一次请求
+      if (entry.second.expire_time <= now)
+      {
+        continue;
+      }
+
+      if (entry.second.available() > 0 && (!best || entry.second.available() > best->available()))
+      {
+        best = &entry.second;
+        best_id = &entry.first;
+      }
+    }
+
+    if (!best)
+    {
+      return std::nullopt;
+    }
+
+    best->granted++;
+    return *best_id;
+  }
+
+  void WorkLeaseManager::release(const std::string &executorId)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = leases_.find(executorId);
+    if (it != leases_.end() && it->second.granted > it->second.received)
+    {
+      it->second.granted--;
+    }
+  }
+
+  void WorkLeaseManager::remove(const std::string &executorId)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    leases_.erase(executorId);
+  }
+
+  int WorkLeaseManager::availableCredits()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+
+    int total = 0;
+    for (const auto &entry : leases_)
+    {
+      if (entry.second.expire_time > now)
+      {
+        total += entry.second.available();
+      }
+    }
+    return total;
+  }
+
+} // namespace scheduler
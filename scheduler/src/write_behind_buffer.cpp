@@ -0,0 +1,119 @@
+#include "write_behind_buffer.h"
+#include <algorithm>
+
+namespace scheduler
+{
+
+  WriteBehindBuffer::WriteBehindBuffer(const Options &options)
+      : options_(options)
+  {
+  }
+
+  void WriteBehindBuffer::updateExecutionStatus(uint64_t executionId, JobStatus status)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statuses_[executionId] = status;
+    buffered_++;
+    notifyIfFull();
+  }
+
+  void WriteBehindBuffer::addExecutorLoad(const std::string &executorId, int delta)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_[executorId].load_delta += delta;
+    buffered_++;
+    notifyIfFull();
+  }
+
+  void WriteBehindBuffer::incrementExecutorTaskCount(const std::string &executorId)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_[executorId].tasks_executed++;
+    buffered_++;
+    notifyIfFull();
+  }
+
+  void WriteBehindBuffer::notifyIfFull()
+  {
+    if (pendingKeysLocked() >= options_.max_pending)
+    {
+      cv_.notify_one();
+    }
+  }
+
+  void WriteBehindBuffer::waitForFlush()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_for(lock, options_.flush_interval, [this]()
+                 { return woken_ || pendingKeysLocked() >= options_.max_pending; });
+    woken_ = false;
+  }
+
+  void WriteBehindBuffer::wakeUp()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    woken_ = true;
+    cv_.notify_all();
+  }
+
+  WriteBehindBuffer::Batch WriteBehindBuffer::take()
+  {
+    std::unordered_map<uint64_t, JobStatus> statuses;
+    std::unordered_map<std::string, PendingCounter> counters;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      statuses.swap(statuses_);
+      counters.swap(counters_);
+    }
+
+    Batch batch;
+    batch.statuses.assign(statuses.begin(), statuses.end());
+    for (auto &entry : counters)
+    {
+      // 增减相抵的负载不需要写入
+      if (entry.second.load_delta == 0 && entry.second.tasks_executed == 0)
+      {
+        continue;
+      }
+      batch.counters.push_back({entry.first, entry.second.load_delta, entry.second.tasks_executed});
+    }
+
+    // 固定顺序写入，并发事务按相同顺序加行锁
+    std::sort(batch.statuses.begin(), batch.statuses.end(),
+              [](const auto &a, const auto &b)
+              { return a.first < b.first; });
+    std::sort(batch.counters.begin(), batch.counters.end(),
+              [](const ExecutorCounterDelta &a, const ExecutorCounterDelta &b)
+              { return a.executor_id < b.executor_id; });
+    return batch;
+  }
+
+  void WriteBehindBuffer::restore(const Batch &batch)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 取出之后缓冲的状态更新，保留较新的
+    for (const auto &entry : batch.statuses)
+    {
+      statuses_.emplace(entry.first, entry.second);
+    }
+    for (const auto &delta : batch.counters)
+    {
+      PendingCounter &pending = counters_[delta.executor_id];
+      pending.load_delta += delta.load_delta;
+      pending.tasks_executed += delta.tasks_executed;
+    }
+  }
+
+  size_t WriteBehindBuffer::pendingKeys() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pendingKeysLocked();
+  }
+
+  uint64_t WriteBehindBuffer::bufferedUpdates() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return buffered_;
+  }
+
+} // namespace scheduler
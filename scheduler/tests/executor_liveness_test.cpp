@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include "executor_liveness_tracker.h"
+
+using namespace scheduler;
+using namespace std::chrono_literals;
+
+class ExecutorLivenessTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ExecutorLivenessTracker::Options options;
+    options.expected_interval = 1000ms;
+    options.min_std_deviation = 100ms;
+    options.acceptable_pause = 0ms;
+    options.suspect_threshold = 3.0;
+    options.dead_threshold = 8.0;
+    tracker = std::make_unique<ExecutorLivenessTracker>(options);
+    start = ExecutorLivenessTracker::Clock::now();
+  }
+
+  // 以固定间隔发送count次心跳，返回最后一次心跳时间
+  ExecutorLivenessTracker::Clock::time_point sendHeartbeats(const std::string &executorId, int count)
+  {
+    auto now = start;
+    for (int i = 0; i < count; ++i)
+    {
+      now = start + i * 1000ms;
+      tracker->heartbeat(executorId, now);
+    }
+    return now;
+  }
+
+  std::unique_ptr<ExecutorLivenessTracker> tracker;
+  ExecutorLivenessTracker::Clock::time_point start;
+};
+
+// 按时到达的心跳不触发故障
+TEST_F(ExecutorLivenessTest, RegularHeartbeatsStayAlive)
+{
+  auto last = sendHeartbeats("executor-1", 20);
+
+  EXPECT_EQ(tracker->health("executor-1", last + 1000ms), ExecutorHealth::ALIVE);
+  EXPECT_TRUE(tracker->detect(last + 1000ms).dead.empty());
+}
+
+// 心跳停止后依次进入疑似故障和故障状态
+TEST_F(ExecutorLivenessTest, MissedHeartbeatsBecomeSuspectThenDead)
+{
+  auto last = sendHeartbeats("executor-1", 20);
+
+  EXPECT_EQ(tracker->health("executor-1", last + 1400ms), ExecutorHealth::SUSPECT);
+  EXPECT_TRUE(tracker->isSuspect("executor-1", last + 1400ms));
+  EXPECT_EQ(tracker->health("executor-1", last + 2000ms), ExecutorHealth::DEAD);
+
+  auto changes = tracker->detect(last + 2000ms);
+  ASSERT_EQ(changes.dead.size(), 1u);
+  EXPECT_EQ(changes.dead[0], "executor-1");
+
+  // 同一状态变化只上报一次
+  EXPECT_TRUE(tracker->detect(last + 3000ms).dead.empty());
+}
+
+// 故障执行器恢复心跳后上报恢复
+TEST_F(ExecutorLivenessTest, DeadExecutorRecovers)
+{
+  auto last = sendHeartbeats("executor-1", 20);
+  ASSERT_EQ(tracker->detect(last + 5000ms).dead.size(), 1u);
+
+  tracker->heartbeat("executor-1", last + 60000ms);
+  auto changes = tracker->detect(last + 60100ms);
+  ASSERT_EQ(changes.recovered.size(), 1u);
+
+  // 故障期间的长间隔不计入历史
+  EXPECT_EQ(tracker->health("executor-1", last + 61000ms), ExecutorHealth::ALIVE);
+  EXPECT_EQ(tracker->health("executor-1", last + 62500ms), ExecutorHealth::DEAD);
+}
+
+// 未收到过心跳的执行器视为正常
+TEST_F(ExecutorLivenessTest, UnknownExecutorIsAlive)
+{
+  EXPECT_EQ(tracker->health("unknown"), ExecutorHealth::ALIVE);
+  EXPECT_DOUBLE_EQ(tracker->phi("unknown"), 0.0);
+}
+
+// 心跳记录取出后清空
+TEST_F(ExecutorLivenessTest, TakeHeartbeatsClearsDirtyEntries)
+{
+  tracker->heartbeat("executor-1", start);
+  tracker->heartbeat("executor-2", start);
+
+  EXPECT_EQ(tracker->takeHeartbeats().size(), 2u);
+  EXPECT_TRUE(tracker->takeHeartbeats().empty());
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "work_lease_manager.h"
+#include "loopback_transport.h"
+
+using namespace scheduler;
+using namespace std::chrono_literals;
+
+// 最多派发执行器上报的credit数
+TEST(WorkLeaseManagerTest, GrantsUpToCredits)
+{
+  WorkLeaseManager leases;
+  leases.offer("a", 2, 0, 30000);
+  EXPECT_EQ(leases.availableCredits(), 2);
+
+  EXPECT_EQ(leases.acquire(), std::optional<std::string>("a"));
+  EXPECT_EQ(leases.acquire(), std::optional<std::string>("a"));
+  EXPECT_FALSE(leases.acquire().has_value());
+  EXPECT_EQ(leases.availableCredits(), 0);
+}
+
+// 重新上报的credit是绝对值，已派发但执行器尚未收到的任务要扣除
+TEST(WorkLeaseManagerTest, DeductsInFlightJobs)
+{
+  WorkLeaseManager leases;
+  leases.offer("a", 3, 0, 30000);
+  ASSERT_TRUE(leases.acquire().has_value());
+  ASSERT_TRUE(leases.acquire().has_value());
+
+  // 执行器只收到一个任务时仍上报3个空闲槽位，另一个在途
+  leases.offer("a", 3, 1, 30000);
+  EXPECT_EQ(leases.availableCredits(), 2);
+
+  // 两个都已收到
+  leases.offer("a", 1, 2, 30000);
+  EXPECT_EQ(leases.availableCredits(), 1);
+}
+
+// 派发失败归还credit，但不会低于执行器已收到的数量
+TEST(WorkLeaseManagerTest, ReleaseReturnsCredit)
+{
+  WorkLeaseManager leases;
+  leases.offer("a", 1, 0, 30000);
+  ASSERT_TRUE(leases.acquire().has_value());
+  EXPECT_EQ(leases.availableCredits(), 0);
+
+  leases.release("a");
+  EXPECT_EQ(leases.availableCredits(), 1);
+
+  leases.release("a");
+  EXPECT_EQ(leases.availableCredits(), 1);
+  leases.release("unknown");
+}
+
+// 优先选择可用credit最多的执行器
+TEST(WorkLeaseManagerTest, PrefersMostAvailable)
+{
+  WorkLeaseManager leases;
+  leases.offer("a", 1, 0, 30000);
+  leases.offer("b", 3, 0, 30000);
+
+  EXPECT_EQ(leases.acquire(), std::optional<std::string>("b"));
+  EXPECT_EQ(leases.acquire(), std::optional<std::string>("b"));
+  EXPECT_EQ(leases.availableCredits(), 2);
+}
+
+// 过期和已移除的执行器不再派发
+TEST(WorkLeaseManagerTest, ExpiredAndRemoved)
+{
+  WorkLeaseManager leases;
+  leases.offer("a", 2, 0, 20);
+  leases.offer("b", 2, 0, 30000);
+  std::this_thread::sleep_for(50ms);
+
+  EXPECT_EQ(leases.availableCredits(), 2);
+  EXPECT_EQ(leases.acquire(), std::optional<std::string>("b"));
+
+  leases.remove("b");
+  EXPECT_FALSE(leases.acquire().has_value());
+  EXPECT_EQ(leases.availableCredits(), 0);
+}
+
+// 主节点切换后累计派发数从0开始，以执行器上报的接收数为准
+TEST(WorkLeaseManagerTest, NewLeaderTrustsReceivedCount)
+{
+  WorkLeaseManager leases;
+  leases.offer("a", 2, 100, 30000);
+  EXPECT_EQ(leases.availableCredits(), 2);
+  ASSERT_TRUE(leases.acquire().has_value());
+  EXPECT_EQ(leases.availableCredits(), 1);
+}
+
+// 解析执行器发送的WORK_REQUEST消息体，格式错误时不记录
+TEST(WorkLeaseManagerTest, OffersFromPayload)
+{
+  WorkLeaseManager leases;
+  EXPECT_TRUE(leases.offer(R"({"executor_id":"a","credits":3,"received":0,"wait_ms":30000})"));
+  EXPECT_EQ(leases.availableCredits(), 3);
+  EXPECT_FALSE(leases.offer(R"({"credits":3})"));
+  EXPECT_FALSE(leases.offer("not json"));
+  EXPECT_EQ(leases.availableCredits(), 3);
+}
+
+// 两个调度器节点各用自己的消费组，主从节点都收到全部工作请求，无论哪个节点是主节点都能派发
+TEST(WorkLeaseManagerTest, EveryNodeSeesAllCredits)
+{
+  LoopbackBroker broker;
+  WorkLeaseManager leader, follower;
+  std::atomic<int> leaderRequests{0}, followerRequests{0};
+
+  LoopbackTransport leaderConsumer(broker), followerConsumer(broker);
+  leaderConsumer.initConsumer("", WorkLeaseManager::consumerGroup("scheduler-1"), {"executor-credit"},
+                              [&](const KafkaMessage &message)
+                              { leader.offer(message.payload); leaderRequests++; }, "latest");
+  followerConsumer.initConsumer("", WorkLeaseManager::consumerGroup("scheduler-2"), {"executor-credit"},
+                                [&](const KafkaMessage &message)
+                                { follower.offer(message.payload); followerRequests++; }, "latest");
+  ASSERT_TRUE(leaderConsumer.startConsume());
+  ASSERT_TRUE(followerConsumer.startConsume());
+
+  LoopbackTransport executor(broker);
+  ASSERT_TRUE(executor.initProducer(""));
+  for (int i = 0; i < 4; ++i)
+  {
+    std::string id = "executor-" + std::to_string(i);
+    std::string payload = R"({"executor_id":")" + id + R"(","credits":2,"received":0,"wait_ms":30000})";
+    ASSERT_TRUE(executor.sendMessage("executor-credit", KafkaMessage(MessageType::WORK_REQUEST, payload, id)));
+  }
+
+  auto deadline = std::chrono::steady_clock::now() + 2s;
+  while ((leaderRequests < 4 || followerRequests < 4) && std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(5ms);
+  }
+  leaderConsumer.stopConsume();
+  followerConsumer.stopConsume();
+
+  EXPECT_NE(WorkLeaseManager::consumerGroup("scheduler-1"), WorkLeaseManager::consumerGroup("scheduler-2"));
+  EXPECT_EQ(leader.availableCredits(), 8);
+  EXPECT_EQ(follower.availableCredits(), 8);
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include "write_behind_buffer.h"
+
+using namespace scheduler;
+using namespace std::chrono_literals;
+
+class WriteBehindBufferTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    WriteBehindBuffer::Options options;
+    options.flush_interval = 10s;
+    options.max_pending = 4;
+    buffer = std::make_unique<WriteBehindBuffer>(options);
+  }
+
+  std::unique_ptr<WriteBehindBuffer> buffer;
+};
+
+// 执行器计数的增量相加，相抵为0的不写入
+TEST_F(WriteBehindBufferTest, CountersAreSummed)
+{
+  buffer->addExecutorLoad("b", 1);
+  buffer->addExecutorLoad("b", 1);
+  buffer->addExecutorLoad("a", 1);
+  buffer->addExecutorLoad("a", -1);
+  buffer->addExecutorLoad("b", -1);
+  buffer->incrementExecutorTaskCount("b");
+  buffer->addExecutorLoad("c", -1);
+  buffer->incrementExecutorTaskCount("c");
+
+  auto counters = buffer->take().counters;
+  ASSERT_EQ(counters.size(), 2u);
+  EXPECT_EQ(counters[0].executor_id, "b");
+  EXPECT_EQ(counters[0].load_delta, 1);
+  EXPECT_EQ(counters[0].tasks_executed, 1u);
+  EXPECT_EQ(counters[1].executor_id, "c");
+  EXPECT_EQ(counters[1].load_delta, -1);
+  EXPECT_EQ(counters[1].tasks_executed, 1u);
+
+  EXPECT_EQ(buffer->pendingKeys(), 0u);
+  EXPECT_EQ(buffer->bufferedUpdates(), 8u);
+}
+
+// 写入失败后放回缓冲区，与之后的增量相加，相加后相抵的不再写入
+TEST_F(WriteBehindBufferTest, RestoreMergesWithNewerUpdates)
+{
+  buffer->addExecutorLoad("a", 2);
+  buffer->incrementExecutorTaskCount("a");
+  buffer->addExecutorLoad("b", 1);
+  auto failed = buffer->take();
+
+  buffer->addExecutorLoad("a", -1);
+  buffer->incrementExecutorTaskCount("a");
+  buffer->addExecutorLoad("b", -1);
+  buffer->addExecutorLoad("c", 1);
+  buffer->restore(failed);
+
+  auto counters = buffer->take().counters;
+  ASSERT_EQ(counters.size(), 2u);
+  EXPECT_EQ(counters[0].executor_id, "a");
+  EXPECT_EQ(counters[0].load_delta, 1);
+  EXPECT_EQ(counters[0].tasks_executed, 2u);
+  EXPECT_EQ(counters[1].executor_id, "c");
+  EXPECT_EQ(counters[1].load_delta, 1);
+}
+
+// 同一执行记录只保留最后的状态，按执行ID排序
+TEST_F(WriteBehindBufferTest, LastStatusWins)
+{
+  buffer->updateExecutionStatus(7, JobStatus::WAITING);
+  buffer->updateExecutionStatus(3, JobStatus::RUNNING);
+  buffer->updateExecutionStatus(7, JobStatus::RUNNING);
+
+  auto batch = buffer->take();
+  ASSERT_EQ(batch.statuses.size(), 2u);
+  EXPECT_EQ(batch.statuses[0], std::make_pair(uint64_t(3), JobStatus::RUNNING));
+  EXPECT_EQ(batch.statuses[1], std::make_pair(uint64_t(7), JobStatus::RUNNING));
+  EXPECT_TRUE(batch.counters.empty());
+  EXPECT_TRUE(buffer->take().empty());
+}
+
+// 放回的状态不覆盖取出之后缓冲的状态
+TEST_F(WriteBehindBufferTest, RestoreKeepsNewerStatus)
+{
+  buffer->updateExecutionStatus(1, JobStatus::WAITING);
+  buffer->updateExecutionStatus(2, JobStatus::RUNNING);
+  auto failed = buffer->take();
+
+  buffer->updateExecutionStatus(1, JobStatus::RUNNING);
+  buffer->restore(failed);
+
+  auto batch = buffer->take();
+  ASSERT_EQ(batch.statuses.size(), 2u);
+  EXPECT_EQ(batch.statuses[0], std::make_pair(uint64_t(1), JobStatus::RUNNING));
+  EXPECT_EQ(batch.statuses[1], std::make_pair(uint64_t(2), JobStatus::RUNNING));
+}
+
+// 缓冲的键数达到max_pending时不等刷新周期结束
+TEST_F(WriteBehindBufferTest, FlushesEarlyWhenFull)
+{
+  for (int i = 0; i < 4; ++i)
+  {
+    buffer->addExecutorLoad("executor-" + std::to_string(i), 1);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  buffer->waitForFlush();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+
+  // wakeUp提前唤醒
+  buffer->take();
+  buffer->wakeUp();
+  start = std::chrono::steady_clock::now();
+  buffer->waitForFlush();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+}